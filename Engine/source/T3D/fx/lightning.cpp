@@ -176,7 +176,7 @@ void LightningStrikeEvent::pack(NetConnection* con, BitStream* stream)
       return;
    }
    stream->writeFlag(true);
-   stream->writeRangedU32(U32(id), 0, NetConnection::MaxGhostCount);
+   con->writeGhostId(stream, U32(id));
    stream->writeFloat(mStart.x, PositionalBits);
    stream->writeFloat(mStart.y, PositionalBits);
 
@@ -188,7 +188,7 @@ void LightningStrikeEvent::pack(NetConnection* con, BitStream* stream)
       else
       {
          stream->writeFlag(true);
-         stream->writeRangedU32(U32(ghostIndex), 0, NetConnection::MaxGhostCount);
+         con->writeGhostId(stream, U32(ghostIndex));
       }
    }
    else
@@ -199,7 +199,7 @@ void LightningStrikeEvent::unpack(NetConnection* con, BitStream* stream)
 {
    if(!stream->readFlag())
       return;
-   S32 mClientId = stream->readRangedU32(0, NetConnection::MaxGhostCount);
+   S32 mClientId = con->readGhostId(stream);
    mLightning = NULL;
    NetObject* pObject = con->resolveGhost(mClientId);
    if (pObject)
@@ -211,7 +211,7 @@ void LightningStrikeEvent::unpack(NetConnection* con, BitStream* stream)
    if( stream->readFlag() )
    {
       // target id
-      S32 mTargetID    = stream->readRangedU32(0, NetConnection::MaxGhostCount);
+      S32 mTargetID    = con->readGhostId(stream);
 
       NetObject* pObject = con->resolveGhost(mTargetID);
       if( pObject != NULL )
@@ -52,8 +52,8 @@
 
 #define ControlRequestTime 5000
 
-const U32 GameConnection::CurrentProtocolVersion = 12;
-const U32 GameConnection::MinRequiredProtocolVersion = 12;
+const U32 GameConnection::CurrentProtocolVersion = 14;
+const U32 GameConnection::MinRequiredProtocolVersion = 14;
 
 //----------------------------------------------------------------------------
 
@@ -1054,7 +1054,7 @@ void GameConnection::readPacket(BitStream *bstream)
             if(mControlObject.isNull())
                callScript = true;
 
-            S32 gIndex = bstream->readInt(NetConnection::GhostIdBitSize);
+            S32 gIndex = readGhostId(bstream);
             GameBase* obj = dynamic_cast<GameBase*>(resolveGhost(gIndex));
             if (mControlObject != obj)
             {
@@ -1095,7 +1095,7 @@ void GameConnection::readPacket(BitStream *bstream)
 
       if (bstream->readFlag())
       {
-         S32 gIndex = bstream->readInt(NetConnection::GhostIdBitSize);
+         S32 gIndex = readGhostId(bstream);
          GameBase* obj = dynamic_cast<GameBase*>(resolveGhost(gIndex));
          setCameraObject(obj);
          obj->readPacketData(this, bstream);
@@ -1276,7 +1276,7 @@ void GameConnection::writePacket(BitStream *bstream, PacketNotify *note)
                Con::printf("packetDataChecksum disagree! (force)");
 #endif
 
-            bstream->writeInt(gIndex, NetConnection::GhostIdBitSize);
+            writeGhostId(bstream, gIndex);
 #ifdef TORQUE_NET_STATS
             U32 beginSize = bstream->getBitPosition();
 #endif
@@ -1305,7 +1305,7 @@ void GameConnection::writePacket(BitStream *bstream, PacketNotify *note)
          gIndex = getGhostIndex(mCameraObject);
          if (bstream->writeFlag(gIndex != -1))
          {
-            bstream->writeInt(gIndex, NetConnection::GhostIdBitSize);
+            writeGhostId(bstream, gIndex);
             mCameraObject->writePacketData(this, bstream);
          }
       }
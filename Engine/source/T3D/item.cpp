@@ -1055,7 +1055,7 @@ U32 Item::packUpdate(NetConnection *connection, U32 mask, BitStream *stream)
    if (mask & ThrowSrcMask && mCollisionObject) {
       S32 gIndex = connection->getGhostIndex(mCollisionObject);
       if (stream->writeFlag(gIndex != -1))
-         stream->writeInt(gIndex,NetConnection::GhostIdBitSize);
+         connection->writeGhostId(stream, gIndex);
    }
    else
       stream->writeFlag(false);
@@ -1095,7 +1095,7 @@ void Item::unpackUpdate(NetConnection *connection, BitStream *stream)
 
    // ThrowSrcMask && mCollisionObject
    if (stream->readFlag()) {
-      S32 gIndex = stream->readInt(NetConnection::GhostIdBitSize);
+      S32 gIndex = connection->readGhostId(stream);
       setCollisionTimeout(static_cast<ShapeBase*>(connection->resolveGhost(gIndex)));
    }
 
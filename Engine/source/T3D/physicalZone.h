@@ -76,10 +76,12 @@ class PhysicalZone : public SceneObject
    // NetObject
    U32  packUpdate  (NetConnection *conn, U32 mask, BitStream *stream);
    void unpackUpdate(NetConnection *conn,           BitStream *stream);
+   bool isPackUpdateThreadSafe(U32 mask) const { return true; }
 
    // SceneObject
    void setTransform(const MatrixF &mat);
    void prepRenderImage( SceneRenderState* state );
+   bool isPrepRenderImageThreadSafe() const { return true; }
 
    inline F32 getVelocityMod() const      { return mVelocityMod; }
    inline F32 getGravityMod()  const      { return mGravityMod;  }
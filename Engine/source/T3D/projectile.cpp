@@ -1288,9 +1288,7 @@ U32 Projectile::packUpdate( NetConnection *con, U32 mask, BitStream *stream )
          S32 ghostIndex = con->getGhostIndex( mSourceObject );
          if ( stream->writeFlag( ghostIndex != -1 ) )
          {
-            stream->writeRangedU32( U32(ghostIndex), 
-                                    0, 
-                                    NetConnection::MaxGhostCount );
+            con->writeGhostId( stream, U32(ghostIndex) );
 
             stream->writeRangedU32( U32(mSourceObjectSlot),
                                     0, 
@@ -1335,7 +1333,7 @@ void Projectile::unpackUpdate(NetConnection* con, BitStream* stream)
       mCurrTick = stream->readRangedU32( 0, MaxLivingTicks );
       if ( stream->readFlag() )
       {
-         mSourceObjectId   = stream->readRangedU32( 0, NetConnection::MaxGhostCount );
+         mSourceObjectId   = con->readGhostId( stream );
          mSourceObjectSlot = stream->readRangedU32( 0, ShapeBase::MaxMountedImages - 1 );
 
          NetObject* pObject = con->resolveGhost( mSourceObjectId );
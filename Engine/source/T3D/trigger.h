@@ -131,10 +131,12 @@ class Trigger : public GameBase
    // NetObject
    U32  packUpdate  (NetConnection *conn, U32 mask, BitStream* stream);
    void unpackUpdate(NetConnection *conn,           BitStream* stream);
+   bool isPackUpdateThreadSafe(U32 mask) const { return true; }
 
    // SceneObject
    void setTransform(const MatrixF &mat);
    void prepRenderImage( SceneRenderState* state );
+   bool isPrepRenderImageThreadSafe() const { return true; }
 
    // GameBase
    bool onNewDataBlock( GameBaseData *dptr, bool reload );
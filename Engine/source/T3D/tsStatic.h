@@ -192,6 +192,10 @@ public:
    U32 packUpdate( NetConnection *conn, U32 mask, BitStream *stream );
    void unpackUpdate( NetConnection *conn, BitStream *stream );
 
+   /// The skin is sent as a NetStringHandle, and lighting plugins pack
+   /// their own state, so only updates without either are thread safe.
+   bool isPackUpdateThreadSafe( U32 mask ) const { return !( mask & SkinMask ) && !mLightPlugin; }
+
    // SceneObject
    void setTransform( const MatrixF &mat );
    void onScaleChanged();
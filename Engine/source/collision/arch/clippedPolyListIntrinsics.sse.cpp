@@ -0,0 +1,76 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "collision/clippedPolyList.h"
+
+#if defined(TORQUE_CPU_X86)
+#include "collision/clippedPolyListIntrinsics.h"
+#include <xmmintrin.h>
+
+void computeVertexPlaneMasks_SSE(const PlaneF * __restrict planes, const dsize_t numPlanes, ClippedPolyList::Vertex * __restrict verts, const dsize_t numVerts)
+{
+   AssertFatal( numPlanes <= 32, "computeVertexPlaneMasks - Too many planes for a U32 mask!" );
+
+   // A vertex is a Point3F followed by its U32 mask, so four of them
+   // transpose straight into x, y, z and a throwaway row.
+   AssertFatal( sizeof( ClippedPolyList::Vertex ) == 4 * sizeof( F32 ), "computeVertexPlaneMasks_SSE - Unexpected vertex layout!" );
+
+   const __m128 zero = _mm_setzero_ps();
+
+   dsize_t i = 0;
+   for(; i + 4 <= numVerts; i += 4)
+   {
+      __m128 x = _mm_loadu_ps( (const F32*)&verts[i] );
+      __m128 y = _mm_loadu_ps( (const F32*)&verts[i + 1] );
+      __m128 z = _mm_loadu_ps( (const F32*)&verts[i + 2] );
+      __m128 w = _mm_loadu_ps( (const F32*)&verts[i + 3] );
+      _MM_TRANSPOSE4_PS( x, y, z, w );
+
+      __m128 masks = zero;
+      for(dsize_t p = 0; p < numPlanes; p++)
+      {
+         const F32 *plane = (const F32*)&planes[p];
+
+         // Same operation order as PlaneF::distToPlane() so the
+         // results match the C++ version exactly.
+         __m128 dist = _mm_add_ps( _mm_mul_ps( x, _mm_load1_ps( plane ) ), _mm_mul_ps( y, _mm_load1_ps( plane + 1 ) ) );
+         dist = _mm_add_ps( dist, _mm_mul_ps( z, _mm_load1_ps( plane + 2 ) ) );
+         dist = _mm_add_ps( dist, _mm_load1_ps( plane + 3 ) );
+
+         union { U32 u; F32 f; } bit;
+         bit.u = 1U << p;
+         masks = _mm_or_ps( masks, _mm_and_ps( _mm_cmpgt_ps( dist, zero ), _mm_set1_ps( bit.f ) ) );
+      }
+
+      union { __m128 v; U32 u[4]; } out;
+      out.v = masks;
+      verts[i].mask = out.u[0];
+      verts[i + 1].mask = out.u[1];
+      verts[i + 2].mask = out.u[2];
+      verts[i + 3].mask = out.u[3];
+   }
+
+   if(i < numVerts)
+      computeVertexPlaneMasks_C( planes, numPlanes, verts + i, numVerts - i );
+}
+
+#endif // TORQUE_CPU_X86
@@ -22,6 +22,7 @@
 
 #include "platform/platform.h"
 #include "collision/clippedPolyList.h"
+#include "collision/clippedPolyListIntrinsics.h"
 
 #include "math/mMath.h"
 #include "console/console.h"
@@ -35,7 +36,8 @@ bool ClippedPolyList::allowClipping = true;
 //----------------------------------------------------------------------------
 
 ClippedPolyList::ClippedPolyList()
- : mNormal( Point3F::Zero ),
+ : mNumMaskedVerts( 0 ),
+   mNormal( Point3F::Zero ),
    mNormalTolCosineRadians( 0.0f )
 {
    VECTOR_SET_ASSOCIATION(mPolyList);
@@ -63,6 +65,7 @@ void ClippedPolyList::clear()
    mIndexList.clear();
    mPolyPlaneList.clear();
    mNormalList.clear();
+   mNumMaskedVerts = 0;
 }
 
 bool ClippedPolyList::isEmpty() const
@@ -95,17 +98,9 @@ U32 ClippedPolyList::addPointAndNormal(const Point3F& p, const Point3F& normal)
 
     AssertFatal(mNormalList.size() == mVertexList.size(), "Normals count does not match vertex count!");    
 
-   // Build the plane mask
-   register U32      mask = 1;
-   register S32      count = mPlaneList.size();
-   register PlaneF * plane = mPlaneList.address();
-
+   // The plane mask is filled in by end() for all
+   // the new vertices at once.
    v.mask = 0;
-   while(--count >= 0) {
-      if (plane++->distToPlane(v.point) > 0)
-         v.mask |= mask;
-      mask <<= 1;
-   }
 
    return mVertexList.size() - 1;
 }
@@ -187,6 +182,8 @@ void ClippedPolyList::end()
       return;
    }
 
+   _updateVertexMasks();
+
    // Build initial inside/outside plane masks
    U32 indexStart = poly.vertexStart;
    U32 vertexCount = mIndexList.size() - indexStart;
@@ -276,6 +273,8 @@ void ClippedPolyList::end()
                   iv.mask = 1 << i;
                   break;
                }
+
+            mNumMaskedVerts = mVertexList.size();
          }
 
          if (!(mask2 & pmask)) 
@@ -308,6 +307,20 @@ void ClippedPolyList::end()
 
 //----------------------------------------------------------------------------
 
+void ClippedPolyList::_updateVertexMasks()
+{
+   // Vertices may have been removed since, ie. by cullUnusedVerts().
+   if ( mNumMaskedVerts > mVertexList.size() )
+      mNumMaskedVerts = mVertexList.size();
+
+   const U32 numVerts = mVertexList.size() - mNumMaskedVerts;
+   if ( numVerts == 0 )
+      return;
+
+   computeVertexPlaneMasks( mPlaneList.address(), mPlaneList.size(), mVertexList.address() + mNumMaskedVerts, numVerts );
+   mNumMaskedVerts = mVertexList.size();
+}
+
 void ClippedPolyList::memcpy(U32* dst, U32* src,U32 size)
 {
    U32* end = src + size;
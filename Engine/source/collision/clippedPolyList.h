@@ -26,8 +26,8 @@
 #ifndef _MMATH_H_
 #include "math/mMath.h"
 #endif
-#ifndef _TVECTORSPEC_H_
-#include "core/util/tVectorSpecializations.h"
+#ifndef _POLYLISTARENA_H_
+#include "collision/polyListArena.h"
 #endif
 #ifndef _ABSTRACTPOLYLIST_H_
 #include "collision/abstractPolyList.h"
@@ -66,10 +66,10 @@ public:
    /// ???
    static bool allowClipping;
 
-   typedef Vector<PlaneF> PlaneList;
-   typedef Vector<Vertex> VertexList;
-   typedef Vector<Poly> PolyList;
-   typedef FastVector<U32> IndexList;
+   typedef PolyListVector<PlaneF> PlaneList;
+   typedef PolyListVector<Vertex> VertexList;
+   typedef PolyListVector<Poly> PolyList;
+   typedef PolyListVector<U32> IndexList;
 
    typedef PlaneList::iterator PlaneListIterator;
    typedef VertexList::iterator VertexListIterator;
@@ -81,6 +81,11 @@ public:
    VertexList mVertexList;
    IndexList  mIndexList;
 
+   /// The number of vertices at the start of mVertexList whose
+   /// plane masks are up to date.
+   /// @see _updateVertexMasks()
+   U32 mNumMaskedVerts;
+
    // Temporary lists used by triangulate and kept
    // here to reduce memory allocations.
    PolyList    mTempPolyList;
@@ -90,7 +95,7 @@ public:
 
    /// The per-vertex normals.
    /// @see generateNormals()
-   Vector<VectorF> mNormalList;
+   PolyListVector<VectorF> mNormalList;
 
    PlaneList mPolyPlaneList;
 
@@ -142,6 +147,10 @@ public:
 
   protected:
 
+   /// Computes the plane masks of all the vertices added since the
+   /// last call in one batch.
+   void _updateVertexMasks();
+
    // AbstractPolyList
    const PlaneF& getIndexedPlane(const U32 index);
 };
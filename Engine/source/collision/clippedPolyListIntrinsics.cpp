@@ -0,0 +1,77 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "collision/clippedPolyListIntrinsics.h"
+#include "collision/arch/clippedPolyListIntrinsics.arch.h"
+
+#include "core/module.h"
+
+
+void (*computeVertexPlaneMasks)(const PlaneF * __restrict planes, const dsize_t numPlanes, ClippedPolyList::Vertex * __restrict verts, const dsize_t numVerts) = NULL;
+
+//------------------------------------------------------------------------------
+// Default C++ Implementations
+//------------------------------------------------------------------------------
+
+void computeVertexPlaneMasks_C(const PlaneF * __restrict planes, const dsize_t numPlanes, ClippedPolyList::Vertex * __restrict verts, const dsize_t numVerts)
+{
+   AssertFatal( numPlanes <= 32, "computeVertexPlaneMasks - Too many planes for a U32 mask!" );
+
+   for(dsize_t i = 0; i < numVerts; i++)
+   {
+      ClippedPolyList::Vertex &v = verts[i];
+
+      U32 mask = 0;
+      for(dsize_t p = 0; p < numPlanes; p++)
+      {
+         if(planes[p].distToPlane(v.point) > 0)
+            mask |= 1U << p;
+      }
+
+      v.mask = mask;
+   }
+}
+
+//------------------------------------------------------------------------------
+// Initializer.
+//------------------------------------------------------------------------------
+
+MODULE_BEGIN( ClippedPolyListIntrinsics )
+
+   MODULE_INIT_AFTER( 3D )
+
+   MODULE_INIT
+   {
+      // Assign defaults (C++ versions)
+      computeVertexPlaneMasks = computeVertexPlaneMasks_C;
+
+      // Find the best implementation for the current CPU
+      if(Platform::SystemInfo.processor.properties & CPU_PROP_SSE)
+      {
+   #if defined(TORQUE_CPU_X86)
+         computeVertexPlaneMasks = computeVertexPlaneMasks_SSE;
+   #endif
+      }
+   }
+
+MODULE_END;
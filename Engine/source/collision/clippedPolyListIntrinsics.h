@@ -0,0 +1,49 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _CLIPPEDPOLYLISTINTRINSICS_H_
+#define _CLIPPEDPOLYLISTINTRINSICS_H_
+
+#ifndef _CLIPPEDPOLYLIST_H_
+#include "collision/clippedPolyList.h"
+#endif
+
+/// Compute the plane masks for a run of clipped poly list vertices
+///
+/// Bit i of a vertex mask is set if the vertex is in front of plane i,
+/// which is when PlaneF::distToPlane() is greater than zero.
+///
+/// @param planes    Planes to test against
+/// @param numPlanes Number of planes, at most 32
+/// @param verts     Vertices whose masks are written
+/// @param numVerts  Number of vertices
+extern void (*computeVertexPlaneMasks)
+                          (const PlaneF * __restrict planes,
+                           const dsize_t numPlanes,
+                           ClippedPolyList::Vertex * __restrict verts,
+                           const dsize_t numVerts);
+
+/// The reference C++ version of computeVertexPlaneMasks, which the other
+/// implementations must match bit for bit.
+extern void computeVertexPlaneMasks_C(const PlaneF * __restrict planes, const dsize_t numPlanes, ClippedPolyList::Vertex * __restrict verts, const dsize_t numVerts);
+
+#endif
@@ -26,6 +26,9 @@
 #ifndef _ABSTRACTPOLYLIST_H_
 #include "collision/abstractPolyList.h"
 #endif
+#ifndef _POLYLISTARENA_H_
+#include "collision/polyListArena.h"
+#endif
 
 /// A concrete, renderable PolyList
 ///
@@ -53,10 +56,10 @@ class ConcretePolyList : public AbstractPolyList
       }
    };
 
-   typedef Vector<PlaneF> PlaneList;
-   typedef Vector<Point3F> VertexList;
-   typedef Vector<Poly>   PolyList;
-   typedef Vector<U32>    IndexList;
+   typedef PolyListVector<PlaneF> PlaneList;
+   typedef PolyListVector<Point3F> VertexList;
+   typedef PolyListVector<Poly>   PolyList;
+   typedef PolyListVector<U32>    IndexList;
 
    PolyList   mPolyList;
    VertexList mVertexList;
@@ -39,6 +39,10 @@
 #include "collision/abstractPolyList.h"
 #endif
 
+#ifndef _POLYLISTARENA_H_
+#include "collision/polyListArena.h"
+#endif
+
 
 class CollisionList;
 
@@ -77,10 +81,10 @@ public:
       F32 height;
    };
 
-   typedef Vector<ExtrudedFace> ExtrudedList;
-   typedef Vector<PlaneF> PlaneList;
-   typedef Vector<Vertex> VertexList;
-   typedef Vector<U32> IndexList;
+   typedef PolyListVector<ExtrudedFace> ExtrudedList;
+   typedef PolyListVector<PlaneF> PlaneList;
+   typedef PolyListVector<Vertex> VertexList;
+   typedef PolyListVector<U32> IndexList;
 
    static F32 EqualEpsilon;
    static F32 FaceEpsilon;
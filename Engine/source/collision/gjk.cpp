@@ -29,6 +29,8 @@
 #include "scene/sceneObject.h"
 #include "collision/convex.h"
 #include "collision/gjk.h"
+#include "core/module.h"
+#include "console/engineAPI.h"
 
 
 //----------------------------------------------------------------------------
@@ -41,12 +43,47 @@ static U32 sIteration = 15;       // Stuck in a loop?
 S32 num_iterations = 0;
 S32 num_irregularities = 0;
 
+bool GjkCollisionState::smWarmStart = true;
+S32 GjkCollisionState::smNumQueries = 0;
+S32 GjkCollisionState::smNumWarmStarts = 0;
+S32 GjkCollisionState::smNumIterations = 0;
+S32 GjkCollisionState::smNumIrregularities = 0;
+
+
+MODULE_BEGIN( Gjk )
+
+   MODULE_INIT
+   {
+      Con::addVariable( "$Collision::gjkWarmStart", TypeBool, &GjkCollisionState::smWarmStart,
+         "If true, GJK distance queries start from the simplex found for the same pair on the last query.\n"
+         "@ingroup Physics" );
+
+      Con::addVariable( "$Collision::gjkQueries", TypeS32, &GjkCollisionState::smNumQueries,
+         "The number of GJK distance queries since the last gjkResetStats().\n"
+         "@ingroup Physics" );
+
+      Con::addVariable( "$Collision::gjkWarmStarts", TypeS32, &GjkCollisionState::smNumWarmStarts,
+         "The number of GJK distance queries which were warm started since the last gjkResetStats().\n"
+         "@ingroup Physics" );
+
+      Con::addVariable( "$Collision::gjkIterations", TypeS32, &GjkCollisionState::smNumIterations,
+         "The number of GJK iterations across all queries since the last gjkResetStats().\n"
+         "@ingroup Physics" );
+
+      Con::addVariable( "$Collision::gjkIrregularities", TypeS32, &GjkCollisionState::smNumIrregularities,
+         "The number of GJK distance queries which gave up early since the last gjkResetStats().\n"
+         "@ingroup Physics" );
+   }
+
+MODULE_END;
+
 
 //----------------------------------------------------------------------------
 
 GjkCollisionState::GjkCollisionState()
 {
    a = b = 0;
+   warm_bits = 0;
 }
 
 GjkCollisionState::~GjkCollisionState()
@@ -61,6 +98,11 @@ void GjkCollisionState::swap()
    Convex* t = a; a = b; b = t;
    CollisionStateList* l = mLista; mLista = mListb; mListb = l;
    v.neg();
+
+   // Keep the cached simplex in step with the new order.
+   for (int i = 0; i < 4; ++i) {
+      Point3F tp = p[i]; p[i] = q[i]; q[i] = tp;
+   }
 }
 
 
@@ -208,6 +250,7 @@ void GjkCollisionState::set(Convex* aa, Convex* bb,
 
    bits = 0;
    all_bits = 0;
+   warm_bits = 0;
    reset(a2w,b2w);
 
    // link
@@ -230,6 +273,51 @@ void GjkCollisionState::reset(const MatrixF& a2w, const MatrixF& b2w)
 }
 
 
+//----------------------------------------------------------------------------
+
+bool GjkCollisionState::warmStart(const MatrixF& a2w, const MatrixF& b2w)
+{
+   // A full simplex means the last query found the shapes touching, there
+   // is no separating axis to carry over.
+   const S32 warm = warm_bits;
+   warm_bits = 0;
+   if (!warm || warm == 15)
+      return false;
+
+   // Move the kept support points by the new transforms and add them back
+   // one at a time so the determinant cache is rebuilt as it would have
+   // been while iterating.
+   bits = 0;
+   all_bits = 0;
+   for (int i = 0, bit = 1; i < 4; ++i, bit <<= 1) {
+      if (!(warm & bit))
+         continue;
+
+      Point3F sa,sb;
+      a2w.mulP(p[i],&sa);
+      b2w.mulP(q[i],&sb);
+      VectorF w = sa - sb;
+
+      all_bits = bits;
+      if (degenerate(w))
+         return false;
+
+      last = i;
+      last_bit = bit;
+      y[last] = w;
+      all_bits = bits | last_bit;
+      if (!closest(v))
+         return false;
+   }
+
+   if (v.lenSquared() <= sEpsilon2)
+      return false;
+
+   dist = v.len();
+   return true;
+}
+
+
 //----------------------------------------------------------------------------
 
 void GjkCollisionState::getCollisionInfo(const MatrixF& mat, Collision* info)
@@ -274,6 +362,7 @@ void GjkCollisionState::getClosestPoints(Point3F& p1, Point3F& p2)
 bool GjkCollisionState::intersect(const MatrixF& a2w, const MatrixF& b2w)
 {
    num_iterations = 0;
+   warm_bits = 0;
    MatrixF w2a,w2b;
 
    w2a = a2w;
@@ -323,6 +412,24 @@ F32 GjkCollisionState::distance(const MatrixF& a2w, const MatrixF& b2w,
    const F32 dontCareDist, const MatrixF* _w2a, const MatrixF* _w2b)
 {
    num_iterations = 0;
+   const S32 irregularities = num_irregularities;
+
+   F32 result = _distance(a2w, b2w, dontCareDist, _w2a, _w2b);
+
+   // Whatever simplex we stopped with is the best start for next time.
+   warm_bits = bits;
+
+   ++smNumQueries;
+   smNumIterations += num_iterations;
+   if (num_irregularities != irregularities)
+      ++smNumIrregularities;
+
+   return result;
+}
+
+F32 GjkCollisionState::_distance(const MatrixF& a2w, const MatrixF& b2w,
+   const F32 dontCareDist, const MatrixF* _w2a, const MatrixF* _w2b)
+{
    MatrixF w2a,w2b;
 
    if (_w2a == NULL || _w2b == NULL) {
@@ -336,9 +443,13 @@ F32 GjkCollisionState::distance(const MatrixF& a2w, const MatrixF& b2w,
       w2b = *_w2b;
    }
 
-   reset(a2w,b2w);
-   bits = 0;
-   all_bits = 0;
+   if (smWarmStart && warmStart(a2w,b2w))
+      ++smNumWarmStarts;
+   else {
+      reset(a2w,b2w);
+      bits = 0;
+      all_bits = 0;
+   }
    F32 mu = 0;
 
    do {
@@ -385,3 +496,23 @@ F32 GjkCollisionState::distance(const MatrixF& a2w, const MatrixF& b2w,
       dist = 0;
    return dist;
 }
+
+
+//----------------------------------------------------------------------------
+
+void GjkCollisionState::resetStats()
+{
+   smNumQueries = 0;
+   smNumWarmStarts = 0;
+   smNumIterations = 0;
+   smNumIrregularities = 0;
+}
+
+DefineEngineFunction( gjkResetStats, void, (),,
+   "@brief Reset the GJK collision counters.\n\n"
+   "The counters are exposed as $Collision::gjkQueries, $Collision::gjkWarmStarts, "
+   "$Collision::gjkIterations and $Collision::gjkIrregularities.\n\n"
+   "@ingroup Physics" )
+{
+   GjkCollisionState::resetStats();
+}
@@ -56,6 +56,36 @@ struct GjkCollisionState: public CollisionState
    S32 last_bit;     ///< last_bit = 1<<last
    /// @}
 
+   /// @name Warm Starting
+   ///
+   /// The support points of the simplex found by the last distance() query
+   /// are kept in object space.  The states live as long as the two convexes
+   /// stay close, so the next query for the pair, usually on the next tick,
+   /// starts from that simplex moved by the new transforms rather than
+   /// from scratch.
+   /// @{
+
+   S32 warm_bits;    ///< simplex left by the last query, 0 if there isn't one
+
+   bool warmStart(const MatrixF& a2w, const MatrixF& b2w);
+
+   /// @}
+
+   /// @name Statistics
+   /// @{
+
+   /// Set to false to always start from scratch.
+   static bool smWarmStart;
+
+   static S32 smNumQueries;         ///< distance() calls
+   static S32 smNumWarmStarts;      ///< distance() calls which started from the last simplex
+   static S32 smNumIterations;      ///< support point iterations across all queries
+   static S32 smNumIrregularities;  ///< queries which gave up early
+
+   static void resetStats();
+
+   /// @}
+
    ///
    void compute_det();
    bool valid(int s);
@@ -76,6 +106,11 @@ struct GjkCollisionState: public CollisionState
    bool intersect(const MatrixF& a2w, const MatrixF& b2w);
    F32 distance(const MatrixF& a2w, const MatrixF& b2w, const F32 dontCareDist,
                        const MatrixF* w2a = NULL, const MatrixF* _w2b = NULL);
+
+protected:
+
+   F32 _distance(const MatrixF& a2w, const MatrixF& b2w, const F32 dontCareDist,
+                 const MatrixF* w2a, const MatrixF* _w2b);
 };
 
 
@@ -0,0 +1,156 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "collision/polyListArena.h"
+
+#include "platform/platformTLS.h"
+#include "platform/threads/mutex.h"
+#include "core/util/safeDelete.h"
+#include "core/module.h"
+#include "console/engineAPI.h"
+
+
+/// The arena for each thread.
+static ThreadStorage *sgArenaStorage = NULL;
+
+/// Every arena created so that they can be freed on shutdown.
+static Vector<PolyListArena*> sgArenas( __FILE__, __LINE__ );
+static Mutex sgArenasMutex;
+
+
+MODULE_BEGIN( PolyListArena )
+
+   MODULE_INIT
+   {
+      sgArenaStorage = new ThreadStorage;
+   }
+
+   MODULE_SHUTDOWN
+   {
+      PolyListArena::releaseAll();
+   }
+
+MODULE_END;
+
+
+PolyListArena::PolyListArena()
+   : mNumBlocks( 0 ),
+     mNumAllocs( 0 )
+{
+}
+
+PolyListArena::~PolyListArena()
+{
+   for ( U32 i = 0; i < mNumBlocks; i++ )
+   {
+      if ( mBlocks[i].memory )
+         dFree( mBlocks[i].memory );
+   }
+}
+
+PolyListArena* PolyListArena::get()
+{
+   if ( !sgArenaStorage )
+      return NULL;
+
+   PolyListArena *arena = (PolyListArena*)sgArenaStorage->get();
+   if ( !arena )
+   {
+      arena = new PolyListArena;
+      sgArenaStorage->set( arena );
+
+      MutexHandle lock;
+      lock.lock( &sgArenasMutex, true );
+      sgArenas.push_back( arena );
+   }
+
+   return arena;
+}
+
+void* PolyListArena::take( U32 &outBytes )
+{
+   if ( mNumBlocks == 0 )
+   {
+      outBytes = 0;
+      return NULL;
+   }
+
+   const Block &block = mBlocks[--mNumBlocks];
+   outBytes = block.bytes;
+   return block.memory;
+}
+
+void PolyListArena::give( void *block, U32 bytes )
+{
+   if ( mNumBlocks == MaxBlocks || bytes > MaxBlockBytes )
+   {
+      if ( block )
+         dFree( block );
+      return;
+   }
+
+   mBlocks[mNumBlocks].memory = block;
+   mBlocks[mNumBlocks].bytes = bytes;
+   mNumBlocks++;
+}
+
+U32 PolyListArena::getAllocCount()
+{
+   PolyListArena *arena = get();
+   return arena ? arena->mNumAllocs : 0;
+}
+
+void PolyListArena::resetAllocCount()
+{
+   PolyListArena *arena = get();
+   if ( arena )
+      arena->mNumAllocs = 0;
+}
+
+void PolyListArena::releaseAll()
+{
+   SAFE_DELETE( sgArenaStorage );
+
+   MutexHandle lock;
+   lock.lock( &sgArenasMutex, true );
+
+   for ( U32 i = 0; i < sgArenas.size(); i++ )
+      delete sgArenas[i];
+   sgArenas.clear();
+}
+
+DefineEngineFunction( getPolyListAllocCount, S32, (),,
+   "@brief Returns the number of heap allocations made by poly lists on the main thread.\n\n"
+   "Once collision queries have warmed up the poly list arena this should stay at zero.\n\n"
+   "@see resetPolyListAllocCount()\n"
+   "@ingroup Physics" )
+{
+   return PolyListArena::getAllocCount();
+}
+
+DefineEngineFunction( resetPolyListAllocCount, void, (),,
+   "@brief Resets the count returned by getPolyListAllocCount().\n\n"
+   "@ingroup Physics" )
+{
+   PolyListArena::resetAllocCount();
+}
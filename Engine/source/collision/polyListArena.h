@@ -0,0 +1,211 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _POLYLISTARENA_H_
+#define _POLYLISTARENA_H_
+
+#ifndef _TVECTORSPEC_H_
+#include "core/util/tVectorSpecializations.h"
+#endif
+
+
+/// A per-thread pool of heap blocks which the poly list containers
+/// borrow their element storage from.
+///
+/// Poly lists are built and thrown away many times per tick (several per
+/// player in Player::updatePos alone), and each build used to grow a handful
+/// of Vectors from nothing.  A PolyListVector instead adopts a block from the
+/// calling thread's arena when it is constructed and hands the block back,
+/// along with any growth, when it is destroyed.  After the first few ticks
+/// the blocks have reached the sizes the queries need and building a poly
+/// list no longer touches the heap.
+///
+/// Blocks are recycled in LIFO order so that a repeated query pattern gets
+/// the same block back for the same list.  Containers which never needed
+/// storage return an empty slot to keep that order intact.
+///
+/// The arenas only exist between module init and shutdown; containers
+/// constructed outside of that window behave like a plain Vector.
+class PolyListArena
+{
+public:
+
+   enum
+   {
+      /// The number of idle blocks kept per thread.
+      MaxBlocks = 64,
+
+      /// Blocks which have grown beyond this are released to the heap
+      /// rather than pooled.
+      MaxBlockBytes = 256 * 1024,
+   };
+
+   /// Returns the arena for the calling thread, creating it on first use,
+   /// or NULL if the arenas are not available.
+   static PolyListArena* get();
+
+   /// Takes the most recently returned block, or NULL if none are idle
+   /// or the slot is empty.
+   void* take( U32 &outBytes );
+
+   /// Returns a block, or an empty slot if the block is NULL, to the pool.
+   void give( void *block, U32 bytes );
+
+   /// Notes that a container had to go to the heap for its storage.
+   void noteAlloc() { mNumAllocs++; }
+
+   /// The number of heap allocations made by poly list containers on the
+   /// calling thread since the last resetAllocCount().
+   static U32 getAllocCount();
+
+   /// Resets the calling thread's allocation count.
+   static void resetAllocCount();
+
+   /// Frees every arena and their idle blocks.  Called on module shutdown,
+   /// after which get() returns NULL.
+   static void releaseAll();
+
+protected:
+
+   struct Block
+   {
+      void *memory;
+      U32 bytes;
+   };
+
+   Block mBlocks[MaxBlocks];
+   U32 mNumBlocks;
+   U32 mNumAllocs;
+
+   PolyListArena();
+   ~PolyListArena();
+};
+
+
+/// A FastVector which borrows its storage from the PolyListArena.
+template<class T>
+class PolyListVector : public FastVector<T>
+{
+protected:
+
+   /// The block we adopted, its capacity in elements and its
+   /// real size which need not be a whole number of elements.
+   T *mArenaBlock;
+   U32 mArenaSize;
+   U32 mArenaBytes;
+
+   void _adopt()
+   {
+      mArenaBlock = NULL;
+      mArenaSize = 0;
+      mArenaBytes = 0;
+
+      PolyListArena *arena = PolyListArena::get();
+      if ( !arena )
+         return;
+
+      U32 bytes;
+      void *block = arena->take( bytes );
+      if ( !block )
+         return;
+
+      if ( bytes < sizeof( T ) )
+      {
+         dFree( block );
+         return;
+      }
+
+      this->mArray = (T*)block;
+      this->mArraySize = bytes / sizeof( T );
+      mArenaBlock = this->mArray;
+      mArenaSize = this->mArraySize;
+      mArenaBytes = bytes;
+   }
+
+public:
+
+   PolyListVector()
+   {
+      _adopt();
+   }
+
+   PolyListVector( const PolyListVector &p )
+   {
+      _adopt();
+      operator=( p );
+   }
+
+   ~PolyListVector()
+   {
+      this->clear();
+
+      PolyListArena *arena = PolyListArena::get();
+      if ( !arena )
+         return;
+
+      // Even an unused container gives back an empty slot so
+      // that the next one constructed in its place gets its
+      // slot rather than the block of a neighbour.
+      if ( !this->mArray )
+      {
+         arena->give( NULL, 0 );
+         return;
+      }
+
+      // Any growth past the block we adopted went through the heap.
+      U32 bytes = mArenaBytes;
+      if ( this->mArray != mArenaBlock || this->mArraySize != mArenaSize )
+      {
+         arena->noteAlloc();
+         bytes = this->mArraySize * sizeof( T );
+      }
+
+      arena->give( this->mArray, bytes );
+      this->mArray = NULL;
+      this->mArraySize = 0;
+   }
+
+   PolyListVector& operator=( const Vector<T> &p )
+   {
+      if ( &p == this )
+         return *this;
+
+      // Vector::operator= always resizes, which reallocates the block
+      // even when it is already big enough.
+      if ( p.size() <= this->mArraySize )
+      {
+         this->clear();
+         this->merge( p );
+      }
+      else
+         Vector<T>::operator=( p );
+
+      return *this;
+   }
+
+   PolyListVector& operator=( const PolyListVector &p )
+   {
+      return operator=( (const Vector<T>&)p );
+   }
+};
+
+#endif // _POLYLISTARENA_H_
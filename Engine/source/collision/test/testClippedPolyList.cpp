@@ -0,0 +1,195 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "console/console.h"
+#include "collision/clippedPolyList.h"
+#include "collision/clippedPolyListIntrinsics.h"
+#include "math/mRandom.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+CreateUnitTest( TestClippedPolyListPlaneMasks, "Collision/ClippedPolyList/PlaneMasks" )
+{
+   enum
+   {
+      NumRuns = 20,
+      NumPolys = 500,
+      NumVerts = 1001,
+   };
+
+   static void randomPlanes( MRandomLCG &rand, U32 count, Vector<PlaneF> &outPlanes )
+   {
+      // A box around the origin with some extra cuts
+      // through it, like a player's collision volume.
+      outPlanes.clear();
+      outPlanes.push_back( PlaneF( Point3F( -1.0f, 0.0f, 0.0f ), VectorF( -1.0f, 0.0f, 0.0f ) ) );
+      outPlanes.push_back( PlaneF( Point3F( 1.0f, 0.0f, 0.0f ), VectorF( 1.0f, 0.0f, 0.0f ) ) );
+      outPlanes.push_back( PlaneF( Point3F( 0.0f, -1.0f, 0.0f ), VectorF( 0.0f, -1.0f, 0.0f ) ) );
+      outPlanes.push_back( PlaneF( Point3F( 0.0f, 1.0f, 0.0f ), VectorF( 0.0f, 1.0f, 0.0f ) ) );
+      outPlanes.push_back( PlaneF( Point3F( 0.0f, 0.0f, -1.0f ), VectorF( 0.0f, 0.0f, -1.0f ) ) );
+      outPlanes.push_back( PlaneF( Point3F( 0.0f, 0.0f, 1.0f ), VectorF( 0.0f, 0.0f, 1.0f ) ) );
+
+      while ( outPlanes.size() < count )
+      {
+         VectorF normal( rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ) );
+         normal.normalizeSafe();
+         outPlanes.push_back( PlaneF( normal * rand.randF( 0.5f, 1.0f ), normal ) );
+      }
+   }
+
+   static Point3F randomPoint( MRandomLCG &rand )
+   {
+      return Point3F( rand.randF( -2.0f, 2.0f ), rand.randF( -2.0f, 2.0f ), rand.randF( -2.0f, 2.0f ) );
+   }
+
+   /// Fills a poly list with random triangles and quads, some of
+   /// them sharing vertices with the previous poly.
+   static void fillPolyList( U32 seed, const Vector<PlaneF> &planes, ClippedPolyList &polyList )
+   {
+      MRandomLCG rand( seed );
+
+      polyList.mPlaneList = planes;
+
+      U32 verts[4];
+      for ( U32 i = 0; i < NumPolys; i++ )
+      {
+         const U32 numVerts = rand.randI( 3, 4 );
+         for ( U32 j = 0; j < numVerts; j++ )
+         {
+            if ( i > 0 && j == 0 && rand.randI( 0, 1 ) )
+               continue;
+            verts[j] = polyList.addPoint( randomPoint( rand ) );
+         }
+
+         polyList.begin( NULL, i );
+         polyList.plane( verts[0], verts[1], verts[2] );
+         for ( U32 j = 0; j < numVerts; j++ )
+            polyList.vertex( verts[j] );
+         polyList.end();
+      }
+   }
+
+   void testMasks( MRandomLCG &rand )
+   {
+      Vector<PlaneF> planes;
+      randomPlanes( rand, rand.randI( 1, 32 ), planes );
+
+      Vector<ClippedPolyList::Vertex> ref( NumVerts );
+      ref.setSize( NumVerts );
+      for ( U32 i = 0; i < NumVerts; i++ )
+      {
+         ref[i].point = randomPoint( rand );
+         ref[i].mask = 0xdeadbeef;
+      }
+
+      Vector<ClippedPolyList::Vertex> verts( ref );
+
+      computeVertexPlaneMasks_C( planes.address(), planes.size(), ref.address(), ref.size() );
+      computeVertexPlaneMasks( planes.address(), planes.size(), verts.address(), verts.size() );
+
+      bool match = true;
+      for ( U32 i = 0; i < NumVerts; i++ )
+         match &= verts[i].mask == ref[i].mask;
+
+      test( match, "computeVertexPlaneMasks doesn't match the C++ version!" );
+   }
+
+   void testClipper( MRandomLCG &rand )
+   {
+      Vector<PlaneF> planes;
+      randomPlanes( rand, rand.randI( 6, 12 ), planes );
+      const U32 seed = rand.randI();
+
+      void (*current)(const PlaneF*, const dsize_t, ClippedPolyList::Vertex*, const dsize_t) = computeVertexPlaneMasks;
+
+      ClippedPolyList scalar;
+      computeVertexPlaneMasks = computeVertexPlaneMasks_C;
+      fillPolyList( seed, planes, scalar );
+
+      ClippedPolyList vectorized;
+      computeVertexPlaneMasks = current;
+      fillPolyList( seed, planes, vectorized );
+
+      test( scalar.mPolyList.size() > 0, "Expected some polys to survive clipping!" );
+
+      bool match = scalar.mPolyList.size() == vectorized.mPolyList.size() &&
+                   scalar.mIndexList.size() == vectorized.mIndexList.size() &&
+                   scalar.mVertexList.size() == vectorized.mVertexList.size();
+
+      for ( U32 i = 0; match && i < scalar.mPolyList.size(); i++ )
+      {
+         const ClippedPolyList::Poly &a = scalar.mPolyList[i];
+         const ClippedPolyList::Poly &b = vectorized.mPolyList[i];
+         match = a.vertexStart == b.vertexStart &&
+                 a.vertexCount == b.vertexCount &&
+                 a.surfaceKey == b.surfaceKey;
+      }
+
+      for ( U32 i = 0; match && i < scalar.mIndexList.size(); i++ )
+         match = scalar.mIndexList[i] == vectorized.mIndexList[i];
+
+      for ( U32 i = 0; match && i < scalar.mVertexList.size(); i++ )
+         match = scalar.mVertexList[i].point == vectorized.mVertexList[i].point &&
+                 scalar.mVertexList[i].mask == vectorized.mVertexList[i].mask;
+
+      test( match, "Clipping with computeVertexPlaneMasks doesn't match the C++ version!" );
+   }
+
+   void run()
+   {
+      MRandomLCG rand( 1 );
+
+      for ( U32 i = 0; i < NumRuns; i++ )
+      {
+         testMasks( rand );
+         testClipper( rand );
+      }
+
+      // Compare the speed of the two on a player sized plane set.
+      Vector<PlaneF> planes;
+      randomPlanes( rand, 10, planes );
+
+      Vector<ClippedPolyList::Vertex> verts( NumVerts );
+      verts.setSize( NumVerts );
+      for ( U32 i = 0; i < NumVerts; i++ )
+         verts[i].point = randomPoint( rand );
+
+      U32 start = Platform::getRealMilliseconds();
+      for ( U32 i = 0; i < 1000; i++ )
+         computeVertexPlaneMasks_C( planes.address(), planes.size(), verts.address(), verts.size() );
+      const U32 scalarTime = Platform::getRealMilliseconds() - start;
+
+      start = Platform::getRealMilliseconds();
+      for ( U32 i = 0; i < 1000; i++ )
+         computeVertexPlaneMasks( planes.address(), planes.size(), verts.address(), verts.size() );
+      const U32 currentTime = Platform::getRealMilliseconds() - start;
+
+      Con::printf( "   plane masks for %d verts x %d planes x 1000: C++ %dms, current %dms", (S32)NumVerts, planes.size(), scalarTime, currentTime );
+   }
+};
+
+#endif // TORQUE_SHIPPING
@@ -0,0 +1,153 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "console/console.h"
+#include "collision/boxConvex.h"
+#include "collision/gjk.h"
+#include "math/mRandom.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+CreateUnitTest( TestGjkWarmStart, "Collision/GJK/WarmStart" )
+{
+   enum
+   {
+      NumWorldBoxes = 200,
+      NumTicks = 300,
+   };
+
+   /// A player sized box walking through a field of rotated static boxes
+   /// with one collision state per pair kept across ticks, as
+   /// Convex::updateStateList() does.
+   struct Scene
+   {
+      BoxConvex player;
+      BoxConvex world[NumWorldBoxes];
+      MatrixF worldMats[NumWorldBoxes];
+      GjkCollisionState states[NumWorldBoxes];
+
+      Scene()
+      {
+         MRandomLCG rand( 1 );
+
+         player.mCenter.set( 0, 0, 0 );
+         player.mSize.set( 0.5f, 0.5f, 1.0f );
+
+         for ( U32 i = 0; i < NumWorldBoxes; i++ )
+         {
+            world[i].mCenter.set( 0, 0, 0 );
+            world[i].mSize.set( rand.randF( 0.2f, 1.2f ), rand.randF( 0.2f, 1.2f ), rand.randF( 0.2f, 1.2f ) );
+
+            worldMats[i].set( EulerF( rand.randF( 0.0f, M_2PI_F ), rand.randF( 0.0f, M_2PI_F ), rand.randF( 0.0f, M_2PI_F ) ) );
+            worldMats[i].setPosition( Point3F( rand.randF( 0.0f, 20.0f ), rand.randF( 0.0f, 20.0f ), rand.randF( 0.0f, 2.0f ) ) );
+
+            states[i].set( &player, &world[i], MatrixF( true ), worldMats[i] );
+         }
+      }
+
+      static MatrixF getPlayerTransform( U32 tick )
+      {
+         MatrixF mat( EulerF( 0.0f, 0.0f, tick * 0.01f ) );
+         mat.setPosition( Point3F( tick * 0.066f, tick * 0.05f, 1.5f + 0.5f * mSin( tick * 0.1f ) ) );
+         return mat;
+      }
+
+      F32 distance( U32 tick, U32 i )
+      {
+         return states[i].distance( getPlayerTransform( tick ), worldMats[i], 100.0f );
+      }
+   };
+
+   void run()
+   {
+      const bool oldWarmStart = GjkCollisionState::smWarmStart;
+
+      Scene *cold = new Scene;
+      Scene *warm = new Scene;
+
+      // Same answers with and without warm starting.
+      U32 coldIterations = 0;
+      U32 warmIterations = 0;
+      bool distancesMatch = true;
+      for ( U32 tick = 0; tick < NumTicks; tick++ )
+      {
+         for ( U32 i = 0; i < NumWorldBoxes; i++ )
+         {
+            GjkCollisionState::resetStats();
+            GjkCollisionState::smWarmStart = false;
+            const F32 coldDist = cold->distance( tick, i );
+            coldIterations += GjkCollisionState::smNumIterations;
+
+            GjkCollisionState::resetStats();
+            GjkCollisionState::smWarmStart = true;
+            const F32 warmDist = warm->distance( tick, i );
+            warmIterations += GjkCollisionState::smNumIterations;
+
+            if ( mFabs( coldDist - warmDist ) > 0.001f * ( 1.0f + coldDist ) )
+               distancesMatch = false;
+         }
+      }
+
+      test( distancesMatch, "Warm started GJK should find the same distances!" );
+      test( warmIterations < coldIterations, "Warm started GJK should need fewer iterations!" );
+
+      // Timings, starting both from fresh states.
+      delete cold;
+      delete warm;
+      cold = new Scene;
+      warm = new Scene;
+
+      GjkCollisionState::smWarmStart = false;
+      U32 start = Platform::getRealMilliseconds();
+      for ( U32 tick = 0; tick < NumTicks; tick++ )
+         for ( U32 i = 0; i < NumWorldBoxes; i++ )
+            cold->distance( tick, i );
+      const U32 coldTime = Platform::getRealMilliseconds() - start;
+
+      GjkCollisionState::smWarmStart = true;
+      GjkCollisionState::resetStats();
+      start = Platform::getRealMilliseconds();
+      for ( U32 tick = 0; tick < NumTicks; tick++ )
+         for ( U32 i = 0; i < NumWorldBoxes; i++ )
+            warm->distance( tick, i );
+      const U32 warmTime = Platform::getRealMilliseconds() - start;
+
+      Con::printf( "   %d pairs over %d ticks: cold %dms %.2f iterations per query, warm %dms %.2f iterations per query (%d warm starts)",
+         NumWorldBoxes, NumTicks,
+         coldTime, F32( coldIterations ) / ( NumWorldBoxes * NumTicks ),
+         warmTime, F32( warmIterations ) / ( NumWorldBoxes * NumTicks ),
+         GjkCollisionState::smNumWarmStarts );
+
+      delete cold;
+      delete warm;
+
+      GjkCollisionState::smWarmStart = oldWarmStart;
+      GjkCollisionState::resetStats();
+   }
+};
+
+#endif // TORQUE_SHIPPING
@@ -0,0 +1,110 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "console/console.h"
+#include "collision/clippedPolyList.h"
+#include "collision/concretePolyList.h"
+#include "collision/extrudedPolyList.h"
+#include "collision/collision.h"
+#include "math/mPolyhedron.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+CreateUnitTest( TestPolyListArena, "Collision/PolyListArena" )
+{
+   enum
+   {
+      NumBoxes = 32,
+   };
+
+   /// Build each kind of poly list against a row of boxes the way a
+   /// movement tick does, with the lists living on the stack.
+   static void buildPolyLists()
+   {
+      const Box3F playerBox( -0.5f, -0.5f, 0.0f, 0.5f, 0.5f, 2.0f );
+
+      {
+         ClippedPolyList polyList;
+         polyList.mNormal.set( 0.0f, 0.0f, 0.0f );
+         polyList.mPlaneList.setSize( 6 );
+         polyList.mPlaneList[0].set( playerBox.minExtents, VectorF( -1.0f, 0.0f, 0.0f ) );
+         polyList.mPlaneList[1].set( playerBox.minExtents, VectorF( 0.0f, -1.0f, 0.0f ) );
+         polyList.mPlaneList[2].set( playerBox.minExtents, VectorF( 0.0f, 0.0f, -1.0f ) );
+         polyList.mPlaneList[3].set( playerBox.maxExtents, VectorF( 1.0f, 0.0f, 0.0f ) );
+         polyList.mPlaneList[4].set( playerBox.maxExtents, VectorF( 0.0f, 1.0f, 0.0f ) );
+         polyList.mPlaneList[5].set( playerBox.maxExtents, VectorF( 0.0f, 0.0f, 1.0f ) );
+
+         for ( U32 i = 0; i < NumBoxes; i++ )
+            polyList.addBox( Box3F( -1.0f + i * 0.1f, -1.0f, -0.2f, i * 0.1f, 1.0f, 0.3f ) );
+      }
+
+      {
+         ConcretePolyList polyList;
+         for ( U32 i = 0; i < NumBoxes; i++ )
+            polyList.addBox( Box3F( i * 2.0f, 0.0f, 0.0f, i * 2.0f + 1.0f, 1.0f, 1.0f ) );
+      }
+
+      {
+         Polyhedron polyhedron;
+         polyhedron.buildBox( MatrixF( true ), playerBox, true );
+
+         CollisionList collisionList;
+         ExtrudedPolyList polyList;
+         polyList.extrude( polyhedron, VectorF( 0.5f, 0.0f, -0.25f ) );
+         polyList.setVelocity( VectorF( 16.0f, 0.0f, -8.0f ) );
+         polyList.setCollisionList( &collisionList );
+
+         for ( U32 i = 0; i < NumBoxes; i++ )
+            polyList.addBox( Box3F( -1.0f + i * 0.1f, -1.0f, -0.5f, i * 0.1f, 1.0f, 0.1f ) );
+      }
+   }
+
+   void run()
+   {
+      if ( !PolyListArena::get() )
+      {
+         Con::printf( "   PolyListArena is not available, skipping." );
+         return;
+      }
+
+      // The first pass warms up the arena.
+      PolyListArena::resetAllocCount();
+      buildPolyLists();
+      const U32 firstAllocs = PolyListArena::getAllocCount();
+
+      // After that the same queries must not touch the heap.
+      PolyListArena::resetAllocCount();
+      for ( U32 i = 0; i < 4; i++ )
+         buildPolyLists();
+      const U32 steadyAllocs = PolyListArena::getAllocCount();
+
+      Con::printf( "   poly list allocations: first pass %d, steady state %d", firstAllocs, steadyAllocs );
+      test( steadyAllocs == 0, "Poly lists allocated from the heap after warming up the arena!" );
+   }
+};
+
+#endif // TORQUE_SHIPPING
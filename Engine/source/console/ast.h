@@ -27,6 +27,12 @@ class ExprEvalState;
 class Namespace;
 class SimObject;
 class SimGroup;
+struct IntBinaryExprNode;
+
+namespace Compiler
+{
+   struct CompilerLocalVarTable;
+}
 
 /// Enable this #define if you are seeing the message "precompile size mismatch" in the console.
 /// This will help track down which node type is causing the error. It could be
@@ -143,6 +149,7 @@ struct IfStmtNode : StmtNode
    U32 elseOffset;
    bool integer;
    bool propagate;
+   IntBinaryExprNode *fusedCompare; ///< Float comparison compiled into the conditional jump, if any.
 
    static IfStmtNode *alloc( S32 lineNumber, ExprNode *testExpr, StmtNode *ifBlock, StmtNode *elseBlock, bool propagateThrough );
    void propagateSwitchExpr(ExprNode *left, bool string);
@@ -163,6 +170,7 @@ struct LoopStmtNode : StmtNode
    U32 continueOffset;
    U32 loopBlockStartOffset;
    bool integer;
+   IntBinaryExprNode *fusedCompare; ///< Float comparison compiled into the conditional jumps, if any.
 
    static LoopStmtNode *alloc( S32 lineNumber, ExprNode *testExpr, ExprNode *initExpr, ExprNode *endLoopExpr, StmtNode *loopBlock, bool isDoLoop );
    U32 precompileStmt(U32 loopCount);
@@ -204,6 +212,9 @@ struct BinaryExprNode : ExprNode
 
 struct FloatBinaryExprNode : BinaryExprNode
 {
+   bool folded;   ///< Operands are constant; compiled as a single immediate.
+   U32 index;     ///< Immediate table index if folded.
+
    static FloatBinaryExprNode *alloc( S32 lineNumber, S32 op, ExprNode *left, ExprNode *right );
    U32 precompile(TypeReq type);
    U32 compile(U32 *codeStream, U32 ip, TypeReq type);
@@ -217,6 +228,7 @@ struct ConditionalExprNode : ExprNode
    ExprNode *trueExpr;
    ExprNode *falseExpr;
    bool integer;
+   IntBinaryExprNode *fusedCompare; ///< Float comparison compiled into the conditional jump, if any.
    static ConditionalExprNode *alloc( S32 lineNumber, ExprNode *testExpr, ExprNode *trueExpr, ExprNode *falseExpr );
    virtual U32 precompile(TypeReq type);
    virtual U32 compile(U32 *codeStream, U32 ip, TypeReq type);
@@ -285,6 +297,8 @@ struct FloatUnaryExprNode : ExprNode
 {
    S32 op;
    ExprNode *expr;
+   bool folded;   ///< Operand is constant; compiled as a single immediate.
+   U32 index;     ///< Immediate table index if folded.
 
    static FloatUnaryExprNode *alloc( S32 lineNumber, S32 op, ExprNode *expr );
    U32 precompile(TypeReq type);
@@ -387,6 +401,8 @@ struct AssignOpExprNode : ExprNode
    S32 op;
    U32 operand;
    TypeReq subType;
+   bool increment;   ///< Compiled as OP_INCVAR_FLT.
+   U32 incIndex;     ///< Float table index of the increment.
 
    static AssignOpExprNode *alloc( S32 lineNumber, StringTableEntry varName, ExprNode *arrayIndex, ExprNode *expr, S32 op );
    U32 precompile(TypeReq type);
@@ -445,6 +461,8 @@ struct FuncCallExprNode : ExprNode
    U32 precompile(TypeReq type);
    U32 compile(U32 *codeStream, U32 ip, TypeReq type);
    TypeReq getPreferredType();
+   /// The type the given argument is pushed as.
+   static TypeReq getArgType(ExprNode *arg);
    DBG_STMT_TYPE(FuncCallExprNode);
 };
 
@@ -568,6 +586,7 @@ struct FunctionDeclStmtNode : StmtNode
    StringTableEntry package;
    U32 endOffset;
    U32 argc;
+   Compiler::CompilerLocalVarTable *locals; ///< Frame slots of the locals; set by precompileStmt.
 
    static FunctionDeclStmtNode *alloc( S32 lineNumber, StringTableEntry fnName, StringTableEntry nameSpace, VarNode *args, StmtNode *stmts );
    U32 precompileStmt(U32 loopCount);
@@ -168,6 +168,265 @@ static U32 conversionOp(TypeReq src, TypeReq dst)
    return OP_INVALID;
 }
 
+/// Strings left on the string stack need no cleanup, so the only place an
+/// OP_STR_TO_NONE is worth emitting is right after a call where the VM uses it
+/// to tell that the return value is discarded.
+static bool needsConversion(TypeReq src, TypeReq dst)
+{
+   return src != dst && !(src == TypeReqString && dst == TypeReqNone);
+}
+
+//------------------------------------------------------------
+// Constant folding
+//------------------------------------------------------------
+
+/// Evaluate expr at compile time if it is made up only of numeric literals
+/// and float arithmetic.
+static bool getNumericConstant(ExprNode *expr, F64 &value)
+{
+   if(IntNode *intNode = dynamic_cast<IntNode *>(expr))
+   {
+      value = intNode->value;
+      return true;
+   }
+   if(FloatNode *floatNode = dynamic_cast<FloatNode *>(expr))
+   {
+      value = floatNode->value;
+      return true;
+   }
+   if(FloatUnaryExprNode *unary = dynamic_cast<FloatUnaryExprNode *>(expr))
+   {
+      if(!getNumericConstant(unary->expr, value))
+         return false;
+      value = -value;
+      return true;
+   }
+   if(FloatBinaryExprNode *binary = dynamic_cast<FloatBinaryExprNode *>(expr))
+   {
+      F64 left, right;
+      if(!getNumericConstant(binary->left, left) || !getNumericConstant(binary->right, right))
+         return false;
+      switch(binary->op)
+      {
+      case '+':
+         value = left + right;
+         return true;
+      case '-':
+         value = left - right;
+         return true;
+      case '*':
+         value = left * right;
+         return true;
+      case '/':
+         // Leave division by zero to the VM.
+         if(right == 0)
+            return false;
+         value = left / right;
+         return true;
+      }
+   }
+   return false;
+}
+
+// A folded constant is compiled the same way the VM would have left the
+// result of the expression: as a float, converted if need be.
+
+static U32 precompileFoldedConstant(F64 value, TypeReq type, U32 &index)
+{
+   switch(type)
+   {
+   case TypeReqString:
+      index = getCurrentStringTable()->addFloatString(value);
+      return 2;
+   case TypeReqFloat:
+      index = getCurrentFloatTable()->add(value);
+      return 2;
+   case TypeReqUInt:
+      index = getCurrentFloatTable()->add(value);
+      return 3;
+   default:
+      return 0;
+   }
+}
+
+static U32 compileFoldedConstant(U32 *codeStream, U32 ip, TypeReq type, U32 index)
+{
+   switch(type)
+   {
+   case TypeReqString:
+      codeStream[ip++] = OP_LOADIMMED_STR;
+      codeStream[ip++] = index;
+      break;
+   case TypeReqFloat:
+      codeStream[ip++] = OP_LOADIMMED_FLT;
+      codeStream[ip++] = index;
+      break;
+   case TypeReqUInt:
+      codeStream[ip++] = OP_LOADIMMED_FLT;
+      codeStream[ip++] = index;
+      codeStream[ip++] = OP_FLT_TO_UINT;
+      break;
+   case TypeReqNone:
+      break;
+   }
+   return ip;
+}
+
+//------------------------------------------------------------
+// Compare and branch
+//------------------------------------------------------------
+
+/// Returns testExpr if it is a float comparison whose result can be folded
+/// into the conditional jump testing it.
+static IntBinaryExprNode *getFusableCompare(ExprNode *testExpr)
+{
+   IntBinaryExprNode *cmp = dynamic_cast<IntBinaryExprNode *>(testExpr);
+   if(!cmp)
+      return NULL;
+   cmp->getSubTypeOperand();
+   return cmp->subType == TypeReqFloat ? cmp : NULL;
+}
+
+/// Precompile the test of a conditional jump.  Returns the size of the test
+/// without the jump instruction and its target.
+static U32 precompileTest(ExprNode *testExpr, bool &integer, IntBinaryExprNode *&fusedCompare)
+{
+   fusedCompare = NULL;
+   if(testExpr->getPreferredType() == TypeReqUInt)
+   {
+      integer = true;
+      fusedCompare = getFusableCompare(testExpr);
+      if(fusedCompare)
+         return fusedCompare->left->precompile(TypeReqFloat) + fusedCompare->right->precompile(TypeReqFloat);
+      return testExpr->precompile(TypeReqUInt);
+   }
+   integer = false;
+   return testExpr->precompile(TypeReqFloat);
+}
+
+/// Compile the test of a conditional jump followed by the jump instruction.
+/// Returns the ip of the jump target, which the caller fills in.
+static U32 compileTest(U32 *codeStream, U32 ip, ExprNode *testExpr, bool integer, IntBinaryExprNode *fusedCompare, bool jumpIfTrue)
+{
+   if(fusedCompare)
+   {
+      ip = fusedCompare->right->compile(codeStream, ip, TypeReqFloat);
+      ip = fusedCompare->left->compile(codeStream, ip, TypeReqFloat);
+
+      U32 jumpOp = OP_INVALID;
+      switch(fusedCompare->operand)
+      {
+      case OP_CMPEQ:
+         jumpOp = jumpIfTrue ? OP_JMPIF_CMPEQ : OP_JMPIFNOT_CMPEQ;
+         break;
+      case OP_CMPGR:
+         jumpOp = jumpIfTrue ? OP_JMPIF_CMPGR : OP_JMPIFNOT_CMPGR;
+         break;
+      case OP_CMPGE:
+         jumpOp = jumpIfTrue ? OP_JMPIF_CMPGE : OP_JMPIFNOT_CMPGE;
+         break;
+      case OP_CMPLT:
+         jumpOp = jumpIfTrue ? OP_JMPIF_CMPLT : OP_JMPIFNOT_CMPLT;
+         break;
+      case OP_CMPLE:
+         jumpOp = jumpIfTrue ? OP_JMPIF_CMPLE : OP_JMPIFNOT_CMPLE;
+         break;
+      case OP_CMPNE:
+         jumpOp = jumpIfTrue ? OP_JMPIF_CMPNE : OP_JMPIFNOT_CMPNE;
+         break;
+      }
+      codeStream[ip++] = jumpOp;
+   }
+   else if(jumpIfTrue)
+   {
+      ip = testExpr->compile(codeStream, ip, integer ? TypeReqUInt : TypeReqFloat);
+      codeStream[ip++] = integer ? OP_JMPIF : OP_JMPIFF;
+   }
+   else
+   {
+      ip = testExpr->compile(codeStream, ip, integer ? TypeReqUInt : TypeReqFloat);
+      codeStream[ip++] = integer ? OP_JMPIFNOT : OP_JMPIFFNOT;
+   }
+   return ip;
+}
+
+//------------------------------------------------------------
+// Variable access
+//------------------------------------------------------------
+
+/// Size of the code setting the current variable to a variable without an
+/// array index.
+static U32 precompileSetCurVar(StringTableEntry varName)
+{
+   U32 slot;
+   precompileIdent(varName);
+   return getLocalVarSlot(varName, slot) ? 3 : 2;
+}
+
+/// Emit OP_SETCURVAR or OP_SETCURVAR_CREATE, or their frame slot versions
+/// for locals.
+static U32 compileSetCurVar(U32 *codeStream, U32 ip, StringTableEntry varName, bool create)
+{
+   U32 slot;
+   if(getLocalVarSlot(varName, slot))
+   {
+      codeStream[ip++] = create ? OP_SETCURVAR_LOCAL_CREATE : OP_SETCURVAR_LOCAL;
+      codeStream[ip++] = slot;
+   }
+   else
+      codeStream[ip++] = create ? OP_SETCURVAR_CREATE : OP_SETCURVAR;
+   codeStream[ip] = STEtoU32(varName, ip);
+   ip++;
+   return ip;
+}
+
+//------------------------------------------------------------
+// Object field access
+//------------------------------------------------------------
+
+/// Returns objectExpr if it is a plain variable that OP_SETCUROBJECT_VAR can
+/// resolve without going through the string stack.
+static VarNode *getObjectVar(ExprNode *objectExpr)
+{
+   VarNode *var = dynamic_cast<VarNode *>(objectExpr);
+   return var && !var->arrayIndex ? var : NULL;
+}
+
+/// Size of the code setting the current object from objectExpr.
+static U32 precompileSetCurObject(ExprNode *objectExpr)
+{
+   if(VarNode *var = getObjectVar(objectExpr))
+   {
+      U32 slot;
+      precompileIdent(var->varName);
+      return getLocalVarSlot(var->varName, slot) ? 3 : 2;
+   }
+   return objectExpr->precompile(TypeReqString) + 1;
+}
+
+static U32 compileSetCurObject(U32 *codeStream, U32 ip, ExprNode *objectExpr)
+{
+   if(VarNode *var = getObjectVar(objectExpr))
+   {
+      U32 slot;
+      if(getLocalVarSlot(var->varName, slot))
+      {
+         codeStream[ip++] = OP_SETCUROBJECT_LOCAL;
+         codeStream[ip++] = slot;
+      }
+      else
+         codeStream[ip++] = OP_SETCUROBJECT_VAR;
+      codeStream[ip] = STEtoU32(var->varName, ip);
+      ip++;
+   }
+   else
+   {
+      ip = objectExpr->compile(codeStream, ip, TypeReqString);
+      codeStream[ip++] = OP_SETCUROBJECT;
+   }
+   return ip;
+}
+
 //------------------------------------------------------------
 
 U32 BreakStmtNode::precompileStmt(U32 loopCount)
@@ -275,19 +534,10 @@ void IfStmtNode::propagateSwitchExpr(ExprNode *left, bool string)
 
 U32 IfStmtNode::precompileStmt(U32 loopCount)
 {
-   U32 exprSize;
    addBreakCount();
 
-   if(testExpr->getPreferredType() == TypeReqUInt)
-   {
-      exprSize = testExpr->precompile(TypeReqUInt);
-      integer = true;
-   }
-   else
-   {
-      exprSize = testExpr->precompile(TypeReqFloat);
-      integer = false;
-   }
+   U32 exprSize = precompileTest(testExpr, integer, fusedCompare);
+
    // next is the JMPIFNOT or JMPIFFNOT - size of 2
    U32 ifSize = precompileBlock(ifBlock, loopCount);
    if(!elseBlock)
@@ -306,8 +556,7 @@ U32 IfStmtNode::compileStmt(U32 *codeStream, U32 ip, U32 continuePoint, U32 brea
    U32 start = ip;
    addBreakLine(ip);
 
-   ip = testExpr->compile(codeStream, ip, integer ? TypeReqUInt : TypeReqFloat);
-   codeStream[ip++] = integer ? OP_JMPIFNOT : OP_JMPIFFNOT;
+   ip = compileTest(codeStream, ip, testExpr, integer, fusedCompare, false);
 
    if(elseBlock)
    {
@@ -335,18 +584,7 @@ U32 LoopStmtNode::precompileStmt(U32 loopCount)
    if(initExpr)
       initSize = initExpr->precompile(TypeReqNone);
 
-   U32 testSize;
-
-   if(testExpr->getPreferredType() == TypeReqUInt)
-   {
-      integer = true;
-      testSize = testExpr->precompile(TypeReqUInt);
-   }
-   else
-   {
-      integer = false;
-      testSize = testExpr->precompile(TypeReqFloat);
-   }
+   U32 testSize = precompileTest(testExpr, integer, fusedCompare);
 
    U32 blockSize = precompileBlock(loopBlock, loopCount + 1);
 
@@ -400,8 +638,7 @@ U32 LoopStmtNode::compileStmt(U32 *codeStream, U32 ip, U32, U32)
 
    if(!isDoLoop)
    {
-      ip = testExpr->compile(codeStream, ip, integer ? TypeReqUInt : TypeReqFloat);
-      codeStream[ip++] = integer ? OP_JMPIFNOT : OP_JMPIFFNOT;
+      ip = compileTest(codeStream, ip, testExpr, integer, fusedCompare, false);
       codeStream[ip++] = start + breakOffset;
    }
 
@@ -411,9 +648,7 @@ U32 LoopStmtNode::compileStmt(U32 *codeStream, U32 ip, U32, U32)
    if(endLoopExpr)
       ip = endLoopExpr->compile(codeStream, ip, TypeReqNone);
 
-   ip = testExpr->compile(codeStream, ip, integer ? TypeReqUInt : TypeReqFloat);
-
-   codeStream[ip++] = integer ? OP_JMPIF : OP_JMPIFF;
+   ip = compileTest(codeStream, ip, testExpr, integer, fusedCompare, true);
    codeStream[ip++] = start + loopBlockStartOffset;
 
    return ip;
@@ -428,7 +663,7 @@ U32 IterStmtNode::precompileStmt( U32 loopCount )
    // Instruction sequence:
    //
    //   containerExpr
-   //   OP_ITER_BEGIN varName .fail
+   //   OP_ITER_BEGIN varName .fail slot
    // .continue:
    //   OP_ITER .break
    //   body
@@ -442,7 +677,7 @@ U32 IterStmtNode::precompileStmt( U32 loopCount )
    
    return 
         exprSize
-      + 3 // OP_ITER_BEGIN
+      + 4 // OP_ITER_BEGIN
       + 2 // OP_ITER
       + bodySize
       + 2 // OP_JMP
@@ -457,7 +692,7 @@ U32 IterStmtNode::compileStmt( U32* codeStream, U32 ip, U32 continuePoint, U32 b
    const U32 startIp = ip;
    const U32 iterBeginIp = containerExpr->compile( codeStream, startIp, TypeReqString );
       
-   const U32 continueIp = iterBeginIp + 3;
+   const U32 continueIp = iterBeginIp + 4;
    const U32 bodyIp = continueIp + 2;
    const U32 jmpIp = bodyIp + bodySize;
    const U32 breakIp = jmpIp + 2;
@@ -466,6 +701,10 @@ U32 IterStmtNode::compileStmt( U32* codeStream, U32 ip, U32 continuePoint, U32 b
    codeStream[ iterBeginIp ] = isStringIter ? OP_ITER_BEGIN_STR : OP_ITER_BEGIN;
    codeStream[ iterBeginIp + 1 ] = STEtoU32( varName, iterBeginIp + 1 );
    codeStream[ iterBeginIp + 2 ] = finalIp;
+   
+   // Frame slot of the variable if it is a local, -1 otherwise.
+   U32 slot;
+   codeStream[ iterBeginIp + 3 ] = getLocalVarSlot( varName, slot ) ? slot : U32( -1 );
    codeStream[ continueIp ] = OP_ITER;
    codeStream[ continueIp + 1 ] = breakIp;
       
@@ -487,18 +726,8 @@ U32 ConditionalExprNode::precompile(TypeReq type)
    // trueExpr
    // JMP end
    // falseExpr
-   U32 exprSize;
+   U32 exprSize = precompileTest(testExpr, integer, fusedCompare);
 
-   if(testExpr->getPreferredType() == TypeReqUInt)
-   {
-      exprSize = testExpr->precompile(TypeReqUInt);
-      integer = true;
-   }
-   else
-   {
-      exprSize = testExpr->precompile(TypeReqFloat);
-      integer = false;
-   }
    return exprSize + 
       trueExpr->precompile(type) +
       falseExpr->precompile(type) + 4;
@@ -506,8 +735,7 @@ U32 ConditionalExprNode::precompile(TypeReq type)
 
 U32 ConditionalExprNode::compile(U32 *codeStream, U32 ip, TypeReq type)
 {
-   ip = testExpr->compile(codeStream, ip, integer ? TypeReqUInt : TypeReqFloat);
-   codeStream[ip++] = integer ? OP_JMPIFNOT : OP_JMPIFFNOT;
+   ip = compileTest(codeStream, ip, testExpr, integer, fusedCompare, false);
    U32 jumpElseIp = ip++;
    ip = trueExpr->compile(codeStream, ip, type);
    codeStream[ip++] = OP_JMP;
@@ -527,6 +755,11 @@ TypeReq ConditionalExprNode::getPreferredType()
 
 U32 FloatBinaryExprNode::precompile(TypeReq type)
 {
+   F64 value;
+   folded = getNumericConstant(this, value);
+   if(folded)
+      return precompileFoldedConstant(value, type, index);
+
    U32 addSize = left->precompile(TypeReqFloat) + right->precompile(TypeReqFloat) + 1;
    if(type != TypeReqFloat)
       addSize++;
@@ -536,6 +769,9 @@ U32 FloatBinaryExprNode::precompile(TypeReq type)
 
 U32 FloatBinaryExprNode::compile(U32 *codeStream, U32 ip, TypeReq type)
 {
+   if(folded)
+      return compileFoldedConstant(codeStream, ip, type, index);
+
    ip = right->compile(codeStream, ip, TypeReqFloat);
    ip = left->compile(codeStream, ip, TypeReqFloat);
    U32 operand = OP_INVALID;
@@ -805,6 +1041,11 @@ TypeReq IntUnaryExprNode::getPreferredType()
 
 U32 FloatUnaryExprNode::precompile(TypeReq type)
 {
+   F64 value;
+   folded = getNumericConstant(this, value);
+   if(folded)
+      return precompileFoldedConstant(value, type, index);
+
    U32 exprSize = expr->precompile(TypeReqFloat);
    if(type != TypeReqFloat)
       return exprSize + 2;
@@ -814,6 +1055,9 @@ U32 FloatUnaryExprNode::precompile(TypeReq type)
 
 U32 FloatUnaryExprNode::compile(U32 *codeStream, U32 ip, TypeReq type)
 {
+   if(folded)
+      return compileFoldedConstant(codeStream, ip, type, index);
+
    ip = expr->compile(codeStream, ip, TypeReqFloat);
    codeStream[ip++] = OP_NEG;
    if(type != TypeReqFloat)
@@ -840,14 +1084,17 @@ U32 VarNode::precompile(TypeReq type)
    // OP_LOADVAR (type)
 
    // else
-   // OP_SETCURVAR
+   // OP_SETCURVAR (or OP_SETCURVAR_LOCAL slot)
    // varName
    // OP_LOADVAR (type)
    if(type == TypeReqNone)
       return 0;
 
+   if(!arrayIndex)
+      return precompileSetCurVar(varName) + 1;
+
    precompileIdent(varName);
-   return (arrayIndex ? arrayIndex->precompile(TypeReqString) + 6 : 3);
+   return arrayIndex->precompile(TypeReqString) + 6;
 }
 
 U32 VarNode::compile(U32 *codeStream, U32 ip, TypeReq type)
@@ -855,11 +1102,13 @@ U32 VarNode::compile(U32 *codeStream, U32 ip, TypeReq type)
    if(type == TypeReqNone)
       return ip;
 
-   codeStream[ip++] = arrayIndex ? OP_LOADIMMED_IDENT : OP_SETCURVAR;
-   codeStream[ip] = STEtoU32(varName, ip);
-   ip++;
-   if(arrayIndex)
+   if(!arrayIndex)
+      ip = compileSetCurVar(codeStream, ip, varName, false);
+   else
    {
+      codeStream[ip++] = OP_LOADIMMED_IDENT;
+      codeStream[ip] = STEtoU32(varName, ip);
+      ip++;
       codeStream[ip++] = OP_ADVANCE_STR;
       ip = arrayIndex->compile(codeStream, ip, TypeReqString);
       codeStream[ip++] = OP_REWIND_STR;
@@ -1099,10 +1348,10 @@ U32 AssignExprNode::precompile(TypeReq type)
 
    //else
    // eval expr
-   // OP_SETCURVAR_CREATE
+   // OP_SETCURVAR_CREATE (or OP_SETCURVAR_LOCAL_CREATE slot)
    // varname
    // OP_SAVEVAR
-   const U32 addSize = (type != subType ? 1 : 0);
+   const U32 addSize = (needsConversion(subType, type) ? 1 : 0);
    const U32 retSize = expr->precompile(subType);
 
 #ifdef DEBUG_AST_NODES
@@ -1110,9 +1359,11 @@ U32 AssignExprNode::precompile(TypeReq type)
       Con::printf("Bad expr %s", expr->dbgStmtType().c_str());
 #endif
 
-   precompileIdent(varName);
+   if(!arrayIndex)
+      return retSize + addSize + precompileSetCurVar(varName) + 1;
 
-   return retSize + addSize + (arrayIndex ? arrayIndex->precompile(TypeReqString) + (subType == TypeReqString ? 8 : 6 ) : 3);
+   precompileIdent(varName);
+   return retSize + addSize + arrayIndex->precompile(TypeReqString) + (subType == TypeReqString ? 8 : 6 );
 }
 
 U32 AssignExprNode::compile(U32 *codeStream, U32 ip, TypeReq type)
@@ -1134,11 +1385,7 @@ U32 AssignExprNode::compile(U32 *codeStream, U32 ip, TypeReq type)
          codeStream[ip++] = OP_TERMINATE_REWIND_STR;
    }
    else
-   {
-      codeStream[ip++] = OP_SETCURVAR_CREATE;
-      codeStream[ip] = STEtoU32(varName, ip);
-      ip++;
-   }
+      ip = compileSetCurVar(codeStream, ip, varName, true);
    switch(subType)
    {
    case TypeReqString:
@@ -1153,7 +1400,7 @@ U32 AssignExprNode::compile(U32 *codeStream, U32 ip, TypeReq type)
    case TypeReqNone:
       break;
    }
-   if(type != subType)
+   if(needsConversion(subType, type))
       codeStream[ip++] = conversionOp(subType, type);
    return ip;
 }
@@ -1226,7 +1473,7 @@ U32 AssignOpExprNode::precompile(TypeReq type)
    // OP_SETCURVAR_ARRAY_CREATE
 
    // else
-   // OP_SETCURVAR_CREATE
+   // OP_SETCURVAR_CREATE (or OP_SETCURVAR_LOCAL_CREATE slot)
    // varName
 
    // OP_LOADVAR_FLT or UINT
@@ -1234,13 +1481,24 @@ U32 AssignOpExprNode::precompile(TypeReq type)
    // OP_SAVEVAR_FLT or UINT
 
    // conversion OP if necessary.
+
+   // A statement adding or subtracting a constant from a plain variable
+   // compiles to a single OP_INCVAR_FLT or OP_INCVAR_LOCAL.
    getAssignOpTypeOp(op, subType, operand);
    precompileIdent(varName);
+   F64 value;
+   increment = type == TypeReqNone && !arrayIndex && (op == '+' || op == '-') &&
+      (dynamic_cast<IntNode *>(expr) || dynamic_cast<FloatNode *>(expr)) && getNumericConstant(expr, value);
+   if(increment)
+   {
+      incIndex = getCurrentFloatTable()->add(op == '-' ? -value : value);
+      return precompileSetCurVar(varName) + 1;
+   }
    U32 size = expr->precompile(subType);
    if(type != subType)
       size++;
    if(!arrayIndex)
-      return size + 5;
+      return size + precompileSetCurVar(varName) + 3;
    else
    {
       size += arrayIndex->precompile(TypeReqString);
@@ -1250,13 +1508,25 @@ U32 AssignOpExprNode::precompile(TypeReq type)
 
 U32 AssignOpExprNode::compile(U32 *codeStream, U32 ip, TypeReq type)
 {
-   ip = expr->compile(codeStream, ip, subType);
-   if(!arrayIndex)
+   if(increment)
    {
-      codeStream[ip++] = OP_SETCURVAR_CREATE;
+      U32 slot;
+      if(getLocalVarSlot(varName, slot))
+      {
+         codeStream[ip++] = OP_INCVAR_LOCAL;
+         codeStream[ip++] = slot;
+      }
+      else
+         codeStream[ip++] = OP_INCVAR_FLT;
       codeStream[ip] = STEtoU32(varName, ip);
       ip++;
+      codeStream[ip++] = incIndex;
+      return ip;
    }
+
+   ip = expr->compile(codeStream, ip, subType);
+   if(!arrayIndex)
+      ip = compileSetCurVar(codeStream, ip, varName, true);
    else
    {
       codeStream[ip++] = OP_LOADIMMED_IDENT;
@@ -1340,6 +1610,7 @@ U32 FuncCallExprNode::precompile(TypeReq type)
    // function
    // namespace
    // isDot
+   // call site cache index
 
    U32 size = 0;
    if(type != TypeReqString)
@@ -1347,8 +1618,18 @@ U32 FuncCallExprNode::precompile(TypeReq type)
    precompileIdent(funcName);
    precompileIdent(nameSpace);
    for(ExprNode *walk = args; walk; walk = (ExprNode *) walk->getNext())
-      size += walk->precompile(TypeReqString) + 1;
-   return size + 5;
+      size += walk->precompile(getArgType(walk)) + 1;
+   return size + 6;
+}
+
+TypeReq FuncCallExprNode::getArgType(ExprNode *arg)
+{
+   // Numeric arguments are pushed straight off the int and float stacks so
+   // engine functions don't have to parse them back out of a string.
+   TypeReq argType = arg->getPreferredType();
+   if(argType == TypeReqUInt || argType == TypeReqFloat)
+      return argType;
+   return TypeReqString;
 }
 
 U32 FuncCallExprNode::compile(U32 *codeStream, U32 ip, TypeReq type)
@@ -1356,8 +1637,20 @@ U32 FuncCallExprNode::compile(U32 *codeStream, U32 ip, TypeReq type)
    codeStream[ip++] = OP_PUSH_FRAME;
    for(ExprNode *walk = args; walk; walk = (ExprNode *) walk->getNext())
    {
-      ip = walk->compile(codeStream, ip, TypeReqString);
-      codeStream[ip++] = OP_PUSH;
+      TypeReq argType = getArgType(walk);
+      ip = walk->compile(codeStream, ip, argType);
+      switch(argType)
+      {
+         case TypeReqUInt:
+            codeStream[ip++] = OP_PUSH_UINT;
+            break;
+         case TypeReqFloat:
+            codeStream[ip++] = OP_PUSH_FLT;
+            break;
+         default:
+            codeStream[ip++] = OP_PUSH;
+            break;
+      }
    }
    if(callType == MethodCall || callType == ParentCall)
       codeStream[ip++] = OP_CALLFUNC;
@@ -1369,6 +1662,8 @@ U32 FuncCallExprNode::compile(U32 *codeStream, U32 ip, TypeReq type)
    codeStream[ip] = STEtoU32(nameSpace, ip);
    ip++;
    codeStream[ip++] = callType;
+   // The VM assigns a cache the first time the call is made.
+   codeStream[ip++] = 0;
    if(type != TypeReqString)
       codeStream[ip++] = conversionOp(TypeReqString, type);
    return ip;
@@ -1434,8 +1729,10 @@ U32 SlotAccessNode::precompile(TypeReq type)
       // total add of 4 + array precomp
       size += 3 + arrayExpr->precompile(TypeReqString);
    }
-   // eval object expression sub + 3 (op_setCurField + OP_SETCUROBJECT)
-   size += objectExpr->precompile(TypeReqString) + 3;
+   // eval object expression sub + OP_SETCUROBJECT, or OP_SETCUROBJECT_VAR
+   size += precompileSetCurObject(objectExpr);
+   // OP_SETCURFIELD + slotName
+   size += 2;
 
    // get field in desired type:
    return size + 1;
@@ -1451,8 +1748,7 @@ U32 SlotAccessNode::compile(U32 *codeStream, U32 ip, TypeReq type)
       ip = arrayExpr->compile(codeStream, ip, TypeReqString);
       codeStream[ip++] = OP_ADVANCE_STR;
    }
-   ip = objectExpr->compile(codeStream, ip, TypeReqString);
-   codeStream[ip++] = OP_SETCUROBJECT;
+   ip = compileSetCurObject(codeStream, ip, objectExpr);
    
    codeStream[ip++] = OP_SETCURFIELD;
    
@@ -1563,7 +1859,7 @@ U32 SlotAssignNode::precompile(TypeReq type)
    // convert to return type if necessary.
 
    U32 size = 0;
-   if(type != TypeReqString)
+   if(needsConversion(TypeReqString, type))
       size++;
 
    precompileIdent(slotName);
@@ -1571,7 +1867,7 @@ U32 SlotAssignNode::precompile(TypeReq type)
    size += valueExpr->precompile(TypeReqString);
 
    if(objectExpr)
-      size += objectExpr->precompile(TypeReqString) + 5;
+      size += precompileSetCurObject(objectExpr) + 4;
    else
       size += 5;
 
@@ -1594,10 +1890,7 @@ U32 SlotAssignNode::compile(U32 *codeStream, U32 ip, TypeReq type)
       codeStream[ip++] = OP_ADVANCE_STR;
    }
    if(objectExpr)
-   {
-      ip = objectExpr->compile(codeStream, ip, TypeReqString);
-      codeStream[ip++] = OP_SETCUROBJECT;
-   }
+      ip = compileSetCurObject(codeStream, ip, objectExpr);
    else
       codeStream[ip++] = OP_SETCUROBJECT_NEW;
    codeStream[ip++] = OP_SETCURFIELD;
@@ -1618,7 +1911,7 @@ U32 SlotAssignNode::compile(U32 *codeStream, U32 ip, TypeReq type)
       codeStream[ip++] = typeID;
    }
 
-   if(type != TypeReqString)
+   if(needsConversion(TypeReqString, type))
       codeStream[ip++] = conversionOp(TypeReqString, type);
    return ip;
 }
@@ -1661,9 +1954,9 @@ U32 SlotAssignOpNode::precompile(TypeReq type)
    if(type != subType)
       size++;
    if(arrayExpr)
-      return size + 9 + arrayExpr->precompile(TypeReqString) + objectExpr->precompile(TypeReqString);
+      return size + 8 + arrayExpr->precompile(TypeReqString) + precompileSetCurObject(objectExpr);
    else
-      return size + 6 + objectExpr->precompile(TypeReqString);
+      return size + 5 + precompileSetCurObject(objectExpr);
 }
 
 U32 SlotAssignOpNode::compile(U32 *codeStream, U32 ip, TypeReq type)
@@ -1674,8 +1967,7 @@ U32 SlotAssignOpNode::compile(U32 *codeStream, U32 ip, TypeReq type)
       ip = arrayExpr->compile(codeStream, ip, TypeReqString);
       codeStream[ip++] = OP_ADVANCE_STR;
    }
-   ip = objectExpr->compile(codeStream, ip, TypeReqString);
-   codeStream[ip++] = OP_SETCUROBJECT;
+   ip = compileSetCurObject(codeStream, ip, objectExpr);
    codeStream[ip++] = OP_SETCURFIELD;
    codeStream[ip] = STEtoU32(slotName, ip);
    ip++;
@@ -1824,16 +2116,26 @@ U32 FunctionDeclStmtNode::precompileStmt(U32)
    // func end ip
    // argc
    // ident array[argc]
+   // local count
    // code
    // OP_RETURN_VOID
    setCurrentStringTable(&getFunctionStringTable());
    setCurrentFloatTable(&getFunctionFloatTable());
 
+   // The arguments take the first frame slots; the other locals get theirs
+   // as the body is precompiled.
+   locals = (CompilerLocalVarTable *) consoleAlloc(sizeof(CompilerLocalVarTable));
+   locals->reset();
+
    argc = 0;
    for(VarNode *walk = args; walk; walk = (VarNode *)((StmtNode*)walk)->getNext())
+   {
+      locals->addArg(walk->varName);
       argc++;
+   }
    
    CodeBlock::smInFunction = true;
+   setCurrentLocalVarTable(locals);
    
    precompileIdent(fnName);
    precompileIdent(nameSpace);
@@ -1841,13 +2143,14 @@ U32 FunctionDeclStmtNode::precompileStmt(U32)
    
    U32 subSize = precompileBlock(stmts, 0);
    CodeBlock::smInFunction = false;
+   setCurrentLocalVarTable(NULL);
 
    addBreakCount();
 
    setCurrentStringTable(&getGlobalStringTable());
    setCurrentFloatTable(&getGlobalFloatTable());
 
-   endOffset = argc + subSize + 8;
+   endOffset = argc + subSize + 9;
    return endOffset;
 }
 
@@ -1869,7 +2172,9 @@ U32 FunctionDeclStmtNode::compileStmt(U32 *codeStream, U32 ip, U32, U32)
       codeStream[ip] = STEtoU32(walk->varName, ip);
       ip++;
    }
+   codeStream[ip++] = locals->count;
    CodeBlock::smInFunction = true;
+   setCurrentLocalVarTable(locals);
    ip = compileBlock(stmts, codeStream, ip, 0, 0); 
 
    // Add break so breakpoint can be set at closing brace or
@@ -1877,6 +2182,7 @@ U32 FunctionDeclStmtNode::compileStmt(U32 *codeStream, U32 ip, U32, U32)
    addBreakLine( ip );
 
    CodeBlock::smInFunction = false;
+   setCurrentLocalVarTable(NULL);
    codeStream[ip++] = OP_RETURN_VOID;
    return ip;
 }
@@ -29,6 +29,7 @@
 #include "core/strings/stringFunctions.h"
 #include "core/stringTable.h"
 #include "core/stream/fileStream.h"
+#include "core/util/hashFunction.h"
 
 using namespace Compiler;
 
@@ -37,6 +38,9 @@ U32            CodeBlock::smBreakLineCount = 0;
 CodeBlock *    CodeBlock::smCodeBlockList = NULL;
 CodeBlock *    CodeBlock::smCurrentCodeBlock = NULL;
 ConsoleParser *CodeBlock::smCurrentParser = NULL;
+S32            CodeBlock::smCallSiteCacheHits = 0;
+S32            CodeBlock::smCallSiteCacheMisses = 0;
+S32            CodeBlock::smCallSiteCachePolymorphicMisses = 0;
 
 //-------------------------------------------------------------------------
 
@@ -454,6 +458,11 @@ bool CodeBlock::read(StringTableEntry fileName, Stream &st)
 }
 
 
+U32 CodeBlock::getSourceHash(const char *script)
+{
+   return Torque::hash((const U8 *) script, dStrlen(script), 0);
+}
+
 bool CodeBlock::compile(const char *codeFileName, StringTableEntry fileName, const char *inScript, bool overrideNoDso)
 {
    // This will return true, but return value is ignored
@@ -492,6 +501,7 @@ bool CodeBlock::compile(const char *codeFileName, StringTableEntry fileName, con
    if(!st.open(codeFileName, Torque::FS::File::Write)) 
       return false;
    st.write(U32(Con::DSOVersion));
+   st.write(getSourceHash(inScript));
 
    // Reset all our value tables...
    resetTables();
@@ -708,13 +718,14 @@ void CodeBlock::dumpInstructions( U32 startIp, bool upToReturn )
             bool hasBody = bool(code[ip+3]);
             U32 newIp = code[ ip + 4 ];
             U32 argc = code[ ip + 5 ];
+            U32 localCount = code[ ip + 6 + argc ];
             
-            Con::printf( "%i: OP_FUNC_DECL name=%s nspace=%s package=%s hasbody=%i newip=%i argc=%i",
-               ip - 1, fnName, fnNamespace, fnPackage, hasBody, newIp, argc );
+            Con::printf( "%i: OP_FUNC_DECL name=%s nspace=%s package=%s hasbody=%i newip=%i argc=%i locals=%i",
+               ip - 1, fnName, fnNamespace, fnPackage, hasBody, newIp, argc, localCount );
                
             // Skip args.
                            
-            ip += 6 + argc;
+            ip += 7 + argc;
             break;
          }
             
@@ -1205,11 +1216,11 @@ void CodeBlock::dumpInstructions( U32 startIp, bool upToReturn )
             StringTableEntry fnName      = U32toSTE(code[ip]);
             U32 callType = code[ip+2];
 
-            Con::printf( "%i: OP_CALLFUNC_RESOLVE name=%s nspace=%s callType=%s", ip - 1, fnName, fnNamespace,
+            Con::printf( "%i: OP_CALLFUNC_RESOLVE name=%s nspace=%s callType=%s cache=%i", ip - 1, fnName, fnNamespace,
                callType == FuncCallExprNode::FunctionCall ? "FunctionCall"
-                  : callType == FuncCallExprNode::MethodCall ? "MethodCall" : "ParentCall" );
+                  : callType == FuncCallExprNode::MethodCall ? "MethodCall" : "ParentCall", code[ip+3] );
             
-            ip += 3;
+            ip += 4;
             break;
          }
          
@@ -1219,11 +1230,11 @@ void CodeBlock::dumpInstructions( U32 startIp, bool upToReturn )
             StringTableEntry fnName      = U32toSTE(code[ip]);
             U32 callType = code[ip+2];
 
-            Con::printf( "%i: OP_CALLFUNC name=%s nspace=%s callType=%s", ip - 1, fnName, fnNamespace,
+            Con::printf( "%i: OP_CALLFUNC name=%s nspace=%s callType=%s cache=%i", ip - 1, fnName, fnNamespace,
                callType == FuncCallExprNode::FunctionCall ? "FunctionCall"
-                  : callType == FuncCallExprNode::MethodCall ? "MethodCall" : "ParentCall" );
+                  : callType == FuncCallExprNode::MethodCall ? "MethodCall" : "ParentCall", code[ip+3] );
             
-            ip += 3;
+            ip += 4;
             break;
          }
 
@@ -1277,6 +1288,18 @@ void CodeBlock::dumpInstructions( U32 startIp, bool upToReturn )
             break;
          }
 
+         case OP_PUSH_UINT:
+         {
+            Con::printf( "%i: OP_PUSH_UINT", ip - 1 );
+            break;
+         }
+
+         case OP_PUSH_FLT:
+         {
+            Con::printf( "%i: OP_PUSH_FLT", ip - 1 );
+            break;
+         }
+
          case OP_PUSH_FRAME:
          {
             Con::printf( "%i: OP_PUSH_FRAME", ip - 1 );
@@ -1301,20 +1324,24 @@ void CodeBlock::dumpInstructions( U32 startIp, bool upToReturn )
          {
             StringTableEntry varName = U32toSTE( code[ ip ] );
             U32 failIp = code[ ip + 1 ];
+            S32 slot = code[ ip + 2 ];
             
-            Con::printf( "%i: OP_ITER_BEGIN varName=%s failIp=%i", varName, failIp );
+            Con::printf( "%i: OP_ITER_BEGIN varName=%s failIp=%i slot=%i", ip - 1, varName, failIp, slot );
 
-            ++ ip;
+            ip += 3;
+            break;
          }
 
          case OP_ITER_BEGIN_STR:
          {
             StringTableEntry varName = U32toSTE( code[ ip ] );
             U32 failIp = code[ ip + 1 ];
+            S32 slot = code[ ip + 2 ];
             
-            Con::printf( "%i: OP_ITER_BEGIN varName=%s failIp=%i", varName, failIp );
+            Con::printf( "%i: OP_ITER_BEGIN_STR varName=%s failIp=%i slot=%i", ip - 1, varName, failIp, slot );
 
-            ip += 2;
+            ip += 3;
+            break;
          }
          
          case OP_ITER:
@@ -1332,6 +1359,146 @@ void CodeBlock::dumpInstructions( U32 startIp, bool upToReturn )
             break;
          }
 
+         case OP_JMPIFNOT_CMPEQ:
+         {
+            Con::printf( "%i: OP_JMPIFNOT_CMPEQ ip=%i", ip - 1, code[ ip ] );
+            ++ ip;
+            break;
+         }
+
+         case OP_JMPIFNOT_CMPGR:
+         {
+            Con::printf( "%i: OP_JMPIFNOT_CMPGR ip=%i", ip - 1, code[ ip ] );
+            ++ ip;
+            break;
+         }
+
+         case OP_JMPIFNOT_CMPGE:
+         {
+            Con::printf( "%i: OP_JMPIFNOT_CMPGE ip=%i", ip - 1, code[ ip ] );
+            ++ ip;
+            break;
+         }
+
+         case OP_JMPIFNOT_CMPLT:
+         {
+            Con::printf( "%i: OP_JMPIFNOT_CMPLT ip=%i", ip - 1, code[ ip ] );
+            ++ ip;
+            break;
+         }
+
+         case OP_JMPIFNOT_CMPLE:
+         {
+            Con::printf( "%i: OP_JMPIFNOT_CMPLE ip=%i", ip - 1, code[ ip ] );
+            ++ ip;
+            break;
+         }
+
+         case OP_JMPIFNOT_CMPNE:
+         {
+            Con::printf( "%i: OP_JMPIFNOT_CMPNE ip=%i", ip - 1, code[ ip ] );
+            ++ ip;
+            break;
+         }
+
+         case OP_JMPIF_CMPEQ:
+         {
+            Con::printf( "%i: OP_JMPIF_CMPEQ ip=%i", ip - 1, code[ ip ] );
+            ++ ip;
+            break;
+         }
+
+         case OP_JMPIF_CMPGR:
+         {
+            Con::printf( "%i: OP_JMPIF_CMPGR ip=%i", ip - 1, code[ ip ] );
+            ++ ip;
+            break;
+         }
+
+         case OP_JMPIF_CMPGE:
+         {
+            Con::printf( "%i: OP_JMPIF_CMPGE ip=%i", ip - 1, code[ ip ] );
+            ++ ip;
+            break;
+         }
+
+         case OP_JMPIF_CMPLT:
+         {
+            Con::printf( "%i: OP_JMPIF_CMPLT ip=%i", ip - 1, code[ ip ] );
+            ++ ip;
+            break;
+         }
+
+         case OP_JMPIF_CMPLE:
+         {
+            Con::printf( "%i: OP_JMPIF_CMPLE ip=%i", ip - 1, code[ ip ] );
+            ++ ip;
+            break;
+         }
+
+         case OP_JMPIF_CMPNE:
+         {
+            Con::printf( "%i: OP_JMPIF_CMPNE ip=%i", ip - 1, code[ ip ] );
+            ++ ip;
+            break;
+         }
+
+         case OP_INCVAR_FLT:
+         {
+            StringTableEntry var = U32toSTE(code[ip]);
+            F64 val = functionFloats[code[ip+1]];
+
+            Con::printf( "%i: OP_INCVAR_FLT var=%s val=%f", ip - 1, var, val );
+            ip += 2;
+            break;
+         }
+
+         case OP_SETCUROBJECT_VAR:
+         {
+            StringTableEntry var = U32toSTE(code[ip]);
+
+            Con::printf( "%i: OP_SETCUROBJECT_VAR var=%s", ip - 1, var );
+            ip++;
+            break;
+         }
+
+         case OP_SETCURVAR_LOCAL:
+         {
+            StringTableEntry var = U32toSTE(code[ip+1]);
+
+            Con::printf( "%i: OP_SETCURVAR_LOCAL slot=%i var=%s", ip - 1, code[ip], var );
+            ip += 2;
+            break;
+         }
+
+         case OP_SETCURVAR_LOCAL_CREATE:
+         {
+            StringTableEntry var = U32toSTE(code[ip+1]);
+
+            Con::printf( "%i: OP_SETCURVAR_LOCAL_CREATE slot=%i var=%s", ip - 1, code[ip], var );
+            ip += 2;
+            break;
+         }
+
+         case OP_INCVAR_LOCAL:
+         {
+            StringTableEntry var = U32toSTE(code[ip+1]);
+            F64 val = functionFloats[code[ip+2]];
+
+            Con::printf( "%i: OP_INCVAR_LOCAL slot=%i var=%s val=%f", ip - 1, code[ip], var, val );
+            ip += 3;
+            break;
+         }
+
+         case OP_SETCUROBJECT_LOCAL:
+         {
+            StringTableEntry var = U32toSTE(code[ip+1]);
+
+            Con::printf( "%i: OP_SETCUROBJECT_LOCAL slot=%i var=%s", ip - 1, code[ip], var );
+            ip += 2;
+            break;
+         }
+
          default:
             Con::printf( "%i: !!INVALID!!", ip - 1 );
             break;
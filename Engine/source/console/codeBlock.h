@@ -25,6 +25,7 @@
 
 #include "console/compiler.h"
 #include "console/consoleParser.h"
+#include "console/consoleInternal.h"
 
 class Stream;
 
@@ -42,6 +43,19 @@ public:
    static bool                      smInFunction;
    static Compiler::ConsoleParser * smCurrentParser;
 
+   /// @name Call Site Cache Statistics
+   /// Exposed to script as $Con::callSiteCache*.
+   /// @{
+
+   static S32 smCallSiteCacheHits;
+   static S32 smCallSiteCacheMisses;
+
+   /// Misses at call sites that were valid for another namespace.  A high
+   /// count relative to smCallSiteCacheMisses means polymorphic call sites.
+   static S32 smCallSiteCachePolymorphicMisses;
+
+   /// @}
+
    static CodeBlock* getCurrentBlock()
    {
       return smCurrentCodeBlock;
@@ -83,6 +97,27 @@ public:
    U32 *breakList;
    CodeBlock *nextFile;
 
+   /// Inline cache of the function lookup made at an OP_CALLFUNC call site.
+   struct CallSiteCache
+   {
+      Namespace *ns;             ///< Namespace the lookup was made in.
+      Namespace::Entry *entry;   ///< Result of the lookup; may be NULL.
+      U32 sequence;              ///< Namespace::mCacheSequence of the lookup.
+   };
+
+   /// Caches of the call sites that have been executed.  Each call site
+   /// stores its one based index in the instruction stream, or zero until
+   /// it first runs.
+   Vector< CallSiteCache > callSiteCaches;
+
+   /// Look up fnName in ns through the cache of the call site whose cache
+   /// index is at code[cacheIp].
+   Namespace::Entry *lookupCallSite( U32 cacheIp, Namespace *ns, StringTableEntry fnName );
+
+   /// Return the namespace a call site last resolved to if it is still
+   /// valid, NULL otherwise.
+   Namespace *getCallSiteNamespace( U32 cacheIp );
+
    void addToCodeList();
    void removeFromCodeList();
    void calcBreakList();
@@ -107,6 +142,11 @@ public:
    /// 
    String getFunctionArgs( U32 offset );
 
+   /// Return the hash of the given script source.  DSOs store the hash of
+   /// the source they were compiled from after the DSO version, and are only
+   /// used while the source still hashes the same.
+   static U32 getSourceHash(const char *script);
+
    bool read(StringTableEntry fileName, Stream &st);
    bool compile(const char *dsoName, StringTableEntry fileName, const char *script, bool overrideNoDso = false);
 
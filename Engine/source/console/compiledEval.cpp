@@ -37,6 +37,7 @@
 #include "sim/netStringTable.h"
 #include "console/ICallMethod.h"
 #include "console/stringStack.h"
+#include "console/scriptProfiler.h"
 #include "util/messaging/message.h"
 #include "core/frameAllocator.h"
 
@@ -217,6 +218,19 @@ namespace Con
       dMemcpy( ret, arg.c_str(), size );
       return ret;
    }
+
+   bool getNumericArg( const char* arg, F64& value )
+   {
+      if( !STR.isTypedArg( arg ) )
+         return false;
+      value = STR.getTypedArg( arg ).mValue;
+      return true;
+   }
+
+   const char* getArgString( const char* arg )
+   {
+      return STR.formatTypedArg( arg );
+   }
 }
 
 //------------------------------------------------------------
@@ -244,6 +258,18 @@ inline void ExprEvalState::setCurVarNameCreate(StringTableEntry name)
    }
 }
 
+inline void ExprEvalState::setCurVarLocal(U32 slot, StringTableEntry name)
+{
+   currentVariable = getCurrentFrame().lookupLocal(slot, name);
+   if(!currentVariable && gWarnUndefinedScriptVariables)
+	   Con::warnf(ConsoleLogEntry::Script, "Variable referenced before assignment: %s", name);
+}
+
+inline void ExprEvalState::setCurVarLocalCreate(U32 slot, StringTableEntry name)
+{
+   currentVariable = getCurrentFrame().addLocal(slot, name);
+}
+
 //------------------------------------------------------------
 
 inline S32 ExprEvalState::getIntVariable()
@@ -401,6 +427,89 @@ static void setFieldComponent( SimObject* object, StringTableEntry field, const
    }
 }
 
+/// Look up the object a field access is made on.
+static SimObject* findFieldObject( const char* val )
+{
+   // Sim::findObject will sometimes find valid objects from
+   // multi-component strings. This makes sure that doesn't
+   // happen.
+   for( const char* check = val; *check; check++ )
+   {
+      if( *check == ' ' )
+         return NULL;
+   }
+   return Sim::findObject( val );
+}
+
+Namespace::Entry* CodeBlock::lookupCallSite( U32 cacheIp, Namespace* ns, StringTableEntry fnName )
+{
+   U32 index = code[ cacheIp ];
+   if( !index )
+   {
+      // First call through this site.
+      CallSiteCache cache;
+      cache.ns = NULL;
+      cache.entry = NULL;
+      cache.sequence = 0;
+      callSiteCaches.push_back( cache );
+
+      index = callSiteCaches.size();
+      code[ cacheIp ] = index;
+   }
+
+   CallSiteCache& cache = callSiteCaches[ index - 1 ];
+   if( cache.sequence == Namespace::mCacheSequence && cache.ns )
+   {
+      if( cache.ns == ns )
+      {
+         smCallSiteCacheHits ++;
+         return cache.entry;
+      }
+      smCallSiteCachePolymorphicMisses ++;
+   }
+   smCallSiteCacheMisses ++;
+
+   cache.ns = ns;
+   cache.entry = ns->lookup( fnName );
+   cache.sequence = Namespace::mCacheSequence;
+   return cache.entry;
+}
+
+Namespace* CodeBlock::getCallSiteNamespace( U32 cacheIp )
+{
+   U32 index = code[ cacheIp ];
+   if( !index )
+      return NULL;
+
+   const CallSiteCache& cache = callSiteCaches[ index - 1 ];
+   return cache.sequence == Namespace::mCacheSequence ? cache.ns : NULL;
+}
+
+// Opcode dispatch.  Each opcode body is introduced with VM_OP and finished
+// with VM_NEXT.  With the switch dispatch, VM_NEXT simply leaves the switch and
+// the loop fetches the next instruction.  With the threaded dispatch, every
+// opcode fetches its successor and jumps straight to its label, which gives
+// the branch predictor one indirect jump per opcode to learn from instead of
+// funneling everything through the single jump at the top of the switch.
+#ifdef TORQUE_SCRIPT_THREADED_DISPATCH
+   #define VM_OP( op ) case op: op##_Label:
+   #define VM_NEXT \
+      do { \
+         instruction = code[ ip ++ ]; \
+         nsEntry = NULL; \
+         goto *dispatchTable[ instruction < OP_INVALID ? instruction : U32( OP_INVALID ) ]; \
+      } while( 0 )
+#else
+   #define VM_OP( op ) case op:
+   #define VM_NEXT break
+#endif
+
+// Let the script profiler take a pending sample.  Polled on function entry,
+// at taken loop back edges and after engine function calls.
+#define SCRIPT_PROFILER_POLL() \
+   if( ScriptProfiler::smSamplePending ) \
+      ScriptProfiler::takeSample( this, ip )
+
 const char *CodeBlock::exec(U32 ip, const char *functionName, Namespace *thisNamespace, U32 argc, const char **argv, bool noCalls, StringTableEntry packageName, S32 setFrame)
 {
 #ifdef TORQUE_DEBUG
@@ -413,6 +522,7 @@ const char *CodeBlock::exec(U32 ip, const char *functionName, Namespace *thisNam
    U32 iterDepth = 0;
 
    incRefCount();
+   ScriptProfiler::smExecDepth ++;
    F64 *curFloatTable;
    char *curStringTable;
    S32 curStringTableLen = 0; //clint to ensure we dont overwrite it
@@ -455,17 +565,26 @@ const char *CodeBlock::exec(U32 ip, const char *functionName, Namespace *thisNam
          Con::printf("%s", traceBuffer);
       }
       gEvalState.pushFrame(thisFunctionName, thisNamespace);
+      gEvalState.getCurrentFrame().setLocalCount(code[ip + fnArgc + 6]);
       popFrame = true;
+
+      // Argument i is in local slot i.
       for(i = 0; i < argc; i++)
       {
          StringTableEntry var = U32toSTE(code[ip + i + 6]);
-         gEvalState.setCurVarNameCreate(var);
+         gEvalState.setCurVarLocalCreate(i, var);
          gEvalState.setStringVariable(argv[i+1]);
       }
-      ip = ip + fnArgc + 6;
+      ip = ip + fnArgc + 7;
       curFloatTable = functionFloats;
       curStringTable = functionStrings;
       curStringTableLen = functionStringsMaxLen;
+
+      if(ScriptProfiler::smEnabled)
+      {
+         ScriptProfiler::countCall(thisNamespace, thisFunctionName);
+         SCRIPT_PROFILER_POLL();
+      }
    }
    else
    {
@@ -549,6 +668,125 @@ const char *CodeBlock::exec(U32 ip, const char *functionName, Namespace *thisNam
    static S32 VAL_BUFFER_SIZE = 1024;
    FrameTemp<char> valBuffer( VAL_BUFFER_SIZE );
 
+#ifdef TORQUE_SCRIPT_THREADED_DISPATCH
+   // Label addresses for the computed-goto dispatch; must match the order of
+   // Compiler::CompiledInstructions.
+   static void* const dispatchTable[] =
+   {
+      &&OP_FUNC_DECL_Label,
+      &&OP_CREATE_OBJECT_Label,
+      &&OP_ADD_OBJECT_Label,
+      &&OP_END_OBJECT_Label,
+      &&OP_FINISH_OBJECT_Label,
+      &&OP_JMPIFFNOT_Label,
+      &&OP_JMPIFNOT_Label,
+      &&OP_JMPIFF_Label,
+      &&OP_JMPIF_Label,
+      &&OP_JMPIFNOT_NP_Label,
+      &&OP_JMPIF_NP_Label,
+      &&OP_JMP_Label,
+      &&OP_RETURN_Label,
+      &&OP_RETURN_VOID_Label,
+      &&OP_CMPEQ_Label,
+      &&OP_CMPGR_Label,
+      &&OP_CMPGE_Label,
+      &&OP_CMPLT_Label,
+      &&OP_CMPLE_Label,
+      &&OP_CMPNE_Label,
+      &&OP_XOR_Label,
+      &&OP_MOD_Label,
+      &&OP_BITAND_Label,
+      &&OP_BITOR_Label,
+      &&OP_NOT_Label,
+      &&OP_NOTF_Label,
+      &&OP_ONESCOMPLEMENT_Label,
+      &&OP_SHR_Label,
+      &&OP_SHL_Label,
+      &&OP_AND_Label,
+      &&OP_OR_Label,
+      &&OP_ADD_Label,
+      &&OP_SUB_Label,
+      &&OP_MUL_Label,
+      &&OP_DIV_Label,
+      &&OP_NEG_Label,
+      &&OP_SETCURVAR_Label,
+      &&OP_SETCURVAR_CREATE_Label,
+      &&OP_SETCURVAR_ARRAY_Label,
+      &&OP_SETCURVAR_ARRAY_CREATE_Label,
+      &&OP_LOADVAR_UINT_Label,
+      &&OP_LOADVAR_FLT_Label,
+      &&OP_LOADVAR_STR_Label,
+      &&OP_SAVEVAR_UINT_Label,
+      &&OP_SAVEVAR_FLT_Label,
+      &&OP_SAVEVAR_STR_Label,
+      &&OP_SETCUROBJECT_Label,
+      &&OP_SETCUROBJECT_NEW_Label,
+      &&OP_SETCUROBJECT_INTERNAL_Label,
+      &&OP_SETCURFIELD_Label,
+      &&OP_SETCURFIELD_ARRAY_Label,
+      &&OP_SETCURFIELD_TYPE_Label,
+      &&OP_LOADFIELD_UINT_Label,
+      &&OP_LOADFIELD_FLT_Label,
+      &&OP_LOADFIELD_STR_Label,
+      &&OP_SAVEFIELD_UINT_Label,
+      &&OP_SAVEFIELD_FLT_Label,
+      &&OP_SAVEFIELD_STR_Label,
+      &&OP_STR_TO_UINT_Label,
+      &&OP_STR_TO_FLT_Label,
+      &&OP_STR_TO_NONE_Label,
+      &&OP_FLT_TO_UINT_Label,
+      &&OP_FLT_TO_STR_Label,
+      &&OP_FLT_TO_NONE_Label,
+      &&OP_UINT_TO_FLT_Label,
+      &&OP_UINT_TO_STR_Label,
+      &&OP_UINT_TO_NONE_Label,
+      &&OP_LOADIMMED_UINT_Label,
+      &&OP_LOADIMMED_FLT_Label,
+      &&OP_TAG_TO_STR_Label,
+      &&OP_LOADIMMED_STR_Label,
+      &&OP_DOCBLOCK_STR_Label,
+      &&OP_LOADIMMED_IDENT_Label,
+      &&OP_CALLFUNC_RESOLVE_Label,
+      &&OP_CALLFUNC_Label,
+      &&OP_ADVANCE_STR_Label,
+      &&OP_ADVANCE_STR_APPENDCHAR_Label,
+      &&OP_ADVANCE_STR_COMMA_Label,
+      &&OP_ADVANCE_STR_NUL_Label,
+      &&OP_REWIND_STR_Label,
+      &&OP_TERMINATE_REWIND_STR_Label,
+      &&OP_COMPARE_STR_Label,
+      &&OP_PUSH_Label,
+      &&OP_PUSH_FRAME_Label,
+      &&OP_ASSERT_Label,
+      &&OP_BREAK_Label,
+      &&OP_ITER_BEGIN_Label,
+      &&OP_ITER_BEGIN_STR_Label,
+      &&OP_ITER_Label,
+      &&OP_ITER_END_Label,
+      &&OP_JMPIFNOT_CMPEQ_Label,
+      &&OP_JMPIFNOT_CMPGR_Label,
+      &&OP_JMPIFNOT_CMPGE_Label,
+      &&OP_JMPIFNOT_CMPLT_Label,
+      &&OP_JMPIFNOT_CMPLE_Label,
+      &&OP_JMPIFNOT_CMPNE_Label,
+      &&OP_JMPIF_CMPEQ_Label,
+      &&OP_JMPIF_CMPGR_Label,
+      &&OP_JMPIF_CMPGE_Label,
+      &&OP_JMPIF_CMPLT_Label,
+      &&OP_JMPIF_CMPLE_Label,
+      &&OP_JMPIF_CMPNE_Label,
+      &&OP_INCVAR_FLT_Label,
+      &&OP_SETCUROBJECT_VAR_Label,
+      &&OP_SETCURVAR_LOCAL_Label,
+      &&OP_SETCURVAR_LOCAL_CREATE_Label,
+      &&OP_INCVAR_LOCAL_Label,
+      &&OP_SETCUROBJECT_LOCAL_Label,
+      &&OP_PUSH_UINT_Label,
+      &&OP_PUSH_FLT_Label,
+      &&OP_INVALID_Label
+   };
+#endif
+
    for(;;)
    {
       U32 instruction = code[ip++];
@@ -556,7 +794,7 @@ const char *CodeBlock::exec(U32 ip, const char *functionName, Namespace *thisNam
 breakContinue:
       switch(instruction)
       {
-         case OP_FUNC_DECL:
+         VM_OP( OP_FUNC_DECL )
             if(!noCalls)
             {
                fnName       = U32toSTE(code[ip]);
@@ -587,9 +825,9 @@ breakContinue:
                //Con::printf("Adding function %s::%s (%d)", fnNamespace, fnName, ip);
             }
             ip = code[ip + 4];
-            break;
+            VM_NEXT;
 
-         case OP_CREATE_OBJECT:
+         VM_OP( OP_CREATE_OBJECT )
          {
             // Read some useful info.
             objParent        = U32toSTE(code[ip    ]);
@@ -606,7 +844,7 @@ breakContinue:
             if(noCalls)
             {
                ip = failJump;
-               break;
+               VM_NEXT;
             }
 
             // Push the old info to the stack
@@ -616,6 +854,7 @@ breakContinue:
 
             // Get the constructor information off the stack.
             STR.getArgcArgv(NULL, &callArgc, &callArgv);
+            STR.formatTypedArgs(callArgc, callArgv);
             const char* objectName = callArgv[ 2 ];
 
             // Con::printf("Creating object...");
@@ -638,7 +877,7 @@ breakContinue:
                   Con::errorf(ConsoleLogEntry::General, "%s: Cannot re-declare data block %s with a different class.", getFileLine(ip), objectName);
                   ip = failJump;
                   STR.popFrame();
-                  break;
+                  VM_NEXT;
                }
 
                // If there was one, set the currentNewObject and move on.
@@ -662,7 +901,7 @@ breakContinue:
                            getFileLine(ip), objectName, callArgv[1], obj->getClassName());
                         ip = failJump;
                         STR.popFrame();
-                        break;
+                        VM_NEXT;
                      }
 
                      // We're creating a singleton, so use the found object
@@ -714,7 +953,7 @@ breakContinue:
                               getFileLine(ip), newName.c_str() );
                            ip = failJump;
                            STR.popFrame();
-                           break;
+                           VM_NEXT;
                         }
                         else
                            objectName = StringTable->insert( newName );
@@ -725,7 +964,7 @@ breakContinue:
                            getFileLine(ip), objectName);
                         ip = failJump;
                         STR.popFrame();
-                        break;
+                        VM_NEXT;
                      }
                   }
                }
@@ -743,7 +982,7 @@ breakContinue:
                {
                   Con::errorf(ConsoleLogEntry::General, "%s: Unable to instantiate non-conobject class %s.", getFileLine(ip), callArgv[1]);
                   ip = failJump;
-                  break;
+                  VM_NEXT;
                }
 
                // Do special datablock init if appropros
@@ -761,7 +1000,7 @@ breakContinue:
                      // Clean up...
                      delete object;
                      ip = failJump;
-                     break;
+                     VM_NEXT;
                   }
                }
 
@@ -774,7 +1013,7 @@ breakContinue:
                   Con::errorf(ConsoleLogEntry::General, "%s: Unable to instantiate non-SimObject class %s.", getFileLine(ip), callArgv[1]);
                   delete object;
                   ip = failJump;
-                  break;
+                  VM_NEXT;
                }
 
                // Set the declaration line
@@ -805,7 +1044,7 @@ breakContinue:
                      // Fail to create the object.
                      delete object;
                      ip = failJump;
-                     break;
+                     VM_NEXT;
                   }
                }
 
@@ -827,7 +1066,7 @@ breakContinue:
                   delete currentNewObject;
                   currentNewObject = NULL;
                   ip = failJump;
-                  break;
+                  VM_NEXT;
                }
 
                // If it's not a datablock, allow people to modify bits of it.
@@ -840,10 +1079,10 @@ breakContinue:
 
             // Advance the IP past the create info...
             ip += 6;
-            break;
+            VM_NEXT;
          }
 
-         case OP_ADD_OBJECT:
+         VM_OP( OP_ADD_OBJECT )
          {
             // See OP_SETCURVAR for why we do this.
             curFNDocBlock = NULL;
@@ -877,7 +1116,7 @@ breakContinue:
                   Con::warnf(ConsoleLogEntry::General, "%s: Register object failed for object %s of class %s.", getFileLine(ip), currentNewObject->getName(), currentNewObject->getClassName());
                   delete currentNewObject;
                   ip = failJump;
-                  break;
+                  VM_NEXT;
                }
             }
 
@@ -892,7 +1131,7 @@ breakContinue:
                            currentNewObject->getName(), errorStr.c_str());
                dataBlock->deleteObject();
                ip = failJump;
-               break;
+               VM_NEXT;
             }
 
             // What group will we be added to, if any?
@@ -946,88 +1185,91 @@ breakContinue:
             else
                intStack[++_UINT] = currentNewObject->getId();
 
-            break;
+            VM_NEXT;
          }
 
-         case OP_END_OBJECT:
+         VM_OP( OP_END_OBJECT )
          {
             // If we're not to be placed at the root, make sure we clean up
             // our group reference.
             bool placeAtRoot = code[ip++];
             if(!placeAtRoot)
                _UINT--;
-            break;
+            VM_NEXT;
          }
 
-         case OP_FINISH_OBJECT:
+         VM_OP( OP_FINISH_OBJECT )
          {
             //Assert( objectCreationStackIndex >= 0 );
             // Restore the object info from the stack [7/9/2007 Black]
             currentNewObject = objectCreationStack[ --objectCreationStackIndex ].newObject;
             failJump = objectCreationStack[ objectCreationStackIndex ].failJump;
-            break;
+            VM_NEXT;
          }
 
-         case OP_JMPIFFNOT:
+         VM_OP( OP_JMPIFFNOT )
             if(floatStack[_FLT--])
             {
                ip++;
-               break;
+               VM_NEXT;
             }
             ip = code[ip];
-            break;
-         case OP_JMPIFNOT:
+            VM_NEXT;
+         VM_OP( OP_JMPIFNOT )
             if(intStack[_UINT--])
             {
                ip++;
-               break;
+               VM_NEXT;
             }
             ip = code[ip];
-            break;
-         case OP_JMPIFF:
+            VM_NEXT;
+         VM_OP( OP_JMPIFF )
             if(!floatStack[_FLT--])
             {
                ip++;
-               break;
+               VM_NEXT;
             }
             ip = code[ip];
-            break;
-         case OP_JMPIF:
+            SCRIPT_PROFILER_POLL();
+            VM_NEXT;
+         VM_OP( OP_JMPIF )
             if(!intStack[_UINT--])
             {
                ip ++;
-               break;
+               VM_NEXT;
             }
             ip = code[ip];
-            break;
-         case OP_JMPIFNOT_NP:
+            SCRIPT_PROFILER_POLL();
+            VM_NEXT;
+         VM_OP( OP_JMPIFNOT_NP )
             if(intStack[_UINT])
             {
                _UINT--;
                ip++;
-               break;
+               VM_NEXT;
             }
             ip = code[ip];
-            break;
-         case OP_JMPIF_NP:
+            VM_NEXT;
+         VM_OP( OP_JMPIF_NP )
             if(!intStack[_UINT])
             {
                _UINT--;
                ip++;
-               break;
+               VM_NEXT;
             }
             ip = code[ip];
-            break;
-         case OP_JMP:
+            VM_NEXT;
+         VM_OP( OP_JMP )
             ip = code[ip];
-            break;
+            SCRIPT_PROFILER_POLL();
+            VM_NEXT;
             
          // This fixes a bug when not explicitly returning a value.
-         case OP_RETURN_VOID:
+         VM_OP( OP_RETURN_VOID )
       		STR.setStringValue("");
       		// We're falling thru here on purpose.
             
-         case OP_RETURN:
+         VM_OP( OP_RETURN )
          
             if( iterDepth > 0 )
             {
@@ -1045,122 +1287,122 @@ breakContinue:
                
             goto execFinished;
             
-         case OP_CMPEQ:
+         VM_OP( OP_CMPEQ )
             intStack[_UINT+1] = bool(floatStack[_FLT] == floatStack[_FLT-1]);
             _UINT++;
             _FLT -= 2;
-            break;
+            VM_NEXT;
 
-         case OP_CMPGR:
+         VM_OP( OP_CMPGR )
             intStack[_UINT+1] = bool(floatStack[_FLT] > floatStack[_FLT-1]);
             _UINT++;
             _FLT -= 2;
-            break;
+            VM_NEXT;
 
-         case OP_CMPGE:
+         VM_OP( OP_CMPGE )
             intStack[_UINT+1] = bool(floatStack[_FLT] >= floatStack[_FLT-1]);
             _UINT++;
             _FLT -= 2;
-            break;
+            VM_NEXT;
 
-         case OP_CMPLT:
+         VM_OP( OP_CMPLT )
             intStack[_UINT+1] = bool(floatStack[_FLT] < floatStack[_FLT-1]);
             _UINT++;
             _FLT -= 2;
-            break;
+            VM_NEXT;
 
-         case OP_CMPLE:
+         VM_OP( OP_CMPLE )
             intStack[_UINT+1] = bool(floatStack[_FLT] <= floatStack[_FLT-1]);
             _UINT++;
             _FLT -= 2;
-            break;
+            VM_NEXT;
 
-         case OP_CMPNE:
+         VM_OP( OP_CMPNE )
             intStack[_UINT+1] = bool(floatStack[_FLT] != floatStack[_FLT-1]);
             _UINT++;
             _FLT -= 2;
-            break;
+            VM_NEXT;
 
-         case OP_XOR:
+         VM_OP( OP_XOR )
             intStack[_UINT-1] = intStack[_UINT] ^ intStack[_UINT-1];
             _UINT--;
-            break;
+            VM_NEXT;
 
-         case OP_MOD:
+         VM_OP( OP_MOD )
             if(  intStack[_UINT-1] != 0 )
                intStack[_UINT-1] = intStack[_UINT] % intStack[_UINT-1];
             else
                intStack[_UINT-1] = 0;
             _UINT--;
-            break;
+            VM_NEXT;
 
-         case OP_BITAND:
+         VM_OP( OP_BITAND )
             intStack[_UINT-1] = intStack[_UINT] & intStack[_UINT-1];
             _UINT--;
-            break;
+            VM_NEXT;
 
-         case OP_BITOR:
+         VM_OP( OP_BITOR )
             intStack[_UINT-1] = intStack[_UINT] | intStack[_UINT-1];
             _UINT--;
-            break;
+            VM_NEXT;
 
-         case OP_NOT:
+         VM_OP( OP_NOT )
             intStack[_UINT] = !intStack[_UINT];
-            break;
+            VM_NEXT;
 
-         case OP_NOTF:
+         VM_OP( OP_NOTF )
             intStack[_UINT+1] = !floatStack[_FLT];
             _FLT--;
             _UINT++;
-            break;
+            VM_NEXT;
 
-         case OP_ONESCOMPLEMENT:
+         VM_OP( OP_ONESCOMPLEMENT )
             intStack[_UINT] = ~intStack[_UINT];
-            break;
+            VM_NEXT;
 
-         case OP_SHR:
+         VM_OP( OP_SHR )
             intStack[_UINT-1] = intStack[_UINT] >> intStack[_UINT-1];
             _UINT--;
-            break;
+            VM_NEXT;
 
-         case OP_SHL:
+         VM_OP( OP_SHL )
             intStack[_UINT-1] = intStack[_UINT] << intStack[_UINT-1];
             _UINT--;
-            break;
+            VM_NEXT;
 
-         case OP_AND:
+         VM_OP( OP_AND )
             intStack[_UINT-1] = intStack[_UINT] && intStack[_UINT-1];
             _UINT--;
-            break;
+            VM_NEXT;
 
-         case OP_OR:
+         VM_OP( OP_OR )
             intStack[_UINT-1] = intStack[_UINT] || intStack[_UINT-1];
             _UINT--;
-            break;
+            VM_NEXT;
 
-         case OP_ADD:
+         VM_OP( OP_ADD )
             floatStack[_FLT-1] = floatStack[_FLT] + floatStack[_FLT-1];
             _FLT--;
-            break;
+            VM_NEXT;
 
-         case OP_SUB:
+         VM_OP( OP_SUB )
             floatStack[_FLT-1] = floatStack[_FLT] - floatStack[_FLT-1];
             _FLT--;
-            break;
+            VM_NEXT;
 
-         case OP_MUL:
+         VM_OP( OP_MUL )
             floatStack[_FLT-1] = floatStack[_FLT] * floatStack[_FLT-1];
             _FLT--;
-            break;
-         case OP_DIV:
+            VM_NEXT;
+         VM_OP( OP_DIV )
             floatStack[_FLT-1] = floatStack[_FLT] / floatStack[_FLT-1];
             _FLT--;
-            break;
-         case OP_NEG:
+            VM_NEXT;
+         VM_OP( OP_NEG )
             floatStack[_FLT] = -floatStack[_FLT];
-            break;
+            VM_NEXT;
 
-         case OP_SETCURVAR:
+         VM_OP( OP_SETCURVAR )
             var = U32toSTE(code[ip]);
             ip++;
 
@@ -1178,9 +1420,9 @@ breakContinue:
             // won't inappropriately carry forward to following function decls.
             curFNDocBlock = NULL;
             curNSDocBlock = NULL;
-            break;
+            VM_NEXT;
 
-         case OP_SETCURVAR_CREATE:
+         VM_OP( OP_SETCURVAR_CREATE )
             var = U32toSTE(code[ip]);
             ip++;
 
@@ -1194,9 +1436,9 @@ breakContinue:
             // See OP_SETCURVAR for why we do this.
             curFNDocBlock = NULL;
             curNSDocBlock = NULL;
-            break;
+            VM_NEXT;
 
-         case OP_SETCURVAR_ARRAY:
+         VM_OP( OP_SETCURVAR_ARRAY )
             var = STR.getSTValue();
 
             // See OP_SETCURVAR
@@ -1209,9 +1451,9 @@ breakContinue:
             // See OP_SETCURVAR for why we do this.
             curFNDocBlock = NULL;
             curNSDocBlock = NULL;
-            break;
+            VM_NEXT;
 
-         case OP_SETCURVAR_ARRAY_CREATE:
+         VM_OP( OP_SETCURVAR_ARRAY_CREATE )
             var = STR.getSTValue();
 
             // See OP_SETCURVAR
@@ -1224,55 +1466,42 @@ breakContinue:
             // See OP_SETCURVAR for why we do this.
             curFNDocBlock = NULL;
             curNSDocBlock = NULL;
-            break;
+            VM_NEXT;
 
-         case OP_LOADVAR_UINT:
+         VM_OP( OP_LOADVAR_UINT )
             intStack[_UINT+1] = gEvalState.getIntVariable();
             _UINT++;
-            break;
+            VM_NEXT;
 
-         case OP_LOADVAR_FLT:
+         VM_OP( OP_LOADVAR_FLT )
             floatStack[_FLT+1] = gEvalState.getFloatVariable();
             _FLT++;
-            break;
+            VM_NEXT;
 
-         case OP_LOADVAR_STR:
+         VM_OP( OP_LOADVAR_STR )
             val = gEvalState.getStringVariable();
             STR.setStringValue(val);
-            break;
+            VM_NEXT;
 
-         case OP_SAVEVAR_UINT:
+         VM_OP( OP_SAVEVAR_UINT )
             gEvalState.setIntVariable(intStack[_UINT]);
-            break;
+            VM_NEXT;
 
-         case OP_SAVEVAR_FLT:
+         VM_OP( OP_SAVEVAR_FLT )
             gEvalState.setFloatVariable(floatStack[_FLT]);
-            break;
+            VM_NEXT;
 
-         case OP_SAVEVAR_STR:
+         VM_OP( OP_SAVEVAR_STR )
             gEvalState.setStringVariable(STR.getStringValue());
-            break;
+            VM_NEXT;
 
-         case OP_SETCUROBJECT:
+         VM_OP( OP_SETCUROBJECT )
             // Save the previous object for parsing vector fields.
             prevObject = curObject;
-            val = STR.getStringValue();
+            curObject = findFieldObject( STR.getStringValue() );
+            VM_NEXT;
 
-            // Sim::findObject will sometimes find valid objects from
-            // multi-component strings. This makes sure that doesn't
-            // happen.
-            for( const char* check = val; *check; check++ )
-            {
-               if( *check == ' ' )
-               {
-                  val = "";
-                  break;
-               }
-            }
-            curObject = Sim::findObject(val);
-            break;
-
-         case OP_SETCUROBJECT_INTERNAL:
+         VM_OP( OP_SETCUROBJECT_INTERNAL )
             ++ip; // To skip the recurse flag if the object wasn't found
             if(curObject)
             {
@@ -1291,32 +1520,32 @@ breakContinue:
                   intStack[_UINT] = 0;
                }
             }
-            break;
+            VM_NEXT;
 
-         case OP_SETCUROBJECT_NEW:
+         VM_OP( OP_SETCUROBJECT_NEW )
             curObject = currentNewObject;
-            break;
+            VM_NEXT;
 
-         case OP_SETCURFIELD:
+         VM_OP( OP_SETCURFIELD )
             // Save the previous field for parsing vector fields.
             prevField = curField;
             dStrcpy( prevFieldArray, curFieldArray );
             curField = U32toSTE(code[ip]);
             curFieldArray[0] = 0;
             ip++;
-            break;
+            VM_NEXT;
 
-         case OP_SETCURFIELD_ARRAY:
+         VM_OP( OP_SETCURFIELD_ARRAY )
             dStrcpy(curFieldArray, STR.getStringValue());
-            break;
+            VM_NEXT;
 
-         case OP_SETCURFIELD_TYPE:
+         VM_OP( OP_SETCURFIELD_TYPE )
             if(curObject)
                curObject->setDataFieldType(code[ip], curField, curFieldArray);
             ip++;
-            break;
+            VM_NEXT;
 
-         case OP_LOADFIELD_UINT:
+         VM_OP( OP_LOADFIELD_UINT )
             if(curObject)
                intStack[_UINT+1] = U32(dAtoi(curObject->getDataField(curField, curFieldArray)));
             else
@@ -1327,9 +1556,9 @@ breakContinue:
                intStack[_UINT+1] = dAtoi( valBuffer );
             }
             _UINT++;
-            break;
+            VM_NEXT;
 
-         case OP_LOADFIELD_FLT:
+         VM_OP( OP_LOADFIELD_FLT )
             if(curObject)
                floatStack[_FLT+1] = dAtof(curObject->getDataField(curField, curFieldArray));
             else
@@ -1340,9 +1569,9 @@ breakContinue:
                floatStack[_FLT+1] = dAtof( valBuffer );
             }
             _FLT++;
-            break;
+            VM_NEXT;
 
-         case OP_LOADFIELD_STR:
+         VM_OP( OP_LOADFIELD_STR )
             if(curObject)
             {
                val = curObject->getDataField(curField, curFieldArray);
@@ -1355,9 +1584,9 @@ breakContinue:
                getFieldComponent( prevObject, prevField, prevFieldArray, curField, valBuffer );
                STR.setStringValue( valBuffer );
             }
-            break;
+            VM_NEXT;
 
-         case OP_SAVEFIELD_UINT:
+         VM_OP( OP_SAVEFIELD_UINT )
             STR.setIntValue(intStack[_UINT]);
             if(curObject)
                curObject->setDataField(curField, curFieldArray, STR.getStringValue());
@@ -1368,9 +1597,9 @@ breakContinue:
                setFieldComponent( prevObject, prevField, prevFieldArray, curField );
                prevObject = NULL;
             }
-            break;
+            VM_NEXT;
 
-         case OP_SAVEFIELD_FLT:
+         VM_OP( OP_SAVEFIELD_FLT )
             STR.setFloatValue(floatStack[_FLT]);
             if(curObject)
                curObject->setDataField(curField, curFieldArray, STR.getStringValue());
@@ -1381,9 +1610,9 @@ breakContinue:
                setFieldComponent( prevObject, prevField, prevFieldArray, curField );
                prevObject = NULL;
             }
-            break;
+            VM_NEXT;
 
-         case OP_SAVEFIELD_STR:
+         VM_OP( OP_SAVEFIELD_STR )
             if(curObject)
                curObject->setDataField(curField, curFieldArray, STR.getStringValue());
             else
@@ -1393,64 +1622,64 @@ breakContinue:
                setFieldComponent( prevObject, prevField, prevFieldArray, curField );
                prevObject = NULL;
             }
-            break;
+            VM_NEXT;
 
-         case OP_STR_TO_UINT:
+         VM_OP( OP_STR_TO_UINT )
             intStack[_UINT+1] = STR.getIntValue();
             _UINT++;
-            break;
+            VM_NEXT;
 
-         case OP_STR_TO_FLT:
+         VM_OP( OP_STR_TO_FLT )
             floatStack[_FLT+1] = STR.getFloatValue();
             _FLT++;
-            break;
+            VM_NEXT;
 
-         case OP_STR_TO_NONE:
+         VM_OP( OP_STR_TO_NONE )
             // This exists simply to deal with certain typecast situations.
-            break;
+            VM_NEXT;
 
-         case OP_FLT_TO_UINT:
+         VM_OP( OP_FLT_TO_UINT )
             intStack[_UINT+1] = (S64)floatStack[_FLT];
             _FLT--;
             _UINT++;
-            break;
+            VM_NEXT;
 
-         case OP_FLT_TO_STR:
+         VM_OP( OP_FLT_TO_STR )
             STR.setFloatValue(floatStack[_FLT]);
             _FLT--;
-            break;
+            VM_NEXT;
 
-         case OP_FLT_TO_NONE:
+         VM_OP( OP_FLT_TO_NONE )
             _FLT--;
-            break;
+            VM_NEXT;
 
-         case OP_UINT_TO_FLT:
+         VM_OP( OP_UINT_TO_FLT )
             floatStack[_FLT+1] = (F32)intStack[_UINT];
             _UINT--;
             _FLT++;
-            break;
+            VM_NEXT;
 
-         case OP_UINT_TO_STR:
+         VM_OP( OP_UINT_TO_STR )
             STR.setIntValue(intStack[_UINT]);
             _UINT--;
-            break;
+            VM_NEXT;
 
-         case OP_UINT_TO_NONE:
+         VM_OP( OP_UINT_TO_NONE )
             _UINT--;
-            break;
+            VM_NEXT;
 
-         case OP_LOADIMMED_UINT:
+         VM_OP( OP_LOADIMMED_UINT )
             intStack[_UINT+1] = code[ip++];
             _UINT++;
-            break;
+            VM_NEXT;
 
-         case OP_LOADIMMED_FLT:
+         VM_OP( OP_LOADIMMED_FLT )
             floatStack[_FLT+1] = curFloatTable[code[ip]];
             ip++;
             _FLT++;
-            break;
+            VM_NEXT;
             
-         case OP_TAG_TO_STR:
+         VM_OP( OP_TAG_TO_STR )
             code[ip-1] = OP_LOADIMMED_STR;
             // it's possible the string has already been converted
             if(U8(curStringTable[code[ip]]) != StringTagPrefixByte)
@@ -1459,11 +1688,11 @@ breakContinue:
                dSprintf(curStringTable + code[ip] + 1, 7, "%d", id);
                *(curStringTable + code[ip]) = StringTagPrefixByte;
             }
-         case OP_LOADIMMED_STR:
+         VM_OP( OP_LOADIMMED_STR )
             STR.setStringValue(curStringTable + code[ip++]);
-            break;
+            VM_NEXT;
 
-         case OP_DOCBLOCK_STR:
+         VM_OP( OP_DOCBLOCK_STR )
             {
                // If the first word of the doc is '\class' or '@class', then this
                // is a namespace doc block, otherwise it is a function doc block.
@@ -1492,33 +1721,36 @@ breakContinue:
                   curFNDocBlock = docblock;
             }
 
-            break;
+            VM_NEXT;
 
-         case OP_LOADIMMED_IDENT:
+         VM_OP( OP_LOADIMMED_IDENT )
             STR.setStringValue(U32toSTE(code[ip++]));
-            break;
+            VM_NEXT;
 
-         case OP_CALLFUNC_RESOLVE:
+         VM_OP( OP_CALLFUNC_RESOLVE )
             // This deals with a function that is potentially living in a namespace.
             fnNamespace = U32toSTE(code[ip+1]);
             fnName      = U32toSTE(code[ip]);
 
-            // Try to look it up.
-            ns = Namespace::find(fnNamespace);
-            nsEntry = ns->lookup(fnName);
+            // Try to look it up.  The namespace of a resolved call never
+            // changes so the cache saves finding it as well.
+            ns = getCallSiteNamespace(ip+3);
+            if(!ns)
+               ns = Namespace::find(fnNamespace);
+            nsEntry = lookupCallSite(ip+3, ns, fnName);
             if(!nsEntry)
             {
-               ip+= 3;
+               ip+= 4;
                Con::warnf(ConsoleLogEntry::General,
                   "%s: Unable to find function %s%s%s",
-                  getFileLine(ip-4), fnNamespace ? fnNamespace : "",
+                  getFileLine(ip-5), fnNamespace ? fnNamespace : "",
                   fnNamespace ? "::" : "", fnName);
                STR.popFrame();
-               break;
+               VM_NEXT;
             }
             // Now fall through to OP_CALLFUNC...
 
-         case OP_CALLFUNC:
+         VM_OP( OP_CALLFUNC )
          {
             // This routingId is set when we query the object as to whether
             // it handles this method.  It is set to an enum from the table
@@ -1536,8 +1768,9 @@ breakContinue:
             }
 
             U32 callType = code[ip+2];
+            U32 cacheIp = ip+3;
 
-            ip += 3;
+            ip += 4;
             STR.getArgcArgv(fnName, &callArgc, &callArgv);
 
             const char *componentReturnValue = "";
@@ -1548,22 +1781,22 @@ breakContinue:
                {
                   // We must not have come from OP_CALLFUNC_RESOLVE, so figure out
                   // our own entry.
-                  nsEntry = Namespace::global()->lookup( fnName );
+                  nsEntry = lookupCallSite( cacheIp, Namespace::global(), fnName );
                }
                ns = NULL;
             }
             else if(callType == FuncCallExprNode::MethodCall)
             {
                saveObject = gEvalState.thisObject;
-               gEvalState.thisObject = Sim::findObject(callArgv[1]);
+               gEvalState.thisObject = Sim::findObject(STR.formatTypedArg(callArgv[1]));
                if(!gEvalState.thisObject)
                {
                   // Go back to the previous saved object.
                   gEvalState.thisObject = saveObject;
 
-                  Con::warnf(ConsoleLogEntry::General,"%s: Unable to find object: '%s' attempting to call function '%s'", getFileLine(ip-4), callArgv[1], fnName);
+                  Con::warnf(ConsoleLogEntry::General,"%s: Unable to find object: '%s' attempting to call function '%s'", getFileLine(ip-5), callArgv[1], fnName);
                   STR.popFrame();
-                  break;
+                  VM_NEXT;
                }
                
                bool handlesMethod = gEvalState.thisObject->handlesConsoleMethod(fnName,&routingId);
@@ -1571,12 +1804,15 @@ breakContinue:
                {
                   ICallMethod *pComponent = dynamic_cast<ICallMethod *>( gEvalState.thisObject );
                   if( pComponent )
+                  {
+                     STR.formatTypedArgs(callArgc, callArgv);
                      componentReturnValue = pComponent->callMethodArgList( callArgc, callArgv, false );
+                  }
                }
                
                ns = gEvalState.thisObject->getNamespace();
                if(ns)
-                  nsEntry = ns->lookup(fnName);
+                  nsEntry = lookupCallSite(cacheIp, ns, fnName);
                else
                   nsEntry = NULL;
             }
@@ -1586,7 +1822,7 @@ breakContinue:
                {
                   ns = thisNamespace->mParent;
                   if(ns)
-                     nsEntry = ns->lookup(fnName);
+                     nsEntry = lookupCallSite(cacheIp, ns, fnName);
                   else
                      nsEntry = NULL;
                }
@@ -1609,7 +1845,7 @@ breakContinue:
             {
                if(!noCalls && !( routingId == MethodOnComponent ) )
                {
-                  Con::warnf(ConsoleLogEntry::General,"%s: Unknown command %s.", getFileLine(ip-4), fnName);
+                  Con::warnf(ConsoleLogEntry::General,"%s: Unknown command %s.", getFileLine(ip-5), fnName);
                   if(callType == FuncCallExprNode::MethodCall)
                   {
                      Con::warnf(ConsoleLogEntry::General, "  Object %s(%d) %s",
@@ -1624,11 +1860,12 @@ breakContinue:
                else
                   STR.setStringValue( "" );
 
-               break;
+               VM_NEXT;
             }
             if(nsEntry->mType == Namespace::Entry::ConsoleFunctionType)
             {
                const char *ret = "";
+               STR.formatTypedArgs(callArgc, callArgv);
                if(nsEntry->mFunctionOffset)
                   ret = nsEntry->mCode->exec(nsEntry->mFunctionOffset, fnName, nsEntry->mNamespace, callArgc, callArgv, false, nsEntry->mPackage);
                
@@ -1643,20 +1880,25 @@ breakContinue:
                // which is useful behavior when debugging so I'm ifdefing this out for debug builds.
                if(nsEntry->mToolOnly && ! Con::isCurrentScriptToolScript())
                {
-                  Con::errorf(ConsoleLogEntry::Script, "%s: %s::%s - attempting to call tools only function from outside of tools.", getFileLine(ip-4), nsName, fnName);
+                  Con::errorf(ConsoleLogEntry::Script, "%s: %s::%s - attempting to call tools only function from outside of tools.", getFileLine(ip-5), nsName, fnName);
                }
                else
 #endif
                if((nsEntry->mMinArgs && S32(callArgc) < nsEntry->mMinArgs) || (nsEntry->mMaxArgs && S32(callArgc) > nsEntry->mMaxArgs))
                {
                   Con::warnf(ConsoleLogEntry::Script, "%s: %s::%s - wrong number of arguments (got %i, expected min %i and max %i).",
-                     getFileLine(ip-4), nsName, fnName,
+                     getFileLine(ip-5), nsName, fnName,
                      callArgc, nsEntry->mMinArgs, nsEntry->mMaxArgs);
-                  Con::warnf(ConsoleLogEntry::Script, "%s: usage: %s", getFileLine(ip-4), nsEntry->mUsage);
+                  Con::warnf(ConsoleLogEntry::Script, "%s: usage: %s", getFileLine(ip-5), nsEntry->mUsage);
                   STR.popFrame();
                }
                else
                {
+                  // Only the engine API thunks know how to read typed
+                  // arguments.  Everything else wants strings.
+                  if(!nsEntry->mHeader)
+                     STR.formatTypedArgs(callArgc, callArgv);
+
                   switch(nsEntry->mType)
                   {
                      case Namespace::Entry::StringCallbackType:
@@ -1716,7 +1958,7 @@ breakContinue:
                      case Namespace::Entry::VoidCallbackType:
                         nsEntry->cb.mVoidCallbackFunc(gEvalState.thisObject, callArgc, callArgv);
                         if( code[ ip ] != OP_STR_TO_NONE && Con::getBoolVariable( "$Con::warnVoidAssignment", true ) )
-                           Con::warnf(ConsoleLogEntry::General, "%s: Call to %s in %s uses result of void function call.", getFileLine(ip-4), fnName, functionName);
+                           Con::warnf(ConsoleLogEntry::General, "%s: Call to %s in %s uses result of void function call.", getFileLine(ip-5), fnName, functionName);
                         
                         STR.popFrame();
                         STR.setStringValue("");
@@ -1744,48 +1986,59 @@ breakContinue:
                         break;
                      }
                   }
+
+                  if(ScriptProfiler::smSamplePending)
+                     ScriptProfiler::takeSample(this, cacheIp, nsEntry->mNamespace, fnName);
                }
             }
 
             if(callType == FuncCallExprNode::MethodCall)
                gEvalState.thisObject = saveObject;
-            break;
+            VM_NEXT;
          }
-         case OP_ADVANCE_STR:
+         VM_OP( OP_ADVANCE_STR )
             STR.advance();
-            break;
-         case OP_ADVANCE_STR_APPENDCHAR:
+            VM_NEXT;
+         VM_OP( OP_ADVANCE_STR_APPENDCHAR )
             STR.advanceChar(code[ip++]);
-            break;
+            VM_NEXT;
 
-         case OP_ADVANCE_STR_COMMA:
+         VM_OP( OP_ADVANCE_STR_COMMA )
             STR.advanceChar('_');
-            break;
+            VM_NEXT;
 
-         case OP_ADVANCE_STR_NUL:
+         VM_OP( OP_ADVANCE_STR_NUL )
             STR.advanceChar(0);
-            break;
+            VM_NEXT;
 
-         case OP_REWIND_STR:
+         VM_OP( OP_REWIND_STR )
             STR.rewind();
-            break;
+            VM_NEXT;
 
-         case OP_TERMINATE_REWIND_STR:
+         VM_OP( OP_TERMINATE_REWIND_STR )
             STR.rewindTerminate();
-            break;
+            VM_NEXT;
 
-         case OP_COMPARE_STR:
+         VM_OP( OP_COMPARE_STR )
             intStack[++_UINT] = STR.compare();
-            break;
-         case OP_PUSH:
+            VM_NEXT;
+         VM_OP( OP_PUSH )
             STR.push();
-            break;
+            VM_NEXT;
+
+         VM_OP( OP_PUSH_UINT )
+            STR.pushUInt(intStack[_UINT--]);
+            VM_NEXT;
+
+         VM_OP( OP_PUSH_FLT )
+            STR.pushFloat(floatStack[_FLT--]);
+            VM_NEXT;
 
-         case OP_PUSH_FRAME:
+         VM_OP( OP_PUSH_FRAME )
             STR.pushFrame();
-            break;
+            VM_NEXT;
 
-         case OP_ASSERT:
+         VM_OP( OP_ASSERT )
          {
             if( !intStack[_UINT--] )
             {
@@ -1809,10 +2062,10 @@ breakContinue:
             }
 
             ip++;
-            break;
+            VM_NEXT;
          }
 
-         case OP_BREAK:
+         VM_OP( OP_BREAK )
          {
             //append the ip and codeptr before managing the breakpoint!
             AssertFatal( gEvalState.getStackDepth() > 0, "Empty eval stack on break!");
@@ -1827,20 +2080,24 @@ breakContinue:
             goto breakContinue;
          }
          
-         case OP_ITER_BEGIN_STR:
+         VM_OP( OP_ITER_BEGIN_STR )
          {
             iterStack[ _ITER ].mIsStringIter = true;
             /* fallthrough */
          }
          
-         case OP_ITER_BEGIN:
+         VM_OP( OP_ITER_BEGIN )
          {
             StringTableEntry varName = U32toSTE( code[ ip ] );
             U32 failIp = code[ ip + 1 ];
+            U32 slot = code[ ip + 2 ];
             
             IterStackRecord& iter = iterStack[ _ITER ];
             
-            iter.mVariable = gEvalState.getCurrentFrame().add( varName );
+            if( slot != U32( -1 ) )
+               iter.mVariable = gEvalState.getCurrentFrame().addLocal( slot, varName );
+            else
+               iter.mVariable = gEvalState.getCurrentFrame().add( varName );
             
             if( iter.mIsStringIter )
             {
@@ -1857,7 +2114,7 @@ breakContinue:
                   Con::errorf( ConsoleLogEntry::General, "No SimSet object '%s'", STR.getStringValue() );
                   Con::errorf( ConsoleLogEntry::General, "Did you mean to use 'foreach$' instead of 'foreach'?" );
                   ip = failIp;
-                  continue;
+                  VM_NEXT;
                }
                
                // Set up.
@@ -1871,11 +2128,11 @@ breakContinue:
             
             STR.push();
             
-            ip += 2;
-            break;
+            ip += 3;
+            VM_NEXT;
          }
          
-         case OP_ITER:
+         VM_OP( OP_ITER )
          {
             U32 breakIp = code[ ip ];
             IterStackRecord& iter = iterStack[ _ITER - 1 ];
@@ -1892,7 +2149,7 @@ breakContinue:
                if( !str[ startIndex ] )
                {
                   ip = breakIp;
-                  continue;
+                  VM_NEXT;
                }
 
                // Find right end of current component.
@@ -1927,7 +2184,7 @@ breakContinue:
                if( index >= set->size() )
                {
                   ip = breakIp;
-                  continue;
+                  VM_NEXT;
                }
                
                iter.mVariable->setIntValue( set->at( index )->getId() );
@@ -1935,10 +2192,10 @@ breakContinue:
             }
             
             ++ ip;
-            break;
+            VM_NEXT;
          }
          
-         case OP_ITER_END:
+         VM_OP( OP_ITER_END )
          {
             -- _ITER;
             -- iterDepth;
@@ -1946,10 +2203,224 @@ breakContinue:
             STR.rewind();
             
             iterStack[ _ITER ].mIsStringIter = false;
-            break;
+            VM_NEXT;
          }
          
-         case OP_INVALID:
+         // Superinstructions.  The fused compares take their operands the
+         // same way as OP_CMPxx and then jump like OP_JMPIF/OP_JMPIFNOT.
+         VM_OP( OP_JMPIFNOT_CMPEQ )
+            if(floatStack[_FLT] == floatStack[_FLT-1])
+               ip++;
+            else
+               ip = code[ip];
+            _FLT -= 2;
+            VM_NEXT;
+
+         VM_OP( OP_JMPIFNOT_CMPGR )
+            if(floatStack[_FLT] > floatStack[_FLT-1])
+               ip++;
+            else
+               ip = code[ip];
+            _FLT -= 2;
+            VM_NEXT;
+
+         VM_OP( OP_JMPIFNOT_CMPGE )
+            if(floatStack[_FLT] >= floatStack[_FLT-1])
+               ip++;
+            else
+               ip = code[ip];
+            _FLT -= 2;
+            VM_NEXT;
+
+         VM_OP( OP_JMPIFNOT_CMPLT )
+            if(floatStack[_FLT] < floatStack[_FLT-1])
+               ip++;
+            else
+               ip = code[ip];
+            _FLT -= 2;
+            VM_NEXT;
+
+         VM_OP( OP_JMPIFNOT_CMPLE )
+            if(floatStack[_FLT] <= floatStack[_FLT-1])
+               ip++;
+            else
+               ip = code[ip];
+            _FLT -= 2;
+            VM_NEXT;
+
+         VM_OP( OP_JMPIFNOT_CMPNE )
+            if(floatStack[_FLT] != floatStack[_FLT-1])
+               ip++;
+            else
+               ip = code[ip];
+            _FLT -= 2;
+            VM_NEXT;
+
+         VM_OP( OP_JMPIF_CMPEQ )
+            if(floatStack[_FLT] == floatStack[_FLT-1])
+            {
+               ip = code[ip];
+               SCRIPT_PROFILER_POLL();
+            }
+            else
+               ip++;
+            _FLT -= 2;
+            VM_NEXT;
+
+         VM_OP( OP_JMPIF_CMPGR )
+            if(floatStack[_FLT] > floatStack[_FLT-1])
+            {
+               ip = code[ip];
+               SCRIPT_PROFILER_POLL();
+            }
+            else
+               ip++;
+            _FLT -= 2;
+            VM_NEXT;
+
+         VM_OP( OP_JMPIF_CMPGE )
+            if(floatStack[_FLT] >= floatStack[_FLT-1])
+            {
+               ip = code[ip];
+               SCRIPT_PROFILER_POLL();
+            }
+            else
+               ip++;
+            _FLT -= 2;
+            VM_NEXT;
+
+         VM_OP( OP_JMPIF_CMPLT )
+            if(floatStack[_FLT] < floatStack[_FLT-1])
+            {
+               ip = code[ip];
+               SCRIPT_PROFILER_POLL();
+            }
+            else
+               ip++;
+            _FLT -= 2;
+            VM_NEXT;
+
+         VM_OP( OP_JMPIF_CMPLE )
+            if(floatStack[_FLT] <= floatStack[_FLT-1])
+            {
+               ip = code[ip];
+               SCRIPT_PROFILER_POLL();
+            }
+            else
+               ip++;
+            _FLT -= 2;
+            VM_NEXT;
+
+         VM_OP( OP_JMPIF_CMPNE )
+            if(floatStack[_FLT] != floatStack[_FLT-1])
+            {
+               ip = code[ip];
+               SCRIPT_PROFILER_POLL();
+            }
+            else
+               ip++;
+            _FLT -= 2;
+            VM_NEXT;
+
+         VM_OP( OP_INCVAR_FLT )
+            var = U32toSTE(code[ip]);
+
+            // See OP_SETCURVAR
+            prevField = NULL;
+            prevObject = NULL;
+            curObject = NULL;
+
+            gEvalState.setCurVarNameCreate(var);
+            gEvalState.setFloatVariable(gEvalState.getFloatVariable() + curFloatTable[code[ip+1]]);
+
+            // See OP_SETCURVAR for why we do this.
+            curFNDocBlock = NULL;
+            curNSDocBlock = NULL;
+            ip += 2;
+            VM_NEXT;
+
+         VM_OP( OP_SETCUROBJECT_VAR )
+            var = U32toSTE(code[ip]);
+            ip++;
+
+            // Same as OP_SETCURVAR, OP_LOADVAR_STR, OP_SETCUROBJECT without
+            // going through the string stack.
+            prevField = NULL;
+            prevObject = NULL;
+
+            gEvalState.setCurVarName(var);
+            val = gEvalState.getStringVariable();
+            curObject = findFieldObject( val );
+
+            // Without an object, the vector parser takes the components
+            // from the string stack.
+            if(!curObject)
+               STR.setStringValue(val);
+
+            // See OP_SETCURVAR for why we do this.
+            curFNDocBlock = NULL;
+            curNSDocBlock = NULL;
+            VM_NEXT;
+
+         VM_OP( OP_SETCURVAR_LOCAL )
+            // See OP_SETCURVAR
+            prevField = NULL;
+            prevObject = NULL;
+            curObject = NULL;
+
+            gEvalState.setCurVarLocal(code[ip], U32toSTE(code[ip+1]));
+            ip += 2;
+
+            // See OP_SETCURVAR for why we do this.
+            curFNDocBlock = NULL;
+            curNSDocBlock = NULL;
+            VM_NEXT;
+
+         VM_OP( OP_SETCURVAR_LOCAL_CREATE )
+            // See OP_SETCURVAR
+            prevField = NULL;
+            prevObject = NULL;
+            curObject = NULL;
+
+            gEvalState.setCurVarLocalCreate(code[ip], U32toSTE(code[ip+1]));
+            ip += 2;
+
+            // See OP_SETCURVAR for why we do this.
+            curFNDocBlock = NULL;
+            curNSDocBlock = NULL;
+            VM_NEXT;
+
+         VM_OP( OP_INCVAR_LOCAL )
+            // See OP_INCVAR_FLT
+            prevField = NULL;
+            prevObject = NULL;
+            curObject = NULL;
+
+            gEvalState.setCurVarLocalCreate(code[ip], U32toSTE(code[ip+1]));
+            gEvalState.setFloatVariable(gEvalState.getFloatVariable() + curFloatTable[code[ip+2]]);
+
+            curFNDocBlock = NULL;
+            curNSDocBlock = NULL;
+            ip += 3;
+            VM_NEXT;
+
+         VM_OP( OP_SETCUROBJECT_LOCAL )
+            // See OP_SETCUROBJECT_VAR
+            prevField = NULL;
+            prevObject = NULL;
+
+            gEvalState.setCurVarLocal(code[ip], U32toSTE(code[ip+1]));
+            ip += 2;
+            val = gEvalState.getStringVariable();
+            curObject = findFieldObject( val );
+            if(!curObject)
+               STR.setStringValue(val);
+
+            curFNDocBlock = NULL;
+            curNSDocBlock = NULL;
+            VM_NEXT;
+
+         VM_OP( OP_INVALID )
 
          default:
             // error!
@@ -2006,6 +2477,7 @@ execFinished:
       Con::gCurrentRoot = saveCodeBlock->modPath;
    }
 
+   ScriptProfiler::smExecDepth --;
    decRefCount();
 
 #ifdef TORQUE_DEBUG
@@ -2015,4 +2487,8 @@ execFinished:
    return STR.getStringValue();
 }
 
+#undef VM_OP
+#undef VM_NEXT
+#undef SCRIPT_PROFILER_POLL
+
 //------------------------------------------------------------
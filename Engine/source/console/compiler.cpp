@@ -60,6 +60,7 @@ namespace Compiler
    CompilerFloatTable  *gCurrentFloatTable,  gGlobalFloatTable,  gFunctionFloatTable;
    DataChunker          gConsoleAllocator;
    CompilerIdentTable   gIdentTable;
+   CompilerLocalVarTable *gCurrentLocalVarTable;
    CodeBlock           *gCurBreakBlock;
 
    //------------------------------------------------------------
@@ -102,6 +103,18 @@ namespace Compiler
 
    void setCurrentFloatTable (CompilerFloatTable* cst) { gCurrentFloatTable  = cst; }
 
+   CompilerLocalVarTable *getCurrentLocalVarTable() { return gCurrentLocalVarTable; }
+
+   void setCurrentLocalVarTable (CompilerLocalVarTable* lvt) { gCurrentLocalVarTable = lvt; }
+
+   bool getLocalVarSlot(StringTableEntry varName, U32 &slot)
+   {
+      if(!gCurrentLocalVarTable || !varName || varName[0] != '%')
+         return false;
+      slot = gCurrentLocalVarTable->add(varName);
+      return true;
+   }
+
    CompilerIdentTable &getIdentTable() { return gIdentTable; }
 
    void precompileIdent(StringTableEntry ident)
@@ -114,6 +127,7 @@ namespace Compiler
    {
       setCurrentStringTable(&gGlobalStringTable);
       setCurrentFloatTable(&gGlobalFloatTable);
+      setCurrentLocalVarTable(NULL);
       getGlobalFloatTable().reset();
       getGlobalStringTable().reset();
       getFunctionFloatTable().reset();
@@ -242,6 +256,35 @@ void CompilerFloatTable::write(Stream &st)
 
 //------------------------------------------------------------
 
+U32 CompilerLocalVarTable::add(StringTableEntry name)
+{
+   // Entries are kept newest first so a duplicated argument name
+   // resolves to the last argument, which is the one that wins when
+   // the arguments are assigned.
+   for(Entry *walk = list; walk; walk = walk->next)
+      if(walk->name == name)
+         return walk->slot;
+   return addArg(name);
+}
+
+U32 CompilerLocalVarTable::addArg(StringTableEntry name)
+{
+   Entry *newVar = (Entry *) consoleAlloc(sizeof(Entry));
+   newVar->name = name;
+   newVar->slot = count++;
+   newVar->next = list;
+   list = newVar;
+   return newVar->slot;
+}
+
+void CompilerLocalVarTable::reset()
+{
+   list = NULL;
+   count = 0;
+}
+
+//------------------------------------------------------------
+
 void CompilerIdentTable::reset()
 {
    list = NULL;
@@ -31,6 +31,13 @@ class DataChunker;
 #include "console/ast.h"
 #include "console/codeBlock.h"
 
+/// CodeBlock::exec dispatches opcodes through computed gotos on compilers
+/// that support them (GCC and Clang).  Define TORQUE_SCRIPT_SWITCH_DISPATCH
+/// to force the portable switch loop instead.
+#if defined( TORQUE_COMPILER_GCC ) && !defined( TORQUE_SCRIPT_SWITCH_DISPATCH )
+#  define TORQUE_SCRIPT_THREADED_DISPATCH
+#endif
+
 
 namespace Compiler
 {
@@ -147,6 +154,36 @@ namespace Compiler
       OP_ITER,             ///< Enter foreach loop.
       OP_ITER_END,         ///< End foreach loop.
 
+      // Superinstructions.  The compiler emits these in place of common
+      // instruction sequences to cut down on dispatch and stack traffic.
+
+      OP_JMPIFNOT_CMPEQ,   ///< OP_CMPEQ + OP_JMPIFNOT.
+      OP_JMPIFNOT_CMPGR,   ///< OP_CMPGR + OP_JMPIFNOT.
+      OP_JMPIFNOT_CMPGE,   ///< OP_CMPGE + OP_JMPIFNOT.
+      OP_JMPIFNOT_CMPLT,   ///< OP_CMPLT + OP_JMPIFNOT.
+      OP_JMPIFNOT_CMPLE,   ///< OP_CMPLE + OP_JMPIFNOT.
+      OP_JMPIFNOT_CMPNE,   ///< OP_CMPNE + OP_JMPIFNOT.
+      OP_JMPIF_CMPEQ,      ///< OP_CMPEQ + OP_JMPIF.
+      OP_JMPIF_CMPGR,      ///< OP_CMPGR + OP_JMPIF.
+      OP_JMPIF_CMPGE,      ///< OP_CMPGE + OP_JMPIF.
+      OP_JMPIF_CMPLT,      ///< OP_CMPLT + OP_JMPIF.
+      OP_JMPIF_CMPLE,      ///< OP_CMPLE + OP_JMPIF.
+      OP_JMPIF_CMPNE,      ///< OP_CMPNE + OP_JMPIF.
+
+      OP_INCVAR_FLT,       ///< Add an immediate float to a variable; %var++, %var -= 2, ...
+      OP_SETCUROBJECT_VAR, ///< OP_SETCURVAR + OP_LOADVAR_STR + OP_SETCUROBJECT.
+
+      // Local variable access through frame slots.  These take the slot
+      // followed by the variable name.
+
+      OP_SETCURVAR_LOCAL,
+      OP_SETCURVAR_LOCAL_CREATE,
+      OP_INCVAR_LOCAL,
+      OP_SETCUROBJECT_LOCAL,
+
+      OP_PUSH_UINT,        ///< Push a function argument from the int stack.
+      OP_PUSH_FLT,         ///< Push a function argument from the float stack.
+
       OP_INVALID
    };
 
@@ -218,6 +255,30 @@ namespace Compiler
 
    //------------------------------------------------------------
 
+   /// Frame slots of the local variables of a function.  Locals named in the
+   /// function body are resolved to a slot at compile time so the VM can
+   /// access them without going through the frame's hash table.
+   struct CompilerLocalVarTable
+   {
+      struct Entry
+      {
+         StringTableEntry name;
+         U32 slot;
+         Entry *next;
+      };
+      U32 count;
+      Entry *list;
+
+      /// Return the slot of the given local, allocating one if needed.
+      U32 add(StringTableEntry name);
+      /// Allocate a slot for a function argument.  Arguments always get a
+      /// slot of their own so argument i is in slot i.
+      U32 addArg(StringTableEntry name);
+      void reset();
+   };
+
+   //------------------------------------------------------------
+
    inline StringTableEntry U32toSTE(U32 u)
    {
       return *((StringTableEntry *) &u);
@@ -240,6 +301,15 @@ namespace Compiler
 
    void setCurrentFloatTable (CompilerFloatTable* cst);
 
+   /// The local variable table of the function being compiled or NULL
+   /// outside of functions.
+   CompilerLocalVarTable *getCurrentLocalVarTable();
+   void setCurrentLocalVarTable (CompilerLocalVarTable* lvt);
+
+   /// Return true and the slot of the given variable if it is a local that
+   /// gets resolved at compile time.
+   bool getLocalVarSlot(StringTableEntry varName, U32 &slot);
+
    CompilerIdentTable &getIdentTable();
 
    void precompileIdent(StringTableEntry ident);
@@ -35,6 +35,7 @@
 #include "console/simBase.h"
 #include "console/compiler.h"
 #include "console/stringStack.h"
+#include "console/scriptProfiler.h"
 #include "console/ICallMethod.h"
 #include "console/engineAPI.h"
 #include <stdarg.h>
@@ -343,6 +344,16 @@ void init()
       "failures based on a missing copy object and does not report an error..\n"
 	   "@ingroup Console\n");   
 
+   addVariable("Con::callSiteCacheHits", TypeS32, &CodeBlock::smCallSiteCacheHits, "Number of script function calls that found their function "
+      "in the inline cache of the call site.\n"
+	   "@ingroup Console\n");
+   addVariable("Con::callSiteCacheMisses", TypeS32, &CodeBlock::smCallSiteCacheMisses, "Number of script function calls that had to look up "
+      "their function in the namespace.\n"
+	   "@ingroup Console\n");
+   addVariable("Con::callSiteCachePolymorphicMisses", TypeS32, &CodeBlock::smCallSiteCachePolymorphicMisses, "Number of call site cache misses "
+      "caused by the call site being used on objects of a different namespace than the previous call.\n"
+	   "@ingroup Console\n");
+
    // Current script file name and root
    addVariable( "Con::File", TypeString, &gCurrentFile, "The currently executing script file.\n"
 	   "@ingroup FileSystem\n");
@@ -383,6 +394,8 @@ void shutdown()
 
    smConsoleInput.remove(postConsoleInput);
 
+   ScriptProfiler::enable(false);
+
    consoleLogFile.close();
    Namespace::shutdown();
    AbstractClassRep::shutdown();
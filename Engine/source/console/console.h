@@ -182,7 +182,12 @@ namespace Con
       /// 09/12/07 - CAF - 43->44 remove newmsg operator
       /// 09/27/07 - RDB - 44->45 Patch from Andreas Kirsch: Added opcode to support correct void return
       /// 01/13/09 - TMS - 45->46 Added script assert
-      DSOVersion = 46,
+      /// 46->47 Added superinstructions and compile-time constant folding
+      /// 47->48 Locals are accessed through frame slots
+      /// 48->49 Added call site cache index to OP_CALLFUNC
+      /// 49->50 Numeric function arguments are pushed as ints and floats
+      /// 50->51 DSOs store a hash of the script source they were compiled from
+      DSOVersion = 51,
 
       MaxLineLength = 512,  ///< Maximum length of a line of console input.
       MaxDataTypes = 256    ///< Maximum number of registered data types.
@@ -644,6 +649,15 @@ namespace Con
    char* getIntArg  (S32 arg);
    char* getStringArg( const char *arg );
    char* getStringArg( const String& arg );
+
+   /// The interpreter passes numeric arguments to functions defined through
+   /// the engine API without formatting them first.  Returns true and the value
+   /// if @a arg is such an argument.
+   bool getNumericArg( const char* arg, F64& value );
+
+   /// Return the string form of an argument, formatting it if it was passed
+   /// as a number.
+   const char* getArgString( const char* arg );
    /// @}
 
    /// @name Namespaces
@@ -29,6 +29,7 @@
 #include "core/strings/stringUnit.h"
 #include "core/strings/unicode.h"
 #include "core/stream/fileStream.h"
+#include "platform/threads/threadPool.h"
 #include "console/compiler.h"
 #include "platform/platformInput.h"
 #include "core/util/journal/journal.h"
@@ -1759,31 +1760,18 @@ DefineConsoleFunction( getDSOPath, const char*, ( const char* scriptFileName ),,
 
 //-----------------------------------------------------------------------------
 
-DefineEngineFunction( compile, bool, ( const char* fileName, bool overrideNoDSO ), ( false ),
-   "Compile a file to bytecode.\n\n"
-   "This function will read the TorqueScript code in the specified file, compile it to internal bytecode, and, "
-   "if DSO generation is enabled or @a overrideNoDDSO is true, will store the compiled code in a .dso file "
-   "in the current DSO path mirrorring the path of @a fileName.\n\n"
-   "@param fileName Path to the file to compile to bytecode.\n"
-   "@param overrideNoDSO If true, force generation of DSOs even if the engine is compiled to not "
-      "generate write compiled code to DSO files.\n\n"
-   "@return True if the file was successfully compiled, false if not.\n\n"
-   "@note The definitions contained in the given file will not be made available and no code will actually "
-      "be executed.  Use exec() for that.\n\n"
-   "@see getDSOPath\n"
-   "@see exec\n"
-   "@ingroup Scripting" )
+/// Work out the DSO file a script compiles to.  Returns false if the script
+/// should not be compiled.
+static bool getCompiledScriptName(const char *scriptFileName, char *nameBuffer, U32 nameBufferSize)
 {
-   Con::expandScriptFilename( scriptFilenameBuffer, sizeof( scriptFilenameBuffer ), fileName );
-
    // Figure out where to put DSOs
-   StringTableEntry dsoPath = getDSOPath(scriptFilenameBuffer);
+   StringTableEntry dsoPath = getDSOPath(scriptFileName);
    if(dsoPath && *dsoPath == 0)
       return false;
 
    // If the script file extention is '.ed.cs' then compile it to a different compiled extention
    bool isEditorScript = false;
-   const char *ext = dStrrchr( scriptFilenameBuffer, '.' );
+   const char *ext = dStrrchr( scriptFileName, '.' );
    if( ext && ( dStricmp( ext, ".cs" ) == 0 ) )
    {
       const char* ext2 = ext - 3;
@@ -1797,18 +1785,40 @@ DefineEngineFunction( compile, bool, ( const char* fileName, bool overrideNoDSO
          isEditorScript = true;
    }
 
-   const char *filenameOnly = dStrrchr(scriptFilenameBuffer, '/');
+   const char *filenameOnly = dStrrchr(scriptFileName, '/');
    if(filenameOnly)
       ++filenameOnly;
    else
-      filenameOnly = scriptFilenameBuffer;
- 
-   char nameBuffer[512];
+      filenameOnly = scriptFileName;
 
    if( isEditorScript )
-      dStrcpyl(nameBuffer, sizeof(nameBuffer), dsoPath, "/", filenameOnly, ".edso", NULL);
+      dStrcpyl(nameBuffer, nameBufferSize, dsoPath, "/", filenameOnly, ".edso", NULL);
    else
-      dStrcpyl(nameBuffer, sizeof(nameBuffer), dsoPath, "/", filenameOnly, ".dso", NULL);
+      dStrcpyl(nameBuffer, nameBufferSize, dsoPath, "/", filenameOnly, ".dso", NULL);
+
+   return true;
+}
+
+DefineEngineFunction( compile, bool, ( const char* fileName, bool overrideNoDSO ), ( false ),
+   "Compile a file to bytecode.\n\n"
+   "This function will read the TorqueScript code in the specified file, compile it to internal bytecode, and, "
+   "if DSO generation is enabled or @a overrideNoDDSO is true, will store the compiled code in a .dso file "
+   "in the current DSO path mirrorring the path of @a fileName.\n\n"
+   "@param fileName Path to the file to compile to bytecode.\n"
+   "@param overrideNoDSO If true, force generation of DSOs even if the engine is compiled to not "
+      "generate write compiled code to DSO files.\n\n"
+   "@return True if the file was successfully compiled, false if not.\n\n"
+   "@note The definitions contained in the given file will not be made available and no code will actually "
+      "be executed.  Use exec() for that.\n\n"
+   "@see getDSOPath\n"
+   "@see exec\n"
+   "@ingroup Scripting" )
+{
+   Con::expandScriptFilename( scriptFilenameBuffer, sizeof( scriptFilenameBuffer ), fileName );
+
+   char nameBuffer[512];
+   if(!getCompiledScriptName(scriptFilenameBuffer, nameBuffer, sizeof(nameBuffer)))
+      return false;
    
    void *data = NULL;
    U32 dataSize = 0;
@@ -1835,6 +1845,161 @@ DefineEngineFunction( compile, bool, ( const char* fileName, bool overrideNoDSO
 
 //-----------------------------------------------------------------------------
 
+/// Loads one script for compileScripts().
+///
+/// Only reading the script, hashing it and checking the existing DSO run on
+/// the pool's threads.  The parser, the code generator and the string table
+/// are global state that isn't thread safe, so compileScripts() compiles the
+/// stale scripts one at a time on the calling thread afterwards.  Parsing and
+/// code generation are not parallelized.
+struct ScriptCompileWorkItem : public ThreadPool::WorkItem
+{
+   typedef ThreadPool::WorkItem Parent;
+
+   ThreadPool::WorkItemGroup* mGroup;
+
+   StringTableEntry mScriptFileName;
+   String mDSOFileName;
+
+   /// Source of the script if its DSO needs to be compiled.
+   char* mScript;
+
+   bool mFailed;
+
+   ScriptCompileWorkItem( ThreadPool::WorkItemGroup* group, StringTableEntry scriptFileName, const char* dsoFileName )
+      : mGroup( group ),
+        mScriptFileName( scriptFileName ),
+        mDSOFileName( dsoFileName ),
+        mScript( NULL ),
+        mFailed( false ) {}
+
+   ~ScriptCompileWorkItem()
+   {
+      delete [] mScript;
+   }
+
+   /// Return true if the DSO exists and was compiled from the given source.
+   bool isUpToDate( const char* script )
+   {
+      FileStream* stream = FileStream::createAndOpen( mDSOFileName, Torque::FS::File::Read );
+      if( !stream )
+         return false;
+
+      U32 version = 0;
+      U32 sourceHash = 0;
+      stream->read( &version );
+      stream->read( &sourceHash );
+      delete stream;
+
+      return version == Con::DSOVersion && sourceHash == CodeBlock::getSourceHash( script );
+   }
+
+protected:
+   virtual void execute()
+   {
+      void* data = NULL;
+      U32 dataSize = 0;
+      Torque::FS::ReadFile( mScriptFileName, data, dataSize, true );
+
+      char* script = static_cast< char* >( data );
+      if( !script )
+         mFailed = true;
+      else if( isUpToDate( script ) )
+         delete [] script;
+      else
+         mScript = script;
+
+      mGroup->done();
+   }
+};
+
+DefineEngineFunction( compileScripts, S32, ( const char* path, const char* pattern, bool overrideNoDSO ), ( "*.cs", false ),
+   "Compile all scripts in a directory tree to bytecode.\n\n"
+   "Only reading the scripts and checking them against their DSOs is spread across the global thread pool.  The "
+   "parser and compiler are not thread safe, so the scripts that need compiling are compiled one at a time on the "
+   "calling thread.  A tree without any DSOs takes about as long as calling compile() on each script.  Scripts "
+   "whose DSO was compiled from the current source are skipped, so running this over a tree that has been compiled "
+   "before only recompiles the scripts that changed.\n\n"
+   "@param path Directory to search for scripts.  Subdirectories are searched as well.\n"
+   "@param pattern File pattern of the scripts to compile.\n"
+   "@param overrideNoDSO If true, force generation of DSOs even if the engine is compiled to not "
+      "generate write compiled code to DSO files.\n\n"
+   "@return The number of scripts that were compiled or -1 if any of them failed to compile.\n\n"
+   "@tsexample\n"
+      "// Bring all DSOs of the game scripts up to date.\n"
+      "compileScripts( \"scripts\" );\n"
+   "@endtsexample\n\n"
+   "@see compile\n"
+   "@ingroup Scripting" )
+{
+#ifdef TORQUE_NO_DSO_GENERATION
+   if( !overrideNoDSO )
+   {
+      Con::warnf( "compileScripts: DSO generation is disabled in this build." );
+      return 0;
+   }
+#endif
+
+   char pathBuffer[1024];
+   Con::expandScriptFilename( pathBuffer, sizeof( pathBuffer ), path );
+
+   Vector< String > files;
+   Torque::FS::FindByPattern( Torque::Path( pathBuffer ), pattern, true, files );
+
+   // Work out the file names here as that goes through the console.
+   ThreadPool::WorkItemGroup group;
+   Vector< ThreadSafeRef< ScriptCompileWorkItem > > items;
+   for( U32 i = 0; i < files.size(); ++ i )
+   {
+      char nameBuffer[512];
+      if( !getCompiledScriptName( files[ i ], nameBuffer, sizeof( nameBuffer ) ) )
+         continue;
+
+      ThreadSafeRef< ScriptCompileWorkItem > item( new ScriptCompileWorkItem( &group, StringTable->insert( files[ i ] ), nameBuffer ) );
+      items.push_back( item );
+   }
+
+   const U32 start = Platform::getRealMilliseconds();
+
+   ThreadPool* pool = &ThreadPool::GLOBAL();
+   for( U32 i = 0; i < items.size(); ++ i )
+   {
+      group.add();
+      pool->queueWorkItem( items[ i ] );
+   }
+   group.wait();
+
+   // Compile the scripts whose DSOs are stale.
+
+   S32 numCompiled = 0;
+   bool failed = false;
+   for( U32 i = 0; i < items.size(); ++ i )
+   {
+      ScriptCompileWorkItem* item = items[ i ];
+      if( !item->mFailed && item->mScript )
+      {
+         CodeBlock* code = new CodeBlock();
+         item->mFailed = !code->compile( item->mDSOFileName, item->mScriptFileName, item->mScript, overrideNoDSO );
+         delete code;
+
+         if( !item->mFailed )
+            numCompiled ++;
+      }
+
+      if( item->mFailed )
+      {
+         Con::errorf( ConsoleLogEntry::Script, "compileScripts: failed to compile %s.", item->mScriptFileName );
+         failed = true;
+      }
+   }
+
+   Con::printf( "compileScripts: compiled %d of %d scripts in %dms.", numCompiled, items.size(), Platform::getRealMilliseconds() - start );
+
+   return failed ? -1 : numCompiled;
+}
+
+//-----------------------------------------------------------------------------
+
 DefineEngineFunction( exec, bool, ( const char* fileName, bool noCalls, bool journalScript ), ( false, false ),
    "Execute the given script file.\n"
    "@param fileName Path to the file to execute\n"
@@ -1968,10 +2133,10 @@ DefineEngineFunction( exec, bool, ( const char* fileName, bool noCalls, bool jou
 
    char nameBuffer[512];
    char* script = NULL;
+   U32 scriptSize = 0;
    U32 version;
 
    Stream *compiledStream = NULL;
-   Torque::Time scriptModifiedTime, dsoModifiedTime;
 
    // Check here for .edso
    bool edso = false;
@@ -1981,7 +2146,6 @@ DefineEngineFunction( exec, bool, ( const char* fileName, bool noCalls, bool jou
       dsoFile = scriptFile;
       scriptFile = NULL;
 
-      dsoModifiedTime = dsoFile->getModifiedTime();
       dStrcpy( nameBuffer, scriptFileName );
    }
 
@@ -2003,12 +2167,6 @@ DefineEngineFunction( exec, bool, ( const char* fileName, bool noCalls, bool jou
          dStrcpyl(nameBuffer, sizeof(nameBuffer), pathAndFilename, ".dso", NULL);
 
       dsoFile = Torque::FS::GetFileNode(nameBuffer);
-
-      if(scriptFile != NULL)
-         scriptModifiedTime = scriptFile->getModifiedTime();
-      
-      if(dsoFile != NULL)
-         dsoModifiedTime = dsoFile->getModifiedTime();
    }
 
    // Let's do a sanity check to complain about DSOs in the future.
@@ -2022,10 +2180,11 @@ DefineEngineFunction( exec, bool, ( const char* fileName, bool noCalls, bool jou
    //}
 
    // If we had a DSO, let's check to see if we should be reading from it.
-   //MGT: fixed bug with dsos not getting recompiled correctly
-   //Note: Using Nathan Martin's version from the forums since its easier to read and understand
-   if(compiled && dsoFile != NULL && (scriptFile == NULL|| (dsoModifiedTime >= scriptModifiedTime)))
-   { //MGT: end
+   // DSOs are matched against the hash of the source they were compiled
+   // from rather than file times, so copying or checking out a script tree
+   // neither forces a recompile nor lets a stale DSO win over newer source.
+   if(compiled && dsoFile != NULL)
+   {
       compiledStream = FileStream::createAndOpen( nameBuffer, Torque::FS::File::Read );
       if (compiledStream)
       {
@@ -2037,6 +2196,26 @@ DefineEngineFunction( exec, bool, ( const char* fileName, bool noCalls, bool jou
             delete compiledStream;
             compiledStream = NULL;
          }
+         else
+         {
+            U32 sourceHash;
+            compiledStream->read(&sourceHash);
+
+            // Without source the DSO is all we have.  Otherwise load the
+            // source now; it gets compiled below if the hash is off.
+            if(scriptFile != NULL)
+            {
+               void *data = NULL;
+               Torque::FS::ReadFile(scriptFileName, data, scriptSize, true);
+               script = (char *)data;
+
+               if(!script || CodeBlock::getSourceHash(script) != sourceHash)
+               {
+                  delete compiledStream;
+                  compiledStream = NULL;
+               }
+            }
+         }
       }
    }
 
@@ -2049,9 +2228,10 @@ DefineEngineFunction( exec, bool, ( const char* fileName, bool noCalls, bool jou
       // If we have source but no compiled version, then we need to compile
       // (and journal as we do so, if that's required).
 
-      void *data;
-      U32 dataSize = 0;
-      Torque::FS::ReadFile(scriptFileName, data, dataSize, true);
+      void *data = script;
+      U32 dataSize = scriptSize;
+      if(!data)
+         Torque::FS::ReadFile(scriptFileName, data, dataSize, true);
 
       if(journal && Journal::IsRecording())
          Journal::Write(bool(data != NULL));
@@ -2095,7 +2275,9 @@ DefineEngineFunction( exec, bool, ( const char* fileName, bool noCalls, bool jou
          compiledStream = FileStream::createAndOpen( nameBuffer, Torque::FS::File::Read );
          if(compiledStream)
          {
+            U32 sourceHash;
             compiledStream->read(&version);
+            compiledStream->read(&sourceHash);
          }
          else
          {
@@ -268,6 +268,24 @@ S32 HashPointer(StringTableEntry ptr)
 }
 
 Dictionary::Entry *Dictionary::lookup(StringTableEntry name)
+{
+   Entry *ent = lookupHashed(name);
+   if(ent)
+      return ent;
+
+   // Search the local slots from the end so that a duplicated argument
+   // name finds the last argument like the compiled code does.
+   for(U32 i = hashTable->localCount; i > 0; i--)
+   {
+      ent = hashTable->locals[i - 1];
+      if(ent && ent->name == name)
+         return ent;
+   }
+
+   return NULL;
+}
+
+Dictionary::Entry *Dictionary::lookupHashed(StringTableEntry name)
 {
    Entry *walk = hashTable->data[HashPointer(name) % hashTable->size];
    while(walk)
@@ -337,9 +355,49 @@ Dictionary::Entry *Dictionary::add(StringTableEntry name)
    return ret;
 }
 
+void Dictionary::setLocalCount(U32 count)
+{
+   AssertFatal( hashTable == &ownHashTable && !ownHashTable.localCount,
+      "Dictionary::setLocalCount - Locals must be set up on a new frame!" );
+
+   if( count > ownHashTable.localCapacity )
+   {
+      delete [] ownHashTable.locals;
+      ownHashTable.locals = new Entry *[ count ];
+      ownHashTable.localCapacity = count;
+   }
+
+   dMemset( ownHashTable.locals, 0, count * sizeof( Entry* ) );
+   ownHashTable.localCount = count;
+}
+
+Dictionary::Entry *Dictionary::createLocal(U32 slot, StringTableEntry name)
+{
+   Entry *ret = lookupHashed( name );
+   if( ret )
+      return ret;
+
+   ret = hashTable->mChunker.alloc();
+   constructInPlace( ret, name );
+   hashTable->locals[ slot ] = ret;
+
+   return ret;
+}
+
 // deleteVariables() assumes remove() is a stable remove (will not reorder entries on remove)
 void Dictionary::remove(Dictionary::Entry *ent)
 {
+   for(U32 i = 0; i < hashTable->localCount; i++)
+   {
+      if(hashTable->locals[i] == ent)
+      {
+         hashTable->locals[i] = NULL;
+         destructInPlace( ent );
+         hashTable->mChunker.free( ent );
+         return;
+      }
+   }
+
    Entry **walk = &hashTable->data[HashPointer(ent->name) % hashTable->size];
    while(*walk != ent)
       walk = &((*walk)->nextEntry);
@@ -396,6 +454,7 @@ Dictionary::~Dictionary()
    reset();
    if( ownHashTable.data )
       delete [] ownHashTable.data;
+   delete [] ownHashTable.locals;
 }
 
 void Dictionary::reset()
@@ -417,6 +476,11 @@ void Dictionary::reset()
       }
    }
 
+   for( U32 i = 0; i < ownHashTable.localCount; ++ i )
+      if( ownHashTable.locals[ i ] )
+         destructInPlace( ownHashTable.locals[ i ] );
+   ownHashTable.localCount = 0;
+
    dMemset( ownHashTable.data, 0, ownHashTable.size * sizeof( Entry* ) );
    ownHashTable.mChunker.freeBlocks( true );
    
@@ -657,6 +721,8 @@ void ExprEvalState::pushFrame(StringTableEntry frameName, Namespace *ns)
       
    newFrame.scopeName = frameName;
    newFrame.scopeNamespace = ns;
+   newFrame.code = NULL;
+   newFrame.ip = 0;
 
    mStackDepth ++;
    currentVariable = NULL;
@@ -710,6 +776,8 @@ void ExprEvalState::pushFrameRef(S32 stackIndex)
 
    Dictionary& newFrame = *( stack[ mStackDepth ] );
    newFrame.setState( this, stack[ stackIndex ] );
+   newFrame.code = NULL;
+   newFrame.ip = 0;
    
    mStackDepth ++;
    currentVariable = NULL;
@@ -444,9 +444,24 @@ public:
         S32 count;
         Entry **data;
         FreeListChunker< Entry > mChunker;
+
+        /// @name Local Variable Slots
+        ///
+        /// Locals the compiler resolved to a frame slot live here instead
+        /// of in the hash table.  The entries are created on first use and
+        /// are still found by name through lookup() so eval'd code and the
+        /// debugger see them.
+        /// @{
+
+        Entry **locals;
+        U32 localCount;
+        U32 localCapacity;
+
+        /// @}
         
         HashTableData( Dictionary* owner )
-           : owner( owner ), size( 0 ), count( 0 ), data( NULL ) {}
+           : owner( owner ), size( 0 ), count( 0 ), data( NULL ),
+             locals( NULL ), localCount( 0 ), localCapacity( 0 ) {}
     };
 
     HashTableData* hashTable;
@@ -463,6 +478,26 @@ public:
 
     Entry *lookup(StringTableEntry name);
     Entry *add(StringTableEntry name);
+
+    /// Set up the local variable slots for a function frame.
+    void setLocalCount(U32 count);
+
+    /// Return the local in the given slot or NULL if it hasn't been assigned.
+    Entry *lookupLocal(U32 slot, StringTableEntry name)
+    {
+       AssertFatal( slot < hashTable->localCount, "Dictionary::lookupLocal - Slot out of range!" );
+       Entry* ent = hashTable->locals[ slot ];
+       return ent ? ent : lookupHashed( name );
+    }
+
+    /// Return the local in the given slot, creating it if needed.
+    Entry *addLocal(U32 slot, StringTableEntry name)
+    {
+       AssertFatal( slot < hashTable->localCount, "Dictionary::addLocal - Slot out of range!" );
+       Entry* ent = hashTable->locals[ slot ];
+       return ent ? ent : createLocal( slot, name );
+    }
+
     void setState(ExprEvalState *state, Dictionary* ref=NULL);
     void remove(Entry *);
     void reset();
@@ -504,6 +539,15 @@ public:
     
     /// Run integrity checks for debugging.
     void validate();
+
+protected:
+
+    /// Look up name in the hash table, skipping the local slots.
+    Entry *lookupHashed(StringTableEntry name);
+
+    /// Create the entry for the given local slot.  If eval'd code has
+    /// already created the variable by name, that entry is returned instead.
+    Entry *createLocal(U32 slot, StringTableEntry name);
 };
 
 class ExprEvalState
@@ -536,6 +580,8 @@ public:
     
     void setCurVarName(StringTableEntry name);
     void setCurVarNameCreate(StringTableEntry name);
+    void setCurVarLocal(U32 slot, StringTableEntry name);
+    void setCurVarLocalCreate(U32 slot, StringTableEntry name);
     S32 getIntVariable();
     F64 getFloatVariable();
     const char *getStringVariable();
@@ -194,13 +194,17 @@ inline void EngineMarshallData( const T* object, S32& argc, const char** argv )
 ///
 /// This is wrapped in an a struct as partial specializations on function
 /// templates are not allowed in C++.
+///
+/// Numeric arguments may arrive from the interpreter unformatted (see
+/// Con::getNumericArg).  The numeric specializations read these directly;
+/// all others go through Con::getArgString first.
 template< typename T >
 struct EngineUnmarshallData
 {
    T operator()( const char* str ) const
    {
       T value;
-      castConsoleTypeFromString( value, str );
+      castConsoleTypeFromString( value, Con::getArgString( str ) );
       return value;
    }
 };
@@ -209,6 +213,9 @@ struct EngineUnmarshallData< S32 >
 {
    S32 operator()( const char* str ) const
    {
+      F64 value;
+      if( Con::getNumericArg( str, value ) )
+         return S32( value );
       return dAtoi( str );
    }
 };
@@ -217,6 +224,9 @@ struct EngineUnmarshallData< U32 >
 {
    U32 operator()( const char* str ) const
    {
+      F64 value;
+      if( Con::getNumericArg( str, value ) )
+         return U32( S32( value ) );
       return dAtoui( str );
    }
 };
@@ -225,15 +235,29 @@ struct EngineUnmarshallData< F32 >
 {
    F32 operator()( const char* str ) const
    {
+      F64 value;
+      if( Con::getNumericArg( str, value ) )
+         return F32( value );
       return dAtof( str );
    }
 };
 template<>
+struct EngineUnmarshallData< bool >
+{
+   bool operator()( const char* str ) const
+   {
+      F64 value;
+      if( Con::getNumericArg( str, value ) )
+         return ( value != 0 );
+      return dAtob( str );
+   }
+};
+template<>
 struct EngineUnmarshallData< const char* >
 {
    const char* operator()( const char* str ) const
    {
-      return str;
+      return Con::getArgString( str );
    }
 };
 template< typename T >
@@ -241,7 +265,7 @@ struct EngineUnmarshallData< T* >
 {
    T* operator()( const char* str ) const
    {
-      return dynamic_cast< T* >( Sim::findObject( str ) );
+      return dynamic_cast< T* >( Sim::findObject( Con::getArgString( str ) ) );
    }
 };
 template<>
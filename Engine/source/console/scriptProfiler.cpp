@@ -0,0 +1,351 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "console/scriptProfiler.h"
+
+#include "console/codeBlock.h"
+#include "console/consoleInternal.h"
+#include "console/engineAPI.h"
+#include "core/stream/fileStream.h"
+#include "core/util/tDictionary.h"
+#include "core/util/tVector.h"
+#include "platform/threads/thread.h"
+
+
+bool ScriptProfiler::smEnabled = false;
+volatile bool ScriptProfiler::smSamplePending = false;
+volatile S32 ScriptProfiler::smExecDepth = 0;
+
+typedef CompoundKey< Namespace*, StringTableEntry > ScriptProfilerKey;
+
+struct ScriptProfilerFunction
+{
+   String mName;
+   U32 mCalls;
+   U32 mInclusiveSamples;
+   U32 mExclusiveSamples;
+
+   /// Index of the last sample counted in mInclusiveSamples so recursive
+   /// functions are only counted once per sample.
+   U32 mLastSample;
+};
+
+/// Requests a sample from the interpreter at a fixed interval.
+class ScriptProfilerThread : public Thread
+{
+public:
+   U32 mIntervalMs;
+
+   ScriptProfilerThread( U32 intervalMs )
+      : mIntervalMs( intervalMs ) {}
+
+   virtual void run( void* arg = 0 )
+   {
+      while( !checkForStop() )
+      {
+         Platform::sleep( mIntervalMs );
+         if( ScriptProfiler::smExecDepth > 0 )
+            ScriptProfiler::smSamplePending = true;
+      }
+   }
+};
+
+static ScriptProfilerThread* sThread = NULL;
+static U32 sIntervalMs = 1;
+static bool sLineNumbers = false;
+static U32 sSampleCount = 0;
+static HashTable< ScriptProfilerKey, ScriptProfilerFunction > sFunctions;
+static HashTable< String, U32 > sLines;
+static HashTable< String, U32 > sStacks;
+
+//-----------------------------------------------------------------------------
+
+static ScriptProfilerFunction& findFunction( Namespace* ns, StringTableEntry fnName, CodeBlock* code )
+{
+   // Code outside of functions is keyed by its file.
+   if( !fnName )
+      fnName = code && code->name ? code->name : StringTable->insert( "<input>" );
+
+   HashTable< ScriptProfilerKey, ScriptProfilerFunction >::Iterator iter = sFunctions.find( ScriptProfilerKey( ns, fnName ) );
+   if( iter != sFunctions.end() )
+      return iter->value;
+
+   ScriptProfilerFunction function;
+   if( ns && ns->mName )
+      function.mName = String::ToString( "%s::%s", ns->mName, fnName );
+   else
+      function.mName = fnName;
+   function.mCalls = 0;
+   function.mInclusiveSamples = 0;
+   function.mExclusiveSamples = 0;
+   function.mLastSample = 0;
+
+   return sFunctions.insertUnique( ScriptProfilerKey( ns, fnName ), function )->value;
+}
+
+static void appendFrame( char* buffer, U32 bufferSize, U32& length, const char* frame )
+{
+   if( length && length + 1 < bufferSize )
+      buffer[ length ++ ] = ';';
+
+   while( *frame && length + 1 < bufferSize )
+   {
+      // ';' separates frames and the last space separates the sample count.
+      const char c = *frame ++;
+      buffer[ length ++ ] = ( c == ';' ) ? ':' : c;
+   }
+   buffer[ length ] = 0;
+}
+
+//-----------------------------------------------------------------------------
+
+void ScriptProfiler::enable( bool enable, U32 intervalMs, bool lineNumbers )
+{
+   if( sThread )
+   {
+      sThread->stop();
+      sThread->join();
+      SAFE_DELETE( sThread );
+   }
+
+   smEnabled = enable;
+   smSamplePending = false;
+
+   if( !enable )
+      return;
+
+   sIntervalMs = getMax( intervalMs, U32( 1 ) );
+   sLineNumbers = lineNumbers;
+
+   sThread = new ScriptProfilerThread( sIntervalMs );
+   sThread->start();
+}
+
+void ScriptProfiler::reset()
+{
+   sFunctions.clear();
+   sLines.clear();
+   sStacks.clear();
+   sSampleCount = 0;
+}
+
+void ScriptProfiler::countCall( Namespace* ns, StringTableEntry fnName )
+{
+   findFunction( ns, fnName, NULL ).mCalls ++;
+}
+
+void ScriptProfiler::takeSample( CodeBlock* code, U32 ip, Namespace* nativeNs, StringTableEntry nativeFn )
+{
+   smSamplePending = false;
+   if( !smEnabled )
+      return;
+
+   sSampleCount ++;
+
+   char stack[ 4096 ];
+   U32 stackLength = 0;
+   stack[ 0 ] = 0;
+
+   char frameName[ 1024 ];
+   ScriptProfilerFunction* innermost = NULL;
+   CodeBlock* innermostCode = NULL;
+   U32 innermostLine = 0;
+
+   const S32 depth = gEvalState.getStackDepth();
+   for( S32 i = 0; i < depth; ++ i )
+   {
+      const Dictionary* frame = gEvalState.stack[ i ];
+
+      // Outer frames remember where they made their call.
+      CodeBlock* frameCode = ( i == depth - 1 ) ? code : frame->code;
+      const U32 frameIp = ( i == depth - 1 ) ? ip : frame->ip;
+
+      ScriptProfilerFunction& function = findFunction( frame->scopeNamespace, frame->scopeName, frameCode );
+      if( function.mLastSample != sSampleCount )
+      {
+         function.mLastSample = sSampleCount;
+         function.mInclusiveSamples ++;
+      }
+      innermost = &function;
+
+      U32 line = 0;
+      if( frameCode )
+      {
+         U32 instruction;
+         frameCode->findBreakLine( frameIp, line, instruction );
+      }
+      innermostCode = frameCode;
+      innermostLine = line;
+
+      if( sLineNumbers && frameCode && frameCode->name )
+      {
+         dSprintf( frameName, sizeof( frameName ), "%s (%s:%d)", function.mName.c_str(), frameCode->name, line );
+         appendFrame( stack, sizeof( stack ), stackLength, frameName );
+      }
+      else
+         appendFrame( stack, sizeof( stack ), stackLength, function.mName.c_str() );
+   }
+
+   // Time spent in an engine function is its own, not its caller's.
+   if( nativeFn )
+   {
+      ScriptProfilerFunction& function = findFunction( nativeNs, nativeFn, NULL );
+      function.mInclusiveSamples ++;
+      function.mLastSample = sSampleCount;
+      innermost = &function;
+      appendFrame( stack, sizeof( stack ), stackLength, function.mName.c_str() );
+   }
+
+   if( innermost )
+      innermost->mExclusiveSamples ++;
+
+   if( sLineNumbers && innermostCode && innermostCode->name )
+      sLines.findOrInsert( String::ToString( "%s:%d", innermostCode->name, innermostLine ) )->value ++;
+
+   if( stackLength )
+      sStacks.findOrInsert( String( stack ) )->value ++;
+}
+
+//-----------------------------------------------------------------------------
+
+static S32 QSORT_CALLBACK compareFunctions( const void* a, const void* b )
+{
+   const ScriptProfilerFunction* fa = *( const ScriptProfilerFunction** ) a;
+   const ScriptProfilerFunction* fb = *( const ScriptProfilerFunction** ) b;
+
+   if( fa->mExclusiveSamples != fb->mExclusiveSamples )
+      return fa->mExclusiveSamples > fb->mExclusiveSamples ? -1 : 1;
+   if( fa->mInclusiveSamples != fb->mInclusiveSamples )
+      return fa->mInclusiveSamples > fb->mInclusiveSamples ? -1 : 1;
+   return fa->mCalls > fb->mCalls ? -1 : ( fa->mCalls < fb->mCalls ? 1 : 0 );
+}
+
+static S32 QSORT_CALLBACK compareLines( const void* a, const void* b )
+{
+   const HashTable< String, U32 >::Pair* la = *( const HashTable< String, U32 >::Pair** ) a;
+   const HashTable< String, U32 >::Pair* lb = *( const HashTable< String, U32 >::Pair** ) b;
+   return la->value > lb->value ? -1 : ( la->value < lb->value ? 1 : 0 );
+}
+
+void ScriptProfiler::dumpToConsole()
+{
+   Vector< ScriptProfilerFunction* > functions;
+   for( HashTable< ScriptProfilerKey, ScriptProfilerFunction >::Iterator iter = sFunctions.begin(); iter != sFunctions.end(); ++ iter )
+      functions.push_back( &iter->value );
+   dQsort( functions.address(), functions.size(), sizeof( ScriptProfilerFunction* ), compareFunctions );
+
+   const F32 total = getMax( sSampleCount, U32( 1 ) );
+
+   Con::printf( "Script profile: %d samples, %dms interval", sSampleCount, sIntervalMs );
+   Con::printf( "%%Excl  %%Incl   Excl ms   Incl ms     Calls  Function" );
+   for( U32 i = 0; i < functions.size(); ++ i )
+   {
+      const ScriptProfilerFunction* function = functions[ i ];
+      Con::printf( "%5.1f %6.1f %9d %9d %9d  %s",
+         100.0f * function->mExclusiveSamples / total,
+         100.0f * function->mInclusiveSamples / total,
+         function->mExclusiveSamples * sIntervalMs,
+         function->mInclusiveSamples * sIntervalMs,
+         function->mCalls,
+         function->mName.c_str() );
+   }
+
+   if( !sLineNumbers )
+      return;
+
+   Vector< HashTable< String, U32 >::Pair* > lines;
+   for( HashTable< String, U32 >::Iterator iter = sLines.begin(); iter != sLines.end(); ++ iter )
+      lines.push_back( &( *iter ) );
+   dQsort( lines.address(), lines.size(), sizeof( HashTable< String, U32 >::Pair* ), compareLines );
+
+   Con::printf( "" );
+   Con::printf( "%%Excl   Excl ms  Line" );
+   for( U32 i = 0; i < lines.size(); ++ i )
+      Con::printf( "%5.1f %9d  %s", 100.0f * lines[ i ]->value / total, lines[ i ]->value * sIntervalMs, lines[ i ]->key.c_str() );
+}
+
+bool ScriptProfiler::dumpToFile( const char* fileName )
+{
+   FileStream stream;
+   if( !stream.open( fileName, Torque::FS::File::Write ) )
+   {
+      Con::errorf( "ScriptProfiler::dumpToFile - cannot open '%s' for writing", fileName );
+      return false;
+   }
+
+   char buffer[ 32 ];
+   for( HashTable< String, U32 >::Iterator iter = sStacks.begin(); iter != sStacks.end(); ++ iter )
+   {
+      stream.write( iter->key.length(), iter->key.c_str() );
+      dSprintf( buffer, sizeof( buffer ), " %d\n", iter->value );
+      stream.write( dStrlen( buffer ), buffer );
+   }
+
+   stream.close();
+   return true;
+}
+
+//=============================================================================
+//    Console Functions.
+//=============================================================================
+// MARK: ---- Console Functions ----
+
+//-----------------------------------------------------------------------------
+
+DefineEngineFunction( scriptProfilerEnable, void, ( bool enable, S32 sampleInterval, bool lineNumbers ), ( 1, false ),
+   "@brief Enables or disables the script profiler.\n\n"
+   "While enabled, the script call stack is sampled at a fixed interval and the samples are attributed "
+   "to the script functions on the stack.  Calls to script functions are counted.\n\n"
+   "@param enable Whether to run the profiler.\n"
+   "@param sampleInterval Milliseconds between samples.\n"
+   "@param lineNumbers If true, samples are also attributed to source lines.\n\n"
+   "@ingroup Debugging" )
+{
+   ScriptProfiler::enable( enable, getMax( sampleInterval, 1 ), lineNumbers );
+}
+
+DefineEngineFunction( scriptProfilerDump, void, (),,
+   "@brief Dumps the functions (and lines) the script profiler found most time in to the console.\n\n"
+   "@ingroup Debugging" )
+{
+   ScriptProfiler::dumpToConsole();
+}
+
+DefineEngineFunction( scriptProfilerDumpToFile, bool, ( const char* fileName ),,
+   "@brief Writes all call stacks sampled by the script profiler to a file.\n\n"
+   "The file is in the folded stack format used by flamegraph.pl.\n\n"
+   "@param fileName Name and path of the file to write.\n"
+   "@return True if the file was written.\n\n"
+   "@tsexample\n"
+   "scriptProfilerDumpToFile( \"script.folded\" );\n"
+   "@endtsexample\n\n"
+   "@ingroup Debugging" )
+{
+   return ScriptProfiler::dumpToFile( fileName );
+}
+
+DefineEngineFunction( scriptProfilerReset, void, (),,
+   "@brief Resets the script profiler, clearing it of all its data.\n\n"
+   "@ingroup Debugging" )
+{
+   ScriptProfiler::reset();
+}
@@ -0,0 +1,98 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SCRIPTPROFILER_H_
+#define _SCRIPTPROFILER_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+
+class CodeBlock;
+class Namespace;
+
+/// Sampling profiler for TorqueScript.
+///
+/// The C++ Profiler only sees CodeBlock::exec; this one looks inside it.  While
+/// enabled, a background thread requests a sample every few milliseconds and
+/// the interpreter takes it at its next poll point (function entry, loop back
+/// edge, or return from an engine function) by walking the script call stack.
+/// Each sample is attributed to every function on the stack (inclusive) and
+/// to the innermost one (exclusive), and optionally to the source line being
+/// executed.  Calls to script functions are counted exactly.
+///
+/// No high resolution timer is needed, so the profiler is cheap enough to
+/// run on production servers.  Times reported are sample counts multiplied
+/// by the sample interval.
+///
+/// From script:
+/// @code
+/// scriptProfilerEnable( true, 1, true );   // 1ms interval, attribute lines
+/// ...
+/// scriptProfilerDump();                    // hottest functions to the console
+/// scriptProfilerDumpToFile( "script.folded" );
+/// scriptProfilerReset();
+/// @endcode
+///
+/// The file is written in the folded stack format read by flamegraph.pl:
+/// one line per distinct call stack, frames separated by ';', followed by
+/// the number of samples taken in that stack.
+class ScriptProfiler
+{
+public:
+
+   /// True while the profiler is running.
+   static bool smEnabled;
+
+   /// Set by the sampler thread when a sample is due.
+   static volatile bool smSamplePending;
+
+   /// Number of CodeBlock::exec calls on the stack.  The sampler thread only
+   /// requests samples while script is running.
+   static volatile S32 smExecDepth;
+
+   /// Start or stop the profiler.
+   ///
+   /// @param intervalMs   Milliseconds between samples.
+   /// @param lineNumbers  Attribute samples to source lines as well.
+   static void enable( bool enable, U32 intervalMs = 1, bool lineNumbers = false );
+
+   /// Throw away all gathered data.
+   static void reset();
+
+   /// Print the hottest functions and lines to the console.
+   static void dumpToConsole();
+
+   /// Write all sampled stacks to the given file in folded stack format.
+   static bool dumpToFile( const char* fileName );
+
+   /// Count a call to a script function.
+   static void countCall( Namespace* ns, StringTableEntry fnName );
+
+   /// Record the script call stack.  @a code and @a ip give the position in
+   /// the innermost frame.  If the sample is taken right after an engine
+   /// function returned, @a nativeNs and @a nativeFn name it so it shows up
+   /// as a leaf of the stack.
+   static void takeSample( CodeBlock* code, U32 ip, Namespace* nativeNs = NULL, StringTableEntry nativeFn = NULL );
+};
+
+#endif // _SCRIPTPROFILER_H_
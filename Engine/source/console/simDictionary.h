@@ -32,56 +32,305 @@
 #ifndef _PLATFORMMUTEX_H_
 #include "platform/threads/mutex.h"
 #endif
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+#ifndef _PLATFORMINTRINSICS_H_
+#include "platform/platformIntrinsics.h"
+#endif
 
 class SimObject;
 
+extern S32 HashPointer(StringTableEntry e);
+
 //----------------------------------------------------------------------------
-/// Map of names to SimObjects
+/// Open addressing hash table from keys to SimObjects.
 ///
-/// Provides fast lookup for name->object and
-/// for fast removal of an object given object*
-class SimNameDictionary
+/// Keys are stored next to the object pointers so a lookup probes one flat
+/// array without touching the objects.  The table is a power of two in size,
+/// uses linear probing, doubles once it is half full, and removes entries by
+/// shifting the entries after them back so no tombstones are left behind.
+/// Objects sharing a key are found newest first.
+///
+/// With TORQUE_MULTITHREAD, changes are serialized on a mutex while lookups
+/// take no lock.  Writers bump a version counter before and after every
+/// change and lookups retry if it moved under them.  Tables replaced when
+/// growing are only freed with the dictionary so a lookup running during a
+/// resize never reads freed memory.
+template< typename Key >
+class SimObjectTable
 {
+public:
+
+   struct Entry
+   {
+      Key key;
+      SimObject* object;
+   };
+
+   SimObjectTable();
+   ~SimObjectTable();
+
+   /// Return the object most recently inserted under the given key.
+   SimObject* find( Key key );
+
+   void insert( Key key, SimObject* object );
+   void remove( Key key, SimObject* object );
+
+   /// Number of objects in the table.
+   U32 size() const { return mCount; }
+
+protected:
+
    enum
    {
-      DefaultTableSize = 29
+      MinTableShift = 4
    };
 
-   SimObject **hashTable;  // hash the pointers of the names...
-   S32 hashTableSize;
-   S32 hashEntryCount;
+   struct Table
+   {
+      U32 shift;
+      U32 mask;
+      Entry entries[ 1 ];
+   };
 
-   void *mutex;
+   Table* volatile mTable;
+   U32 mCount;
+   volatile U32 mVersion;
+   void* mMutex;
+   Vector< Table* > mRetiredTables;
 
-public:
-   void insert(SimObject* obj);
-   void remove(SimObject* obj);
-   SimObject* find(StringTableEntry name);
+   static U32 hash( U32 id ) { return id; }
+   static U32 hash( StringTableEntry name ) { return HashPointer( name ); }
+
+   /// Fibonacci hashing; spreads sequential ids and pointers over the table.
+   static U32 getIndex( const Table* table, Key key )
+   {
+      return ( hash( key ) * 2654435769U ) >> table->shift;
+   }
 
-   SimNameDictionary();
-   ~SimNameDictionary();
+   static Table* createTable( U32 shift );
+
+   SimObject* _find( Key key ) const;
+   void _insert( Table* table, Key key, SimObject* object );
+   void _append( Table* table, Key key, SimObject* object );
+   void _grow();
+
+   void _beginWrite()
+   {
+      Mutex::lockMutex( mMutex );
+      #ifdef TORQUE_MULTITHREAD
+      dFetchAndAdd( mVersion, 1 );
+      #endif
+   }
+
+   void _endWrite()
+   {
+      #ifdef TORQUE_MULTITHREAD
+      dFetchAndAdd( mVersion, 1 );
+      #endif
+      Mutex::unlockMutex( mMutex );
+   }
 };
 
-class SimManagerNameDictionary
+template< typename Key >
+SimObjectTable< Key >::SimObjectTable()
+   : mTable( NULL ),
+     mCount( 0 ),
+     mVersion( 0 )
 {
-   enum
+   mMutex = Mutex::createMutex();
+}
+
+template< typename Key >
+SimObjectTable< Key >::~SimObjectTable()
+{
+   dFree( mTable );
+   for( U32 i = 0; i < mRetiredTables.size(); ++ i )
+      dFree( mRetiredTables[ i ] );
+   Mutex::destroyMutex( mMutex );
+}
+
+template< typename Key >
+typename SimObjectTable< Key >::Table* SimObjectTable< Key >::createTable( U32 shift )
+{
+   const U32 size = 1 << ( 32 - shift );
+   Table* table = ( Table* ) dMalloc( sizeof( Table ) + sizeof( Entry ) * ( size - 1 ) );
+   table->shift = shift;
+   table->mask = size - 1;
+   dMemset( table->entries, 0, sizeof( Entry ) * size );
+   return table;
+}
+
+template< typename Key >
+inline SimObject* SimObjectTable< Key >::_find( Key key ) const
+{
+   const Table* table = mTable;
+   if( !table )
+      return NULL;
+
+   for( U32 index = getIndex( table, key ); table->entries[ index ].object; index = ( index + 1 ) & table->mask )
+      if( table->entries[ index ].key == key )
+         return table->entries[ index ].object;
+
+   return NULL;
+}
+
+template< typename Key >
+inline SimObject* SimObjectTable< Key >::find( Key key )
+{
+   #ifdef TORQUE_MULTITHREAD
+   for( ;; )
    {
-      DefaultTableSize = 29
-   };
+      const U32 version = dAtomicRead( mVersion );
+      if( version & 1 )
+         continue;
+
+      SimObject* object = _find( key );
+      if( dAtomicRead( mVersion ) == version )
+         return object;
+   }
+   #else
+   return _find( key );
+   #endif
+}
 
-   SimObject **hashTable;  // hash the pointers of the names...
-   S32 hashTableSize;
-   S32 hashEntryCount;
+template< typename Key >
+void SimObjectTable< Key >::_insert( Table* table, Key key, SimObject* object )
+{
+   U32 index = getIndex( table, key );
+   while( table->entries[ index ].object )
+   {
+      // Newer objects go in front of older ones with the same key.
+      Entry& entry = table->entries[ index ];
+      if( entry.key == key )
+      {
+         SimObject* older = entry.object;
+         entry.object = object;
+         object = older;
+      }
+      index = ( index + 1 ) & table->mask;
+   }
+
+   table->entries[ index ].key = key;
+   table->entries[ index ].object = object;
+}
+
+template< typename Key >
+void SimObjectTable< Key >::_append( Table* table, Key key, SimObject* object )
+{
+   U32 index = getIndex( table, key );
+   while( table->entries[ index ].object )
+      index = ( index + 1 ) & table->mask;
+
+   table->entries[ index ].key = key;
+   table->entries[ index ].object = object;
+}
+
+template< typename Key >
+void SimObjectTable< Key >::_grow()
+{
+   Table* oldTable = mTable;
+   Table* newTable = createTable( oldTable ? oldTable->shift - 1 : 32 - MinTableShift );
+
+   // Move entries over.  Walking the old table from the start of a cluster
+   // and appending keeps objects with the same key in the same order.
+   if( oldTable )
+   {
+      U32 start = 0;
+      while( oldTable->entries[ start ].object )
+         ++ start;
+
+      for( U32 i = 0; i <= oldTable->mask; ++ i )
+      {
+         const Entry& entry = oldTable->entries[ ( start + i ) & oldTable->mask ];
+         if( entry.object )
+            _append( newTable, entry.key, entry.object );
+      }
+   }
+
+   mTable = newTable;
+
+   #ifdef TORQUE_MULTITHREAD
+   if( oldTable )
+      mRetiredTables.push_back( oldTable );
+   #else
+   dFree( oldTable );
+   #endif
+}
+
+template< typename Key >
+void SimObjectTable< Key >::insert( Key key, SimObject* object )
+{
+   _beginWrite();
+
+   if( !mTable || ( mCount + 1 ) * 2 > mTable->mask + 1 )
+      _grow();
+
+   _insert( mTable, key, object );
+   mCount ++;
+
+   _endWrite();
+}
+
+template< typename Key >
+void SimObjectTable< Key >::remove( Key key, SimObject* object )
+{
+   _beginWrite();
+
+   Table* table = mTable;
+   if( table )
+   {
+      U32 index = getIndex( table, key );
+      while( table->entries[ index ].object && table->entries[ index ].object != object )
+         index = ( index + 1 ) & table->mask;
+
+      if( table->entries[ index ].object )
+      {
+         // Shift back the entries after the hole that may move into it.
+         U32 hole = index;
+         for( U32 next = ( hole + 1 ) & table->mask; table->entries[ next ].object; next = ( next + 1 ) & table->mask )
+         {
+            const U32 home = getIndex( table, table->entries[ next ].key );
+            const bool stays = ( hole <= next ) ? ( hole < home && home <= next ) : ( hole < home || home <= next );
+            if( !stays )
+            {
+               table->entries[ hole ] = table->entries[ next ];
+               hole = next;
+            }
+         }
 
-   void *mutex;
+         table->entries[ hole ].object = NULL;
+         mCount --;
+      }
+   }
+
+   _endWrite();
+}
+
+//----------------------------------------------------------------------------
+/// Map of names to SimObjects
+///
+/// Provides fast lookup for name->object and
+/// for fast removal of an object given object*
+class SimNameDictionary
+{
+   SimObjectTable< StringTableEntry > mTable;
 
 public:
    void insert(SimObject* obj);
    void remove(SimObject* obj);
    SimObject* find(StringTableEntry name);
+};
+
+class SimManagerNameDictionary
+{
+   SimObjectTable< StringTableEntry > mTable;
 
-   SimManagerNameDictionary();
-   ~SimManagerNameDictionary();
+public:
+   void insert(SimObject* obj);
+   void remove(SimObject* obj);
+   SimObject* find(StringTableEntry name);
 };
 
 //----------------------------------------------------------------------------
@@ -91,22 +340,12 @@ public:
 /// for fast removal of an object given object*
 class SimIdDictionary
 {
-   enum
-   {
-      DefaultTableSize = 4096,
-      TableBitMask = 4095
-   };
-   SimObject *table[DefaultTableSize];
-
-   void *mutex;
+   SimObjectTable< U32 > mTable;
 
 public:
    void insert(SimObject* obj);
    void remove(SimObject* obj);
    SimObject* find(S32 id);
-
-   SimIdDictionary();
-   ~SimIdDictionary();
 };
 
 #endif //_SIMDICTIONARY_H_
@@ -54,7 +54,7 @@ class Semaphore;
 class SimEvent
 {
 public:
-   SimEvent *nextEvent;     ///< Linked list details - pointer to next item in the list.
+   U32 heapIndex;           ///< Position in the event queue heap.
    SimTime startTime;       ///< When the event was posted.
    SimTime time;            ///< When the event is scheduled to occur.
    U32 sequenceCount;       ///< Unique ID. These are assigned sequentially based on order
@@ -28,74 +28,238 @@
 #include "console/consoleInternal.h"
 #include "core/frameAllocator.h"
 
-SimFieldDictionary::Entry *SimFieldDictionary::smFreeList = NULL;
+static FreeListChunker<SimFieldDictionary::Entry> fieldChunker;
 
-static Chunker<SimFieldDictionary::Entry> fieldChunker;
+//------------------------------------------------------------------------------
+// Value storage.  Values up to MaxPooledValueSize bytes are rounded up to a
+// power of two and come from per size free lists; larger ones are allocated
+// directly.
 
-U32 SimFieldDictionary::getHashValue( StringTableEntry slotName )
+enum
 {
-   return HashPointer( slotName ) % HashTableSize;
-}
+   MinPooledValueSize = 16,
+   MaxPooledValueSize = 128,
+};
 
-U32 SimFieldDictionary::getHashValue( const String& fieldName )
+static FreeListChunkerUntyped valueChunker16( 16 );
+static FreeListChunkerUntyped valueChunker32( 32 );
+static FreeListChunkerUntyped valueChunker64( 64 );
+static FreeListChunkerUntyped valueChunker128( 128 );
+
+static FreeListChunkerUntyped* getValueChunker( U32 size )
 {
-   return getHashValue( StringTable->insert( fieldName ) );
+   switch( size )
+   {
+      case 16:    return &valueChunker16;
+      case 32:    return &valueChunker32;
+      case 64:    return &valueChunker64;
+      default:    return &valueChunker128;
+   }
 }
 
-SimFieldDictionary::Entry *SimFieldDictionary::addEntry( U32 bucket, StringTableEntry slotName, ConsoleBaseType* type, char* value )
+void SimFieldDictionary::setEntryValue( Entry *entry, const char *value )
 {
-   Entry* ret;
-   if(smFreeList)
+   const U32 length = dStrlen( value ) + 1;
+
+   // Reuse the buffer we have unless it is too small or a large buffer
+   // would be mostly wasted.
+   if( length > entry->valueSize || ( entry->valueSize > MaxPooledValueSize && length <= entry->valueSize / 4 ) )
    {
-      ret = smFreeList;
-      smFreeList = ret->next;
+      freeEntryValue( entry );
+
+      if( length <= MaxPooledValueSize )
+      {
+         entry->valueSize = getMax( getNextPow2( length ), U32( MinPooledValueSize ) );
+         entry->value = ( char* ) getValueChunker( entry->valueSize )->alloc();
+      }
+      else
+      {
+         entry->valueSize = length;
+         entry->value = ( char* ) dMalloc( length );
+      }
    }
+
+   dMemcpy( entry->value, value, length );
+}
+
+void SimFieldDictionary::freeEntryValue( Entry *entry )
+{
+   if( !entry->value )
+      return;
+
+   if( entry->valueSize <= MaxPooledValueSize )
+      getValueChunker( entry->valueSize )->free( entry->value );
    else
-      ret = fieldChunker.alloc();
+      dFree( entry->value );
 
-   ret->next      = mHashTable[ bucket ];
+   entry->value = NULL;
+   entry->valueSize = 0;
+}
+
+//------------------------------------------------------------------------------
+
+SimFieldDictionary::Entry *SimFieldDictionary::allocEntry()
+{
+   Entry *entry = fieldChunker.alloc();
+   entry->value = NULL;
+   entry->valueSize = 0;
+   entry->type = NULL;
+   return entry;
+}
+
+void SimFieldDictionary::freeEntry(SimFieldDictionary::Entry *entry)
+{
+   freeEntryValue( entry );
+   fieldChunker.free( entry );
+}
+
+SimFieldDictionary::Entry *SimFieldDictionary::addEntry( StringTableEntry slotName, ConsoleBaseType* type, const char* value )
+{
+   Entry* ret = allocEntry();
    ret->slotName  = slotName;
    ret->type      = type;
-   ret->value     = value;
+   if( value )
+      setEntryValue( ret, value );
+
+   if( mNumFields == mSlotCapacity )
+   {
+      const U32 newCapacity = mSlotCapacity * 2;
+      if( mSlots == mInlineSlots )
+      {
+         mSlots = ( Slot* ) dMalloc( sizeof( Slot ) * newCapacity );
+         dMemcpy( mSlots, mInlineSlots, sizeof( mInlineSlots ) );
+      }
+      else
+         mSlots = ( Slot* ) dRealloc( mSlots, sizeof( Slot ) * newCapacity );
 
-   mHashTable[ bucket ] = ret;
+      mSlotCapacity = newCapacity;
+   }
+
+   mSlots[ mNumFields ].slotName = slotName;
+   mSlots[ mNumFields ].entry = ret;
    mNumFields ++;
    mVersion ++;
 
+   if( mIndex && mNumFields * 2 <= ( U32( 1 ) << ( 32 - mIndexShift ) ) )
+      insertIndex( mNumFields - 1 );
+   else if( mIndex || mNumFields > LinearSearchLimit )
+      buildIndex();
+
    return ret;
 }
 
-void SimFieldDictionary::freeEntry(SimFieldDictionary::Entry *ent)
+void SimFieldDictionary::removeEntry( U32 slot )
 {
-   ent->next = smFreeList;
-   smFreeList = ent;
+   const U32 last = mNumFields - 1;
 
+   if( mIndex )
+   {
+      // Take the entry out of the index, shifting back the entries after
+      // it that would otherwise no longer be found.
+      const U32 mask = ( U32( 1 ) << ( 32 - mIndexShift ) ) - 1;
+      U32 hole = getIndexPosition( mSlots[ slot ].slotName );
+      while( mIndex[ hole ] != slot + 1 )
+         hole = ( hole + 1 ) & mask;
+
+      for( U32 next = ( hole + 1 ) & mask; mIndex[ next ]; next = ( next + 1 ) & mask )
+      {
+         const U32 home = getIndexPosition( mSlots[ mIndex[ next ] - 1 ].slotName );
+         const bool stays = ( hole <= next ) ? ( hole < home && home <= next ) : ( hole < home || home <= next );
+         if( !stays )
+         {
+            mIndex[ hole ] = mIndex[ next ];
+            hole = next;
+         }
+      }
+      mIndex[ hole ] = 0;
+
+      // The last slot moves into the freed one.
+      if( slot != last )
+      {
+         U32 position = getIndexPosition( mSlots[ last ].slotName );
+         while( mIndex[ position ] != last + 1 )
+            position = ( position + 1 ) & mask;
+         mIndex[ position ] = slot + 1;
+      }
+   }
+
+   freeEntry( mSlots[ slot ].entry );
+   mSlots[ slot ] = mSlots[ last ];
    mNumFields --;
+   mVersion ++;
 }
 
-SimFieldDictionary::SimFieldDictionary()
-:  mNumFields( 0 ),
-   mVersion( 0 )
+U32 SimFieldDictionary::getIndexPosition( StringTableEntry slotName ) const
 {
-   dMemset( mHashTable, 0, sizeof( mHashTable ) );
+   return ( U32( HashPointer( slotName ) ) * 2654435769U ) >> mIndexShift;
 }
 
-SimFieldDictionary::~SimFieldDictionary()
+void SimFieldDictionary::insertIndex( U32 slot )
+{
+   const U32 mask = ( U32( 1 ) << ( 32 - mIndexShift ) ) - 1;
+   U32 position = getIndexPosition( mSlots[ slot ].slotName );
+   while( mIndex[ position ] )
+      position = ( position + 1 ) & mask;
+   mIndex[ position ] = slot + 1;
+}
+
+void SimFieldDictionary::buildIndex()
 {
-   for(U32 i = 0; i < HashTableSize; i++)
+   // Size the index to at most half full.
+   U32 shift = 32 - 4;
+   while( ( U32( 1 ) << ( 32 - shift ) ) < mNumFields * 2 )
+      shift --;
+
+   const U32 size = U32( 1 ) << ( 32 - shift );
+   mIndex = ( U32* ) dRealloc( mIndex, sizeof( U32 ) * size );
+   mIndexShift = shift;
+   dMemset( mIndex, 0, sizeof( U32 ) * size );
+
+   for( U32 i = 0; i < mNumFields; ++ i )
+      insertIndex( i );
+}
+
+S32 SimFieldDictionary::findSlot( StringTableEntry slotName ) const
+{
+   if( mIndex )
    {
-      for(Entry *walk = mHashTable[i]; walk;)
+      const U32 mask = ( U32( 1 ) << ( 32 - mIndexShift ) ) - 1;
+      for( U32 position = getIndexPosition( slotName ); mIndex[ position ]; position = ( position + 1 ) & mask )
       {
-         Entry *temp = walk;
-         walk = temp->next;
-
-         if( temp->value )
-            dFree(temp->value);
-         freeEntry(temp);
+         const U32 slot = mIndex[ position ] - 1;
+         if( mSlots[ slot ].slotName == slotName )
+            return slot;
       }
    }
+   else
+   {
+      for( U32 i = 0; i < mNumFields; ++ i )
+         if( mSlots[ i ].slotName == slotName )
+            return i;
+   }
+
+   return -1;
+}
+
+SimFieldDictionary::SimFieldDictionary()
+:  mSlots( mInlineSlots ),
+   mSlotCapacity( InlineSlots ),
+   mIndex( NULL ),
+   mIndexShift( 0 ),
+   mNumFields( 0 ),
+   mVersion( 0 )
+{
+}
+
+SimFieldDictionary::~SimFieldDictionary()
+{
+   for( U32 i = 0; i < mNumFields; ++ i )
+      freeEntry( mSlots[ i ].entry );
 
-   AssertFatal( mNumFields == 0, "Incorrect count on field dictionary" );
+   if( mSlots != mInlineSlots )
+      dFree( mSlots );
+   if( mIndex )
+      dFree( mIndex );
 }
 
 void SimFieldDictionary::setFieldType(StringTableEntry slotName, const char *typeString)
@@ -113,57 +277,43 @@ void SimFieldDictionary::setFieldType(StringTableEntry slotName, const U32 typeI
 void SimFieldDictionary::setFieldType(StringTableEntry slotName, ConsoleBaseType *type)
 {
    // If the field exists on the object, set the type
-   U32 bucket = getHashValue( slotName );
-
-   for( Entry *walk = mHashTable[bucket]; walk; walk = walk->next )
+   S32 slot = findSlot( slotName );
+   if( slot != -1 )
    {
-      if( walk->slotName == slotName )
-      {
-         // Found and type assigned, let's bail
-         walk->type = type;
-         return;
-      }
+      // Found and type assigned, let's bail
+      mSlots[ slot ].entry->type = type;
+      return;
    }
 
    // Otherwise create the field, and set the type. Assign a null value.
-   addEntry( bucket, slotName, type );
+   addEntry( slotName, type );
 }
 
 U32 SimFieldDictionary::getFieldType(StringTableEntry slotName) const
 {
-   U32 bucket = getHashValue( slotName );
-
-   for( Entry *walk = mHashTable[bucket]; walk; walk = walk->next )
-      if( walk->slotName == slotName )
-         return walk->type ? walk->type->getTypeID() : TypeString;
+   S32 slot = findSlot( slotName );
+   if( slot != -1 && mSlots[ slot ].entry->type )
+      return mSlots[ slot ].entry->type->getTypeID();
 
    return TypeString;
 }
 
 SimFieldDictionary::Entry  *SimFieldDictionary::findDynamicField(const String &fieldName) const
 {
-   U32 bucket = getHashValue( fieldName );
-
-   for( Entry *walk = mHashTable[bucket]; walk; walk = walk->next )
-   {
-      if( fieldName.equal(walk->slotName, String::NoCase) )
-         return walk;
-   }
+   // Field names are interned case insensitively.  A name that isn't in the
+   // string table can't be a field, and looking it up mustn't add it.
+   StringTableEntry ste = StringTable->lookup( fieldName );
+   if( !ste )
+      return NULL;
 
-   return NULL;
+   return findDynamicField( ste );
 }
 
 SimFieldDictionary::Entry *SimFieldDictionary::findDynamicField( StringTableEntry fieldName) const
 {
-   U32 bucket = getHashValue( fieldName );
-
-   for( Entry *walk = mHashTable[bucket]; walk; walk = walk->next )
-   {
-       if( walk->slotName == fieldName )
-       {
-        return walk;
-       }
-   }
+   S32 slot = findSlot( fieldName );
+   if( slot != -1 )
+      return mSlots[ slot ].entry;
 
    return NULL;
 }
@@ -171,46 +321,26 @@ SimFieldDictionary::Entry *SimFieldDictionary::findDynamicField( StringTableEntr
 
 void SimFieldDictionary::setFieldValue(StringTableEntry slotName, const char *value)
 {
-   U32 bucket = getHashValue(slotName);
-   Entry **walk = &mHashTable[bucket];
-   while(*walk && (*walk)->slotName != slotName)
-      walk = &((*walk)->next);
-
-   Entry *field = *walk;
+   S32 slot = findSlot( slotName );
    if( !value || !*value )
    {
-      if(field)
-      {
-         mVersion++;
-
-         if( field->value )
-            dFree(field->value);
-
-         *walk = field->next;
-         freeEntry(field);
-      }
+      if( slot != -1 )
+         removeEntry( slot );
    }
    else
    {
-      if(field)
-      {
-         if( field->value )
-            dFree(field->value);
-
-         field->value = dStrdup(value);
-      }
+      if( slot != -1 )
+         setEntryValue( mSlots[ slot ].entry, value );
       else
-         addEntry( bucket, slotName, 0, dStrdup( value ) );
+         addEntry( slotName, 0, value );
    }
 }
 
 const char *SimFieldDictionary::getFieldValue(StringTableEntry slotName)
 {
-   U32 bucket = getHashValue(slotName);
-
-   for(Entry *walk = mHashTable[bucket];walk;walk = walk->next)
-      if(walk->slotName == slotName)
-         return walk->value;
+   S32 slot = findSlot( slotName );
+   if( slot != -1 )
+      return mSlots[ slot ].entry->value;
 
    return NULL;
 }
@@ -219,13 +349,11 @@ void SimFieldDictionary::assignFrom(SimFieldDictionary *dict)
 {
    mVersion++;
 
-   for(U32 i = 0; i < HashTableSize; i++)
+   for( U32 i = 0; i < dict->mNumFields; i++ )
    {
-      for(Entry *walk = dict->mHashTable[i];walk; walk = walk->next)
-      {
-         setFieldValue(walk->slotName, walk->value);
-         setFieldType(walk->slotName, walk->type);
-      }
+      Entry *entry = dict->mSlots[ i ].entry;
+      setFieldValue(entry->slotName, entry->value);
+      setFieldType(entry->slotName, entry->type);
    }
 }
 
@@ -241,25 +369,24 @@ void SimFieldDictionary::writeFields(SimObject *obj, Stream &stream, U32 tabStop
    const AbstractClassRep::FieldList &list = obj->getFieldList();
    Vector<Entry *> flist(__FILE__, __LINE__);
 
-   for(U32 i = 0; i < HashTableSize; i++)
+   for(U32 j = 0; j < mNumFields; j++)
    {
-      for(Entry *walk = mHashTable[i];walk; walk = walk->next)
-      {
-         // make sure we haven't written this out yet:
-         U32 i;
-         for(i = 0; i < list.size(); i++)
-            if(list[i].pFieldname == walk->slotName)
-               break;
+      Entry *walk = mSlots[j].entry;
 
-         if(i != list.size())
-            continue;
+      // make sure we haven't written this out yet:
+      U32 i;
+      for(i = 0; i < list.size(); i++)
+         if(list[i].pFieldname == walk->slotName)
+            break;
 
+      if(i != list.size())
+         continue;
 
-         if (!obj->writeField(walk->slotName, walk->value))
-            continue;
 
-         flist.push_back(walk);
-      }
+      if (!obj->writeField(walk->slotName, walk->value))
+         continue;
+
+      flist.push_back(walk);
    }
 
    // Sort Entries to prevent version control conflicts
@@ -289,21 +416,20 @@ void SimFieldDictionary::printFields(SimObject *obj)
    char expandedBuffer[4096];
    Vector<Entry *> flist(__FILE__, __LINE__);
 
-   for(U32 i = 0; i < HashTableSize; i++)
+   for(U32 j = 0; j < mNumFields; j++)
    {
-      for(Entry *walk = mHashTable[i];walk; walk = walk->next)
-      {
-         // make sure we haven't written this out yet:
-         U32 i;
-         for(i = 0; i < list.size(); i++)
-            if(list[i].pFieldname == walk->slotName)
-               break;
+      Entry *walk = mSlots[j].entry;
 
-         if(i != list.size())
-            continue;
+      // make sure we haven't written this out yet:
+      U32 i;
+      for(i = 0; i < list.size(); i++)
+         if(list[i].pFieldname == walk->slotName)
+            break;
 
-         flist.push_back(walk);
-      }
+      if(i != list.size())
+         continue;
+
+      flist.push_back(walk);
    }
    dQsort(flist.address(),flist.size(),sizeof(Entry *),compareEntries);
 
@@ -324,22 +450,17 @@ SimFieldDictionary::Entry  *SimFieldDictionary::operator[](U32 index)
 {
    AssertFatal ( index < mNumFields, "out of range" );
 
-   if ( index > mNumFields )
+   if ( index >= mNumFields )
       return NULL;
 
-   SimFieldDictionaryIterator itr(this);
-
-   for (S32 i = 0; i < index && *itr; i++)
-      ++itr;
-
-   return (*itr);
+   return mSlots[ index ].entry;
 }
 
 //------------------------------------------------------------------------------
 SimFieldDictionaryIterator::SimFieldDictionaryIterator(SimFieldDictionary * dictionary)
 {
    mDictionary = dictionary;
-   mHashIndex = -1;
+   mIndex = dictionary ? dictionary->mNumFields : 0;
    mEntry = 0;
    operator++();
 }
@@ -349,11 +470,13 @@ SimFieldDictionary::Entry* SimFieldDictionaryIterator::operator++()
    if(!mDictionary)
       return(mEntry);
 
-   if(mEntry)
-      mEntry = mEntry->next;
-
-   while(!mEntry && (mHashIndex < (SimFieldDictionary::HashTableSize-1)))
-      mEntry = mDictionary->mHashTable[++mHashIndex];
+   // Walk the fields backwards.  Removing a field moves the last one into
+   // its place, which has then already been visited.
+   mIndex = getMin( mIndex, mDictionary->mNumFields );
+   if( mIndex > 0 )
+      mEntry = mDictionary->mSlots[ -- mIndex ].entry;
+   else
+      mEntry = NULL;
 
    return(mEntry);
 }
@@ -361,4 +484,4 @@ SimFieldDictionary::Entry* SimFieldDictionaryIterator::operator++()
 SimFieldDictionary::Entry* SimFieldDictionaryIterator::operator*()
 {
    return(mEntry);
-}
\ No newline at end of file
+}
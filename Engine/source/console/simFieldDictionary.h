@@ -35,6 +35,16 @@ class SimObject;
 #endif
 
 /// Dictionary to keep track of dynamic fields on SimObject.
+///
+/// Fields are kept in a flat array of name/entry pairs that starts out
+/// inside the dictionary itself, so objects with only a few fields need no
+/// extra allocation and look them up with a short linear scan.  Once an
+/// object has more than LinearSearchLimit fields, an open addressing index
+/// over the array is built.
+///
+/// Entries and field values come from pools shared by all dictionaries.
+/// Entries never move, so pointers to them stay valid until the field is
+/// removed.
 class SimFieldDictionary
 {
    friend class SimFieldDictionaryIterator;
@@ -46,23 +56,44 @@ public:
 
       StringTableEntry slotName;
       char *value;
-      Entry *next;
       ConsoleBaseType *type;
+      U32 valueSize;    ///< Size of the buffer holding the value.
    };
 private:
    enum
    {
-      HashTableSize = 19
+      InlineSlots = 4,        ///< Number of fields stored without allocating.
+      LinearSearchLimit = 8,  ///< Number of fields up to which no index is kept.
    };
-   Entry *mHashTable[HashTableSize];
 
-   static Entry   *smFreeList;
+   struct Slot
+   {
+      StringTableEntry slotName;
+      Entry *entry;
+   };
+
+   Slot *mSlots;
+   U32   mSlotCapacity;
+   Slot  mInlineSlots[InlineSlots];
+
+   /// Open addressing index from field names to mSlots; holds the slot
+   /// index plus one and zero for free positions.  NULL while the
+   /// dictionary has few fields.
+   U32  *mIndex;
+   U32   mIndexShift;
+
+   static Entry*  allocEntry();
+   static void    freeEntry(Entry *entry);
+   static void    setEntryValue(Entry *entry, const char *value);
+   static void    freeEntryValue(Entry *entry);
 
-   void           freeEntry(Entry *entry);
-   Entry*         addEntry( U32 bucket, StringTableEntry slotName, ConsoleBaseType* type, char* value = 0 );
+   Entry*         addEntry( StringTableEntry slotName, ConsoleBaseType* type, const char* value = 0 );
+   void           removeEntry( U32 slot );
 
-   static U32     getHashValue( StringTableEntry slotName );
-   static U32     getHashValue( const String& fieldName );
+   S32            findSlot( StringTableEntry slotName ) const;
+   U32            getIndexPosition( StringTableEntry slotName ) const;
+   void           insertIndex( U32 slot );
+   void           buildIndex();
 
    U32   mNumFields;
 
@@ -92,10 +123,14 @@ public:
    Entry  *operator[](U32 index);
 };
 
+/// Iterates the fields of a SimFieldDictionary.
+///
+/// The field being visited may be removed from the dictionary without
+/// disturbing the iteration.
 class SimFieldDictionaryIterator
 {
    SimFieldDictionary *          mDictionary;
-   S32                           mHashIndex;
+   U32                           mIndex;
    SimFieldDictionary::Entry *   mEntry;
 
 public:
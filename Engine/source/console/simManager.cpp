@@ -32,6 +32,8 @@
 #include "console/engineAPI.h"
 #include "core/idGenerator.h"
 #include "core/util/safeDelete.h"
+#include "core/util/tDictionary.h"
+#include "core/util/tVector.h"
 #include "platform/platformIntrinsics.h"
 #include "platform/profiler.h"
 #include "math/mMathFn.h"
@@ -53,14 +55,98 @@ namespace Sim
 
 //---------------------------------------------------------------------------
 // event queue variables:
+//
+// Pending events are kept in a binary min-heap ordered by time and, for
+// events due at the same time, by sequence count so they are dispatched in
+// the order they were posted.  Every event knows its own heap index and the
+// lookup table maps sequence counts to events, so cancellation and queries
+// by event id don't have to search the queue.
 
 SimTime gCurrentTime;
 SimTime gTargetTime;
 
 void *gEventQueueMutex;
-SimEvent *gEventQueue;
+Vector<SimEvent*> gEventQueue;
+HashTable<U32, SimEvent*> gEventLookup;
 U32 gEventSequence;
 
+//---------------------------------------------------------------------------
+// event queue heap
+
+/// Return true if a has to be dispatched before b.
+static inline bool eventBefore(const SimEvent *a, const SimEvent *b)
+{
+   if(a->time != b->time)
+      return a->time < b->time;
+
+   // [tom, 6/24/2005] This ensures that SimEvents are dispatched in the same order that they are posted.
+   // This is needed to ensure Con::threadSafeExecute() executes script code in the correct order.
+   return S32(a->sequenceCount - b->sequenceCount) < 0;
+}
+
+static inline void placeEvent(SimEvent *event, U32 index)
+{
+   gEventQueue[index] = event;
+   event->heapIndex = index;
+}
+
+static void siftEventUp(U32 index)
+{
+   SimEvent *event = gEventQueue[index];
+   while(index > 0)
+   {
+      U32 parent = (index - 1) >> 1;
+      if(!eventBefore(event, gEventQueue[parent]))
+         break;
+      placeEvent(gEventQueue[parent], index);
+      index = parent;
+   }
+   placeEvent(event, index);
+}
+
+static void siftEventDown(U32 index)
+{
+   const U32 count = gEventQueue.size();
+   SimEvent *event = gEventQueue[index];
+   for(;;)
+   {
+      U32 child = (index << 1) + 1;
+      if(child >= count)
+         break;
+      if(child + 1 < count && eventBefore(gEventQueue[child + 1], gEventQueue[child]))
+         child++;
+      if(!eventBefore(gEventQueue[child], event))
+         break;
+      placeEvent(gEventQueue[child], index);
+      index = child;
+   }
+   placeEvent(event, index);
+}
+
+/// Take the event at the given heap index out of the queue.
+static void removeEventAt(U32 index)
+{
+   SimEvent *event = gEventQueue[index];
+   gEventLookup.erase(event->sequenceCount);
+
+   SimEvent *last = gEventQueue.last();
+   gEventQueue.pop_back();
+   if(last == event)
+      return;
+
+   placeEvent(last, index);
+   if(index > 0 && eventBefore(last, gEventQueue[(index - 1) >> 1]))
+      siftEventUp(index);
+   else
+      siftEventDown(index);
+}
+
+static SimEvent *findEvent(U32 eventSequence)
+{
+   HashTable<U32, SimEvent*>::Iterator iter = gEventLookup.find(eventSequence);
+   return iter != gEventLookup.end() ? iter->value : NULL;
+}
+
 //---------------------------------------------------------------------------
 // event queue init/shutdown
 
@@ -69,7 +155,8 @@ static void initEventQueue()
    gCurrentTime = 0;
    gTargetTime = 0;
    gEventSequence = 1;
-   gEventQueue = NULL;
+   gEventQueue.clear();
+   gEventLookup.clear();
    gEventQueueMutex = Mutex::createMutex();
 }
 
@@ -77,13 +164,10 @@ static void shutdownEventQueue()
 {
    // Delete all pending events
    Mutex::lockMutex(gEventQueueMutex);
-   SimEvent *walk = gEventQueue;
-   while(walk)
-   {
-      SimEvent *temp = walk->nextEvent;
-      delete walk;
-      walk = temp;
-   }
+   for(U32 i = 0; i < gEventQueue.size(); i++)
+      delete gEventQueue[i];
+   gEventQueue.clear();
+   gEventLookup.clear();
    Mutex::unlockMutex(gEventQueueMutex);
    Mutex::destroyMutex(gEventQueueMutex);
 }
@@ -115,19 +199,10 @@ U32 postEvent(SimObject *destObject, SimEvent* event,U32 time)
       return InvalidEventId;
    }
    event->sequenceCount = gEventSequence++;
-   SimEvent **walk = &gEventQueue;
-   SimEvent *current;
-   
-   while((current = *walk) != NULL && (current->time < event->time))
-      walk = &(current->nextEvent);
-   
-   // [tom, 6/24/2005] This ensures that SimEvents are dispatched in the same order that they are posted.
-   // This is needed to ensure Con::threadSafeExecute() executes script code in the correct order.
-   while((current = *walk) != NULL && (current->time == event->time))
-      walk = &(current->nextEvent);
-   
-   event->nextEvent = current;
-   *walk = event;
+
+   gEventQueue.push_back(event);
+   siftEventUp(gEventQueue.size() - 1);
+   gEventLookup.insertUnique(event->sequenceCount, event);
 
    U32 seqCount = event->sequenceCount;
 
@@ -143,20 +218,11 @@ void cancelEvent(U32 eventSequence)
 {
    Mutex::lockMutex(gEventQueueMutex);
 
-   SimEvent **walk = &gEventQueue;
-   SimEvent *current;
-   
-   while((current = *walk) != NULL)
+   SimEvent *event = findEvent(eventSequence);
+   if(event)
    {
-      if(current->sequenceCount == eventSequence)
-      {
-         *walk = current->nextEvent;
-         delete current;
-         Mutex::unlockMutex(gEventQueueMutex);
-         return;
-      }
-      else
-         walk = &(current->nextEvent);
+      removeEventAt(event->heapIndex);
+      delete event;
    }
 
    Mutex::unlockMutex(gEventQueueMutex);
@@ -166,19 +232,29 @@ void cancelPendingEvents(SimObject *obj)
 {
    Mutex::lockMutex(gEventQueueMutex);
 
-   SimEvent **walk = &gEventQueue;
-   SimEvent *current;
-   
-   while((current = *walk) != NULL)
+   // Compact the queue and rebuild the heap if anything was removed.
+   U32 count = 0;
+   for(U32 i = 0; i < gEventQueue.size(); i++)
    {
-      if(current->destObject == obj)
+      SimEvent *event = gEventQueue[i];
+      if(event->destObject == obj)
       {
-         *walk = current->nextEvent;
-         delete current;
+         gEventLookup.erase(event->sequenceCount);
+         delete event;
       }
       else
-         walk = &(current->nextEvent);
+         gEventQueue[count++] = event;
+   }
+
+   if(count != gEventQueue.size())
+   {
+      gEventQueue.setSize(count);
+      for(U32 i = 0; i < count; i++)
+         gEventQueue[i]->heapIndex = i;
+      for(S32 i = S32(count / 2) - 1; i >= 0; i--)
+         siftEventDown(i);
    }
+
    Mutex::unlockMutex(gEventQueueMutex);
 }
 
@@ -188,28 +264,22 @@ void cancelPendingEvents(SimObject *obj)
 bool isEventPending(U32 eventSequence)
 {
    Mutex::lockMutex(gEventQueueMutex);
-
-   for(SimEvent *walk = gEventQueue; walk; walk = walk->nextEvent)
-      if(walk->sequenceCount == eventSequence)
-      {
-         Mutex::unlockMutex(gEventQueueMutex);
-         return true;
-      }
+   bool pending = findEvent(eventSequence) != NULL;
    Mutex::unlockMutex(gEventQueueMutex);
-   return false;
+   return pending;
 }
 
 U32 getEventTimeLeft(U32 eventSequence)
 {
    Mutex::lockMutex(gEventQueueMutex);
 
-   for(SimEvent *walk = gEventQueue; walk; walk = walk->nextEvent)
-      if(walk->sequenceCount == eventSequence)
-      {
-         SimTime t = walk->time - getCurrentTime();
-         Mutex::unlockMutex(gEventQueueMutex);
-         return t;
-      }
+   SimEvent *event = findEvent(eventSequence);
+   if(event)
+   {
+      SimTime t = event->time - getCurrentTime();
+      Mutex::unlockMutex(gEventQueueMutex);
+      return t;
+   }
 
    Mutex::unlockMutex(gEventQueueMutex);
 
@@ -218,17 +288,35 @@ U32 getEventTimeLeft(U32 eventSequence)
 
 U32 getScheduleDuration(U32 eventSequence)
 {
-   for(SimEvent *walk = gEventQueue; walk; walk = walk->nextEvent)
-      if(walk->sequenceCount == eventSequence)
-         return (walk->time-walk->startTime);
+   Mutex::lockMutex(gEventQueueMutex);
+
+   SimEvent *event = findEvent(eventSequence);
+   if(event)
+   {
+      SimTime t = event->time - event->startTime;
+      Mutex::unlockMutex(gEventQueueMutex);
+      return t;
+   }
+
+   Mutex::unlockMutex(gEventQueueMutex);
+
    return 0;
 }
 
 U32 getTimeSinceStart(U32 eventSequence)
 {
-   for(SimEvent *walk = gEventQueue; walk; walk = walk->nextEvent)
-      if(walk->sequenceCount == eventSequence)
-         return (getCurrentTime()-walk->startTime);
+   Mutex::lockMutex(gEventQueueMutex);
+
+   SimEvent *event = findEvent(eventSequence);
+   if(event)
+   {
+      SimTime t = getCurrentTime() - event->startTime;
+      Mutex::unlockMutex(gEventQueueMutex);
+      return t;
+   }
+
+   Mutex::unlockMutex(gEventQueueMutex);
+
    return 0;
 }
 
@@ -243,10 +331,10 @@ void advanceToTime(SimTime targetTime)
    Mutex::lockMutex(gEventQueueMutex);
 
    gTargetTime = targetTime;
-   while(gEventQueue && gEventQueue->time <= targetTime)
+   while(gEventQueue.size() && gEventQueue.first()->time <= targetTime)
    {
-      SimEvent *event = gEventQueue;
-      gEventQueue = gEventQueue->nextEvent;
+      SimEvent *event = gEventQueue.first();
+      removeEventAt(0);
       AssertFatal(event->time >= gCurrentTime,
          "Sim::advanceToTime() - Event time is less than current time.");
       gCurrentTime = event->time;
@@ -283,14 +283,13 @@ class SimObject: public ConsoleObject
          NoNameChange      = BIT( 11 ),   ///< Whether changing the name of this object is allowed.
          Hidden            = BIT( 12 ),   ///< Object is hidden in editors.
          Locked            = BIT( 13 ),   ///< Object is locked in editors.
+         InNameDictionary  = BIT( 14 ),   ///< Object is in its group's name dictionary.
+         InManagerNameDictionary = BIT( 15 ),   ///< Object is in the global name dictionary.
       };
       
       // dictionary information stored on the object
       StringTableEntry objectName;
       StringTableEntry mOriginalName;
-      SimObject*       nextNameObject;
-      SimObject*       nextManagerNameObject;
-      SimObject*       nextIdObject;
 
       /// SimGroup we're contained in, if any.
       SimGroup*   mGroup;
@@ -31,7 +31,13 @@ void StringStack::getArgcArgv(StringTableEntry name, U32 *argc, const char ***in
    mArgV[0] = name;
    
    for(U32 i = 0; i < argCount; i++)
-      mArgV[i+1] = mBuffer + mStartOffsets[startStack + i];
+   {
+      U32 slot = startStack + i;
+      if(mTypedSlots[slot])
+         mArgV[i+1] = mTypedArgs[slot].mString;
+      else
+         mArgV[i+1] = mBuffer + mStartOffsets[slot];
+   }
    argCount++;
    
    *argc = argCount;
@@ -47,11 +47,27 @@ struct StringStack
       MaxArgs = 20,
       ReturnBufferSpace = 512
    };
+
+   /// A numeric function argument pushed straight from the interpreter's
+   /// int or float stack.
+   ///
+   /// Engine API functions read the value without a string round-trip.  For
+   /// everyone else the string is formatted on demand, see formatTypedArgs().
+   struct TypedArg
+   {
+      char mString[32];    ///< Must come first; argv points here.
+      F64  mValue;
+      bool mIsInt;
+      bool mFormatted;
+   };
+
    char *mBuffer;
    U32   mBufferSize;
    const char *mArgV[MaxArgs];
    U32 mFrameOffsets[MaxStackDepth];
    U32 mStartOffsets[MaxStackDepth];
+   bool mTypedSlots[MaxStackDepth];
+   TypedArg mTypedArgs[MaxStackDepth];
 
    U32 mNumFrames;
    U32 mArgc;
@@ -214,9 +230,71 @@ struct StringStack
    /// Push the stack, placing a zero-length string on the top.
    void push()
    {
+      mTypedSlots[mStartStackSize] = false;
+      advanceChar(0);
+   }
+
+   /// Push an integer function argument.
+   void pushUInt(U32 i)
+   {
+      pushTyped(S32(i), true);
+   }
+
+   /// Push a float function argument.
+   void pushFloat(F64 v)
+   {
+      pushTyped(v, false);
+   }
+
+   void pushTyped(F64 value, bool isInt)
+   {
+      TypedArg &arg = mTypedArgs[mStartStackSize];
+      arg.mValue = value;
+      arg.mIsInt = isInt;
+      arg.mFormatted = false;
+      mTypedSlots[mStartStackSize] = true;
+      mLen = 0;
       advanceChar(0);
    }
 
+   /// Return true if the argv entry is a typed argument.
+   inline bool isTypedArg(const char *arg) const
+   {
+      return arg >= mTypedArgs[0].mString && arg < (const char *) (mTypedArgs + MaxStackDepth);
+   }
+
+   inline TypedArg &getTypedArg(const char *arg)
+   {
+      return *reinterpret_cast<TypedArg *>(const_cast<char *>(arg));
+   }
+
+   /// Make sure the argv entry holds its string.  Typed arguments are
+   /// formatted the same way as OP_UINT_TO_STR and OP_FLT_TO_STR would.
+   const char *formatTypedArg(const char *arg)
+   {
+      if(!isTypedArg(arg))
+         return arg;
+
+      TypedArg &typed = getTypedArg(arg);
+      if(!typed.mFormatted)
+      {
+         if(typed.mIsInt)
+            dSprintf(typed.mString, sizeof(typed.mString), "%d", S32(typed.mValue));
+         else
+            dSprintf(typed.mString, sizeof(typed.mString), "%g", typed.mValue);
+         typed.mFormatted = true;
+      }
+      return arg;
+   }
+
+   /// Format all typed arguments in argv.  This has to be done before argv
+   /// is handed to anything but an engine API thunk.
+   void formatTypedArgs(U32 argc, const char **argv)
+   {
+      for(U32 i = 1; i < argc; i++)
+         formatTypedArg(argv[i]);
+   }
+
    inline void setLen(U32 newlen)
    {
       mLen = newlen;
@@ -0,0 +1,79 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "unit/test.h"
+#include "console/console.h"
+#include "core/stream/fileStream.h"
+#include "core/strings/stringFunctions.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+// Checks that DSOs are keyed on the script source rather than on file
+// times, and that compileScripts() only compiles what is out of date.
+
+CreateUnitTest( TestScriptCache, "Console/ScriptCache" )
+{
+   bool writeScript( const char* fileName, const char* script )
+   {
+      FileStream stream;
+      if( !stream.open( fileName, Torque::FS::File::Write ) )
+         return false;
+      stream.write( dStrlen( script ), script );
+      stream.close();
+      return true;
+   }
+
+   void deleteScript( const char* fileName )
+   {
+      dFileDelete( Con::executef( "getDSOPath", fileName ) );
+      dFileDelete( fileName );
+   }
+
+   void run()
+   {
+      const char* first = "scriptCacheTest/first.cs";
+      const char* second = "scriptCacheTest/second.cs";
+
+      if( !test( writeScript( first, "$scriptCacheTest = 1;" ) && writeScript( second, "$scriptCacheTest2 = 1;" ),
+            "Unable to write test scripts" ) )
+         return;
+
+      test( dAtoi( Con::executef( "compileScripts", "scriptCacheTest" ) ) == 2, "Scripts were not compiled" );
+      test( dAtoi( Con::executef( "compileScripts", "scriptCacheTest" ) ) == 0, "Up to date scripts were compiled again" );
+
+      // Change the source without changing its size.  The DSO may well look
+      // newer than the script, but it was compiled from different source.
+      writeScript( first, "$scriptCacheTest = 2;" );
+      Con::executef( "exec", first );
+      test( Con::getIntVariable( "$scriptCacheTest" ) == 2, "Stale DSO was executed" );
+
+      test( dAtoi( Con::executef( "compileScripts", "scriptCacheTest" ) ) == 0, "exec() did not update the DSO" );
+
+      deleteScript( first );
+      deleteScript( second );
+   }
+};
+
+#endif // TORQUE_SHIPPING
@@ -0,0 +1,97 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "unit/test.h"
+#include "console/console.h"
+#include "core/strings/stringFunctions.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+// Checks that code using the superinstructions, constant folding,
+// local variable slots, call site caches and typed arguments evaluates the
+// same as the unoptimized forms.
+
+CreateUnitTest( TestScriptCompilerOptimizations, "Console/CompilerOptimizations" )
+{
+   /// Run the given function body and check that it returns expected.
+   void check( const char* script, const char* expected )
+   {
+      Con::evaluate( avar( "function testScriptCompiler_check() { %s }", script ), false, "testScriptCompiler" );
+      const char* result = Con::executef( "testScriptCompiler_check" );
+      test( dStrcmp( result, expected ) == 0, avar( "'%s' returned '%s', expected '%s'", script, result, expected ) );
+   }
+
+   void run()
+   {
+      // Compare and branch.
+      check( "%a = 1; %b = 2; if( %a < %b ) return 1; return 0;", "1" );
+      check( "%a = 2; %b = 2; if( %a != %b ) return 1; return 0;", "0" );
+      check( "%a = 3; %b = 2; return %a >= %b ? \"yes\" : \"no\";", "yes" );
+      check( "%n = 0; for( %i = 0; %i <= 9; %i ++ ) %n += 2; return %n;", "20" );
+      check( "%n = 0; %i = 5; do { %n ++; %i --; } while( %i > 0 ); return %n;", "5" );
+      check( "%n = 0; %i = 0; while( %i == 0 ) %i ++; return %i;", "1" );
+
+      // Increments.
+      check( "%i = 1.5; %i += 2; %i -= 0.5; %i ++; %i --; %i ++; return %i;", "4" );
+      check( "%i += 3; return %i;", "3" );
+
+      // Constant folding.
+      check( "return 2 * 3 + 4 / 2 - -1;", "9" );
+      check( "%x = 1 / 4; return %x;", "0.25" );
+      check( "return (7 / 2) | 0;", "3" );
+      check( "return 1 / 0 + 0 == 0;", "0" );
+
+      // Locals in frame slots.
+      check( "%a = 5; eval( \"%a += 1;\" ); return %a;", "6" );
+      check( "eval( \"%b = 3;\" ); %b ++; return %b;", "4" );
+      check( "%n = 0; foreach$( %w in \"a b c\" ) %n ++; return %n @ %w;", "3c" );
+      check( "%n = 1; %n = %n + %n; return %n;", "2" );
+
+      // Call site caches.
+      Con::evaluate( "function TestCallSiteA::who( %this ) { return \"A\"; }"
+                     "function TestCallSiteB::who( %this ) { return \"B\"; }"
+                     "function testScriptCompiler_fn() { return 1; }", false, "testScriptCompiler" );
+      check( "%a = new ScriptObject() { class = TestCallSiteA; }; %b = new ScriptObject() { class = TestCallSiteB; };"
+             "%r = \"\"; for( %i = 0; %i < 4; %i ++ ) { %o = %i % 2 ? %b : %a; %r = %r @ %o.who(); }"
+             "%a.delete(); %b.delete(); return %r;", "ABAB" );
+      check( "%r = \"\"; for( %i = 0; %i < 2; %i ++ ) { %r = %r @ testScriptCompiler_fn();"
+             "eval( \"function testScriptCompiler_fn() { return 2; }\" ); } return %r;", "12" );
+
+      // Field access through variables.
+      check( "%pos = \"1 2 3\"; return %pos.y;", "2" );
+      check( "%pos = \"1 2 3\"; %pos.z = 5; return %pos;", "1 2 5" );
+      check( "%obj = new ScriptObject() { value = 1; }; %obj.value += 2; %obj.list[ 1 ] = %obj.value;"
+             "%r = %obj.list[ 1 ]; %obj.delete(); return %r;", "3" );
+
+      // Numeric arguments to script, engine API and legacy console functions.
+      Con::evaluate( "function testScriptCompiler_args( %a, %b ) { return %a @ \"|\" @ %b; }", false, "testScriptCompiler" );
+      check( "%i = 2; return testScriptCompiler_args( %i + 1, 3 / 2 );", "3|1.5" );
+      check( "return getSubStr( \"foobar\", 2 - 1, 4 / 2 ) @ strlen( 12345 * 2 );", "oo5" );
+      check( "return call( \"testScriptCompiler_args\", -1, 0.25 );", "-1|0.25" );
+      check( "%o = new ScriptObject(); %r = isObject( %o.getId() + 0 ); %o.delete(); return %r;", "1" );
+   }
+};
+
+#endif // TORQUE_SHIPPING
@@ -0,0 +1,197 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "unit/test.h"
+#include "console/console.h"
+#include "console/compiler.h"
+#include "console/simBase.h"
+#include "console/engineAPI.h"
+#include "math/mPoint3.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+// Microbenchmarks for the TorqueScript interpreter.  Each benchmark runs a
+// small script representative of gameplay code and reports the time spent.
+// Run once per dispatch mode (see TORQUE_SCRIPT_SWITCH_DISPATCH) to compare
+// the interpreter loops.
+
+static const char* sScriptPerfSource =
+   "function scriptPerf_arith( %n )"
+   "{"
+   "   %sum = 0;"
+   "   for( %i = 0; %i < %n; %i ++ )"
+   "      %sum = %sum + %i * 2 - 1;"
+   "   return %sum;"
+   "}"
+   "function scriptPerf_fib( %n )"
+   "{"
+   "   if( %n < 2 )"
+   "      return %n;"
+   "   return scriptPerf_fib( %n - 1 ) + scriptPerf_fib( %n - 2 );"
+   "}"
+   "function scriptPerf_strings( %n )"
+   "{"
+   "   %str = \"\";"
+   "   for( %i = 0; %i < %n; %i ++ )"
+   "      %str = %str @ \"x\";"
+   "   return strlen( %str );"
+   "}"
+   "function ScriptPerfObject::step( %this, %delta )"
+   "{"
+   "   %this.counter += %delta;"
+   "   return %this.counter;"
+   "}"
+   "function scriptPerf_methods( %obj, %n )"
+   "{"
+   "   for( %i = 0; %i < %n; %i ++ )"
+   "      %obj.step( 1 );"
+   "   return %obj.counter;"
+   "}"
+   "function scriptPerf_engineTyped( %n )"
+   "{"
+   "   for( %i = 0; %i < %n; %i ++ )"
+   "      scriptPerf_setTransform( %i * 0.5, %i + 1, 2.5, 0.25 );"
+   "   return scriptPerf_getPositionX() + scriptPerf_getPositionY();"
+   "}"
+   "function scriptPerf_engineString( %n )"
+   "{"
+   "   for( %i = 0; %i < %n; %i ++ )"
+   "   {"
+   "      %x = %i * 0.5;"
+   "      %y = %i + 1;"
+   "      scriptPerf_setTransform( %x, %y, \"2.5\", \"0.25\" );"
+   "   }"
+   "   return scriptPerf_getPositionX() + scriptPerf_getPositionY();"
+   "}";
+
+// Stand-ins for hot engine calls like SceneObject::setTransform and
+// getPosition, so the benchmark measures argument passing only.
+
+static Point3F sScriptPerfPosition;
+static F32 sScriptPerfAngle;
+
+DefineEngineFunction( scriptPerf_setTransform, void, ( F32 x, F32 y, F32 z, F32 angle ),,
+   "@internal" )
+{
+   sScriptPerfPosition.set( x, y, z );
+   sScriptPerfAngle = angle;
+}
+
+DefineEngineFunction( scriptPerf_getPositionX, F32, (),,
+   "@internal" )
+{
+   return sScriptPerfPosition.x;
+}
+
+DefineEngineFunction( scriptPerf_getPositionY, F32, (),,
+   "@internal" )
+{
+   return sScriptPerfPosition.y;
+}
+
+CreateUnitTest( TestScriptPerformance, "Console/ScriptPerformance" )
+{
+   U32 mIterations;
+
+   /// Run the given script call mIterations times and report the time taken.
+   /// Returns the result of the last call.
+   const char* bench( const char* label, S32 argc, const char** argv )
+   {
+      const char* result = "";
+      const U32 start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < mIterations; ++ i )
+         result = Con::execute( argc, argv );
+      const U32 end = Platform::getRealMilliseconds();
+
+      Con::printf( "   %-12s %5dms (%d runs)", label, end - start, mIterations );
+      return result;
+   }
+
+   /// Like bench() but returns the time taken and checks the result of the
+   /// engine call benchmarks.
+   U32 benchEngineCalls( const char* label, S32 argc, const char** argv )
+   {
+      const U32 start = Platform::getRealMilliseconds();
+      const char* result = bench( label, argc, argv );
+      const U32 end = Platform::getRealMilliseconds();
+
+      test( dAtof( result ) == 149.5f, avar( "%s passed wrong arguments", argv[ 0 ] ) );
+      test( sScriptPerfPosition.z == 2.5f && sScriptPerfAngle == 0.25f, avar( "%s passed wrong arguments", argv[ 0 ] ) );
+      return end - start;
+   }
+
+   void run()
+   {
+      mIterations = Con::getIntVariable( "$testScriptPerformance::iterations", 200 );
+
+      Con::evaluate( sScriptPerfSource, false, "testScriptPerformance" );
+
+#ifdef TORQUE_SCRIPT_THREADED_DISPATCH
+      Con::printf( "   Script dispatch: threaded (computed goto)" );
+#else
+      Con::printf( "   Script dispatch: switch" );
+#endif
+
+      const char* arithArgv[] = { "scriptPerf_arith", "1000" };
+      test( dAtoi( bench( "arithmetic", 2, arithArgv ) ) == 998000, "scriptPerf_arith returned a wrong result" );
+
+      const char* fibArgv[] = { "scriptPerf_fib", "15" };
+      test( dAtoi( bench( "calls", 2, fibArgv ) ) == 610, "scriptPerf_fib returned a wrong result" );
+
+      const char* strArgv[] = { "scriptPerf_strings", "200" };
+      test( dAtoi( bench( "strings", 2, strArgv ) ) == 200, "scriptPerf_strings returned a wrong result" );
+
+      SimObject* object = Sim::findObject( Con::evaluate( "return new ScriptObject() { class = \"ScriptPerfObject\"; counter = 0; };" ) );
+      if( !test( object != NULL, "Unable to create ScriptPerfObject" ) )
+         return;
+
+      const S32 cacheHits = CodeBlock::smCallSiteCacheHits;
+      const S32 cacheMisses = CodeBlock::smCallSiteCacheMisses;
+
+      const char* methodArgv[] = { "scriptPerf_methods", object->getIdString(), "100" };
+      bench( "methods", 3, methodArgv );
+
+      Con::printf( "   Call site cache: %d hits, %d misses",
+         CodeBlock::smCallSiteCacheHits - cacheHits, CodeBlock::smCallSiteCacheMisses - cacheMisses );
+      test( dAtoi( object->getDataField( StringTable->insert( "counter" ), NULL ) ) == S32( mIterations * 100 ),
+         "ScriptPerfObject::step returned a wrong result" );
+
+      object->deleteObject();
+
+      // Numeric arguments to engine functions are passed without a string
+      // round-trip; variables holding strings still go through dAtof.
+      const char* engineTypedArgv[] = { "scriptPerf_engineTyped", "100" };
+      const U32 typedMs = benchEngineCalls( "engine typed", 2, engineTypedArgv );
+
+      const char* engineStringArgv[] = { "scriptPerf_engineString", "100" };
+      const U32 stringMs = benchEngineCalls( "engine string", 2, engineStringArgv );
+
+      Con::printf( "   Engine calls: %.3fus typed, %.3fus string per call",
+         F32( typedMs ) * 1000.0f / F32( mIterations * 100 ),
+         F32( stringMs ) * 1000.0f / F32( mIterations * 100 ) );
+   }
+};
+
+#endif // TORQUE_SHIPPING
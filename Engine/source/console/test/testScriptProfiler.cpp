@@ -0,0 +1,74 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "unit/test.h"
+#include "console/console.h"
+#include "console/scriptProfiler.h"
+#include "core/stream/fileStream.h"
+#include "core/strings/stringFunctions.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+CreateUnitTest( TestScriptProfiler, "Console/ScriptProfiler" )
+{
+   void run()
+   {
+      Con::evaluate( "function scriptProfilerTest_busy( %ms )"
+                     "{"
+                     "   %end = getRealTime() + %ms;"
+                     "   %n = 0;"
+                     "   while( getRealTime() < %end )"
+                     "      %n ++;"
+                     "   return %n;"
+                     "}", false, "testScriptProfiler" );
+
+      ScriptProfiler::reset();
+      ScriptProfiler::enable( true, 1, true );
+      Con::executef( "scriptProfilerTest_busy", "100" );
+      ScriptProfiler::enable( false );
+
+      const char* fileName = "scriptProfilerTest.folded";
+      if( !test( ScriptProfiler::dumpToFile( fileName ), "Unable to write the script profile" ) )
+         return;
+
+      FileStream stream;
+      if( test( stream.open( fileName, Torque::FS::File::Read ), "Unable to read back the script profile" ) )
+      {
+         const U32 size = getMin( stream.getStreamSize(), U32( 4095 ) );
+         char buffer[ 4096 ];
+         stream.read( size, buffer );
+         buffer[ size ] = 0;
+         stream.close();
+
+         test( dStrstr( buffer, "scriptProfilerTest_busy (testScriptProfiler:" ) != NULL,
+            "Expected samples with line numbers in scriptProfilerTest_busy" );
+      }
+
+      dFileDelete( fileName );
+      ScriptProfiler::reset();
+   }
+};
+
+#endif // TORQUE_SHIPPING
@@ -0,0 +1,168 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "unit/test.h"
+#include "console/console.h"
+#include "console/simBase.h"
+#include "console/simDictionary.h"
+#include "math/mRandom.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+// Checks that objects are found by id and name through the Sim dictionaries,
+// newest first for duplicate names, and gone once unregistered or renamed.
+
+CreateUnitTest( TestSimDictionary, "Console/SimDictionary" )
+{
+   void run()
+   {
+      const U32 count = 2000;
+
+      Vector< SimObject* > objects;
+      for( U32 i = 0; i < count; ++ i )
+      {
+         SimObject* object = new SimObject();
+         object->registerObject( avar( "TestSimDictionary%d", i ) );
+         objects.push_back( object );
+      }
+
+      bool found = true;
+      for( U32 i = 0; i < count; ++ i )
+      {
+         if( Sim::findObject( objects[ i ]->getId() ) != objects[ i ] )
+            found = false;
+         if( Sim::findObject( avar( "TestSimDictionary%d", i ) ) != objects[ i ] )
+            found = false;
+      }
+      test( found, "Registered object not found" );
+
+      // Duplicate names resolve to the most recent object.
+      SimObject* duplicate = new SimObject();
+      duplicate->registerObject( "TestSimDictionary7" );
+      test( Sim::findObject( "TestSimDictionary7" ) == duplicate, "Duplicate name did not resolve to newest object" );
+      duplicate->deleteObject();
+      test( Sim::findObject( "TestSimDictionary7" ) == objects[ 7 ], "Older object lost after removing duplicate" );
+
+      objects[ 9 ]->assignName( "TestSimDictionaryRenamed" );
+      test( !Sim::findObject( "TestSimDictionary9" ), "Old name still resolves after rename" );
+      test( Sim::findObject( "TestSimDictionaryRenamed" ) == objects[ 9 ], "New name does not resolve" );
+
+      // Delete every other object so removal has to shift entries around.
+      for( U32 i = 0; i < count; i += 2 )
+      {
+         const SimObjectId id = objects[ i ]->getId();
+         objects[ i ]->deleteObject();
+         objects[ i ] = NULL;
+         if( Sim::findObject( id ) )
+            found = false;
+      }
+      test( found, "Deleted object still found" );
+
+      for( U32 i = 1; i < count; i += 2 )
+      {
+         if( Sim::findObject( objects[ i ]->getId() ) != objects[ i ] )
+            found = false;
+         if( i != 9 && Sim::findObject( avar( "TestSimDictionary%d", i ) ) != objects[ i ] )
+            found = false;
+      }
+      test( found, "Object lost after deleting its neighbors" );
+
+      for( U32 i = 1; i < count; i += 2 )
+         objects[ i ]->deleteObject();
+   }
+};
+
+// Times lookups by id and by name at increasing table sizes.  The tables
+// never dereference the objects they hold, so the benchmark stores fake
+// object pointers rather than registering millions of SimObjects.
+
+CreateUnitTest( TestSimDictionaryPerformance, "Console/SimDictionaryPerformance" )
+{
+   void runCount( U32 count )
+   {
+      const U32 lookups = 1000000;
+
+      SimObjectTable< U32 > ids;
+      SimObjectTable< StringTableEntry > names;
+      Vector< StringTableEntry > nameList;
+      nameList.setSize( count );
+
+      U32 start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < count; ++ i )
+      {
+         SimObject* object = ( SimObject* ) dsize_t( ( i + 1 ) * 8 );
+         nameList[ i ] = StringTable->insert( avar( "TestSimDictionaryPerformance%d", i ) );
+         ids.insert( i + DataBlockObjectIdLast + 1, object );
+         names.insert( nameList[ i ], object );
+      }
+      const U32 insertTime = Platform::getRealMilliseconds() - start;
+
+      MRandomLCG random( 1234 );
+      Vector< U32 > indices;
+      indices.setSize( lookups );
+      for( U32 i = 0; i < lookups; ++ i )
+         indices[ i ] = random.randI( 0, count - 1 );
+
+      bool found = true;
+
+      start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < lookups; ++ i )
+         if( ids.find( indices[ i ] + DataBlockObjectIdLast + 1 ) != ( SimObject* ) dsize_t( ( indices[ i ] + 1 ) * 8 ) )
+            found = false;
+      const U32 idTime = Platform::getRealMilliseconds() - start;
+
+      start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < lookups; ++ i )
+         if( names.find( nameList[ indices[ i ] ] ) != ( SimObject* ) dsize_t( ( indices[ i ] + 1 ) * 8 ) )
+            found = false;
+      const U32 nameTime = Platform::getRealMilliseconds() - start;
+
+      test( found, "Lookup returned the wrong object" );
+      test( !ids.find( count + DataBlockObjectIdLast + 1 ), "Lookup of a missing id returned an object" );
+
+      start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < count; ++ i )
+      {
+         SimObject* object = ( SimObject* ) dsize_t( ( i + 1 ) * 8 );
+         ids.remove( i + DataBlockObjectIdLast + 1, object );
+         names.remove( nameList[ i ], object );
+      }
+      const U32 removeTime = Platform::getRealMilliseconds() - start;
+
+      test( ids.size() == 0 && names.size() == 0, "Tables not empty after removing everything" );
+
+      Con::printf( "   %d objects: insert %dms, %d finds by id %dms, by name %dms, remove %dms",
+         count, insertTime, lookups, idTime, nameTime, removeTime );
+   }
+
+   void run()
+   {
+      runCount( 10000 );
+      runCount( 100000 );
+      runCount( 1000000 );
+   }
+};
+
+#endif // TORQUE_SHIPPING
@@ -0,0 +1,125 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "unit/test.h"
+#include "console/console.h"
+#include "console/simBase.h"
+#include "console/simEvents.h"
+#include "math/mRandom.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+class TestSimEventQueueEvent : public SimEvent
+{
+public:
+   Vector< U32 >* mLog;
+   U32 mIndex;
+
+   TestSimEventQueueEvent( Vector< U32 >* log, U32 index )
+      : mLog( log ), mIndex( index ) {}
+
+   virtual void process( SimObject* object )
+   {
+      mLog->push_back( mIndex );
+   }
+};
+
+// Posts, cancels and dispatches a large number of events and checks that
+// they come out in time order, first-in first-out for equal times.
+
+CreateUnitTest( TestSimEventQueue, "Console/SimEventQueue" )
+{
+   void run()
+   {
+      const U32 count = 100000;
+      const U32 timeRange = 1000;
+
+      SimObject* object = new SimObject();
+      object->registerObject();
+
+      MRandomLCG random( 1234 );
+      Vector< U32 > ids;
+      Vector< SimTime > times;
+      Vector< U32 > log;
+      ids.setSize( count );
+      times.setSize( count );
+      log.reserve( count );
+
+      const SimTime now = Sim::getCurrentTime();
+
+      U32 start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < count; ++ i )
+      {
+         times[ i ] = now + random.randI( 0, timeRange - 1 );
+         ids[ i ] = Sim::postEvent( object, new TestSimEventQueueEvent( &log, i ), times[ i ] );
+      }
+      const U32 postTime = Platform::getRealMilliseconds() - start;
+
+      // Cancel every third event.
+      start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < count; i += 3 )
+         Sim::cancelEvent( ids[ i ] );
+      const U32 cancelTime = Platform::getRealMilliseconds() - start;
+
+      test( !Sim::isEventPending( ids[ 0 ] ) && Sim::isEventPending( ids[ 1 ] ), "Cancelled event still pending" );
+      test( Sim::getEventTimeLeft( ids[ 1 ] ) == times[ 1 ] - now, "Wrong time left on event" );
+
+      // Events on a deleted object go away with it.
+      SimObject* other = new SimObject();
+      other->registerObject();
+      const U32 otherId = Sim::postEvent( other, new TestSimEventQueueEvent( &log, count ), now + 1 );
+      other->deleteObject();
+      test( !Sim::isEventPending( otherId ), "Event on deleted object still pending" );
+
+      start = Platform::getRealMilliseconds();
+      Sim::advanceToTime( now + timeRange );
+      const U32 dispatchTime = Platform::getRealMilliseconds() - start;
+
+      Con::printf( "   %d events: post %dms, cancel %dms, dispatch %dms", count, postTime, cancelTime, dispatchTime );
+
+      test( log.size() == count - ( count + 2 ) / 3, "Wrong number of events dispatched" );
+
+      bool ordered = true;
+      bool cancelledRan = false;
+      for( U32 i = 0; i < log.size(); ++ i )
+      {
+         const U32 index = log[ i ];
+         if( index >= count || index % 3 == 0 )
+            cancelledRan = true;
+         else if( i > 0 )
+         {
+            const U32 prev = log[ i - 1 ];
+            if( times[ prev ] > times[ index ] || ( times[ prev ] == times[ index ] && prev > index ) )
+               ordered = false;
+         }
+      }
+      test( !cancelledRan, "Cancelled event was dispatched" );
+      test( ordered, "Events dispatched out of order" );
+
+      object->deleteObject();
+   }
+};
+
+#endif // TORQUE_SHIPPING
@@ -0,0 +1,139 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "unit/test.h"
+#include "console/console.h"
+#include "console/simObject.h"
+#include "console/simFieldDictionary.h"
+#include "core/strings/stringFunctions.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+// Adds, changes and removes dynamic fields across the switch from linear
+// search to the index and checks every field is still found.
+
+CreateUnitTest( TestSimFieldDictionary, "Console/SimFieldDictionary" )
+{
+   void run()
+   {
+      const U32 count = 100;
+
+      SimFieldDictionary dict;
+      StringTableEntry names[ count ];
+      for( U32 i = 0; i < count; ++ i )
+      {
+         names[ i ] = StringTable->insert( avar( "testField%d", i ) );
+         dict.setFieldValue( names[ i ], avar( "%d", i ) );
+      }
+      test( dict.getNumFields() == count, "Wrong field count" );
+
+      // Grow some values past the pooled sizes and shrink them again.
+      char longValue[ 300 ];
+      dMemset( longValue, 'x', sizeof( longValue ) - 1 );
+      longValue[ sizeof( longValue ) - 1 ] = 0;
+      for( U32 i = 0; i < count; i += 5 )
+         dict.setFieldValue( names[ i ], longValue );
+      test( dStrcmp( dict.getFieldValue( names[ 5 ] ), longValue ) == 0, "Long value not stored" );
+      for( U32 i = 0; i < count; i += 5 )
+         dict.setFieldValue( names[ i ], avar( "%d", i ) );
+
+      // Remove every third field; setting a field to an empty string removes it.
+      for( U32 i = 0; i < count; i += 3 )
+         dict.setFieldValue( names[ i ], "" );
+
+      bool found = true;
+      for( U32 i = 0; i < count; ++ i )
+      {
+         const char* value = dict.getFieldValue( names[ i ] );
+         if( i % 3 == 0 )
+            found &= ( value == NULL );
+         else
+            found &= ( value && dAtoi( value ) == S32( i ) );
+      }
+      test( found, "Wrong field values after removals" );
+      test( dict.findDynamicField( String( "TESTFIELD7" ) ) == dict.findDynamicField( names[ 7 ] ), "Lookup by name is not case insensitive" );
+
+      // Removing the visited field during iteration must not skip any.
+      U32 visited = 0;
+      const U32 remaining = dict.getNumFields();
+      for( SimFieldDictionaryIterator itr( &dict ); *itr; ++ itr )
+      {
+         visited ++;
+         dict.setFieldValue( ( *itr )->slotName, "" );
+      }
+      test( visited == remaining && dict.getNumFields() == 0, "Iteration skipped fields while removing them" );
+   }
+};
+
+// Measures getDataField/setDataField throughput on objects with different
+// numbers of dynamic fields.
+
+CreateUnitTest( TestSimFieldDictionaryPerformance, "Console/SimFieldDictionaryPerformance" )
+{
+   void runCount( U32 numFields )
+   {
+      const U32 iterations = 1000000;
+
+      SimObject* object = new SimObject();
+      object->registerObject();
+
+      Vector< StringTableEntry > names;
+      for( U32 i = 0; i < numFields; ++ i )
+      {
+         names.push_back( StringTable->insert( avar( "perfField%d", i ) ) );
+         object->setDataField( names[ i ], NULL, "0" );
+      }
+
+      char value[ 32 ];
+      U32 start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < iterations; ++ i )
+      {
+         dSprintf( value, sizeof( value ), "%d", i );
+         object->setDataField( names[ i % numFields ], NULL, value );
+      }
+      const U32 setTime = Platform::getRealMilliseconds() - start;
+
+      U32 sum = 0;
+      start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < iterations; ++ i )
+         sum += dStrlen( object->getDataField( names[ i % numFields ], NULL ) );
+      const U32 getTime = Platform::getRealMilliseconds() - start;
+
+      test( sum > 0, "Fields not found" );
+
+      Con::printf( "   %d fields: %d sets %dms, %d gets %dms", numFields, iterations, setTime, iterations, getTime );
+
+      object->deleteObject();
+   }
+
+   void run()
+   {
+      runCount( 4 );
+      runCount( 16 );
+      runCount( 64 );
+   }
+};
+
+#endif // TORQUE_SHIPPING
@@ -138,6 +138,8 @@ class HuffmanProcessor
   public:
    HuffmanProcessor() : m_tablesBuilt(false) { }
 
+   void initTables() { if (m_tablesBuilt == false) buildTables(); }
+
    static HuffmanProcessor g_huffProcessor;
 
    bool readHuffBuffer(BitStream* pStream, char* out_pBuffer);
@@ -146,6 +148,11 @@ class HuffmanProcessor
 
 HuffmanProcessor HuffmanProcessor::g_huffProcessor;
 
+void BitStream::initStringCompression()
+{
+   HuffmanProcessor::g_huffProcessor.initTables();
+}
+
 void BitStream::setBuffer(void *bufPtr, S32 size, S32 maxSize)
 {
    dataPtr = (U8 *) bufPtr;
@@ -62,6 +62,11 @@ public:
    static BitStream *getPacketStream(U32 writeSize = 0);
    static void sendPacketStream(const NetAddress *addr);
 
+   /// Build the tables used to compress strings.  They are otherwise built
+   /// on first use, which isn't safe when streams are written from several
+   /// threads.
+   static void initStringCompression();
+
    void setBuffer(void *bufPtr, S32 bufSize, S32 maxSize = 0);
    U8*  getBuffer() { return dataPtr; }
    U8*  getBytePtr();
@@ -169,6 +174,7 @@ public:
 
    void clearCompressionPoint();
    void setCompressionPoint(const Point3F& p);
+   const Point3F& getCompressionPoint() const { return mCompressPoint; }
 
    // Matching calls to these compression methods must, of course,
    // have matching scale values.
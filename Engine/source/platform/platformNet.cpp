@@ -76,6 +76,11 @@ typedef in_addr IN_ADDR;
 
 #define closesocket close
 
+// Receive and send UDP packets in batches with recvmmsg() and sendmmsg().
+#ifdef MSG_WAITFORONE
+#define TORQUE_USE_MMSG
+#endif
+
 #elif defined( TORQUE_OS_XENON )
 
 #include <Xtl.h>
@@ -139,6 +144,11 @@ static S32 defaultPort = 28000;
 static S32 netPort = 0;
 static int udpSocket = InvalidSocket;
 
+bool Net::smBatchedIO = true;
+
+/// Nesting depth of Net::beginBatchedSend().
+static S32 sgBatchedSendDepth = 0;
+
 ConnectionNotifyEvent   Net::smConnectionNotify;
 ConnectionAcceptedEvent Net::smConnectionAccept;
 ConnectionReceiveEvent  Net::smConnectionReceive;
@@ -211,6 +221,87 @@ bool netSocketWaitForWritable(NetSocket fd, S32 timeoutMs)
    return false;
 }
 
+#ifdef TORQUE_USE_MMSG
+
+/// Number of packets received or sent with a single system call.
+static const U32 sgPacketBatchSize = 64;
+
+/// Preallocated packet buffers along with the headers that recvmmsg()
+/// and sendmmsg() take to fill or send all of them at once.
+struct PacketBatch
+{
+   mmsghdr headers[sgPacketBatchSize];
+   iovec vectors[sgPacketBatchSize];
+   sockaddr_in addresses[sgPacketBatchSize];
+   U8 data[sgPacketBatchSize][Net::MaxPacketDataSize];
+
+   /// Number of packets queued for sending.
+   U32 count;
+
+   PacketBatch()
+   {
+      dMemset(headers, 0, sizeof(headers));
+      for(U32 i = 0; i < sgPacketBatchSize; i++)
+      {
+         vectors[i].iov_base = data[i];
+         vectors[i].iov_len = Net::MaxPacketDataSize;
+         headers[i].msg_hdr.msg_name = &addresses[i];
+         headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+         headers[i].msg_hdr.msg_iov = &vectors[i];
+         headers[i].msg_hdr.msg_iovlen = 1;
+      }
+      count = 0;
+   }
+};
+
+static PacketBatch* sgReceiveBatch = NULL;
+static PacketBatch* sgSendBatch = NULL;
+
+/// Set when the kernel turns out not to have the calls.
+static bool sgRecvMMsgUnsupported = false;
+static bool sgSendMMsgUnsupported = false;
+
+static void flushSendBatch()
+{
+   PacketBatch* batch = sgSendBatch;
+   if(!batch || !batch->count)
+      return;
+
+   U32 sent = 0;
+   while(sent < batch->count)
+   {
+      if(!sgSendMMsgUnsupported)
+      {
+         S32 result = sendmmsg(udpSocket, batch->headers + sent, batch->count - sent, 0);
+         if(result > 0)
+         {
+            sent += result;
+            continue;
+         }
+
+         if(errno == EINTR)
+            continue;
+         else if(errno == ENOSYS)
+            sgSendMMsgUnsupported = true;
+         else
+         {
+            // The first packet couldn't be sent.  As with sendto(), it's dropped.
+            sent++;
+            continue;
+         }
+      }
+
+      const msghdr& header = batch->headers[sent].msg_hdr;
+      ::sendto(udpSocket, (const char*)header.msg_iov->iov_base, header.msg_iov->iov_len, 0,
+         (sockaddr *)header.msg_name, header.msg_namelen);
+      sent++;
+   }
+
+   batch->count = 0;
+}
+
+#endif
+
 static S32 initCount = 0;
 
 bool Net::init()
@@ -255,6 +346,16 @@ void Net::shutdown()
    closePort();
    initCount--;
 
+#ifdef TORQUE_USE_MMSG
+   if(!initCount)
+   {
+      delete sgReceiveBatch;
+      delete sgSendBatch;
+      sgReceiveBatch = NULL;
+      sgSendBatch = NULL;
+   }
+#endif
+
 #if defined(TORQUE_USE_WINSOCK)
    if(!initCount)
    {
@@ -474,6 +575,10 @@ Net::Error Net::sendtoSocket(NetSocket socket, const U8 *buffer, int  bufferSize
 
 bool Net::openPort(S32 port, bool doBind)
 {
+#ifdef TORQUE_USE_MMSG
+   flushSendBatch();
+#endif
+
    if(udpSocket != InvalidSocket)
       ::closesocket(udpSocket);
 
@@ -531,8 +636,13 @@ NetSocket Net::getPort()
 
 void Net::closePort()
 {
+#ifdef TORQUE_USE_MMSG
+   flushSendBatch();
+#endif
+
    if(udpSocket != InvalidSocket)
       ::closesocket(udpSocket);
+   udpSocket = InvalidSocket;
 }
 
 Net::Error Net::sendto(const NetAddress *address, const U8 *buffer, S32  bufferSize)
@@ -540,6 +650,26 @@ Net::Error Net::sendto(const NetAddress *address, const U8 *buffer, S32  bufferS
    if(Journal::IsPlaying())
       return NoError;
 
+#ifdef TORQUE_USE_MMSG
+   if(sgBatchedSendDepth > 0 && smBatchedIO && bufferSize <= MaxPacketDataSize)
+   {
+      if(!sgSendBatch)
+         sgSendBatch = new PacketBatch;
+
+      PacketBatch* batch = sgSendBatch;
+      const U32 index = batch->count++;
+      netToIPSocketAddress(address, &batch->addresses[index]);
+      dMemcpy(batch->data[index], buffer, bufferSize);
+      batch->vectors[index].iov_len = bufferSize;
+      batch->headers[index].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+
+      if(batch->count == sgPacketBatchSize)
+         flushSendBatch();
+
+      return NoError;
+   }
+#endif
+
    if(address->type == NetAddress::IPAddress)
    {
       sockaddr_in ipAddr;
@@ -562,17 +692,107 @@ Net::Error Net::sendto(const NetAddress *address, const U8 *buffer, S32  bufferS
    }
 }
 
-void Net::process()
+void Net::beginBatchedSend()
+{
+   sgBatchedSendDepth++;
+}
+
+void Net::endBatchedSend()
+{
+   AssertFatal(sgBatchedSendDepth > 0, "Net::endBatchedSend - no matching beginBatchedSend");
+   if(--sgBatchedSendDepth > 0)
+      return;
+
+#ifdef TORQUE_USE_MMSG
+   flushSendBatch();
+#endif
+}
+
+static void dispatchPacket(const sockaddr *sa, S8 *data, S32 bytesRead)
 {
-   sockaddr sa;
-   sa.sa_family = AF_UNSPEC;
    NetAddress srcAddress;
+   if(sa->sa_family == AF_INET)
+      IPSocketToNetAddress((const sockaddr_in *) sa,  &srcAddress);
+   else
+      return;
+
+   if(bytesRead <= 0)
+      return;
+
+   if(srcAddress.type == NetAddress::IPAddress &&
+      srcAddress.netNum[0] == 127 &&
+      srcAddress.netNum[1] == 0 &&
+      srcAddress.netNum[2] == 0 &&
+      srcAddress.netNum[3] == 1 &&
+      srcAddress.port == netPort)
+      return;
+
+   Net::smPacketReceive.trigger(srcAddress, RawData(data, bytesRead));
+}
+
+#ifdef TORQUE_USE_MMSG
+
+/// Receive the waiting packets a batch at a time.  Returns false if
+/// the kernel doesn't support recvmmsg().
+static bool receivePacketBatches()
+{
+   if(sgRecvMMsgUnsupported)
+      return false;
+
+   if(!sgReceiveBatch)
+      sgReceiveBatch = new PacketBatch;
+
+   PacketBatch* batch = sgReceiveBatch;
+   for(;;)
+   {
+      for(U32 i = 0; i < sgPacketBatchSize; i++)
+      {
+         batch->headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+         batch->addresses[i].sin_family = AF_UNSPEC;
+      }
+
+      S32 count = recvmmsg(udpSocket, batch->headers, sgPacketBatchSize, MSG_DONTWAIT, NULL);
+      if(count == -1)
+      {
+         if(errno == ENOSYS)
+         {
+            sgRecvMMsgUnsupported = true;
+            return false;
+         }
+         return true;
+      }
+
+      // The handlers may close the port or open another one.
+      const int port = udpSocket;
+
+      for(S32 i = 0; i < count; i++)
+         dispatchPacket((const sockaddr *) &batch->addresses[i], (S8 *) batch->data[i], batch->headers[i].msg_len);
+
+      if(count < sgPacketBatchSize || udpSocket != port)
+         return true;
+   }
+}
+
+#endif
+
+void Net::receivePackets()
+{
+   if(udpSocket == InvalidSocket)
+      return;
+
+#ifdef TORQUE_USE_MMSG
+   if(smBatchedIO && receivePacketBatches())
+      return;
+#endif
+
+   sockaddr sa;
    RawData tmpBuffer;
    tmpBuffer.alloc(MaxPacketDataSize);
 
    for(;;)
    {
       socklen_t addrLen = sizeof(sa);
+      sa.sa_family = AF_UNSPEC;
       S32 bytesRead = -1;
 
       if(udpSocket != InvalidSocket)
@@ -581,26 +801,13 @@ void Net::process()
       if(bytesRead == -1)
          break;
 
-      if(sa.sa_family == AF_INET)
-         IPSocketToNetAddress((sockaddr_in *) &sa,  &srcAddress);
-      else
-         continue;
-
-      if(bytesRead <= 0)
-         continue;
-
-      if(srcAddress.type == NetAddress::IPAddress &&
-         srcAddress.netNum[0] == 127 &&
-         srcAddress.netNum[1] == 0 &&
-         srcAddress.netNum[2] == 0 &&
-         srcAddress.netNum[3] == 1 &&
-         srcAddress.port == netPort)
-         continue;
-
-      tmpBuffer.size = bytesRead;
-
-      Net::smPacketReceive.trigger(srcAddress, tmpBuffer);
+      dispatchPacket(&sa, tmpBuffer.data, bytesRead);
    }
+}
+
+void Net::process()
+{
+   receivePackets();
 
    // process the polled sockets.  This blob of code performs functions
    // similar to WinsockProc in winNet.cc
@@ -114,6 +114,20 @@ struct Net
    static void closePort();
    static Error sendto(const NetAddress *address, const U8 *buffer, S32 bufferSize);
 
+   /// Dispatch all packets waiting on the unreliable port to smPacketReceive.
+   /// This is done every frame by the net process.
+   static void receivePackets();
+
+   /// Queue the packets passed to sendto() until the matching endBatchedSend()
+   /// and then send them with as few system calls as the platform allows.
+   /// Send errors are not reported for queued packets.  Calls may be nested.
+   static void beginBatchedSend();
+   static void endBatchedSend();
+
+   /// If true, packets are received and sent in batches where the platform
+   /// supports it (recvmmsg() and sendmmsg() on Linux).
+   static bool smBatchedIO;
+
    // Reliable net functions (TCP)
    // all incoming messages come in on the Connected* events
    static NetSocket openListenPort(U16 port);
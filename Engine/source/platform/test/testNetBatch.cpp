@@ -0,0 +1,210 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "platform/platformNet.h"
+#include "unit/test.h"
+#include "console/console.h"
+
+#if !defined( TORQUE_SHIPPING ) && defined( TORQUE_OS_LINUX )
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+using namespace UnitTesting;
+
+/// Load test for the unreliable port.  Hundreds of clients on loopback
+/// send packets that the port echoes back, once with per packet system
+/// calls and once batched.
+CreateUnitTest( TestNetBatchedUDP, "Platform/Net/BatchedUDP" )
+{
+   enum
+   {
+      Port = 28650,
+      NumClients = 512,
+      NumRounds = 20,
+
+      /// Number of clients sending at the same time.  Small enough for
+      /// the packets to fit into the socket buffers.
+      WaveSize = 32,
+
+      PacketSize = 64,
+      TotalPackets = NumClients * NumRounds,
+   };
+
+   Vector< int > mClients;
+   sockaddr_in mServerAddress;
+
+   U32 mNumReceived;
+   U32 mNumEchoed;
+   U32 mNumBad;
+
+   void handlePacket( NetAddress address, RawData data )
+   {
+      // Packets start with an odd byte so that a NetInterface listening
+      // to the same signal takes them for data packets of an unknown
+      // connection and drops them.
+      if( data.size != PacketSize || data.data[ 0 ] != 0x01 )
+      {
+         mNumBad ++;
+         return;
+      }
+
+      mNumReceived ++;
+      Net::sendto( &address, ( const U8* ) data.data, data.size );
+   }
+
+   void sendPacket( U32 client, U32 round )
+   {
+      U8 packet[ PacketSize ];
+      dMemset( packet, 0, sizeof( packet ) );
+      packet[ 0 ] = 0x01;
+      dMemcpy( &packet[ 4 ], &client, sizeof( client ) );
+      dMemcpy( &packet[ 8 ], &round, sizeof( round ) );
+
+      ::sendto( mClients[ client ], packet, sizeof( packet ), 0, ( sockaddr* ) &mServerAddress, sizeof( mServerAddress ) );
+   }
+
+   void receiveEchoes( U32 firstClient, U32 numClients )
+   {
+      U8 packet[ Net::MaxPacketDataSize ];
+      for( U32 i = firstClient; i < firstClient + numClients; ++ i )
+      {
+         for( ;; )
+         {
+            const ssize_t size = ::recv( mClients[ i ], packet, sizeof( packet ), 0 );
+            if( size < 0 )
+               break;
+
+            U32 client;
+            dMemcpy( &client, &packet[ 4 ], sizeof( client ) );
+            if( size == PacketSize && client == i )
+               mNumEchoed ++;
+            else
+               mNumBad ++;
+         }
+      }
+   }
+
+   void pump( U32 firstClient, U32 numClients )
+   {
+      Net::beginBatchedSend();
+      Net::receivePackets();
+      Net::endBatchedSend();
+
+      receiveEchoes( firstClient, numClients );
+   }
+
+   U32 runLoad( bool batched )
+   {
+      Net::smBatchedIO = batched;
+      mNumReceived = 0;
+      mNumEchoed = 0;
+      mNumBad = 0;
+
+      const U32 start = Platform::getRealMilliseconds();
+
+      for( U32 round = 0; round < NumRounds; ++ round )
+      {
+         for( U32 wave = 0; wave < NumClients; wave += WaveSize )
+         {
+            for( U32 i = wave; i < wave + WaveSize; ++ i )
+               sendPacket( i, round );
+
+            pump( wave, WaveSize );
+         }
+      }
+
+      // Loopback delivery isn't synchronous so pick up the stragglers.
+      while( ( mNumReceived < TotalPackets || mNumEchoed < TotalPackets ) &&
+             Platform::getRealMilliseconds() - start < 5000 )
+         pump( 0, NumClients );
+
+      const U32 time = Platform::getRealMilliseconds() - start;
+
+      test( mNumBad == 0, "Got corrupted or misdirected packets!" );
+      test( mNumReceived == TotalPackets, "The port didn't receive all packets!" );
+      test( mNumEchoed == TotalPackets, "The clients didn't receive all echoes!" );
+
+      return time;
+   }
+
+   void run()
+   {
+      if( Net::getPort() != InvalidSocket )
+      {
+         Con::printf( "   skipped, the unreliable port is in use" );
+         return;
+      }
+
+      if( !Net::openPort( Port ) )
+      {
+         test( false, "Failed to open the unreliable port!" );
+         return;
+      }
+      Net::setBufferSize( Net::getPort(), 256 * 1024 );
+
+      dMemset( &mServerAddress, 0, sizeof( mServerAddress ) );
+      mServerAddress.sin_family = AF_INET;
+      mServerAddress.sin_port = htons( Port );
+      mServerAddress.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+      for( U32 i = 0; i < NumClients; ++ i )
+      {
+         const int client = ::socket( AF_INET, SOCK_DGRAM, 0 );
+         if( client == -1 )
+            break;
+
+         fcntl( client, F_SETFL, fcntl( client, F_GETFL ) | O_NONBLOCK );
+         mClients.push_back( client );
+      }
+
+      if( mClients.size() == NumClients )
+      {
+         Net::smPacketReceive.notify( this, &TestNetBatchedUDP::handlePacket );
+
+         const bool oldBatchedIO = Net::smBatchedIO;
+         const U32 unbatchedTime = runLoad( false );
+         const U32 batchedTime = runLoad( true );
+         Net::smBatchedIO = oldBatchedIO;
+
+         Net::smPacketReceive.remove( this, &TestNetBatchedUDP::handlePacket );
+
+         Con::printf( "   echoing %d packets from %d clients: per packet %dms, batched %dms",
+            (S32)TotalPackets, (S32)NumClients, unbatchedTime, batchedTime );
+      }
+      else
+         test( false, "Failed to open the client sockets!" );
+
+      for( U32 i = 0; i < mClients.size(); ++ i )
+         ::close( mClients[ i ] );
+      mClients.clear();
+
+      Net::closePort();
+   }
+};
+
+#endif // !TORQUE_SHIPPING && TORQUE_OS_LINUX
@@ -82,4 +82,71 @@ CreateUnitTest( TestThreadPool, "Platform/ThreadPool/Simple" )
 
 Vector< U32 > TestThreadPool::results( __FILE__, __LINE__ );
 
+// Test that a work item group only returns from wait() once every item
+// in it has finished, including the ones still executing when the
+// queue runs empty.
+
+CreateUnitTest( TestThreadPoolWorkItemGroup, "Platform/ThreadPool/WorkItemGroup" )
+{
+   enum { NUM_ITEMS = 64, NUM_ROUNDS = 4 };
+   
+   static Vector< U32 > results;
+   
+   struct TestItem : public ThreadPool::WorkItem
+   {
+         typedef ThreadPool::WorkItem Parent;
+         
+         ThreadPool::WorkItemGroup* mGroup;
+         U32 mIndex;
+         
+         TestItem( ThreadPool::WorkItemGroup* group, U32 index )
+            : mGroup( group ), mIndex( index ) {}
+      
+      protected:
+         virtual void execute()
+         {
+            // Keep the last items busy well past the point where
+            // the queue is empty.
+            if( mIndex % 16 == 15 )
+               Platform::sleep( 10 );
+               
+            results[ mIndex ] = mIndex;
+            mGroup->done();
+         }
+   };
+   
+   void run()
+   {
+      ThreadPool* pool = &ThreadPool::GLOBAL();
+      ThreadPool::WorkItemGroup group;
+      results.setSize( NUM_ITEMS );
+      
+      // Reuse the group to make sure wait() resets it.
+      for( U32 round = 0; round < NUM_ROUNDS; ++ round )
+      {
+         for( U32 i = 0; i < NUM_ITEMS; ++ i )
+            results[ i ] = U32( -1 );
+         
+         for( U32 i = 0; i < NUM_ITEMS; ++ i )
+         {
+            ThreadSafeRef< TestItem > item( new TestItem( &group, i ) );
+            group.add();
+            pool->queueWorkItem( item );
+         }
+         
+         group.wait();
+         
+         for( U32 i = 0; i < NUM_ITEMS; ++ i )
+            test( results[ i ] == i, "item not finished after wait()" );
+      }
+      
+      // Waiting on an empty group must not block.
+      group.wait();
+         
+      results.clear();
+   }
+};
+
+Vector< U32 > TestThreadPoolWorkItemGroup::results( __FILE__, __LINE__ );
+
 #endif // !TORQUE_SHIPPING
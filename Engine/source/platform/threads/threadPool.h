@@ -233,6 +233,61 @@ class ThreadPool
 
       typedef ThreadSafeRef< WorkItem > WorkItemPtr;
       struct GlobalThreadPool;
+
+      /// Lets the thread queueing a group of work items wait until all
+      /// of them have finished executing.
+      ///
+      /// flushWorkItems() only waits for the queue to run empty, so the
+      /// items taken from it last may still be executing when it returns.
+      /// Call add() before queueing each item and have the item call done()
+      /// as the very last thing in its execute().  The items must not be
+      /// cancellable.
+      class WorkItemGroup
+      {
+         protected:
+
+            /// Items added and not yet done, plus one until wait() is called.
+            volatile U32 mPending;
+
+            /// Released by the last item to finish while wait() is blocking.
+            Semaphore mFinished;
+
+            /// Decrement #mPending and return true if it dropped to zero.
+            bool _release()
+            {
+               U32 pending;
+               do
+                  pending = mPending;
+               while( !dCompareAndSwap( mPending, pending, pending - 1 ) );
+               return ( pending == 1 );
+            }
+
+         public:
+
+            WorkItemGroup()
+               : mPending( 1 ), mFinished( 0 ) {}
+
+            /// Account for an item about to be queued.
+            void add()
+            {
+               dFetchAndAdd( mPending, 1 );
+            }
+
+            /// Called by an item when it has finished.
+            void done()
+            {
+               if( _release() )
+                  mFinished.release();
+            }
+
+            /// Block until all items added since the last wait() are done.
+            void wait()
+            {
+               if( !_release() )
+                  mFinished.acquire();
+               mPending = 1;
+            }
+      };
       
    protected:
    
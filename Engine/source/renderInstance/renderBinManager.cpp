@@ -27,10 +27,16 @@
 #include "materials/matInstance.h"
 #include "scene/sceneManager.h"
 #include "console/engineAPI.h"
+#include "platform/profiler.h"
 
 
 IMPLEMENT_CONOBJECT(RenderBinManager);
 
+bool RenderBinManager::smUseSortHint = true;
+
+/// Lists this short or shorter are insertion sorted.
+static const U32 sgInsertionSortSize = 32;
+
 
 RenderBinManager::RenderBinManager( const RenderInstType& ritype, F32 renderOrder, F32 processAddOrder ) :
    mRenderInstType( ritype ),
@@ -40,6 +46,15 @@ RenderBinManager::RenderBinManager( const RenderInstType& ritype, F32 renderOrde
 {
    VECTOR_SET_ASSOCIATION( mElementList );
    mElementList.reserve( 2048 );
+
+   VECTOR_SET_ASSOCIATION( mLastSortOrder );
+   VECTOR_SET_ASSOCIATION( mSortPairs );
+   VECTOR_SET_ASSOCIATION( mSortTemp );
+   VECTOR_SET_ASSOCIATION( mSortElements );
+
+#ifdef TORQUE_ENABLE_PROFILER
+   mSortProfilerData = NULL;
+#endif
 }
 
 
@@ -60,6 +75,11 @@ void RenderBinManager::initPersistFields()
    addField("processAddOrder", TypeF32, Offset(mProcessAddOrder, RenderBinManager),
       "Defines the order for adding instances in relation to other bins." );
 
+   Con::addVariable( "$RenderBin::useSortHint", TypeBool, &smUseSortHint,
+      "@brief If true render bins first try to sort their elements into the same order as last frame.\n\n"
+      "This is much faster than a full sort when the scene is mostly unchanged from frame to frame.\n"
+      "@ingroup RenderBin\n" );
+
    Parent::initPersistFields();
 }
 
@@ -135,7 +155,174 @@ void RenderBinManager::clear()
 
 void RenderBinManager::sort()
 {
-   dQsort( mElementList.address(), mElementList.size(), sizeof(MainSortElem), cmpKeyFunc);
+#ifdef TORQUE_ENABLE_PROFILER
+   ScopedProfiler scopedProfiler( _getSortProfilerData() );
+#endif
+
+   sortElements( mElementList, &mLastSortOrder );
+}
+
+#ifdef TORQUE_ENABLE_PROFILER
+
+ProfilerRootData* RenderBinManager::_getSortProfilerData()
+{
+   if ( mSortProfilerData )
+      return mSortProfilerData;
+
+   // Bins of the same type share a marker as the profiler
+   // doesn't allow duplicate names.
+   const char *typeName = mRenderInstType.isValid() ? mRenderInstType.getName().c_str() : getClassName();
+   StringTableEntry name = StringTable->insert( avar( "RenderBin_Sort_%s", typeName ) );
+
+   static Vector<ProfilerRootData*> sSortProfilerData;
+   for ( U32 i = 0; i < sSortProfilerData.size(); i++ )
+   {
+      if ( sSortProfilerData[i]->mName == name )
+      {
+         mSortProfilerData = sSortProfilerData[i];
+         return mSortProfilerData;
+      }
+   }
+
+   mSortProfilerData = new ProfilerRootData( name );
+   sSortProfilerData.push_back( mSortProfilerData );
+   return mSortProfilerData;
+}
+
+#endif // TORQUE_ENABLE_PROFILER
+
+bool RenderBinManager::_insertionSortPairs( SortPair *pairs, U32 count, U32 maxMoves )
+{
+   U32 moves = 0;
+   for ( U32 i = 1; i < count; i++ )
+   {
+      if ( pairs[i - 1].key <= pairs[i].key )
+         continue;
+
+      const SortPair pair = pairs[i];
+      U32 j = i;
+      do
+      {
+         pairs[j] = pairs[j - 1];
+         j--;
+
+         if ( ++moves > maxMoves )
+            return false;
+      }
+      while ( j > 0 && pairs[j - 1].key > pair.key );
+
+      pairs[j] = pair;
+   }
+
+   return true;
+}
+
+void RenderBinManager::_radixSortPairs( SortPair *pairs, SortPair *temp, U32 count )
+{
+   // Build the histograms for all the passes at once.
+   U32 counts[8][256];
+   dMemset( counts, 0, sizeof( counts ) );
+
+   for ( U32 i = 0; i < count; i++ )
+   {
+      const U64 key = pairs[i].key;
+      for ( U32 b = 0; b < 8; b++ )
+         counts[b][ ( key >> ( b * 8 ) ) & 0xFF ]++;
+   }
+
+   SortPair *src = pairs;
+   SortPair *dst = temp;
+
+   for ( U32 b = 0; b < 8; b++ )
+   {
+      const U32 shift = b * 8;
+      U32 *digitCounts = counts[b];
+
+      // Skip the pass if every key has the same digit, which
+      // is common for the high bytes of pointers and distances.
+      if ( digitCounts[ ( src[0].key >> shift ) & 0xFF ] == count )
+         continue;
+
+      U32 offset = 0;
+      for ( U32 d = 0; d < 256; d++ )
+      {
+         const U32 digitCount = digitCounts[d];
+         digitCounts[d] = offset;
+         offset += digitCount;
+      }
+
+      for ( U32 i = 0; i < count; i++ )
+         dst[ digitCounts[ ( src[i].key >> shift ) & 0xFF ]++ ] = src[i];
+
+      SortPair *swap = src;
+      src = dst;
+      dst = swap;
+   }
+
+   if ( src != pairs )
+      dMemcpy( pairs, src, count * sizeof( SortPair ) );
+}
+
+void RenderBinManager::sortElements( Vector<MainSortElem> &elements, Vector<U32> *lastOrder )
+{
+   const U32 count = elements.size();
+   if ( count < 2 )
+   {
+      if ( lastOrder )
+      {
+         lastOrder->setSize( count );
+         if ( count == 1 )
+            (*lastOrder)[0] = 0;
+      }
+      return;
+   }
+
+   mSortPairs.setSize( count );
+   SortPair *pairs = mSortPairs.address();
+
+   // Elements are usually added in the same order every frame, so
+   // last frame's order is often still correct or nearly so.
+   bool sorted = false;
+   if ( smUseSortHint && lastOrder && lastOrder->size() == count )
+   {
+      const U32 *order = lastOrder->address();
+      for ( U32 i = 0; i < count; i++ )
+      {
+         pairs[i].key = getSortKey( elements[ order[i] ] );
+         pairs[i].index = order[i];
+      }
+
+      sorted = _insertionSortPairs( pairs, count, count );
+   }
+
+   if ( !sorted )
+   {
+      for ( U32 i = 0; i < count; i++ )
+      {
+         pairs[i].key = getSortKey( elements[i] );
+         pairs[i].index = i;
+      }
+
+      if ( count <= sgInsertionSortSize )
+         _insertionSortPairs( pairs, count, U32_MAX );
+      else
+      {
+         mSortTemp.setSize( count );
+         _radixSortPairs( pairs, mSortTemp.address(), count );
+      }
+   }
+
+   mSortElements.setSize( count );
+   for ( U32 i = 0; i < count; i++ )
+      mSortElements[i] = elements[ pairs[i].index ];
+   dMemcpy( elements.address(), mSortElements.address(), count * sizeof( MainSortElem ) );
+
+   if ( lastOrder )
+   {
+      lastOrder->setSize( count );
+      for ( U32 i = 0; i < count; i++ )
+         (*lastOrder)[i] = pairs[i].index;
+   }
 }
 
 S32 FN_CDECL RenderBinManager::cmpKeyFunc(const void* p1, const void* p2)
@@ -36,6 +36,7 @@
 #endif
 
 class SceneRenderState;
+struct ProfilerRootData;
 
 
 /// This delegate is used in derived RenderBinManager classes
@@ -81,6 +82,10 @@ public:
    /// QSort callback function
    static S32 FN_CDECL cmpKeyFunc(const void* p1, const void* p2);
 
+   /// If true the bins try last frame's sort order on the
+   /// new elements before falling back to a full sort.
+   static bool smUseSortHint;
+
    DECLARE_CONOBJECT(RenderBinManager);
    static void initPersistFields();
 
@@ -95,6 +100,37 @@ protected:
       U32 key2;
    };
 
+   /// A combined 64-bit sort key and the index of
+   /// the element it came from.
+   struct SortPair
+   {
+      U64 key;
+      U32 index;
+   };
+
+   /// Returns a key which orders elements like cmpKeyFunc()
+   /// when compared as an unsigned integer.
+   static U64 getSortKey( const MainSortElem &elem );
+
+   /// Sorts the elements into the order given by cmpKeyFunc().
+   ///
+   /// This is a stable radix sort over the 64-bit keys from getSortKey().
+   /// When smUseSortHint is set and the list has the same number of
+   /// elements as the last time it was sorted, it first tries the order
+   /// saved in lastOrder with a bounded insertion sort.
+   ///
+   /// @param elements  The list to sort.
+   /// @param lastOrder The sort order of the list from the last call, which
+   ///                  is updated on return, or NULL to always do a full sort.
+   void sortElements( Vector<MainSortElem> &elements, Vector<U32> *lastOrder );
+
+   /// Stable insertion sort of the pairs by key which gives up
+   /// once it has moved more than maxMoves elements.
+   static bool _insertionSortPairs( SortPair *pairs, U32 count, U32 maxMoves );
+
+   /// Stable LSD radix sort of the pairs by key, a byte at a time.
+   static void _radixSortPairs( SortPair *pairs, SortPair *temp, U32 count );
+
    void setRenderPass( RenderPassManager *rpm );
 
    /// Called from derived bins to add additional
@@ -102,6 +138,22 @@ protected:
    void notifyType( const RenderInstType &type );
 
    Vector< MainSortElem > mElementList; // List of our instances
+
+   /// The order mElementList was sorted into last frame.
+   /// @see sortElements
+   Vector<U32> mLastSortOrder;
+
+   /// Scratch space for sortElements().
+   Vector<SortPair> mSortPairs;
+   Vector<SortPair> mSortTemp;
+   Vector<MainSortElem> mSortElements;
+
+#ifdef TORQUE_ENABLE_PROFILER
+   /// The profiler marker for this bin's sort time.
+   ProfilerRootData *mSortProfilerData;
+
+   ProfilerRootData* _getSortProfilerData();
+#endif
    F32 mProcessAddOrder;   // Where in the list do we process RenderInstance additions?
    F32 mRenderOrder;       // Where in the list do we render?
 
@@ -156,6 +208,16 @@ inline bool RenderBinManager::newPassNeeded( MeshRenderInst *ri, MeshRenderInst*
    return false;
 }
 
+inline U64 RenderBinManager::getSortKey( const MainSortElem &elem )
+{
+   // cmpKeyFunc() orders by key descending and then by key2 ascending,
+   // comparing both as signed values.  Flipping the sign bit maps
+   // signed order onto unsigned order.
+   const U32 hi = ~( elem.key ^ 0x80000000 );
+   const U32 lo = elem.key2 ^ 0x80000000;
+   return ( U64( hi ) << 32 ) | lo;
+}
+
 inline BaseMatInstance* RenderBinManager::getMaterial( RenderInst *inst ) const
 {
    if (  inst->type == RenderPassManager::RIT_Mesh || 
@@ -40,6 +40,7 @@
 #include "core/util/safeDelete.h"
 #include "math/util/matrixSet.h"
 #include "console/engineAPI.h"
+#include "platform/platformTLS.h"
 
 
 const RenderInstType RenderInstType::Invalid( "" );
@@ -114,6 +115,31 @@ ConsoleDocClass( RenderPassManager,
    "@see RenderBinManager\n"
    "@ingroup RenderBin\n" );
 
+struct RenderPassManager::DeferredBatch
+{
+   /// The pass this batch belongs to.
+   RenderPassManager *pass;
+
+   /// Allocations made while this batch is current.
+   MultiTypedChunker chunker;
+
+   /// The instances added while this batch is current, in order.
+   Vector< RenderInst* > insts;
+
+   DeferredBatch( RenderPassManager *inPass )
+      : pass( inPass )
+   {
+      VECTOR_SET_ASSOCIATION( insts );
+   }
+};
+
+/// The DeferredBatch selected on each thread.
+static ThreadStorage& _getCurrentBatchStorage()
+{
+   static ThreadStorage theStorage;
+   return theStorage;
+}
+
 RenderPassManager::RenderBinEventSignal& RenderPassManager::getRenderBinSignal()
 {
    static RenderBinEventSignal theSignal;
@@ -127,7 +153,10 @@ void RenderPassManager::initPersistFields()
 RenderPassManager::RenderPassManager()
 {   
    mSceneManager = NULL;
+   mIsDeferring = false;
+   mNumDeferredBatches = 0;
    VECTOR_SET_ASSOCIATION( mRenderBins );
+   VECTOR_SET_ASSOCIATION( mDeferredBatches );
 
    mMatrixSet = reinterpret_cast<MatrixSet *>(dMalloc_aligned(sizeof(MatrixSet), 16));
    constructInPlace(mMatrixSet);
@@ -137,6 +166,9 @@ RenderPassManager::~RenderPassManager()
 {
    dFree_aligned(mMatrixSet);
 
+   for ( U32 i=0; i<mDeferredBatches.size(); i++ )
+      delete mDeferredBatches[i];
+
    // Any bins left need to be deleted.
    for ( U32 i=0; i<mRenderBins.size(); i++ )
    {
@@ -200,6 +232,16 @@ void RenderPassManager::addInst( RenderInst *inst )
 
    AssertFatal( inst != NULL, "RenderPassManager::addInst - Got null instance!" );
 
+   if ( mIsDeferring )
+   {
+      DeferredBatch *batch = _getCurrentBatch();
+      if ( batch )
+      {
+         batch->insts.push_back( inst );
+         return;
+      }
+   }
+
    AddInstTable::Iterator iter = mAddInstSignals.find( inst->type );
    if ( iter == mAddInstSignals.end() )
       return;
@@ -207,6 +249,56 @@ void RenderPassManager::addInst( RenderInst *inst )
    iter->value.trigger( inst );
 }
 
+void RenderPassManager::beginDeferring( U32 numBatches )
+{
+   AssertFatal( !mIsDeferring, "RenderPassManager::beginDeferring - Already deferring!" );
+
+   while ( mDeferredBatches.size() < numBatches )
+      mDeferredBatches.push_back( new DeferredBatch( this ) );
+
+   for ( U32 i=0; i<numBatches; i++ )
+      mDeferredBatches[i]->insts.clear();
+
+   mNumDeferredBatches = numBatches;
+   mIsDeferring = true;
+}
+
+void RenderPassManager::setCurrentBatch( DeferredBatch *batch )
+{
+   _getCurrentBatchStorage().set( batch );
+}
+
+void RenderPassManager::endDeferring()
+{
+   PROFILE_SCOPE( RenderPassManager_EndDeferring );
+
+   AssertFatal( mIsDeferring, "RenderPassManager::endDeferring - Not deferring!" );
+   mIsDeferring = false;
+
+   // Call our own addInst() as an override has already seen
+   // the instances when they were first added.
+   for ( U32 i=0; i<mNumDeferredBatches; i++ )
+   {
+      const Vector< RenderInst* > &insts = mDeferredBatches[i]->insts;
+      for ( U32 j=0; j<insts.size(); j++ )
+         RenderPassManager::addInst( insts[j] );
+   }
+
+   mNumDeferredBatches = 0;
+}
+
+RenderPassManager::DeferredBatch* RenderPassManager::_getCurrentBatch() const
+{
+   DeferredBatch *batch = (DeferredBatch*)_getCurrentBatchStorage().get();
+   return ( batch && batch->pass == this ) ? batch : NULL;
+}
+
+MultiTypedChunker& RenderPassManager::_getBatchChunker()
+{
+   DeferredBatch *batch = _getCurrentBatch();
+   return batch ? batch->chunker : mChunker;
+}
+
 void RenderPassManager::sort()
 {
    PROFILE_SCOPE( RenderPassManager_Sort );
@@ -224,6 +316,8 @@ void RenderPassManager::clear()
    PROFILE_SCOPE( RenderPassManager_Clear );
 
    mChunker.clear();
+   for ( U32 i=0; i<mDeferredBatches.size(); i++ )
+      mDeferredBatches[i]->chunker.clear();
 
    for (Vector<RenderBinManager *>::iterator itr = mRenderBins.begin();
       itr != mRenderBins.end(); itr++)
@@ -125,7 +125,7 @@ public:
    template <typename T>
    T* allocInst()
    {
-      T* inst = mChunker.alloc<T>();
+      T* inst = _getChunker().alloc<T>();
       inst->clear();
       return inst;
    }
@@ -133,7 +133,7 @@ public:
    /// Allocate a matrix, valid until ::clear called.
    MatrixF* allocUniqueXform(const MatrixF& data) 
    { 
-      MatrixF *r = mChunker.alloc<MatrixF>(); 
+      MatrixF *r = _getChunker().alloc<MatrixF>(); 
       *r = data; 
       return r; 
    }
@@ -152,11 +152,43 @@ public:
 
    /// Allocate a GFXPrimitive object which will remain valid 
    /// until the pass manager is cleared.
-   GFXPrimitive* allocPrim() { return mChunker.alloc<GFXPrimitive>(); }
+   GFXPrimitive* allocPrim() { return _getChunker().alloc<GFXPrimitive>(); }
    /// @}
 
    /// Add a RenderInstance to the list
    virtual void addInst( RenderInst *inst );
+
+   /// @name Deferred submission
+   ///
+   /// While deferring, render instances are allocated from and added to the
+   /// batch that the calling thread has selected with setCurrentBatch() rather
+   /// than being passed to the bins.  This allows several threads to run
+   /// prepRenderImage() at the same time.  endDeferring() then adds the instances
+   /// to the bins in batch order, so the bins see the same order as they would
+   /// if the batches had been submitted one after the other.
+   ///
+   /// @{
+
+   struct DeferredBatch;
+
+   /// Start deferring submissions into the given number of batches.
+   /// @note Only call this on the main thread.
+   void beginDeferring( U32 numBatches );
+
+   /// Return the batch at the given index.
+   DeferredBatch* getDeferredBatch( U32 index ) const { return mDeferredBatches[ index ]; }
+
+   /// Select the batch that submissions on the calling thread go to.  Pass
+   /// NULL when done.
+   static void setCurrentBatch( DeferredBatch *batch );
+
+   /// Stop deferring and add the deferred instances to the bins.
+   void endDeferring();
+
+   /// Return true if we are between beginDeferring() and endDeferring().
+   bool isDeferring() const { return mIsDeferring; }
+
+   /// @}
    
    /// Sorts the list of RenderInst's per bin. (Normally, one should just call renderPass)
    void sort();
@@ -237,6 +269,26 @@ public:
 protected:
 
    MultiTypedChunker mChunker;
+
+   /// True between beginDeferring() and endDeferring().
+   bool mIsDeferring;
+
+   /// Number of batches in use since beginDeferring().
+   U32 mNumDeferredBatches;
+
+   /// Batches are kept around and reused.  Their instances stay valid
+   /// until ::clear is called.
+   Vector< DeferredBatch* > mDeferredBatches;
+
+   /// Return the chunker to allocate from on the calling thread.
+   MultiTypedChunker& _getChunker() { return mIsDeferring ? _getBatchChunker() : mChunker; }
+
+   /// Return the chunker of the calling thread's batch or mChunker if
+   /// it has no batch on this pass.
+   MultiTypedChunker& _getBatchChunker();
+
+   /// Return the calling thread's batch if it belongs to this pass.
+   DeferredBatch* _getCurrentBatch() const;
       
    Vector< RenderBinManager* > mRenderBins;
 
@@ -251,8 +251,8 @@ void RenderPrePassMgr::sort()
 {
    PROFILE_SCOPE( RenderPrePassMgr_sort );
    Parent::sort();
-   dQsort( mTerrainElementList.address(), mTerrainElementList.size(), sizeof(MainSortElem), cmpKeyFunc);
-   dQsort( mObjectElementList.address(), mObjectElementList.size(), sizeof(MainSortElem), cmpKeyFunc);
+   sortElements( mTerrainElementList, &mTerrainLastSortOrder );
+   sortElements( mObjectElementList, &mObjectLastSortOrder );
 }
 
 void RenderPrePassMgr::clear()
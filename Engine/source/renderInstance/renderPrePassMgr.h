@@ -85,6 +85,11 @@ protected:
    /// The object render instance elements.
    Vector< MainSortElem > mObjectElementList;
 
+   /// The sort orders of the terrain and object
+   /// elements from last frame.
+   Vector<U32> mTerrainLastSortOrder;
+   Vector<U32> mObjectLastSortOrder;
+
    PrePassMatInstance *mPrePassMatInstance;
 
    virtual void _registerFeatures();
@@ -0,0 +1,185 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "console/console.h"
+#include "renderInstance/renderBinManager.h"
+#include "math/mRandom.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+CreateUnitTest( TestRenderBinSort, "RenderBin/Sort" )
+{
+   enum
+   {
+      NumElements = 20000,
+   };
+
+   /// Exposes the sorting of a bin.
+   class SortBin : public RenderBinManager
+   {
+   public:
+
+      /// Fills the bin with elements whose inst is their add order plus one.
+      /// The keys are kept in a range where cmpKeyFunc() can't overflow.
+      void fill( MRandomLCG &rand, U32 count, S32 numKeys )
+      {
+         mElementList.setSize( count );
+         for ( U32 i = 0; i < count; i++ )
+         {
+            MainSortElem &elem = mElementList[i];
+            elem.inst = (RenderInst*)( (dsize_t)i + 1 );
+            elem.key = U32( rand.randI( 0, numKeys - 1 ) - numKeys / 2 );
+            elem.key2 = U32( rand.randI( 0, numKeys - 1 ) - numKeys / 2 );
+         }
+      }
+
+      /// Changes the keys of a few elements, as a moving camera would.
+      void perturb( MRandomLCG &rand, U32 numChanges )
+      {
+         for ( U32 i = 0; i < numChanges; i++ )
+            mElementList[ rand.randI( 0, mElementList.size() - 1 ) ].key2 ^= 1;
+      }
+
+      void sortElements( bool useHint )
+      {
+         smUseSortHint = useHint;
+         RenderBinManager::sortElements( mElementList, &mLastSortOrder );
+      }
+
+      void qsortElements()
+      {
+         dQsort( mElementList.address(), mElementList.size(), sizeof( MainSortElem ), cmpKeyFunc );
+      }
+
+      /// Returns true if the elements are in cmpKeyFunc() order and, when
+      /// stable is set, elements with equal keys are in add order.
+      bool isSorted( bool stable ) const
+      {
+         for ( U32 i = 1; i < mElementList.size(); i++ )
+         {
+            const S32 cmp = cmpKeyFunc( &mElementList[i - 1], &mElementList[i] );
+            if ( cmp > 0 )
+               return false;
+            if ( stable && cmp == 0 && mElementList[i - 1].inst > mElementList[i].inst )
+               return false;
+         }
+
+         return true;
+      }
+
+      bool isPermutation() const
+      {
+         Vector<bool> seen;
+         seen.setSize( mElementList.size() );
+         dMemset( seen.address(), 0, seen.size() * sizeof( bool ) );
+
+         for ( U32 i = 0; i < mElementList.size(); i++ )
+         {
+            const dsize_t index = (dsize_t)mElementList[i].inst - 1;
+            if ( index >= seen.size() || seen[index] )
+               return false;
+            seen[index] = true;
+         }
+
+         return true;
+      }
+   };
+
+   void run()
+   {
+      const bool oldUseSortHint = RenderBinManager::smUseSortHint;
+
+      MRandomLCG rand( 1 );
+      SortBin bin;
+
+      // Short and long lists with few and many distinct keys.
+      const U32 counts[] = { 0, 1, 2, 17, 33, 1000, NumElements };
+      const S32 numKeys[] = { 4, 1 << 16, 1 << 30 };
+      for ( U32 i = 0; i < sizeof( counts ) / sizeof( counts[0] ); i++ )
+      {
+         for ( U32 j = 0; j < sizeof( numKeys ) / sizeof( numKeys[0] ); j++ )
+         {
+            bin.fill( rand, counts[i], numKeys[j] );
+            bin.sortElements( false );
+            test( bin.isPermutation(), "Sorting lost or duplicated elements!" );
+            test( bin.isSorted( true ), "Elements are not stably sorted!" );
+         }
+      }
+
+      // Sorting with last frame's order as the hint, with
+      // none, a few and all of the keys changed.
+      const U32 changes[] = { 0, 10, NumElements };
+      for ( U32 i = 0; i < sizeof( changes ) / sizeof( changes[0] ); i++ )
+      {
+         MRandomLCG fillRand( 2 );
+         bin.fill( fillRand, NumElements, 1 << 16 );
+         bin.sortElements( true );
+
+         MRandomLCG refillRand( 2 );
+         bin.fill( refillRand, NumElements, 1 << 16 );
+         bin.perturb( rand, changes[i] );
+         bin.sortElements( true );
+
+         test( bin.isPermutation(), "Sorting with the hint lost or duplicated elements!" );
+         test( bin.isSorted( false ), "Elements are not sorted when using the hint!" );
+      }
+
+      // Compare the speed against dQsort.
+      U32 start = Platform::getRealMilliseconds();
+      for ( U32 i = 0; i < 50; i++ )
+      {
+         MRandomLCG fillRand( 3 );
+         bin.fill( fillRand, NumElements, 1 << 30 );
+         bin.qsortElements();
+      }
+      const U32 qsortTime = Platform::getRealMilliseconds() - start;
+
+      start = Platform::getRealMilliseconds();
+      for ( U32 i = 0; i < 50; i++ )
+      {
+         MRandomLCG fillRand( 3 );
+         bin.fill( fillRand, NumElements, 1 << 30 );
+         bin.sortElements( false );
+      }
+      const U32 radixTime = Platform::getRealMilliseconds() - start;
+
+      start = Platform::getRealMilliseconds();
+      for ( U32 i = 0; i < 50; i++ )
+      {
+         MRandomLCG fillRand( 3 );
+         bin.fill( fillRand, NumElements, 1 << 30 );
+         bin.sortElements( true );
+      }
+      const U32 hintTime = Platform::getRealMilliseconds() - start;
+
+      Con::printf( "   sorting %d elements x 50: dQsort %dms, radix %dms, with hint %dms", (S32)NumElements, qsortTime, radixTime, hintTime );
+
+      RenderBinManager::smUseSortHint = oldUseSortHint;
+   }
+};
+
+#endif // TORQUE_SHIPPING
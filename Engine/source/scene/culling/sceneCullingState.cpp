@@ -31,6 +31,7 @@
 #include "terrain/terrData.h"
 #include "util/tempAlloc.h"
 #include "gfx/sim/debugDraw.h"
+#include "platform/threads/threadPool.h"
 
 
 extern bool gEditingMission;
@@ -42,6 +43,8 @@ U32 SceneCullingState::smMaxOccludersPerZone = 4;
 F32 SceneCullingState::smOccluderMinWidthPercentage = 0.1f;
 F32 SceneCullingState::smOccluderMinHeightPercentage = 0.1f;
 
+const U32 SceneCullingState::csmCullBatchSize = 512;
+
 
 
 //-----------------------------------------------------------------------------
@@ -707,6 +710,75 @@ bool SceneCullingState::isOccluded( const SphereF& sphere, const U32* zones, U32
 
 //-----------------------------------------------------------------------------
 
+SceneCullingState::ObjectCullResult SceneCullingState::_cullObject( SceneObject* object, U32 cullOptions,
+                                                                    const PlaneF& nearPlane, const PlaneF& farPlane ) const
+{
+   // If we should respect editor overrides, test that now.
+
+   if( !( cullOptions & CullEditorOverrides ) &&
+       gEditingMission &&
+       ( ( object->isCullingDisabledInEditor() && object->isRenderEnabled() ) || object->isSelected() ) )
+      return ObjectVisible;
+
+   // If the object is render-disabled, it gets culled.  The only
+   // way around this is the editor override above.
+
+   if( !( cullOptions & DontCullRenderDisabled ) &&
+       !object->isRenderEnabled() )
+      return ObjectCulled;
+
+   // Global bounds objects are never culled.  Note that this means
+   // that if these objects are to respect zoning, they need to manually
+   // trigger the respective culling checks for whatever they want to
+   // batch.
+
+   if( object->isGlobalBounds() )
+      return ObjectVisible;
+
+   bool isCulled;
+
+   // If the object shouldn't be subjected to more fine-grained culling
+   // or if zone culling is disabled, just test against the root frustum.
+
+   if( !( object->getTypeMask() & CULLING_INCLUDE_TYPEMASK ) ||
+       ( object->getTypeMask() & CULLING_EXCLUDE_TYPEMASK ) ||
+       disableZoneCulling() )
+   {
+      isCulled = getFrustum().isCulled( object->getWorldBox() );
+   }
+
+   // Go through the zones that the object is assigned to and
+   // test the object against the frustums of each of the zones.
+
+   else
+   {
+      CullingTestResult result = _test(
+         object->getWorldBox(),
+         SceneObject::ObjectZonesIterator( object ),
+         nearPlane,
+         farPlane
+      );
+
+      isCulled = ( result == SceneZoneCullingState::CullingTestNegative ||
+                   result == SceneZoneCullingState::CullingTestPositiveByOcclusion );
+   }
+
+   if( isCulled )
+      return ObjectCulled;
+
+   // If terrain occlusion checks are enabled, leave them to the caller.  They
+   // are the most expensive test so they are only run on objects that would
+   // otherwise be visible.
+
+   if( !mDisableTerrainOcclusion &&
+       object->getWorldBox().minExtents.x > -1e5 )
+      return ObjectVisibleUnlessOccludedByTerrain;
+
+   return ObjectVisible;
+}
+
+//-----------------------------------------------------------------------------
+
 U32 SceneCullingState::cullObjects( SceneObject** objects, U32 numObjects, U32 cullOptions ) const
 {
    PROFILE_SCOPE( SceneCullingState_cullObjects );
@@ -721,72 +793,98 @@ U32 SceneCullingState::cullObjects( SceneObject** objects, U32 numObjects, U32 c
    for( U32 i = 0; i < numObjects; ++ i )
    {
       SceneObject* object = objects[ i ];
-      bool isCulled = true;
 
-      // If we should respect editor overrides, test that now.
+      const ObjectCullResult result = _cullObject( object, cullOptions, nearPlane, farPlane );
+      if( result == ObjectVisible ||
+          ( result == ObjectVisibleUnlessOccludedByTerrain && !isOccludedByTerrain( object ) ) )
+         objects[ numRemainingObjects ++ ] = object;
+   }
 
-      if( !( cullOptions & CullEditorOverrides ) &&
-          gEditingMission &&
-          ( ( object->isCullingDisabledInEditor() && object->isRenderEnabled() ) || object->isSelected() ) )
-      {
-         isCulled = false;
-      }
+   return numRemainingObjects;
+}
 
-      // If the object is render-disabled, it gets culled.  The only
-      // way around this is the editor override above.
+//-----------------------------------------------------------------------------
 
-      else if( !( cullOptions & DontCullRenderDisabled ) &&
-               !object->isRenderEnabled() )
-      {
-         isCulled = true;
-      }
+struct SceneCullingState::CullObjectsWorkItem : public ThreadPool::WorkItem
+{
+   typedef ThreadPool::WorkItem Parent;
 
-      // Global bounds objects are never culled.  Note that this means
-      // that if these objects are to respect zoning, they need to manually
-      // trigger the respective culling checks for whatever they want to
-      // batch.
+   const SceneCullingState* mState;
+   ThreadPool::WorkItemGroup* mGroup;
+   SceneObject** mObjects;
+   U8* mResults;
+   U32 mNumObjects;
+   U32 mCullOptions;
 
-      else if( object->isGlobalBounds() )
-         isCulled = false;
+   CullObjectsWorkItem( const SceneCullingState* state, ThreadPool::WorkItemGroup* group, SceneObject** objects, U8* results, U32 numObjects, U32 cullOptions )
+      : mState( state ), mGroup( group ), mObjects( objects ), mResults( results ), mNumObjects( numObjects ), mCullOptions( cullOptions ) {}
+
+   virtual void execute()
+   {
+      const PlaneF& nearPlane = mState->getFrustum().getPlanes()[ Frustum::PlaneNear ];
+      const PlaneF& farPlane = mState->getFrustum().getPlanes()[ Frustum::PlaneFar ];
 
-      // If terrain occlusion checks are enabled, run them now.
+      // Terrain ray casts are reentrant so the terrain occlusion tests
+      // run here as well.
 
-      else if( !mDisableTerrainOcclusion &&
-               object->getWorldBox().minExtents.x > -1e5 &&
-               isOccludedByTerrain( object ) )
+      for( U32 i = 0; i < mNumObjects; ++ i )
       {
-         // Occluded by terrain.
-         isCulled = true;
-      }
+         SceneObject* object = mObjects[ i ];
 
-      // If the object shouldn't be subjected to more fine-grained culling
-      // or if zone culling is disabled, just test against the root frustum.
+         ObjectCullResult result = mState->_cullObject( object, mCullOptions, nearPlane, farPlane );
+         if( result == ObjectVisibleUnlessOccludedByTerrain )
+            result = mState->isOccludedByTerrain( object ) ? ObjectCulled : ObjectVisible;
 
-      else if( !( object->getTypeMask() & CULLING_INCLUDE_TYPEMASK ) ||
-               ( object->getTypeMask() & CULLING_EXCLUDE_TYPEMASK ) ||
-               disableZoneCulling() )
-      {
-         isCulled = getFrustum().isCulled( object->getWorldBox() );
+         mResults[ i ] = result;
       }
 
-      // Go through the zones that the object is assigned to and
-      // test the object against the frustums of each of the zones.
+      mGroup->done();
+   }
+};
 
-      else
-      {
-         CullingTestResult result = _test(
-            object->getWorldBox(),
-            SceneObject::ObjectZonesIterator( object ),
-            nearPlane,
-            farPlane
-         );
+U32 SceneCullingState::cullObjectsParallel( SceneObject** objects, U32 numObjects, U32 cullOptions ) const
+{
+   if( numObjects <= csmCullBatchSize )
+      return cullObjects( objects, numObjects, cullOptions );
 
-         isCulled = ( result == SceneZoneCullingState::CullingTestNegative ||
-                      result == SceneZoneCullingState::CullingTestPositiveByOcclusion );
-      }
+   PROFILE_SCOPE( SceneCullingState_cullObjectsParallel );
 
-      if( !isCulled )
-         objects[ numRemainingObjects ++ ] = object;
+   // The frustum and the zone states compute some of their data lazily
+   // on first use.  Do this here so the work items only read them.
+
+   getFrustum().getPlanes();
+   for( U32 i = 0; i < mZoneStates.size(); ++ i )
+   {
+      if( !mZoneStates[ i ].mHaveSortedVolumes )
+         mZoneStates[ i ]._sortVolumes();
+   }
+
+   TempAlloc< U8 > results( numObjects );
+
+   ThreadPool::WorkItemGroup group;
+   Vector< ThreadSafeRef< CullObjectsWorkItem > > items;
+   for( U32 first = 0; first < numObjects; first += csmCullBatchSize )
+   {
+      const U32 count = getMin( csmCullBatchSize, numObjects - first );
+      ThreadSafeRef< CullObjectsWorkItem > item( new CullObjectsWorkItem( this, &group, objects + first, results + first, count, cullOptions ) );
+      items.push_back( item );
+   }
+
+   ThreadPool* pool = &ThreadPool::GLOBAL();
+   for( U32 i = 0; i < items.size(); ++ i )
+   {
+      group.add();
+      pool->queueWorkItem( items[ i ] );
+   }
+   group.wait();
+
+   // Compact the list.
+
+   U32 numRemainingObjects = 0;
+   for( U32 i = 0; i < numObjects; ++ i )
+   {
+      if( results[ i ] == ObjectVisible )
+         objects[ numRemainingObjects ++ ] = objects[ i ];
    }
 
    return numRemainingObjects;
@@ -843,7 +941,7 @@ bool SceneCullingState::isOccludedByTerrain( SceneObject* object ) const
       Point3F xBaseL1_s = ur - localCamPos;
       Point3F xBaseL1_e = ll - localCamPos;
 
-      static F32 checkPoints[3] = {0.75, 0.5, 0.25};
+      static const F32 checkPoints[3] = {0.75, 0.5, 0.25};
       RayInfo rinfo;
       for( U32 i = 0; i < 3; i ++ )
       {
@@ -170,6 +170,17 @@ class SceneCullingState
       /// @return Number of objects remaining in the list.
       U32 cullObjects( SceneObject** objects, U32 numObjects, U32 cullOptions = 0 ) const;
 
+      /// Cull the given list of objects like cullObjects() but test them in batches
+      /// on the global thread pool.
+      ///
+      /// The objects, the terrains, and the culling state must not change while this
+      /// runs.  Terrain occlusion is tested inside the batches along with the other
+      /// tests.  The objects that remain and their order are the same as with
+      /// cullObjects().
+      ///
+      /// @note Only call this on the main thread.
+      U32 cullObjectsParallel( SceneObject** objects, U32 numObjects, U32 cullOptions = 0 ) const;
+
       /// Return true if the given object is culled according to the current culling state.
       bool isCulled( SceneObject* object ) const { return ( cullObjects( &object, 1 ) == 0 ); }
 
@@ -299,6 +310,22 @@ class SceneCullingState
 
       typedef SceneZoneCullingState::CullingTestResult CullingTestResult;
 
+      /// Result of testing a single object in cullObjects().
+      enum ObjectCullResult
+      {
+         ObjectCulled,
+         ObjectVisible,
+         ObjectVisibleUnlessOccludedByTerrain
+      };
+
+      struct CullObjectsWorkItem;
+
+      /// Number of objects tested by each work item in cullObjectsParallel().
+      static const U32 csmCullBatchSize;
+
+      /// Test a single object against everything but the terrains.
+      ObjectCullResult _cullObject( SceneObject* object, U32 cullOptions, const PlaneF& nearPlane, const PlaneF& farPlane ) const;
+
       // Helper methods to avoid code duplication.
 
       template< bool OCCLUDERS_ONLY, typename T > CullingTestResult _test( const T& bounds, const U32* zones, U32 numZones ) const;
@@ -29,6 +29,7 @@
 #include "platform/profiler.h"
 #include "console/engineAPI.h"
 #include "math/util/frustum.h"
+#include "platform/threads/threadPool.h"
 
 
 // [rene, 02-Mar-11]
@@ -45,6 +46,7 @@ const U32 SceneContainer::csmNumBins = 16;
 const F32 SceneContainer::csmBinSize = 64;
 const F32 SceneContainer::csmTotalBinSize = SceneContainer::csmBinSize * SceneContainer::csmNumBins;
 const U32 SceneContainer::csmRefPoolBlockSize = 4096;
+const U32 SceneContainer::csmRayBatchItemSize = 256;
 
 // Statics used by buildPolyList methods
 static AbstractPolyList* sPolyList;
@@ -91,7 +93,10 @@ void SceneContainer::Link::linkAfter(SceneContainer::Link* ptr)
 SceneContainer::SceneContainer()
 {
    mSearchInProgress = false;
+   mFrozen = false;
    mCurrSeqKey = 0;
+   mChangeCount = 0;
+   mSpatialIndex = SpatialIndexTree;
 
    mEnd.next = mEnd.prev = &mStart;
    mStart.next = mStart.prev = &mEnd;
@@ -117,6 +122,9 @@ SceneContainer::SceneContainer()
    VECTOR_SET_ASSOCIATION( mSearchList );
    VECTOR_SET_ASSOCIATION( mWaterAndZones );
    VECTOR_SET_ASSOCIATION( mTerrains );
+   VECTOR_SET_ASSOCIATION( mGlobalBoundsObjects );
+   VECTOR_SET_ASSOCIATION( mQueryResults );
+   VECTOR_SET_ASSOCIATION( mRayBatchT );
 
    mFreeRefPool = NULL;
    addRefPoolBlock();
@@ -159,10 +167,15 @@ SceneContainer::~SceneContainer()
 bool SceneContainer::addObject(SceneObject* obj)
 {
    AssertFatal(obj->mContainer == NULL, "Adding already added object.");
+   AssertFatal( !mFrozen, "SceneContainer::addObject - Container is frozen" );
    obj->mContainer = this;
    obj->linkAfter(&mStart);
+   mChangeCount++;
 
-   insertIntoBins(obj);
+   if( mSpatialIndex == SpatialIndexTree )
+      _insertIntoTree( obj );
+   else
+      insertIntoBins(obj);
 
    // Also insert water and physical zone types into the special vector.
    if ( obj->getTypeMask() & ( WaterObjectType | PhysicalZoneObjectType ) )
@@ -178,7 +191,13 @@ bool SceneContainer::addObject(SceneObject* obj)
 bool SceneContainer::removeObject(SceneObject* obj)
 {
    AssertFatal(obj->mContainer == this, "Trying to remove from wrong container.");
-   removeFromBins(obj);
+   AssertFatal( !mFrozen, "SceneContainer::removeObject - Container is frozen" );
+   mChangeCount++;
+
+   if( mSpatialIndex == SpatialIndexTree )
+      _removeFromTree( obj );
+   else
+      removeFromBins(obj);
 
    // Remove water and physical zone types from the special vector.
    if ( obj->getTypeMask() & ( WaterObjectType | PhysicalZoneObjectType ) )
@@ -382,8 +401,17 @@ void SceneContainer::removeFromBins(SceneObject* obj)
 void SceneContainer::checkBins(SceneObject* obj)
 {
    AssertFatal(obj != NULL, "No object?");
+   AssertFatal( !mFrozen, "SceneContainer::checkBins - Container is frozen" );
+   mChangeCount++;
 
    PROFILE_START(CheckBins);
+   if( mSpatialIndex == SpatialIndexTree )
+   {
+      _checkTree( obj );
+      PROFILE_END();
+      return;
+   }
+
    if (obj->mBinRefHead == NULL)
    {
       insertIntoBins(obj);
@@ -411,6 +439,178 @@ void SceneContainer::checkBins(SceneObject* obj)
 
 //-----------------------------------------------------------------------------
 
+void SceneContainer::setSpatialIndex( SpatialIndex index )
+{
+   AssertFatal( !mSearchInProgress, "SceneContainer::setSpatialIndex - Cannot switch index during a query" );
+   AssertFatal( !mFrozen, "SceneContainer::setSpatialIndex - Container is frozen" );
+
+   if( index == mSpatialIndex )
+      return;
+
+   for( Link* itr = mStart.next; itr != &mEnd; itr = itr->next )
+   {
+      SceneObject* ptr = static_cast< SceneObject* >( itr );
+      if( mSpatialIndex == SpatialIndexTree )
+         _removeFromTree( ptr );
+      else
+         removeFromBins( ptr );
+   }
+
+   mSpatialIndex = index;
+
+   for( Link* itr = mStart.next; itr != &mEnd; itr = itr->next )
+   {
+      SceneObject* ptr = static_cast< SceneObject* >( itr );
+      if( mSpatialIndex == SpatialIndexTree )
+         _insertIntoTree( ptr );
+      else
+         insertIntoBins( ptr );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::freeze()
+{
+   AssertFatal( !mFrozen, "SceneContainer::freeze - Container already frozen" );
+   mFrozen = true;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::unfreeze()
+{
+   AssertFatal( mFrozen, "SceneContainer::unfreeze - Container not frozen" );
+   mFrozen = false;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::_insertIntoTree( SceneObject* object )
+{
+   AssertFatal( object->mContainerTreeLeaf == SceneContainerTree::NullNode, "SceneContainer::_insertIntoTree - Object already in tree" );
+
+   // Global bounds would swallow the whole tree so keep those aside.
+   if( object->isGlobalBounds() )
+      mGlobalBoundsObjects.push_back( object );
+   else
+      object->mContainerTreeLeaf = mTree.insert( object, object->getWorldBox() );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::_removeFromTree( SceneObject* object )
+{
+   if( object->mContainerTreeLeaf != SceneContainerTree::NullNode )
+   {
+      mTree.remove( object->mContainerTreeLeaf );
+      object->mContainerTreeLeaf = SceneContainerTree::NullNode;
+   }
+   else
+   {
+      Vector< SceneObject* >::iterator iter = find( mGlobalBoundsObjects.begin(), mGlobalBoundsObjects.end(), object );
+      if( iter != mGlobalBoundsObjects.end() )
+         mGlobalBoundsObjects.erase_fast( iter );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::_checkTree( SceneObject* object )
+{
+   const bool inTree = ( object->mContainerTreeLeaf != SceneContainerTree::NullNode );
+
+   // Objects may switch in and out of global bounds.
+   if( inTree == object->isGlobalBounds() )
+   {
+      _removeFromTree( object );
+      _insertIntoTree( object );
+   }
+   else if( inTree )
+      mTree.update( object->mContainerTreeLeaf, object->getWorldBox() );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::_findTreeObjects( const Box3F& box, U32 mask )
+{
+   mQueryResults.clear();
+   mTree.findObjects( box, mQueryResults );
+
+   // Leaf boxes are fattened so test the actual world boxes.
+   for( U32 i = 0; i < mQueryResults.size(); )
+   {
+      SceneObject* object = mQueryResults[ i ];
+      if( ( object->getTypeMask() & mask ) != 0 &&
+          object->isCollisionEnabled() &&
+          object->getWorldBox().isOverlapped( box ) )
+         i ++;
+      else
+         mQueryResults.erase_fast( i );
+   }
+
+   for( U32 i = 0; i < mGlobalBoundsObjects.size(); ++ i )
+   {
+      SceneObject* object = mGlobalBoundsObjects[ i ];
+      if( ( object->getTypeMask() & mask ) != 0 && object->isCollisionEnabled() )
+         mQueryResults.push_back( object );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+static S32 QSORT_CALLBACK cmpObjectPointers( const void* a, const void* b )
+{
+   const dsize_t pa = dsize_t( *( SceneObject* const* ) a );
+   const dsize_t pb = dsize_t( *( SceneObject* const* ) b );
+   return pa < pb ? -1 : ( pa > pb ? 1 : 0 );
+}
+
+void SceneContainer::_findCandidates( const Box3F& box, Vector< SceneObject* >& outObjects, SceneContainerTree::QueryStack& stack ) const
+{
+   outObjects.clear();
+
+   if( mSpatialIndex == SpatialIndexTree )
+   {
+      mTree.findObjects( box, outObjects, stack );
+      outObjects.merge( mGlobalBoundsObjects );
+      return;
+   }
+
+   // Without sequence keys, objects spanning several bins are collected
+   // more than once and have to be weeded out afterwards.
+
+   U32 minX, maxX, minY, maxY;
+   getBinRange( box.minExtents.x, box.maxExtents.x, minX, maxX );
+   getBinRange( box.minExtents.y, box.maxExtents.y, minY, maxY );
+
+   for( U32 i = minY; i <= maxY; i++ )
+   {
+      U32 base = ( i % csmNumBins ) * csmNumBins;
+      for( U32 j = minX; j <= maxX; j++ )
+      {
+         for( SceneObjectRef* chain = mBinArray[ base + ( j % csmNumBins ) ].nextInBin; chain; chain = chain->nextInBin )
+            outObjects.push_back( chain->object );
+      }
+   }
+
+   for( SceneObjectRef* chain = mOverflowBin.nextInBin; chain; chain = chain->nextInBin )
+      outObjects.push_back( chain->object );
+
+   if( outObjects.size() < 2 )
+      return;
+
+   dQsort( outObjects.address(), outObjects.size(), sizeof( SceneObject* ), cmpObjectPointers );
+
+   U32 count = 1;
+   for( U32 i = 1; i < outObjects.size(); ++ i )
+      if( outObjects[ i ] != outObjects[ count - 1 ] )
+         outObjects[ count ++ ] = outObjects[ i ];
+   outObjects.setSize( count );
+}
+
+//-----------------------------------------------------------------------------
+
 void SceneContainer::findObjects(const Box3F& box, U32 mask, FindCallback callback, void *key)
 {
    PROFILE_SCOPE(ContainerFindObjects_Box);
@@ -433,6 +633,16 @@ void SceneContainer::findObjects(const Box3F& box, U32 mask, FindCallback callba
    AssertFatal( !mSearchInProgress, "SceneContainer::findObjects - Container queries are not re-entrant" );
    mSearchInProgress = true;
 
+   if( mSpatialIndex == SpatialIndexTree )
+   {
+      _findTreeObjects( box, mask );
+      for( U32 i = 0; i < mQueryResults.size(); ++ i )
+         (*callback)( mQueryResults[ i ], key );
+
+      mSearchInProgress = false;
+      return;
+   }
+
    U32 minX, maxX, minY, maxY;
    getBinRange(box.minExtents.x, box.maxExtents.x, minX, maxX);
    getBinRange(box.minExtents.y, box.maxExtents.y, minY, maxY);
@@ -511,6 +721,20 @@ void SceneContainer::findObjects( const Frustum &frustum, U32 mask, FindCallback
    AssertFatal( !mSearchInProgress, "SceneContainer::findObjects - Container queries are not re-entrant" );
    mSearchInProgress = true;
 
+   if( mSpatialIndex == SpatialIndexTree )
+   {
+      _findTreeObjects( searchBox, mask );
+      for( U32 i = 0; i < mQueryResults.size(); ++ i )
+      {
+         SceneObject* object = mQueryResults[ i ];
+         if( !frustum.isCulled( object->getWorldBox() ) )
+            (*callback)( object, key );
+      }
+
+      mSearchInProgress = false;
+      return;
+   }
+
    U32 minX, maxX, minY, maxY;
    getBinRange(searchBox.minExtents.x, searchBox.maxExtents.x, minX, maxX);
    getBinRange(searchBox.minExtents.y, searchBox.maxExtents.y, minY, maxY);
@@ -608,6 +832,16 @@ void SceneContainer::polyhedronFindObjects(const Polyhedron& polyhedron, U32 mas
    AssertFatal( !mSearchInProgress, "SceneContainer::polyhedronFindObjects - Container queries are not re-entrant" );
    mSearchInProgress = true;
 
+   if( mSpatialIndex == SpatialIndexTree )
+   {
+      _findTreeObjects( box, mask );
+      for( U32 i = 0; i < mQueryResults.size(); ++ i )
+         (*callback)( mQueryResults[ i ], key );
+
+      mSearchInProgress = false;
+      return;
+   }
+
    U32 minX, maxX, minY, maxY;
    getBinRange(box.minExtents.x, box.maxExtents.x, minX, maxX);
    getBinRange(box.minExtents.y, box.maxExtents.y, minY, maxY);
@@ -673,6 +907,15 @@ void SceneContainer::findObjectList( const Box3F& searchBox, U32 mask, Vector<Sc
 
    // TODO: Optimize for water and zones?
 
+   if( mSpatialIndex == SpatialIndexTree )
+   {
+      _findTreeObjects( searchBox, mask );
+      outFound->merge( mQueryResults );
+
+      mSearchInProgress = false;
+      return;
+   }
+
    U32 minX, maxX, minY, maxY;
    getBinRange(searchBox.minExtents.x, searchBox.maxExtents.x, minX, maxX);
    getBinRange(searchBox.minExtents.y, searchBox.maxExtents.y, minY, maxY);
@@ -839,6 +1082,34 @@ bool SceneContainer::castRayRendered( const Point3F& start, const Point3F& end,
 
 //-----------------------------------------------------------------------------
 
+bool SceneContainer::_castRay( U32 type, const Point3F& start, const Point3F& end, U32 mask, RayInfo* info, CastRayCallback callback )
+{
+   AssertFatal( !mSearchInProgress, "SceneContainer::_castRay - Container queries are not re-entrant" );
+   mSearchInProgress = true;
+
+   F32 currentT = 2.0;
+   if( mSpatialIndex == SpatialIndexTree )
+      _castRayTree( type, start, end, mask, info, currentT, callback );
+   else
+      _castRayBinGrid( type, start, end, mask, info, currentT, callback );
+
+   mSearchInProgress = false;
+
+   // Bump the normal into worldspace if appropriate.
+   if(currentT != 2)
+   {
+      _transformRayNormal( info );
+      return true;
+   }
+   else
+   {
+      // Do nothing and exit...
+      return false;
+   }
+}
+
+//-----------------------------------------------------------------------------
+
 // DMMNOTE: There are still some optimizations to be done here.  In particular:
 //           - After checking the overflow bin, we can potentially shorten the line
 //             that we rasterize against the grid if there is a collision with say,
@@ -851,12 +1122,8 @@ bool SceneContainer::castRayRendered( const Point3F& start, const Point3F& end,
 //             rasterizer for anti-aliased lines that will serve better than what
 //             we have below.
 
-bool SceneContainer::_castRay( U32 type, const Point3F& start, const Point3F& end, U32 mask, RayInfo* info, CastRayCallback callback )
+void SceneContainer::_castRayBinGrid( U32 type, const Point3F& start, const Point3F& end, U32 mask, RayInfo* info, F32& currentT, CastRayCallback callback )
 {
-   AssertFatal( !mSearchInProgress, "SceneContainer::_castRay - Container queries are not re-entrant" );
-   mSearchInProgress = true;
-
-   F32 currentT = 2.0;
    mCurrSeqKey++;
 
    SceneObjectRef* chain = mOverflowBin.nextInBin;
@@ -1100,29 +1367,231 @@ bool SceneContainer::_castRay( U32 type, const Point3F& start, const Point3F& en
          currStartX = currEndX;
       }
    }
+}
 
-   mSearchInProgress = false;
+//-----------------------------------------------------------------------------
 
-   // Bump the normal into worldspace if appropriate.
-   if(currentT != 2)
+struct SceneContainer::TreeRayVisitor
+{
+   U32 type;
+   const Point3F& start;
+   const Point3F& end;
+   U32 mask;
+   RayInfo* info;
+   F32& currentT;
+   SceneContainer::CastRayCallback callback;
+
+   TreeRayVisitor( U32 inType, const Point3F& inStart, const Point3F& inEnd, U32 inMask, RayInfo* inInfo, F32& inCurrentT, SceneContainer::CastRayCallback inCallback )
+      : type( inType ), start( inStart ), end( inEnd ), mask( inMask ), info( inInfo ), currentT( inCurrentT ), callback( inCallback ) {}
+
+   F32 operator()( SceneObject* object )
    {
-      PlaneF fakePlane;
-      fakePlane.x = info->normal.x;
-      fakePlane.y = info->normal.y;
-      fakePlane.z = info->normal.z;
-      fakePlane.d = 0;
+      if( ( object->getTypeMask() & mask ) != 0 &&
+          object->isCollisionEnabled() &&
+          object->getWorldBox().collideLine( start, end ) )
+         SceneContainer::_castRayObject( object, type, start, end, info, currentT, callback );
 
-      PlaneF result;
-      mTransformPlane(info->object->getTransform(), info->object->getScale(), fakePlane, &result);
-      info->normal = result;
+      // Nodes entered past the closest hit can be skipped.
+      return getMin( currentT, 1.0f );
+   }
+};
 
-      return true;
+void SceneContainer::_castRayTree( U32 type, const Point3F& start, const Point3F& end, U32 mask, RayInfo* info, F32& currentT, CastRayCallback callback )
+{
+   for( U32 i = 0; i < mGlobalBoundsObjects.size(); ++ i )
+   {
+      SceneObject* object = mGlobalBoundsObjects[ i ];
+      if( ( object->getTypeMask() & mask ) != 0 && object->isCollisionEnabled() )
+         _castRayObject( object, type, start, end, info, currentT, callback );
+   }
+
+   TreeRayVisitor visitor( type, start, end, mask, info, currentT, callback );
+   mTree.castRay( start, end, visitor );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::_castRayObject( SceneObject* object, U32 type, const Point3F& start, const Point3F& end, RayInfo* info, F32& currentT, CastRayCallback callback )
+{
+   Point3F xformedStart, xformedEnd;
+   object->mWorldToObj.mulP(start, &xformedStart);
+   object->mWorldToObj.mulP(end,   &xformedEnd);
+   xformedStart.convolveInverse(object->mObjScale);
+   xformedEnd.convolveInverse(object->mObjScale);
+
+   RayInfo ri;
+   ri.generateTexCoord  = info->generateTexCoord;
+   bool result = false;
+   if (type == CollisionGeometry)
+      result = object->castRay(xformedStart, xformedEnd, &ri);
+   else if (type == RenderedGeometry)
+      result = object->castRayRendered(xformedStart, xformedEnd, &ri);
+
+   if( result && ri.t < currentT && ( !callback || callback( &ri ) ) )
+   {
+      *info = ri;
+      info->point.interpolate(start, end, info->t);
+      currentT = ri.t;
+      info->distance = (start - info->point).len();
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::_transformRayNormal( RayInfo* info )
+{
+   PlaneF fakePlane;
+   fakePlane.x = info->normal.x;
+   fakePlane.y = info->normal.y;
+   fakePlane.z = info->normal.z;
+   fakePlane.d = 0;
+
+   PlaneF result;
+   mTransformPlane(info->object->getTransform(), info->object->getScale(), fakePlane, &result);
+   info->normal = result;
+}
+
+//-----------------------------------------------------------------------------
+
+struct SceneContainer::RayBatchVisitor
+{
+   const Point3F* starts;
+   const Point3F* ends;
+   U32 mask;
+   RayInfo* infos;
+   F32* rayT;
+   SceneContainer::CastRayCallback callback;
+
+   RayBatchVisitor( const Point3F* inStarts, const Point3F* inEnds, U32 inMask, RayInfo* inInfos, F32* inRayT, SceneContainer::CastRayCallback inCallback )
+      : starts( inStarts ), ends( inEnds ), mask( inMask ), infos( inInfos ), rayT( inRayT ), callback( inCallback ) {}
+
+   void operator()( SceneObject* object, const U32* rays, U32 numRays )
+   {
+      if( ( object->getTypeMask() & mask ) == 0 || !object->isCollisionEnabled() )
+         return;
+
+      const Box3F& worldBox = object->getWorldBox();
+      for( U32 i = 0; i < numRays; ++ i )
+      {
+         const U32 ray = rays[ i ];
+         if( worldBox.collideLine( starts[ ray ], ends[ ray ] ) )
+            SceneContainer::_castRayObject( object, CollisionGeometry, starts[ ray ], ends[ ray ], &infos[ ray ], rayT[ ray ], callback );
+      }
+   }
+};
+
+struct SceneContainer::RayBatchWorkItem : public ThreadPool::WorkItem
+{
+   typedef ThreadPool::WorkItem Parent;
+
+   const SceneContainer* mContainer;
+   ThreadPool::WorkItemGroup* mGroup;
+   const Point3F* mStarts;
+   const Point3F* mEnds;
+   U32 mNumRays;
+   U32 mMask;
+   RayInfo* mInfos;
+   F32* mRayT;
+   SceneContainer::CastRayCallback mCallback;
+   SceneContainerTree::RayBatchScratch mScratch;
+
+   RayBatchWorkItem( const SceneContainer* container, ThreadPool::WorkItemGroup* group, const Point3F* starts, const Point3F* ends, U32 numRays, U32 mask, RayInfo* infos, F32* rayT, SceneContainer::CastRayCallback callback )
+      : mContainer( container ), mGroup( group ), mStarts( starts ), mEnds( ends ), mNumRays( numRays ), mMask( mask ),
+        mInfos( infos ), mRayT( rayT ), mCallback( callback ) {}
+
+   virtual void execute()
+   {
+      mContainer->_castRayBatch( mStarts, mEnds, mNumRays, mMask, mInfos, mRayT, mCallback, mScratch );
+      mGroup->done();
+   }
+};
+
+U32 SceneContainer::castRayBatch( const Point3F* starts, const Point3F* ends, U32 numRays, U32 mask, RayInfo* outInfos, CastRayCallback callback, bool parallel )
+{
+   PROFILE_SCOPE( SceneContainer_CastRayBatch );
+
+   for( U32 i = 0; i < numRays; ++ i )
+   {
+      AssertFatal( outInfos[ i ].userData == NULL, "SceneContainer::castRayBatch - RayInfo->userData cannot be used here!" );
+      outInfos[ i ].object = NULL;
+   }
+
+   // The grid marks visited objects with sequence keys so its rays have to
+   // go one at a time.
+   if( mSpatialIndex != SpatialIndexTree )
+   {
+      U32 numHits = 0;
+      for( U32 i = 0; i < numRays; ++ i )
+         if( castRay( starts[ i ], ends[ i ], mask, &outInfos[ i ], callback ) )
+            numHits ++;
+      return numHits;
+   }
+
+   AssertFatal( !mSearchInProgress, "SceneContainer::castRayBatch - Container queries are not re-entrant" );
+   mSearchInProgress = true;
+
+   mRayBatchT.setSize( numRays );
+   for( U32 i = 0; i < numRays; ++ i )
+      mRayBatchT[ i ] = 2.0f;
+
+   if( parallel && numRays > csmRayBatchItemSize )
+   {
+      ThreadPool::WorkItemGroup group;
+      Vector< ThreadSafeRef< RayBatchWorkItem > > items;
+      for( U32 first = 0; first < numRays; first += csmRayBatchItemSize )
+      {
+         const U32 count = getMin( csmRayBatchItemSize, numRays - first );
+         ThreadSafeRef< RayBatchWorkItem > item( new RayBatchWorkItem( this, &group, starts + first, ends + first, count, mask,
+                                                                       outInfos + first, mRayBatchT.address() + first, callback ) );
+         items.push_back( item );
+      }
+
+      // Wait for the items to finish executing, not just for the queue
+      // to run empty, before the results are read back.
+      ThreadPool* pool = &ThreadPool::GLOBAL();
+      for( U32 i = 0; i < items.size(); ++ i )
+      {
+         group.add();
+         pool->queueWorkItem( items[ i ] );
+      }
+      group.wait();
    }
    else
+      _castRayBatch( starts, ends, numRays, mask, outInfos, mRayBatchT.address(), callback, mRayBatchScratch );
+
+   mSearchInProgress = false;
+
+   U32 numHits = 0;
+   for( U32 i = 0; i < numRays; ++ i )
    {
-      // Do nothing and exit...
-      return false;
+      if( mRayBatchT[ i ] != 2.0f )
+      {
+         _transformRayNormal( &outInfos[ i ] );
+         numHits ++;
+      }
    }
+
+   return numHits;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::_castRayBatch( const Point3F* starts, const Point3F* ends, U32 numRays, U32 mask, RayInfo* outInfos, F32* rayT, CastRayCallback callback, SceneContainerTree::RayBatchScratch& scratch ) const
+{
+   PROFILE_SCOPE( SceneContainer_CastRayBatchTree );
+
+   for( U32 i = 0; i < mGlobalBoundsObjects.size(); ++ i )
+   {
+      SceneObject* object = mGlobalBoundsObjects[ i ];
+      if( ( object->getTypeMask() & mask ) == 0 || !object->isCollisionEnabled() )
+         continue;
+
+      for( U32 ray = 0; ray < numRays; ++ ray )
+         _castRayObject( object, CollisionGeometry, starts[ ray ], ends[ ray ], &outInfos[ ray ], rayT[ ray ], callback );
+   }
+
+   RayBatchVisitor visitor( starts, ends, mask, outInfos, rayT, callback );
+   mTree.castRays( starts, ends, rayT, numRays, visitor, scratch );
 }
 
 //-----------------------------------------------------------------------------
@@ -1439,6 +1908,195 @@ void SceneContainer::getBinRange( const F32 min, const F32 max, U32& minBin, U32
    }
 }
 
+//=============================================================================
+//    SceneContainer::QueryContext.
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+
+SceneContainer::QueryContext::QueryContext( const SceneContainer* container )
+   : mContainer( container )
+{
+   VECTOR_SET_ASSOCIATION( mCandidates );
+   VECTOR_SET_ASSOCIATION( mRadiusResults );
+   VECTOR_SET_ASSOCIATION( mStack );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::QueryContext::_findObjects( const Box3F& box, U32 mask )
+{
+   mContainer->_findCandidates( box, mCandidates, mStack );
+
+   for( U32 i = 0; i < mCandidates.size(); )
+   {
+      SceneObject* object = mCandidates[ i ];
+      if( ( object->getTypeMask() & mask ) != 0 &&
+          object->isCollisionEnabled() &&
+          ( object->isGlobalBounds() || object->getWorldBox().isOverlapped( box ) ) )
+         i ++;
+      else
+         mCandidates.erase_fast( i );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::QueryContext::findObjects( const Box3F& box, U32 mask, FindCallback callback, void* key )
+{
+   AssertFatal( mContainer->isFrozen(), "SceneContainer::QueryContext::findObjects - Container is not frozen" );
+
+   _findObjects( box, mask );
+   for( U32 i = 0; i < mCandidates.size(); ++ i )
+      (*callback)( mCandidates[ i ], key );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::QueryContext::findObjects( const Frustum& frustum, U32 mask, FindCallback callback, void* key )
+{
+   AssertFatal( mContainer->isFrozen(), "SceneContainer::QueryContext::findObjects - Container is not frozen" );
+
+   _findObjects( frustum.getBounds(), mask );
+   for( U32 i = 0; i < mCandidates.size(); ++ i )
+   {
+      SceneObject* object = mCandidates[ i ];
+      if( !frustum.isCulled( object->getWorldBox() ) )
+         (*callback)( object, key );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::QueryContext::findObjectList( const Box3F& box, U32 mask, Vector< SceneObject* >* outFound )
+{
+   AssertFatal( mContainer->isFrozen(), "SceneContainer::QueryContext::findObjectList - Container is not frozen" );
+
+   _findObjects( box, mask );
+   outFound->merge( mCandidates );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainer::QueryContext::findObjectList( const Frustum& frustum, U32 mask, Vector< SceneObject* >* outFound )
+{
+   AssertFatal( mContainer->isFrozen(), "SceneContainer::QueryContext::findObjectList - Container is not frozen" );
+
+   _findObjects( frustum.getBounds(), mask );
+   for( U32 i = 0; i < mCandidates.size(); ++ i )
+   {
+      SceneObject* object = mCandidates[ i ];
+      if( !frustum.isCulled( object->getWorldBox() ) )
+         outFound->push_back( object );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+static S32 QSORT_CALLBACK cmpRadiusResults( const void* a, const void* b )
+{
+   const F32 da = *( const F32* ) a;
+   const F32 db = *( const F32* ) b;
+   return da < db ? -1 : ( da > db ? 1 : 0 );
+}
+
+void SceneContainer::QueryContext::findObjectsInRadius( const Point3F& point, F32 radius, U32 mask, Vector< SceneObject* >* outFound )
+{
+   AssertFatal( mContainer->isFrozen(), "SceneContainer::QueryContext::findObjectsInRadius - Container is not frozen" );
+
+   Box3F queryBox( point, point );
+   queryBox.minExtents -= Point3F( radius, radius, radius );
+   queryBox.maxExtents += Point3F( radius, radius, radius );
+
+   _findObjects( queryBox, mask );
+
+   const F32 radiusSquared = radius * radius;
+
+   mRadiusResults.clear();
+   for( U32 i = 0; i < mCandidates.size(); ++ i )
+   {
+      SceneObject* object = mCandidates[ i ];
+      const Box3F& worldBox = object->getWorldBox();
+
+      if( worldBox.getSqDistanceToPoint( point ) < radiusSquared || object->isGlobalBounds() )
+      {
+         Point3F center;
+         worldBox.getCenter( &center );
+
+         mRadiusResults.increment();
+         mRadiusResults.last().distance = ( center - point ).len();
+         mRadiusResults.last().object = object;
+      }
+   }
+
+   // Same order as initRadiusSearch() without its shared sort state.
+   if( mRadiusResults.size() > 1 )
+      dQsort( mRadiusResults.address(), mRadiusResults.size(), sizeof( RadiusResult ), cmpRadiusResults );
+
+   for( U32 i = 0; i < mRadiusResults.size(); ++ i )
+      outFound->push_back( mRadiusResults[ i ].object );
+}
+
+//-----------------------------------------------------------------------------
+
+bool SceneContainer::QueryContext::castRay( const Point3F& start, const Point3F& end, U32 mask, RayInfo* info, CastRayCallback callback )
+{
+   AssertFatal( info->userData == NULL, "SceneContainer::QueryContext::castRay - RayInfo->userData cannot be used here!" );
+   return _castRay( CollisionGeometry, start, end, mask, info, callback );
+}
+
+//-----------------------------------------------------------------------------
+
+bool SceneContainer::QueryContext::castRayRendered( const Point3F& start, const Point3F& end, U32 mask, RayInfo* info, CastRayCallback callback )
+{
+   AssertFatal( info->userData == NULL, "SceneContainer::QueryContext::castRayRendered - RayInfo->userData cannot be used here!" );
+   return _castRay( RenderedGeometry, start, end, mask, info, callback );
+}
+
+//-----------------------------------------------------------------------------
+
+bool SceneContainer::QueryContext::_castRay( U32 type, const Point3F& start, const Point3F& end, U32 mask, RayInfo* info, CastRayCallback callback )
+{
+   AssertFatal( mContainer->isFrozen(), "SceneContainer::QueryContext::castRay - Container is not frozen" );
+
+   F32 currentT = 2.0;
+
+   if( mContainer->mSpatialIndex == SpatialIndexTree )
+   {
+      for( U32 i = 0; i < mContainer->mGlobalBoundsObjects.size(); ++ i )
+      {
+         SceneObject* object = mContainer->mGlobalBoundsObjects[ i ];
+         if( ( object->getTypeMask() & mask ) != 0 && object->isCollisionEnabled() )
+            _castRayObject( object, type, start, end, info, currentT, callback );
+      }
+
+      TreeRayVisitor visitor( type, start, end, mask, info, currentT, callback );
+      mContainer->mTree.castRay( start, end, visitor, mStack );
+   }
+   else
+   {
+      Box3F rayBox( start, start );
+      rayBox.minExtents.setMin( end );
+      rayBox.maxExtents.setMax( end );
+
+      mContainer->_findCandidates( rayBox, mCandidates, mStack );
+      for( U32 i = 0; i < mCandidates.size(); ++ i )
+      {
+         SceneObject* object = mCandidates[ i ];
+         if( ( object->getTypeMask() & mask ) != 0 &&
+             object->isCollisionEnabled() &&
+             ( object->isGlobalBounds() || object->getWorldBox().collideLine( start, end ) ) )
+            _castRayObject( object, type, start, end, info, currentT, callback );
+      }
+   }
+
+   if( currentT == 2.0 )
+      return false;
+
+   _transformRayNormal( info );
+   return true;
+}
+
 //=============================================================================
 //    Console API.
 //=============================================================================
@@ -1647,4 +2305,31 @@ DefineEngineFunction( containerRayCast, const char*,
    return(returnBuffer);
 }
 
+//-----------------------------------------------------------------------------
+
+DefineEngineFunction( containerSetSpatialIndex, bool, ( const char* index, bool useClientContainer ), ( false ),
+   "@brief Select the spatial index used by a container.\n\n"
+
+   "@param index Either \"tree\" for the dynamic AABB tree or \"grid\" for the bin grid.\n"
+   "@param useClientContainer Optionally indicates the client container should be changed.\n"
+
+   "@return True if the index name was recognized.\n"
+
+   "@ingroup Game")
+{
+   SceneContainer* pContainer = useClientContainer ? &gClientContainer : &gServerContainer;
+
+   if( dStricmp( index, "tree" ) == 0 )
+      pContainer->setSpatialIndex( SceneContainer::SpatialIndexTree );
+   else if( dStricmp( index, "grid" ) == 0 )
+      pContainer->setSpatialIndex( SceneContainer::SpatialIndexBinGrid );
+   else
+   {
+      Con::errorf( "containerSetSpatialIndex - Unknown index '%s'", index );
+      return false;
+   }
+
+   return true;
+}
+
 ConsoleFunctionGroupEnd( Containers );
@@ -43,6 +43,10 @@
 #include "console/simObject.h"
 #endif
 
+#ifndef _SCENECONTAINERTREE_H_
+#include "scene/sceneContainerTree.h"
+#endif
+
 
 /// @file
 /// SceneObject database.
@@ -128,7 +132,10 @@ class SimpleQueryList
 
 /// Database for SceneObjects.
 ///
-/// ScenceContainer implements a grid-based spatial subdivision for the contents of a scene.
+/// ScenceContainer implements a spatial subdivision for the contents of a scene.  By default,
+/// objects are kept in a dynamic AABB tree (SceneContainerTree).  The original grid of
+/// wrapping bins can be selected instead with setSpatialIndex().  The grid is cheap for
+/// small levels but lets far-apart objects alias into the same bins on large worlds.
 class SceneContainer
 {
       enum CastRayType
@@ -137,8 +144,27 @@ class SceneContainer
          RenderedGeometry,
       };
 
+      struct TreeRayVisitor;
+      friend struct TreeRayVisitor;
+
+      struct RayBatchVisitor;
+      friend struct RayBatchVisitor;
+
+      struct RayBatchWorkItem;
+      friend struct RayBatchWorkItem;
+
    public:
 
+      class QueryContext;
+      friend class QueryContext;
+
+      /// Spatial index used to find objects.
+      enum SpatialIndex
+      {
+         SpatialIndexBinGrid,    ///< 16x16 grid of wrapping 64m bins.
+         SpatialIndexTree,       ///< Dynamic AABB tree.
+      };
+
       struct Link
       {
          Link* next;
@@ -166,9 +192,15 @@ class SceneContainer
       /// this is used to detect when it happens.
       bool mSearchInProgress;
 
+      /// While frozen, objects may not be added, removed or moved.
+      bool mFrozen;
+
       /// Current sequence key.
       U32 mCurrSeqKey;
 
+      /// Incremented whenever an object is added, removed or moved.
+      U32 mChangeCount;
+
       SceneObjectRef* mFreeRefPool;
       Vector< SceneObjectRef* > mRefPoolBlocks;
 
@@ -182,6 +214,25 @@ class SceneContainer
       /// Vector that contains just the terrain objects in the container.
       Vector< SceneObject* > mTerrains;
 
+      /// Spatial index objects are currently kept in.
+      SpatialIndex mSpatialIndex;
+
+      /// Objects with non-global bounds when using SpatialIndexTree.
+      SceneContainerTree mTree;
+
+      /// Objects with global bounds when using SpatialIndexTree.  They are
+      /// tested by every query, like the grid's overflow bin.
+      Vector< SceneObject* > mGlobalBoundsObjects;
+
+      /// Candidates collected from the tree by the current query.
+      Vector< SceneObject* > mQueryResults;
+
+      /// Closest hit so far for each ray of the current castRayBatch().
+      Vector< F32 > mRayBatchT;
+
+      /// Working memory for serial castRayBatch() calls.
+      SceneContainerTree::RayBatchScratch mRayBatchScratch;
+
       static const U32 csmNumBins;
       static const F32 csmBinSize;
       static const F32 csmTotalBinSize;
@@ -198,6 +249,30 @@ class SceneContainer
       /// Return a vector containing all terrain objects in this container.
       const Vector< SceneObject* >& getTerrains() const { return mTerrains; }
 
+      /// Return the spatial index used by the container.
+      SpatialIndex getSpatialIndex() const { return mSpatialIndex; }
+
+      /// Return a counter that changes whenever an object is added, removed
+      /// or moved.  Lets caches built from the container's contents tell
+      /// whether they are still valid.
+      U32 getChangeCount() const { return mChangeCount; }
+
+      /// Move all objects over to the given spatial index.
+      void setSpatialIndex( SpatialIndex index );
+
+      /// @name Concurrent Queries
+      ///
+      /// While a container is frozen, any number of threads can query it through
+      /// their own QueryContext.  Adding, removing and moving objects is not
+      /// allowed until it is unfrozen.
+      /// @{
+
+      void freeze();
+      void unfreeze();
+      bool isFrozen() const { return mFrozen; }
+
+      /// @}
+
       /// @name Basic database operations
       /// @{
 
@@ -240,6 +315,24 @@ class SceneContainer
       /// Test against rendered geometry -- slow.
       bool castRayRendered( const Point3F &start, const Point3F &end, U32 mask, RayInfo* info, CastRayCallback callback = NULL );
 
+      /// Cast a batch of independent rays against collision geometry.
+      ///
+      /// The broadphase is walked once for the whole batch and each candidate
+      /// object is tested against all the rays that reach it in one go.
+      /// outInfos[ i ] receives the closest hit of ray i.  Rays that hit
+      /// nothing are left with a NULL object.
+      ///
+      /// If @a parallel is true, the batch is split across the global ThreadPool.
+      /// Only do this if the castRay() of all objects matching @a mask, and
+      /// the callback, are safe to call from several threads.  The container
+      /// must not be changed until the call returns.
+      ///
+      /// @return Number of rays that hit something.
+      U32 castRayBatch( const Point3F* starts, const Point3F* ends, U32 numRays, U32 mask, RayInfo* outInfos, CastRayCallback callback = NULL, bool parallel = false );
+
+      /// Number of rays handed to each work item by a parallel castRayBatch().
+      static const U32 csmRayBatchItemSize;
+
       bool collideBox(const Point3F &start, const Point3F &end, U32 mask, RayInfo* info);
 
       /// @}
@@ -292,8 +385,38 @@ class SceneContainer
 
       void cleanupSearchVectors();
 
+      /// @name Tree
+      /// @{
+
+      void _insertIntoTree( SceneObject* object );
+      void _removeFromTree( SceneObject* object );
+      void _checkTree( SceneObject* object );
+
+      /// Fill #mQueryResults with the objects matching the mask whose world
+      /// box overlaps the given box.
+      void _findTreeObjects( const Box3F& box, U32 mask );
+
+      /// Collect every object that may overlap the given box, each once and
+      /// without filtering.  Does not change any container state.
+      void _findCandidates( const Box3F& box, Vector< SceneObject* >& outObjects, SceneContainerTree::QueryStack& stack ) const;
+
+      /// Cast a ray against a single object and keep the hit in @a info if
+      /// it is closer than @a currentT.
+      static void _castRayObject( SceneObject* object, U32 type, const Point3F& start, const Point3F& end, RayInfo* info, F32& currentT, CastRayCallback callback );
+
+      /// @}
+
       /// Base cast ray code
       bool _castRay( U32 type, const Point3F &start, const Point3F &end, U32 mask, RayInfo* info, CastRayCallback callback );
+      void _castRayBinGrid( U32 type, const Point3F &start, const Point3F &end, U32 mask, RayInfo* info, F32& currentT, CastRayCallback callback );
+      void _castRayTree( U32 type, const Point3F &start, const Point3F &end, U32 mask, RayInfo* info, F32& currentT, CastRayCallback callback );
+
+      /// Run part of a castRayBatch() against the tree.  Does not change any
+      /// container state.
+      void _castRayBatch( const Point3F* starts, const Point3F* ends, U32 numRays, U32 mask, RayInfo* outInfos, F32* rayT, CastRayCallback callback, SceneContainerTree::RayBatchScratch& scratch ) const;
+
+      /// Move the normal of a hit from object space into world space.
+      static void _transformRayNormal( RayInfo* info );
 
       void _findSpecialObjects( const Vector< SceneObject* >& vector, U32 mask, FindCallback, void *key = NULL );
       void _findSpecialObjects( const Vector< SceneObject* >& vector, const Box3F &box, U32 mask, FindCallback callback, void *key = NULL );   
@@ -303,6 +426,68 @@ class SceneContainer
 
 //-----------------------------------------------------------------------------
 
+/// Per-thread state for querying a frozen SceneContainer.
+///
+/// The container's own queries share scratch state and tag objects with
+/// sequence keys, so only one can run at a time.  A QueryContext keeps its
+/// scratch state to itself and writes nothing to the container or its
+/// objects, so each thread can run box, frustum, radius and ray queries
+/// through its own context while the container is frozen.
+///
+/// A context is not re-entrant; callbacks must not query through the
+/// context that invoked them.
+///
+/// Ray casts call SceneObject::castRay() on the objects they hit, so rays
+/// cast from several threads at once must only use masks whose objects
+/// keep no shared scratch state in their castRay().  TerrainBlock's does not.
+class SceneContainer::QueryContext
+{
+   public:
+
+      QueryContext( const SceneContainer* container );
+
+      const SceneContainer* getContainer() const { return mContainer; }
+
+      void findObjects( const Box3F& box, U32 mask, FindCallback callback, void* key = NULL );
+      void findObjects( const Frustum& frustum, U32 mask, FindCallback callback, void* key = NULL );
+
+      void findObjectList( const Box3F& box, U32 mask, Vector< SceneObject* >* outFound );
+      void findObjectList( const Frustum& frustum, U32 mask, Vector< SceneObject* >* outFound );
+
+      /// Find the objects whose world box is within @a radius of @a point,
+      /// sorted nearest first like SceneContainer::initRadiusSearch().
+      void findObjectsInRadius( const Point3F& point, F32 radius, U32 mask, Vector< SceneObject* >* outFound );
+
+      bool castRay( const Point3F& start, const Point3F& end, U32 mask, RayInfo* info, CastRayCallback callback = NULL );
+      bool castRayRendered( const Point3F& start, const Point3F& end, U32 mask, RayInfo* info, CastRayCallback callback = NULL );
+
+   protected:
+
+      struct RadiusResult
+      {
+         F32 distance;
+         SceneObject* object;
+      };
+
+      const SceneContainer* mContainer;
+
+      /// Candidates of the current query.
+      Vector< SceneObject* > mCandidates;
+
+      /// Candidates of the current radius query with their distance.
+      Vector< RadiusResult > mRadiusResults;
+
+      SceneContainerTree::QueryStack mStack;
+
+      /// Fill #mCandidates with the objects matching the mask whose world
+      /// box overlaps the given box.
+      void _findObjects( const Box3F& box, U32 mask );
+
+      bool _castRay( U32 type, const Point3F& start, const Point3F& end, U32 mask, RayInfo* info, CastRayCallback callback );
+};
+
+//-----------------------------------------------------------------------------
+
 extern SceneContainer gServerContainer;
 extern SceneContainer gClientContainer;
 
@@ -0,0 +1,446 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+// The insertion heuristic and the tree rotations are derived from
+// b2DynamicTree in Box2D, which carries the following notice:
+//
+// Copyright (c) 2009 Erin Catto http://www.box2d.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "platform/platform.h"
+#include "scene/sceneContainerTree.h"
+
+
+F32 SceneContainerTree::smLeafMargin = 1.0f;
+
+
+//-----------------------------------------------------------------------------
+
+SceneContainerTree::SceneContainerTree()
+   : mRoot( NullNode ),
+     mFreeList( NullNode ),
+     mObjectCount( 0 )
+{
+   VECTOR_SET_ASSOCIATION( mNodes );
+   VECTOR_SET_ASSOCIATION( mStack );
+}
+
+//-----------------------------------------------------------------------------
+
+F32 SceneContainerTree::_getArea( const Box3F& box )
+{
+   // Half the surface area; only used for comparisons.
+   const F32 x = box.len_x();
+   const F32 y = box.len_y();
+   const F32 z = box.len_z();
+   return x * y + y * z + z * x;
+}
+
+//-----------------------------------------------------------------------------
+
+Box3F SceneContainerTree::_getUnion( const Box3F& a, const Box3F& b )
+{
+   Box3F result = a;
+   result.intersect( b );
+   return result;
+}
+
+//-----------------------------------------------------------------------------
+
+S32 SceneContainerTree::_allocateNode()
+{
+   S32 node;
+   if( mFreeList != NullNode )
+   {
+      node = mFreeList;
+      mFreeList = mNodes[ node ].parent;
+   }
+   else
+   {
+      node = mNodes.size();
+      mNodes.increment();
+   }
+
+   Node& n = mNodes[ node ];
+   n.object = NULL;
+   n.parent = NullNode;
+   n.child1 = NullNode;
+   n.child2 = NullNode;
+   n.height = 0;
+
+   return node;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainerTree::_freeNode( S32 node )
+{
+   mNodes[ node ].parent = mFreeList;
+   mNodes[ node ].height = -1;
+   mNodes[ node ].object = NULL;
+   mFreeList = node;
+}
+
+//-----------------------------------------------------------------------------
+
+S32 SceneContainerTree::insert( SceneObject* object, const Box3F& worldBox )
+{
+   const S32 leaf = _allocateNode();
+
+   Node& node = mNodes[ leaf ];
+   node.object = object;
+   node.box = worldBox;
+   node.box.minExtents -= Point3F( smLeafMargin, smLeafMargin, smLeafMargin );
+   node.box.maxExtents += Point3F( smLeafMargin, smLeafMargin, smLeafMargin );
+
+   _insertLeaf( leaf );
+   mObjectCount ++;
+
+   return leaf;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainerTree::remove( S32 leaf )
+{
+   AssertFatal( leaf >= 0 && leaf < mNodes.size() && mNodes[ leaf ].isLeaf(), "SceneContainerTree::remove - Invalid leaf" );
+
+   _removeLeaf( leaf );
+   _freeNode( leaf );
+   mObjectCount --;
+}
+
+//-----------------------------------------------------------------------------
+
+bool SceneContainerTree::update( S32 leaf, const Box3F& worldBox )
+{
+   AssertFatal( leaf >= 0 && leaf < mNodes.size() && mNodes[ leaf ].isLeaf(), "SceneContainerTree::update - Invalid leaf" );
+
+   Node& node = mNodes[ leaf ];
+   if( node.box.isContained( worldBox ) )
+      return false;
+
+   _removeLeaf( leaf );
+
+   node.box = worldBox;
+   node.box.minExtents -= Point3F( smLeafMargin, smLeafMargin, smLeafMargin );
+   node.box.maxExtents += Point3F( smLeafMargin, smLeafMargin, smLeafMargin );
+
+   _insertLeaf( leaf );
+   return true;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainerTree::_insertLeaf( S32 leaf )
+{
+   if( mRoot == NullNode )
+   {
+      mRoot = leaf;
+      mNodes[ leaf ].parent = NullNode;
+      return;
+   }
+
+   // Find the best sibling.  At each level, compare the cost of pairing the
+   // leaf with the current node against descending into either child, where
+   // descending costs the growth of every box on the way down.
+
+   const Box3F leafBox = mNodes[ leaf ].box;
+   S32 index = mRoot;
+   while( !mNodes[ index ].isLeaf() )
+   {
+      const Node& node = mNodes[ index ];
+      const S32 child1 = node.child1;
+      const S32 child2 = node.child2;
+
+      const F32 area = _getArea( node.box );
+      const F32 combinedArea = _getArea( _getUnion( node.box, leafBox ) );
+
+      // Cost of creating a new parent for this node and the new leaf.
+      const F32 cost = 2.0f * combinedArea;
+
+      // Minimum cost of pushing the leaf further down the tree.
+      const F32 inheritanceCost = 2.0f * ( combinedArea - area );
+
+      F32 cost1;
+      if( mNodes[ child1 ].isLeaf() )
+         cost1 = _getArea( _getUnion( leafBox, mNodes[ child1 ].box ) ) + inheritanceCost;
+      else
+         cost1 = _getArea( _getUnion( leafBox, mNodes[ child1 ].box ) ) - _getArea( mNodes[ child1 ].box ) + inheritanceCost;
+
+      F32 cost2;
+      if( mNodes[ child2 ].isLeaf() )
+         cost2 = _getArea( _getUnion( leafBox, mNodes[ child2 ].box ) ) + inheritanceCost;
+      else
+         cost2 = _getArea( _getUnion( leafBox, mNodes[ child2 ].box ) ) - _getArea( mNodes[ child2 ].box ) + inheritanceCost;
+
+      if( cost < cost1 && cost < cost2 )
+         break;
+
+      index = cost1 < cost2 ? child1 : child2;
+   }
+
+   const S32 sibling = index;
+
+   // Create a new parent for the sibling and the leaf.  _allocateNode() may
+   // move the nodes so don't hold references across it.
+
+   const S32 oldParent = mNodes[ sibling ].parent;
+   const S32 newParent = _allocateNode();
+   mNodes[ newParent ].parent = oldParent;
+   mNodes[ newParent ].box = _getUnion( leafBox, mNodes[ sibling ].box );
+   mNodes[ newParent ].height = mNodes[ sibling ].height + 1;
+   mNodes[ newParent ].child1 = sibling;
+   mNodes[ newParent ].child2 = leaf;
+   mNodes[ sibling ].parent = newParent;
+   mNodes[ leaf ].parent = newParent;
+
+   if( oldParent != NullNode )
+   {
+      if( mNodes[ oldParent ].child1 == sibling )
+         mNodes[ oldParent ].child1 = newParent;
+      else
+         mNodes[ oldParent ].child2 = newParent;
+   }
+   else
+      mRoot = newParent;
+
+   // Walk back up fixing heights and boxes.
+
+   index = mNodes[ leaf ].parent;
+   while( index != NullNode )
+   {
+      index = _balance( index );
+
+      Node& node = mNodes[ index ];
+      node.height = 1 + getMax( mNodes[ node.child1 ].height, mNodes[ node.child2 ].height );
+      node.box = _getUnion( mNodes[ node.child1 ].box, mNodes[ node.child2 ].box );
+
+      index = node.parent;
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainerTree::_removeLeaf( S32 leaf )
+{
+   if( leaf == mRoot )
+   {
+      mRoot = NullNode;
+      return;
+   }
+
+   const S32 parent = mNodes[ leaf ].parent;
+   const S32 grandParent = mNodes[ parent ].parent;
+   const S32 sibling = mNodes[ parent ].child1 == leaf ? mNodes[ parent ].child2 : mNodes[ parent ].child1;
+
+   if( grandParent != NullNode )
+   {
+      // Replace the parent by the sibling.
+      if( mNodes[ grandParent ].child1 == parent )
+         mNodes[ grandParent ].child1 = sibling;
+      else
+         mNodes[ grandParent ].child2 = sibling;
+      mNodes[ sibling ].parent = grandParent;
+      _freeNode( parent );
+
+      // Shrink the boxes on the way up.
+      S32 index = grandParent;
+      while( index != NullNode )
+      {
+         index = _balance( index );
+
+         Node& node = mNodes[ index ];
+         node.box = _getUnion( mNodes[ node.child1 ].box, mNodes[ node.child2 ].box );
+         node.height = 1 + getMax( mNodes[ node.child1 ].height, mNodes[ node.child2 ].height );
+
+         index = node.parent;
+      }
+   }
+   else
+   {
+      mRoot = sibling;
+      mNodes[ sibling ].parent = NullNode;
+      _freeNode( parent );
+   }
+
+   mNodes[ leaf ].parent = NullNode;
+}
+
+//-----------------------------------------------------------------------------
+
+S32 SceneContainerTree::_balance( S32 iA )
+{
+   // B and C are the children of A, D and E the children of B, and F and
+   // G the children of C.
+   //
+   // If one child of A is more than one level taller than the other, the
+   // taller child is rotated up into A's place.
+
+   Node* A = &mNodes[ iA ];
+   if( A->isLeaf() || A->height < 2 )
+      return iA;
+
+   const S32 iB = A->child1;
+   const S32 iC = A->child2;
+   Node* B = &mNodes[ iB ];
+   Node* C = &mNodes[ iC ];
+
+   const S32 balance = C->height - B->height;
+
+   if( balance > 1 )
+   {
+      // Rotate C up.
+      const S32 iF = C->child1;
+      const S32 iG = C->child2;
+      Node* F = &mNodes[ iF ];
+      Node* G = &mNodes[ iG ];
+
+      C->child1 = iA;
+      C->parent = A->parent;
+      A->parent = iC;
+
+      if( C->parent != NullNode )
+      {
+         if( mNodes[ C->parent ].child1 == iA )
+            mNodes[ C->parent ].child1 = iC;
+         else
+            mNodes[ C->parent ].child2 = iC;
+      }
+      else
+         mRoot = iC;
+
+      // Keep the taller of F and G under C.
+      if( F->height > G->height )
+      {
+         C->child2 = iF;
+         A->child2 = iG;
+         G->parent = iA;
+         A->box = _getUnion( B->box, G->box );
+         C->box = _getUnion( A->box, F->box );
+         A->height = 1 + getMax( B->height, G->height );
+         C->height = 1 + getMax( A->height, F->height );
+      }
+      else
+      {
+         C->child2 = iG;
+         A->child2 = iF;
+         F->parent = iA;
+         A->box = _getUnion( B->box, F->box );
+         C->box = _getUnion( A->box, G->box );
+         A->height = 1 + getMax( B->height, F->height );
+         C->height = 1 + getMax( A->height, G->height );
+      }
+
+      return iC;
+   }
+
+   if( balance < -1 )
+   {
+      // Rotate B up.
+      const S32 iD = B->child1;
+      const S32 iE = B->child2;
+      Node* D = &mNodes[ iD ];
+      Node* E = &mNodes[ iE ];
+
+      B->child1 = iA;
+      B->parent = A->parent;
+      A->parent = iB;
+
+      if( B->parent != NullNode )
+      {
+         if( mNodes[ B->parent ].child1 == iA )
+            mNodes[ B->parent ].child1 = iB;
+         else
+            mNodes[ B->parent ].child2 = iB;
+      }
+      else
+         mRoot = iB;
+
+      // Keep the taller of D and E under B.
+      if( D->height > E->height )
+      {
+         B->child2 = iD;
+         A->child1 = iE;
+         E->parent = iA;
+         A->box = _getUnion( C->box, E->box );
+         B->box = _getUnion( A->box, D->box );
+         A->height = 1 + getMax( C->height, E->height );
+         B->height = 1 + getMax( A->height, D->height );
+      }
+      else
+      {
+         B->child2 = iE;
+         A->child1 = iD;
+         D->parent = iA;
+         A->box = _getUnion( C->box, D->box );
+         B->box = _getUnion( A->box, E->box );
+         A->height = 1 + getMax( C->height, D->height );
+         B->height = 1 + getMax( A->height, E->height );
+      }
+
+      return iB;
+   }
+
+   return iA;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneContainerTree::findObjects( const Box3F& box, Vector< SceneObject* >& outObjects, QueryStack& stack ) const
+{
+   if( mRoot == NullNode )
+      return;
+
+   stack.clear();
+   stack.push_back( StackEntry( mRoot, 0.0f ) );
+
+   while( !stack.empty() )
+   {
+      const Node& node = mNodes[ stack.last().node ];
+      stack.pop_back();
+
+      if( !node.box.isOverlapped( box ) )
+         continue;
+
+      if( node.isLeaf() )
+         outObjects.push_back( node.object );
+      else
+      {
+         stack.push_back( StackEntry( node.child1, 0.0f ) );
+         stack.push_back( StackEntry( node.child2, 0.0f ) );
+      }
+   }
+}
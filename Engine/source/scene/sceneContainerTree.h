@@ -0,0 +1,303 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SCENECONTAINERTREE_H_
+#define _SCENECONTAINERTREE_H_
+
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+
+class SceneObject;
+
+
+/// Dynamic bounding volume hierarchy over the objects of a SceneContainer.
+///
+/// Leaves hold the object's world box grown by a margin so that small moves
+/// only need a containment test.  Objects that leave their grown box are
+/// taken out and reinserted.  Insertion descends toward the sibling that
+/// grows the least in surface area, and the tree is kept balanced with
+/// rotations on the way back up, so queries stay logarithmic no matter how
+/// large the world is.
+class SceneContainerTree
+{
+   public:
+
+      enum
+      {
+         NullNode = -1
+      };
+
+      struct StackEntry
+      {
+         S32 node;
+
+         /// Fraction along the ray at which the node's box is entered.
+         F32 t;
+
+         StackEntry() {}
+         StackEntry( S32 inNode, F32 inT ) : node( inNode ), t( inT ) {}
+      };
+
+      /// Traversal stack.  Queries given their own stack don't touch any
+      /// tree state and can run on several threads at once.
+      typedef Vector< StackEntry > QueryStack;
+
+      SceneContainerTree();
+
+      /// Add an object with the given world box and return its leaf.
+      S32 insert( SceneObject* object, const Box3F& worldBox );
+
+      /// Remove the leaf returned by insert().
+      void remove( S32 leaf );
+
+      /// Update the leaf for a new world box.  Returns true if the leaf had
+      /// to be reinserted.
+      bool update( S32 leaf, const Box3F& worldBox );
+
+      /// Add all objects whose leaf box overlaps the given box to the list.
+      /// As leaf boxes are grown, callers have to test the object's world
+      /// box themselves.
+      void findObjects( const Box3F& box, Vector< SceneObject* >& outObjects ) const { findObjects( box, outObjects, mStack ); }
+      void findObjects( const Box3F& box, Vector< SceneObject* >& outObjects, QueryStack& stack ) const;
+
+      /// Walks the leaves hit by a line segment, nearest subtrees first.
+      ///
+      /// The visitor is called as visitor( object ) and returns the fraction
+      /// along the segment of the closest hit so far.  Subtrees whose box is
+      /// entered past that fraction are skipped.
+      template< typename Visitor >
+      void castRay( const Point3F& start, const Point3F& end, Visitor& visitor ) const { castRay( start, end, visitor, mStack ); }
+      template< typename Visitor >
+      void castRay( const Point3F& start, const Point3F& end, Visitor& visitor, QueryStack& stack ) const;
+
+      /// Working memory for castRays().  Each thread querying the tree
+      /// concurrently needs its own.
+      struct RayBatchScratch
+      {
+         struct Entry
+         {
+            S32 node;
+
+            /// Range in #rays of the rays that entered the node.
+            U32 first;
+            U32 count;
+
+            Entry() {}
+            Entry( S32 inNode, U32 inFirst, U32 inCount ) : node( inNode ), first( inFirst ), count( inCount ) {}
+         };
+
+         Vector< Entry > stack;
+         Vector< U32 > rays;
+      };
+
+      /// Walks the tree once for a batch of line segments.
+      ///
+      /// Each node is tested against the rays that entered its parent, and
+      /// the visitor is called once per leaf as visitor( object, rays, numRays )
+      /// with the indices of the rays that reached it.  A ray is dropped from
+      /// a subtree whose box it enters past maxT[ ray ]; the visitor may
+      /// lower maxT as it finds hits.
+      ///
+      /// Unlike the other queries this does not touch any tree state and can
+      /// run on several threads at once.
+      template< typename Visitor >
+      void castRays( const Point3F* starts, const Point3F* ends, const F32* maxT, U32 numRays, Visitor& visitor, RayBatchScratch& scratch ) const;
+
+      /// Return the number of objects in the tree.
+      U32 getObjectCount() const { return mObjectCount; }
+
+      /// Return the height of the tree; 0 for an empty tree.
+      S32 getHeight() const { return mRoot == NullNode ? 0 : mNodes[ mRoot ].height + 1; }
+
+      /// Margin by which leaf boxes are grown on each side.
+      static F32 smLeafMargin;
+
+   protected:
+
+      struct Node
+      {
+         Box3F box;
+
+         /// Object for leaves, NULL for inner nodes.
+         SceneObject* object;
+
+         /// Parent node or, for nodes on the free list, the next free node.
+         S32 parent;
+
+         S32 child1;
+         S32 child2;
+
+         /// Height of the subtree; 0 for leaves and -1 for free nodes.
+         S32 height;
+
+         bool isLeaf() const { return child1 == NullNode; }
+      };
+
+      Vector< Node > mNodes;
+      S32 mRoot;
+      S32 mFreeList;
+      U32 mObjectCount;
+
+      /// Stack reused by queries that aren't given one.
+      mutable QueryStack mStack;
+
+      S32 _allocateNode();
+      void _freeNode( S32 node );
+
+      void _insertLeaf( S32 leaf );
+      void _removeLeaf( S32 leaf );
+
+      /// Rotate the tree around the given node if it is unbalanced and
+      /// return the node now at its position.
+      S32 _balance( S32 node );
+
+      static F32 _getArea( const Box3F& box );
+      static Box3F _getUnion( const Box3F& a, const Box3F& b );
+};
+
+//-----------------------------------------------------------------------------
+
+template< typename Visitor >
+void SceneContainerTree::castRay( const Point3F& start, const Point3F& end, Visitor& visitor, QueryStack& stack ) const
+{
+   if( mRoot == NullNode )
+      return;
+
+   F32 maxT = 1.0f;
+   F32 t;
+   Point3F normal;
+
+   if( !mNodes[ mRoot ].box.collideLine( start, end, &t, &normal ) )
+      return;
+
+   stack.clear();
+   stack.push_back( StackEntry( mRoot, t ) );
+
+   while( !stack.empty() )
+   {
+      const StackEntry entry = stack.last();
+      stack.pop_back();
+
+      // The ray may have been shortened since the node was pushed.
+      if( entry.t > maxT )
+         continue;
+
+      const Node& node = mNodes[ entry.node ];
+      if( node.isLeaf() )
+      {
+         maxT = visitor( node.object );
+         continue;
+      }
+
+      // Push the farther child first so the nearer one is visited first
+      // and can shorten the ray for the other.
+
+      F32 t1, t2;
+      const bool hit1 = mNodes[ node.child1 ].box.collideLine( start, end, &t1, &normal ) && t1 <= maxT;
+      const bool hit2 = mNodes[ node.child2 ].box.collideLine( start, end, &t2, &normal ) && t2 <= maxT;
+
+      if( hit1 && hit2 )
+      {
+         if( t1 <= t2 )
+         {
+            stack.push_back( StackEntry( node.child2, t2 ) );
+            stack.push_back( StackEntry( node.child1, t1 ) );
+         }
+         else
+         {
+            stack.push_back( StackEntry( node.child1, t1 ) );
+            stack.push_back( StackEntry( node.child2, t2 ) );
+         }
+      }
+      else if( hit1 )
+         stack.push_back( StackEntry( node.child1, t1 ) );
+      else if( hit2 )
+         stack.push_back( StackEntry( node.child2, t2 ) );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+template< typename Visitor >
+void SceneContainerTree::castRays( const Point3F* starts, const Point3F* ends, const F32* maxT, U32 numRays, Visitor& visitor, RayBatchScratch& scratch ) const
+{
+   if( mRoot == NullNode )
+      return;
+
+   F32 t;
+   Point3F normal;
+
+   scratch.stack.clear();
+   scratch.rays.clear();
+
+   const Box3F& rootBox = mNodes[ mRoot ].box;
+   for( U32 i = 0; i < numRays; ++ i )
+      if( rootBox.collideLine( starts[ i ], ends[ i ], &t, &normal ) && t <= maxT[ i ] )
+         scratch.rays.push_back( i );
+
+   if( scratch.rays.empty() )
+      return;
+
+   scratch.stack.push_back( RayBatchScratch::Entry( mRoot, 0, scratch.rays.size() ) );
+
+   while( !scratch.stack.empty() )
+   {
+      const RayBatchScratch::Entry entry = scratch.stack.last();
+      scratch.stack.pop_back();
+
+      // Ranges past this entry's belong to subtrees that are done.
+      scratch.rays.setSize( entry.first + entry.count );
+
+      const Node& node = mNodes[ entry.node ];
+      if( node.isLeaf() )
+      {
+         visitor( node.object, scratch.rays.address() + entry.first, entry.count );
+         continue;
+      }
+
+      const S32 children[ 2 ] = { node.child1, node.child2 };
+      for( U32 c = 0; c < 2; ++ c )
+      {
+         const Box3F& box = mNodes[ children[ c ] ].box;
+         const U32 first = scratch.rays.size();
+
+         for( U32 i = 0; i < entry.count; ++ i )
+         {
+            const U32 ray = scratch.rays[ entry.first + i ];
+            if( box.collideLine( starts[ ray ], ends[ ray ], &t, &normal ) && t <= maxT[ ray ] )
+               scratch.rays.push_back( ray );
+         }
+
+         const U32 count = scratch.rays.size() - first;
+         if( count )
+            scratch.stack.push_back( RayBatchScratch::Entry( children[ c ], first, count ) );
+      }
+   }
+}
+
+#endif // !_SCENECONTAINERTREE_H_
@@ -73,6 +73,23 @@ MODULE_BEGIN( Scene )
          "If true, the bounding boxes of objects will be displayed.\n\n"
          "@ingroup Rendering" );
 
+      Con::addVariable( "$Scene::parallelRender", TypeBool, &SceneManager::smParallelRender,
+         "If true, objects are culled and batched for rendering on the global thread pool.  Only objects "
+         "that declare their prepRenderImage() thread-safe are batched on the pool.  Currently only a few editor "
+         "objects (SceneSpace, Trigger, PhysicalZone and Marker) do, so in practice this only speeds up culling.\n\n"
+         "@ingroup Rendering" );
+
+      Con::addVariable( "$Scene::shareScoping", TypeBool, &SceneManager::smShareScoping,
+         "If true, network scoping uses a grid of the scene objects that is built once for all connections and "
+         "reused until objects are added, removed or moved.  Connections with cameras close to each other also share "
+         "the objects they test.\n\n"
+         "@ingroup Networking" );
+
+      Con::addVariable( "$Scene::scopingGridCellSize", TypeF32, &SceneScopingGrid::smCellSize,
+         "Size of the cells in the grid used with $Scene::shareScoping.  Connections with cameras in the same "
+         "cell share the objects they test.\n\n"
+         "@ingroup Networking" );
+
       Con::addVariable( "$Scene::maxOccludersPerZone", TypeS32, &SceneCullingState::smMaxOccludersPerZone,
          "Maximum number of occluders that will be concurrently allowed into the scene culling state of any given zone.\n\n"
          "@ingroup Rendering" );
@@ -97,6 +114,8 @@ MODULE_END;
 
 bool SceneManager::smRenderBoundingBoxes;
 bool SceneManager::smLockDiffuseFrustum = false;
+bool SceneManager::smParallelRender = false;
+bool SceneManager::smShareScoping = true;
 SceneCameraState SceneManager::smLockedDiffuseCamera = SceneCameraState( RectI(), Frustum(), MatrixF(), MatrixF() );
 
 SceneManager* gClientSceneGraph = NULL;
@@ -424,11 +443,12 @@ void SceneManager::_renderScene( SceneRenderState* state, U32 objectMask, SceneZ
 
    // Cull the list.
 
-   U32 numRenderObjects = state->getCullingState().cullObjects(
-      mBatchQueryList.address(),
-      mBatchQueryList.size(),
-      !state->isDiffusePass() ? SceneCullingState::CullEditorOverrides : 0 // Keep forced editor stuff out of non-diffuse passes.
-   );
+   const U32 cullOptions = !state->isDiffusePass() ? SceneCullingState::CullEditorOverrides : 0; // Keep forced editor stuff out of non-diffuse passes.
+   U32 numRenderObjects;
+   if( smParallelRender )
+      numRenderObjects = state->getCullingState().cullObjectsParallel( mBatchQueryList.address(), mBatchQueryList.size(), cullOptions );
+   else
+      numRenderObjects = state->getCullingState().cullObjects( mBatchQueryList.address(), mBatchQueryList.size(), cullOptions );
 
    //HACK: If the control object is a Player and it is not in the render list, force
    // it into it.  This really should be solved by collision bounds being separate from
@@ -457,7 +477,7 @@ void SceneManager::_renderScene( SceneRenderState* state, U32 objectMask, SceneZ
    // Render the remaining objects.
 
    PROFILE_START( Scene_renderObjects );
-   state->renderObjects( mBatchQueryList.address(), numRenderObjects );
+   state->renderObjects( mBatchQueryList.address(), numRenderObjects, smParallelRender );
    PROFILE_END();
 
    // Render bounding boxes, if enabled.
@@ -508,6 +528,11 @@ struct ScopingInfo
    NetConnection* connection;
 };
 
+static void _scopeGridCallback( SceneObject* object, void* data )
+{
+   reinterpret_cast< NetConnection* >( data )->objectInScope( object );
+}
+
 static void _scopeCallback( SceneObject* object, void* data )
 {
    if( !object->isScopeable() )
@@ -544,6 +569,12 @@ void SceneManager::scopeScene( CameraScopeQuery* query, NetConnection* netConnec
    //
    // So, we perform a simple box query on the area covered by the camera query
    // and then scope in everything that is in range.
+
+   if( smShareScoping )
+   {
+      mScopingGrid.scope( getContainer(), query->pos, query->visibleDistance, _scopeGridCallback, netConnection );
+      return;
+   }
    
    // Set up scoping info.
 
@@ -59,6 +59,10 @@
 #include "core/util/tSignal.h"
 #endif
 
+#ifndef _SCENESCOPINGGRID_H_
+#include "scene/sceneScopingGrid.h"
+#endif
+
 
 class LightManager;
 class SceneRootZone;
@@ -117,6 +121,17 @@ class SceneManager
       /// If true, render the AABBs of objects for debugging.
       static bool smRenderBoundingBoxes;
 
+      /// If true, cull objects and run their prepRenderImage() on the
+      /// global thread pool.  Only editor objects opt in to the latter for
+      /// now, so this mostly affects culling.
+      /// @see SceneCullingState::cullObjectsParallel
+      /// @see SceneRenderState::prepRenderImagesParallel
+      static bool smParallelRender;
+
+      /// If true, scopeScene() uses a grid that is shared by all connections
+      /// and rebuilt only when objects have been added, removed or moved.
+      static bool smShareScoping;
+
    protected:
 
       /// Whether this is the client-side scene.
@@ -147,6 +162,9 @@ class SceneManager
 
       WaterFogData mWaterFogData;
 
+      /// Grid used by scopeScene() when #smShareScoping is set.
+      SceneScopingGrid mScopingGrid;
+
       /// The stored last diffuse pass frustum for locking the cull.
       static SceneCameraState smLockedDiffuseCamera;
 
@@ -283,6 +301,9 @@ class SceneManager
       /// Set the scoping states of the objects in the scene.
       void scopeScene( CameraScopeQuery* query, NetConnection* netConnection );
 
+      /// Return the grid shared by the scopeScene() calls of all connections.
+      SceneScopingGrid& getScopingGrid() { return mScopingGrid; }
+
       /// @}
 
       /// @name Fog/Visibility Management
@@ -127,6 +127,7 @@ SceneObject::SceneObject()
    mBinMaxX = 0xFFFFFFFF;
    mBinMinY = 0xFFFFFFFF;
    mBinMaxY = 0xFFFFFFFF;
+   mContainerTreeLeaf = SceneContainerTree::NullNode;
    mLightPlugin = NULL;
 
    mMount.object = NULL;
@@ -146,7 +147,7 @@ SceneObject::SceneObject()
 
 SceneObject::~SceneObject()
 {
-   AssertFatal( mZoneRefHead == NULL && mBinRefHead == NULL,
+   AssertFatal( mZoneRefHead == NULL && mBinRefHead == NULL && mContainerTreeLeaf == SceneContainerTree::NullNode,
       "SceneObject::~SceneObject - Object still linked in reference lists!");
    AssertFatal( !mSceneObjectLinks,
       "SceneObject::~SceneObject() - object is still linked to SceneTrackers" );
@@ -781,7 +782,7 @@ U32 SceneObject::packUpdate( NetConnection* conn, U32 mask, BitStream* stream )
          if ( stream->writeFlag( gIndex != -1 ) ) 
          {
             stream->writeFlag( true );
-            stream->writeInt( gIndex, NetConnection::GhostIdBitSize );
+            conn->writeGhostId( stream, gIndex );
             if ( stream->writeFlag( mMount.node != -1 ) )
                stream->writeInt( mMount.node, NumMountPointBits );
             mathWrite( *stream, mMount.xfm );
@@ -816,7 +817,7 @@ void SceneObject::unpackUpdate( NetConnection* conn, BitStream* stream )
    {
       if ( stream->readFlag() ) 
       {
-         S32 gIndex = stream->readInt( NetConnection::GhostIdBitSize );
+         S32 gIndex = conn->readGhostId( stream );
          SceneObject* obj = dynamic_cast<SceneObject*>( conn->resolveGhost( gIndex ) );
          S32 node = -1;
          if ( stream->readFlag() ) // node != -1
@@ -345,6 +345,9 @@ class SceneObject : public NetObject, private SceneContainer::Link, public Proce
       U32 mBinMinY;
       U32 mBinMaxY;
 
+      /// Leaf in the container's SceneContainerTree or SceneContainerTree::NullNode.
+      S32 mContainerTreeLeaf;
+
       /// Returns the container sequence key.
       U32 getContainerSeqKey() const { return mContainerSeqKey; }
 
@@ -692,6 +695,13 @@ class SceneObject : public NetObject, private SceneContainer::Link, public Proce
       /// @param state Rendering state.
       virtual void prepRenderImage( SceneRenderState* state ) {}
 
+      /// Return true if prepRenderImage() may run on a worker thread at the same time
+      /// as the prepRenderImage() of other objects.  It then must not touch anything
+      /// but this object's own read-only state and the render pass allocation and
+      /// addInst() interface.
+      /// @see SceneManager::smParallelRender
+      virtual bool isPrepRenderImageThreadSafe() const { return false; }
+
       /// @}
 
       /// @name Lighting
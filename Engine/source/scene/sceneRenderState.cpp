@@ -25,6 +25,12 @@
 
 #include "renderInstance/renderPassManager.h"
 #include "math/util/matrixSet.h"
+#include "platform/threads/threadPool.h"
+
+
+/// Maximum number of objects batched by each work item in
+/// SceneRenderState::prepRenderImagesParallel().
+static const U32 sgPrepRenderImageBatchSize = 64;
 
 
 
@@ -94,19 +100,139 @@ const MatrixF& SceneRenderState::getProjectionMatrix() const
 
 //-----------------------------------------------------------------------------
 
-void SceneRenderState::renderObjects( SceneObject** objects, U32 numObjects )
+void SceneRenderState::renderObjects( SceneObject** objects, U32 numObjects, bool parallel )
 {
    // Let the objects batch their stuff.
 
-   PROFILE_START( SceneRenderState_prepRenderImages );
+   if( parallel )
+      prepRenderImagesParallel( objects, numObjects );
+   else
+      prepRenderImages( objects, numObjects );
+
+   // Render what the objects have batched.
+
+   getRenderPass()->renderPass( this );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneRenderState::prepRenderImages( SceneObject** objects, U32 numObjects )
+{
+   PROFILE_SCOPE( SceneRenderState_prepRenderImages );
+
    for( U32 i = 0; i < numObjects; ++ i )
    {
       SceneObject* object = objects[ i ];
       object->prepRenderImage( this );
    }
-   PROFILE_END();
+}
 
-   // Render what the objects have batched.
+//-----------------------------------------------------------------------------
 
-   getRenderPass()->renderPass( this );
+namespace {
+
+   struct PrepRenderImageWorkItem : public ThreadPool::WorkItem
+   {
+      typedef ThreadPool::WorkItem Parent;
+
+      SceneRenderState* mState;
+      ThreadPool::WorkItemGroup* mGroup;
+      SceneObject** mObjects;
+      U32 mNumObjects;
+      RenderPassManager::DeferredBatch* mBatch;
+
+      PrepRenderImageWorkItem( SceneRenderState* state, ThreadPool::WorkItemGroup* group, SceneObject** objects, U32 numObjects, RenderPassManager::DeferredBatch* batch )
+         : mState( state ), mGroup( group ), mObjects( objects ), mNumObjects( numObjects ), mBatch( batch ) {}
+
+      virtual void execute()
+      {
+         RenderPassManager::setCurrentBatch( mBatch );
+         for( U32 i = 0; i < mNumObjects; ++ i )
+            mObjects[ i ]->prepRenderImage( mState );
+         RenderPassManager::setCurrentBatch( NULL );
+
+         mGroup->done();
+      }
+   };
+}
+
+void SceneRenderState::prepRenderImagesParallel( SceneObject** objects, U32 numObjects )
+{
+   PROFILE_SCOPE( SceneRenderState_prepRenderImagesParallel );
+
+   // Split the list into batches of objects that are either all thread-safe
+   // or all not.  Each batch gets its own deferred batch on the render pass
+   // so that its instances can be added to the bins in list order later.
+
+   Vector< U32 > batchStarts;
+   Vector< bool > batchThreadSafe;
+   U32 numThreadSafeBatches = 0;
+
+   for( U32 i = 0; i < numObjects; )
+   {
+      const bool threadSafe = objects[ i ]->isPrepRenderImageThreadSafe();
+
+      U32 end = i + 1;
+      while( end < numObjects &&
+             ( end - i ) < sgPrepRenderImageBatchSize &&
+             objects[ end ]->isPrepRenderImageThreadSafe() == threadSafe )
+         ++ end;
+
+      batchStarts.push_back( i );
+      batchThreadSafe.push_back( threadSafe );
+      if( threadSafe )
+         ++ numThreadSafeBatches;
+
+      i = end;
+   }
+   batchStarts.push_back( numObjects );
+
+   // Nothing to gain if we'd end up with a single batch or if the pass is
+   // already deferring for an outer call.
+
+   RenderPassManager* renderPass = getRenderPass();
+   if( numThreadSafeBatches == 0 || batchThreadSafe.size() < 2 || renderPass->isDeferring() )
+   {
+      prepRenderImages( objects, numObjects );
+      return;
+   }
+
+   const U32 numBatches = batchThreadSafe.size();
+   renderPass->beginDeferring( numBatches );
+
+   // Queue the thread-safe batches.
+
+   ThreadPool::WorkItemGroup group;
+   Vector< ThreadSafeRef< PrepRenderImageWorkItem > > items;
+   ThreadPool* pool = &ThreadPool::GLOBAL();
+   for( U32 i = 0; i < numBatches; ++ i )
+   {
+      if( !batchThreadSafe[ i ] )
+         continue;
+
+      ThreadSafeRef< PrepRenderImageWorkItem > item( new PrepRenderImageWorkItem(
+         this, &group, objects + batchStarts[ i ], batchStarts[ i + 1 ] - batchStarts[ i ], renderPass->getDeferredBatch( i ) ) );
+      items.push_back( item );
+      group.add();
+      pool->queueWorkItem( item );
+   }
+
+   // Batch the other objects on this thread while the pool works.
+
+   for( U32 i = 0; i < numBatches; ++ i )
+   {
+      if( batchThreadSafe[ i ] )
+         continue;
+
+      RenderPassManager::setCurrentBatch( renderPass->getDeferredBatch( i ) );
+      for( U32 n = batchStarts[ i ]; n < batchStarts[ i + 1 ]; ++ n )
+         objects[ n ]->prepRenderImage( this );
+      RenderPassManager::setCurrentBatch( NULL );
+   }
+
+   // Wait for the items to finish executing, not just for the queue
+   // to run empty, before the batches are merged.
+   group.wait();
+
+   renderPass->endDeferring();
 }
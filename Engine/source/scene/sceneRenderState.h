@@ -164,7 +164,24 @@ class SceneRenderState
       ///
       /// @param objects List of objects.
       /// @param numObjects Number of objects in @a objects.
-      void renderObjects( SceneObject** objects, U32 numObjects );
+      /// @param parallel If true, use prepRenderImagesParallel().
+      void renderObjects( SceneObject** objects, U32 numObjects, bool parallel = false );
+
+      /// Batch the given objects to the render pass manager.
+      ///
+      /// @param objects List of objects.
+      /// @param numObjects Number of objects in @a objects.
+      void prepRenderImages( SceneObject** objects, U32 numObjects );
+
+      /// Batch the given objects to the render pass manager like prepRenderImages()
+      /// but run the prepRenderImage() of objects that are thread-safe on the global
+      /// thread pool.  The other objects are batched on the calling thread meanwhile.
+      /// The bins receive the render instances in the same order as with
+      /// prepRenderImages().
+      ///
+      /// @note Only call this on the main thread.
+      /// @see SceneObject::isPrepRenderImageThreadSafe
+      void prepRenderImagesParallel( SceneObject** objects, U32 numObjects );
 
       /// @}
 
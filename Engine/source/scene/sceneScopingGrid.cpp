@@ -0,0 +1,304 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "scene/sceneScopingGrid.h"
+
+#include "scene/sceneContainer.h"
+#include "scene/sceneObject.h"
+#include "platform/profiler.h"
+
+
+F32 SceneScopingGrid::smCellSize = 64.0f;
+
+/// Upper bound on the number of cells along each axis.  The cell size
+/// is doubled until the grid fits.
+static const S32 sgMaxCellsPerAxis = 256;
+
+
+//-----------------------------------------------------------------------------
+
+SceneScopingGrid::SceneScopingGrid()
+   : mChangeCount( 0 ),
+     mContainer( NULL ),
+     mOrigin( 0.0f, 0.0f ),
+     mCellSize( smCellSize ),
+     mNumCellsX( 0 ),
+     mNumCellsY( 0 ),
+     mMaxOverhang( 0.0f ),
+     mNumBuilds( 0 ),
+     mNumQueries( 0 ),
+     mNumSharedQueries( 0 )
+{
+   VECTOR_SET_ASSOCIATION( mEntries );
+   VECTOR_SET_ASSOCIATION( mUnsortedEntries );
+   VECTOR_SET_ASSOCIATION( mLargeEntries );
+   VECTOR_SET_ASSOCIATION( mCellStarts );
+   VECTOR_SET_ASSOCIATION( mEntryCells );
+   VECTOR_SET_ASSOCIATION( mCachedQueries );
+   VECTOR_SET_ASSOCIATION( mCandidates );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneScopingGrid::clear()
+{
+   mContainer = NULL;
+   mEntries.clear();
+   mUnsortedEntries.clear();
+   mLargeEntries.clear();
+   mCellStarts.clear();
+   mCachedQueries.clear();
+   mCandidates.clear();
+   mNumCellsX = 0;
+   mNumCellsY = 0;
+}
+
+//-----------------------------------------------------------------------------
+
+static void _addEntryCallback( SceneObject* object, void* key )
+{
+   Vector< SceneObject* >* objects = reinterpret_cast< Vector< SceneObject* >* >( key );
+   objects->push_back( object );
+}
+
+void SceneScopingGrid::_update( SceneContainer* container )
+{
+   if( container == mContainer && container->getChangeCount() == mChangeCount )
+      return;
+
+   PROFILE_SCOPE( SceneScopingGrid_update );
+
+   mContainer = container;
+   mChangeCount = container->getChangeCount();
+   mNumBuilds ++;
+
+   mCachedQueries.clear();
+   mCandidates.clear();
+
+   // Gather the objects.  Scopeability is tested per query as it
+   // can change without the container noticing.
+
+   Vector< SceneObject* > objects;
+   container->findObjects( 0xFFFFFFFF, _addEntryCallback, &objects );
+
+   mUnsortedEntries.clear();
+   mLargeEntries.clear();
+
+   Box3F bounds;
+   bounds.minExtents.set( F32_MAX, F32_MAX, F32_MAX );
+   bounds.maxExtents.set( -F32_MAX, -F32_MAX, -F32_MAX );
+
+   // Clamp the cell size so a bad $Scene::scopingGridCellSize can't
+   // make the grid sizing below loop forever.
+
+   mCellSize = getMax( smCellSize, 1.0f );
+
+   mMaxOverhang = 0.0f;
+   for( U32 i = 0; i < objects.size(); ++ i )
+   {
+      SceneObject* object = objects[ i ];
+
+      Entry entry;
+      entry.object = object;
+      entry.box = object->getWorldBox();
+      entry.sphere = object->getWorldSphere();
+
+      const F32 overhang = getMax( entry.box.len_x(), entry.box.len_y() ) * 0.5f;
+      if( object->isGlobalBounds() || overhang > mCellSize )
+      {
+         mLargeEntries.push_back( entry );
+         continue;
+      }
+
+      mUnsortedEntries.push_back( entry );
+      mMaxOverhang = getMax( mMaxOverhang, overhang );
+      bounds.extend( entry.box.getCenter() );
+   }
+
+   if( mUnsortedEntries.empty() )
+   {
+      mEntries.clear();
+      mNumCellsX = 0;
+      mNumCellsY = 0;
+      mCellStarts.clear();
+      return;
+   }
+
+   // Size the grid to cover the centers of all entries.
+
+   mOrigin.set( bounds.minExtents.x, bounds.minExtents.y );
+   for( ;; )
+   {
+      mNumCellsX = S32( bounds.len_x() / mCellSize ) + 1;
+      mNumCellsY = S32( bounds.len_y() / mCellSize ) + 1;
+      if( mNumCellsX <= sgMaxCellsPerAxis && mNumCellsY <= sgMaxCellsPerAxis )
+         break;
+
+      mCellSize *= 2.0f;
+   }
+
+   // Sort the entries by cell.
+
+   const U32 numCells = mNumCellsX * mNumCellsY;
+   mCellStarts.setSize( numCells + 1 );
+   dMemset( mCellStarts.address(), 0, mCellStarts.size() * sizeof( U32 ) );
+
+   mEntryCells.setSize( mUnsortedEntries.size() );
+   for( U32 i = 0; i < mUnsortedEntries.size(); ++ i )
+   {
+      const Point3F center = mUnsortedEntries[ i ].box.getCenter();
+      const S32 x = mClamp( S32( ( center.x - mOrigin.x ) / mCellSize ), 0, mNumCellsX - 1 );
+      const S32 y = mClamp( S32( ( center.y - mOrigin.y ) / mCellSize ), 0, mNumCellsY - 1 );
+      mEntryCells[ i ] = y * mNumCellsX + x;
+      mCellStarts[ mEntryCells[ i ] + 1 ] ++;
+   }
+
+   for( U32 i = 1; i <= numCells; ++ i )
+      mCellStarts[ i ] += mCellStarts[ i - 1 ];
+
+   mEntries.setSize( mUnsortedEntries.size() );
+   for( U32 i = 0; i < mUnsortedEntries.size(); ++ i )
+      mEntries[ mCellStarts[ mEntryCells[ i ] ] ++ ] = mUnsortedEntries[ i ];
+
+   // Filling in the entries has moved each cell start to the start of
+   // the next cell, so shift them back.
+
+   for( U32 i = numCells; i > 0; -- i )
+      mCellStarts[ i ] = mCellStarts[ i - 1 ];
+   mCellStarts[ 0 ] = 0;
+}
+
+//-----------------------------------------------------------------------------
+
+SceneScopingGrid::CachedQuery SceneScopingGrid::_getCandidates( S32 cellX, S32 cellY, F32 distance )
+{
+   for( U32 i = 0; i < mCachedQueries.size(); ++ i )
+   {
+      const CachedQuery& query = mCachedQueries[ i ];
+      if( query.cellX == cellX && query.cellY == cellY && query.distance == distance )
+      {
+         mNumSharedQueries ++;
+         return query;
+      }
+   }
+
+   PROFILE_SCOPE( SceneScopingGrid_getCandidates );
+
+   CachedQuery query;
+   query.cellX = cellX;
+   query.cellY = cellY;
+   query.distance = distance;
+   query.first = mCandidates.size();
+
+   // The area any camera in the cell can see.
+
+   const F32 minX = mOrigin.x + cellX * mCellSize - distance;
+   const F32 minY = mOrigin.y + cellY * mCellSize - distance;
+   const F32 maxX = mOrigin.x + ( cellX + 1 ) * mCellSize + distance;
+   const F32 maxY = mOrigin.y + ( cellY + 1 ) * mCellSize + distance;
+
+   // Entries are sorted into cells by their centers so look at all the
+   // cells an entry overlapping the area may be in.
+
+   const F32 invCellSize = 1.0f / mCellSize;
+   const S32 firstX = getMax( S32( mFloor( ( minX - mMaxOverhang - mOrigin.x ) * invCellSize ) ), 0 );
+   const S32 firstY = getMax( S32( mFloor( ( minY - mMaxOverhang - mOrigin.y ) * invCellSize ) ), 0 );
+   const S32 lastX = getMin( S32( mFloor( ( maxX + mMaxOverhang - mOrigin.x ) * invCellSize ) ), mNumCellsX - 1 );
+   const S32 lastY = getMin( S32( mFloor( ( maxY + mMaxOverhang - mOrigin.y ) * invCellSize ) ), mNumCellsY - 1 );
+
+   for( S32 y = firstY; y <= lastY; ++ y )
+   {
+      for( S32 x = firstX; x <= lastX; ++ x )
+      {
+         const U32 cell = y * mNumCellsX + x;
+         for( U32 i = mCellStarts[ cell ]; i < mCellStarts[ cell + 1 ]; ++ i )
+         {
+            const Box3F& box = mEntries[ i ].box;
+            if( box.maxExtents.x >= minX && box.minExtents.x <= maxX &&
+                box.maxExtents.y >= minY && box.minExtents.y <= maxY )
+               mCandidates.push_back( i );
+         }
+      }
+   }
+
+   query.count = mCandidates.size() - query.first;
+   mCachedQueries.push_back( query );
+
+   return query;
+}
+
+//-----------------------------------------------------------------------------
+
+static inline void _scopeEntry( SceneObject* object, const Box3F& box, const SphereF& sphere, const Box3F& area,
+                                const Point3F& point, F32 distance, F32 distanceSquared,
+                                SceneScopingGrid::ScopeCallback callback, void* key )
+{
+   if( !object->isScopeable() || !area.isOverlapped( box ) )
+      return;
+
+   F32 difSq = ( sphere.center - point ).lenSquared();
+   if( difSq < distanceSquared )
+   {
+      // Not even close, it's in...
+      callback( object, key );
+   }
+   else
+   {
+      // Check a little more closely...
+      F32 realDif = mSqrt( difSq );
+      if( realDif - sphere.radius < distance )
+         callback( object, key );
+   }
+}
+
+void SceneScopingGrid::scope( SceneContainer* container, const Point3F& point, F32 distance, ScopeCallback callback, void* key )
+{
+   PROFILE_SCOPE( SceneScopingGrid_scope );
+
+   _update( container );
+   mNumQueries ++;
+
+   Box3F area( distance );
+   area.setCenter( point );
+
+   const F32 distanceSquared = distance * distance;
+
+   if( !mEntries.empty() )
+   {
+      const S32 cellX = S32( mFloor( ( point.x - mOrigin.x ) / mCellSize ) );
+      const S32 cellY = S32( mFloor( ( point.y - mOrigin.y ) / mCellSize ) );
+      const CachedQuery query = _getCandidates( cellX, cellY, distance );
+
+      for( U32 i = 0; i < query.count; ++ i )
+      {
+         const Entry& entry = mEntries[ mCandidates[ query.first + i ] ];
+         _scopeEntry( entry.object, entry.box, entry.sphere, area, point, distance, distanceSquared, callback, key );
+      }
+   }
+
+   for( U32 i = 0; i < mLargeEntries.size(); ++ i )
+   {
+      const Entry& entry = mLargeEntries[ i ];
+      _scopeEntry( entry.object, entry.box, entry.sphere, area, point, distance, distanceSquared, callback, key );
+   }
+}
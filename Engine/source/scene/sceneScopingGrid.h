@@ -0,0 +1,157 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SCENESCOPINGGRID_H_
+#define _SCENESCOPINGGRID_H_
+
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+
+#ifndef _MSPHERE_H_
+#include "math/mSphere.h"
+#endif
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+
+class SceneObject;
+class SceneContainer;
+
+
+/// A flat 2D grid over the objects of a container for network scoping.
+///
+/// Scoping is a sphere test around the camera of each connection.  The grid
+/// is built once from the container and then serves the scope queries of
+/// all connections until the container changes, which on a server usually
+/// means once per tick.
+///
+/// Connections whose cameras are in the same grid cell and that use the same
+/// visible distance share their list of candidate objects.  Only the final
+/// exact test is done per connection, so the result is the same as doing a
+/// box query and sphere test per connection.
+class SceneScopingGrid
+{
+   public:
+
+      /// Callback invoked for every object in scope.
+      typedef void ( *ScopeCallback )( SceneObject* object, void* key );
+
+      /// Side length of the grid cells.  Scope queries of cameras in the
+      /// same cell share their candidates.
+      static F32 smCellSize;
+
+   protected:
+
+      struct Entry
+      {
+         SceneObject* object;
+
+         /// World box and sphere of the object when the grid was built.
+         Box3F box;
+         SphereF sphere;
+      };
+
+      /// Candidate list shared by all queries from the same cell
+      /// with the same distance.
+      struct CachedQuery
+      {
+         S32 cellX;
+         S32 cellY;
+         F32 distance;
+
+         /// Range in #mCandidates.
+         U32 first;
+         U32 count;
+      };
+
+      /// Value of SceneContainer::getChangeCount() when the grid was built.
+      U32 mChangeCount;
+
+      /// The container the grid was built from.
+      SceneContainer* mContainer;
+
+      /// Entries of objects that fit into the grid, sorted by cell.
+      Vector< Entry > mEntries;
+
+      /// Entries of objects that are larger than a cell or have global bounds.
+      /// They are candidates of every query.
+      Vector< Entry > mLargeEntries;
+
+      /// Index into #mEntries of the first entry of each cell plus one
+      /// past the last entry.
+      Vector< U32 > mCellStarts;
+
+      /// Entries of #mEntries while building.
+      Vector< Entry > mUnsortedEntries;
+
+      /// Cell of each entry while building.
+      Vector< U32 > mEntryCells;
+
+      /// Origin, cell size and dimensions of the grid.
+      Point2F mOrigin;
+      F32 mCellSize;
+      S32 mNumCellsX;
+      S32 mNumCellsY;
+
+      /// Largest distance that an entry's box reaches out of its cell.
+      F32 mMaxOverhang;
+
+      Vector< CachedQuery > mCachedQueries;
+      Vector< U32 > mCandidates;
+
+      /// Statistics.
+      U32 mNumBuilds;
+      U32 mNumQueries;
+      U32 mNumSharedQueries;
+
+      /// Rebuild the grid if the container has changed.
+      void _update( SceneContainer* container );
+
+      /// Collect the candidates of queries from the given cell.
+      CachedQuery _getCandidates( S32 cellX, S32 cellY, F32 distance );
+
+   public:
+
+      SceneScopingGrid();
+
+      /// Call @a callback for every object in @a container whose world bounds are within
+      /// @a distance of @a point.  Only scopeable objects are considered.
+      void scope( SceneContainer* container, const Point3F& point, F32 distance, ScopeCallback callback, void* key );
+
+      /// Drop all data, forcing a rebuild on the next query.
+      void clear();
+
+      /// Return the number of times the grid has been built.
+      U32 getNumBuilds() const { return mNumBuilds; }
+
+      /// Return the number of queries that were served.
+      U32 getNumQueries() const { return mNumQueries; }
+
+      /// Return the number of queries that reused the candidates
+      /// collected for an earlier query.
+      U32 getNumSharedQueries() const { return mNumSharedQueries; }
+};
+
+#endif // !_SCENESCOPINGGRID_H_
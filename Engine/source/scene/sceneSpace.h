@@ -70,10 +70,12 @@ class SceneSpace : public SceneObject
       // SceneObject.
       virtual void setTransform( const MatrixF &mat );
       virtual void prepRenderImage( SceneRenderState* state );
+      virtual bool isPrepRenderImageThreadSafe() const { return true; }
 
       // NetObject.
       virtual U32 packUpdate( NetConnection* connection, U32 mask, BitStream* stream );
       virtual void unpackUpdate( NetConnection* connection, BitStream* stream );
+      virtual bool isPackUpdateThreadSafe( U32 mask ) const { return true; }
 
       // SimObject.
       virtual void onEditorEnable();
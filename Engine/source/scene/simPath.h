@@ -119,6 +119,7 @@ class Marker : public SceneObject
    // Rendering
   protected:
    void prepRenderImage(SceneRenderState *state);
+   bool isPrepRenderImageThreadSafe() const { return true; }
    void renderObject(ObjectRenderInst *ri, SceneRenderState *state, BaseMatInstance* overrideMat);
 
   protected:
@@ -145,6 +146,7 @@ class Marker : public SceneObject
 
    U32  packUpdate  (NetConnection *conn, U32 mask, BitStream *stream);
    void unpackUpdate(NetConnection *conn,           BitStream *stream);
+   bool isPackUpdateThreadSafe(U32 mask) const { return true; }
 };
 
 typedef Marker::SmoothingType MarkerSmoothingType;
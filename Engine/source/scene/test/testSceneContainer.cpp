@@ -0,0 +1,528 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "unit/test.h"
+#include "console/console.h"
+#include "scene/sceneContainer.h"
+#include "scene/sceneObject.h"
+#include "math/mRandom.h"
+#include "collision/collision.h"
+#include "platform/threads/threadPool.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+namespace {
+
+   /// Box shaped object that is never registered with the Sim.
+   class ContainerTestObject : public SceneObject
+   {
+      public:
+
+         ContainerTestObject( const Point3F& position, const Point3F& halfExtents )
+         {
+            mTypeMask = StaticObjectType;
+            mObjBox.set( -halfExtents, halfExtents );
+
+            MatrixF mat( true );
+            mat.setPosition( position );
+            setTransform( mat );
+         }
+
+         void setPosition( const Point3F& position )
+         {
+            MatrixF mat( true );
+            mat.setPosition( position );
+            setTransform( mat );
+         }
+
+         virtual bool castRay( const Point3F& start, const Point3F& end, RayInfo* info )
+         {
+            F32 t;
+            Point3F normal;
+            if( !mObjBox.collideLine( start, end, &t, &normal ) )
+               return false;
+
+            info->t = t;
+            info->normal = normal;
+            info->object = this;
+            return true;
+         }
+   };
+
+   Point3F randomPoint( MRandomLCG& random, F32 worldSize )
+   {
+      const F32 halfSize = worldSize * 0.5f;
+      return Point3F( random.randF( -halfSize, halfSize ),
+                      random.randF( -halfSize, halfSize ),
+                      random.randF( 0.0f, 100.0f ) );
+   }
+
+   Point3F randomExtents( MRandomLCG& random )
+   {
+      return Point3F( random.randF( 0.5f, 8.0f ),
+                      random.randF( 0.5f, 8.0f ),
+                      random.randF( 0.5f, 8.0f ) );
+   }
+
+   void populate( SceneContainer& container, Vector< ContainerTestObject* >& objects, U32 count, F32 worldSize, U32 seed )
+   {
+      MRandomLCG random( seed );
+      for( U32 i = 0; i < count; ++ i )
+      {
+         ContainerTestObject* object = new ContainerTestObject( randomPoint( random, worldSize ), randomExtents( random ) );
+         container.addObject( object );
+         objects.push_back( object );
+      }
+   }
+
+   void clear( SceneContainer& container, Vector< ContainerTestObject* >& objects )
+   {
+      for( U32 i = 0; i < objects.size(); ++ i )
+      {
+         container.removeObject( objects[ i ] );
+         delete objects[ i ];
+      }
+      objects.clear();
+   }
+
+   S32 QSORT_CALLBACK comparePointers( const void* a, const void* b )
+   {
+      const dsize_t pa = dsize_t( *( SceneObject* const* ) a );
+      const dsize_t pb = dsize_t( *( SceneObject* const* ) b );
+      return pa < pb ? -1 : ( pa > pb ? 1 : 0 );
+   }
+
+   void findSorted( SceneContainer& container, const Box3F& box, Vector< SceneObject* >& outFound )
+   {
+      outFound.clear();
+      container.findObjectList( box, StaticObjectType, &outFound );
+      dQsort( outFound.address(), outFound.size(), sizeof( SceneObject* ), comparePointers );
+   }
+}
+
+// Checks that box queries and raycasts against the tree return the same
+// results as the bin grid, including after objects move.
+
+CreateUnitTest( TestSceneContainer, "Scene/Container" )
+{
+   bool compare( SceneContainer& container, U32 seed, F32 worldSize )
+   {
+      MRandomLCG random( seed );
+      bool same = true;
+
+      for( U32 i = 0; i < 200; ++ i )
+      {
+         const Point3F center = randomPoint( random, worldSize );
+         const Point3F extents = randomExtents( random ) * 4.0f;
+         const Box3F box( center - extents, center + extents );
+
+         Vector< SceneObject* > gridFound;
+         Vector< SceneObject* > treeFound;
+
+         container.setSpatialIndex( SceneContainer::SpatialIndexBinGrid );
+         findSorted( container, box, gridFound );
+         container.setSpatialIndex( SceneContainer::SpatialIndexTree );
+         findSorted( container, box, treeFound );
+
+         if( gridFound.size() != treeFound.size() )
+            same = false;
+         else if( gridFound.size() && dMemcmp( gridFound.address(), treeFound.address(), gridFound.size() * sizeof( SceneObject* ) ) != 0 )
+            same = false;
+      }
+
+      for( U32 i = 0; i < 200; ++ i )
+      {
+         const Point3F start = randomPoint( random, worldSize );
+         const Point3F end = randomPoint( random, worldSize );
+
+         RayInfo gridInfo;
+         RayInfo treeInfo;
+
+         container.setSpatialIndex( SceneContainer::SpatialIndexBinGrid );
+         const bool gridHit = container.castRay( start, end, StaticObjectType, &gridInfo );
+         container.setSpatialIndex( SceneContainer::SpatialIndexTree );
+         const bool treeHit = container.castRay( start, end, StaticObjectType, &treeInfo );
+
+         if( gridHit != treeHit )
+            same = false;
+         else if( gridHit && mFabs( gridInfo.t - treeInfo.t ) > 0.0001f )
+            same = false;
+      }
+
+      return same;
+   }
+
+   void run()
+   {
+      const F32 worldSize = 2048.0f;
+
+      SceneContainer container;
+      Vector< ContainerTestObject* > objects;
+      populate( container, objects, 2000, worldSize, 1234 );
+
+      test( container.getSpatialIndex() == SceneContainer::SpatialIndexTree, "Tree should be the default index" );
+      test( compare( container, 42, worldSize ), "Tree results differ from bin grid" );
+
+      // Move objects while the tree is active so leaves get updated in place.
+      MRandomLCG random( 99 );
+      for( U32 i = 0; i < objects.size(); ++ i )
+      {
+         Point3F position = objects[ i ]->getPosition();
+         if( i % 3 == 0 )
+            position = randomPoint( random, worldSize );
+         else
+            position += Point3F( random.randF( -2.0f, 2.0f ), random.randF( -2.0f, 2.0f ), 0.0f );
+
+         objects[ i ]->setPosition( position );
+         container.checkBins( objects[ i ] );
+      }
+
+      test( compare( container, 43, worldSize ), "Tree results differ from bin grid after moving objects" );
+
+      // Removal from both indices.
+      for( U32 i = 0; i < objects.size(); i += 2 )
+      {
+         container.removeObject( objects[ i ] );
+         delete objects[ i ];
+         objects.erase_fast( i );
+      }
+
+      test( compare( container, 44, worldSize ), "Tree results differ from bin grid after removing objects" );
+
+      clear( container, objects );
+   }
+};
+
+// Times box queries and raycasts with the bin grid and the tree.  The grid
+// wraps every 1024m so on larger worlds unrelated objects share bins.
+
+CreateUnitTest( TestSceneContainerPerformance, "Scene/ContainerPerformance" )
+{
+   void runQueries( SceneContainer& container, F32 worldSize, U32& boxTime, U32& rayTime, U32& found )
+   {
+      const U32 queries = 20000;
+      MRandomLCG random( 4321 );
+
+      Vector< SceneObject* > results;
+      found = 0;
+
+      U32 start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < queries; ++ i )
+      {
+         const Point3F center = randomPoint( random, worldSize );
+         const Box3F box( center - Point3F( 16, 16, 16 ), center + Point3F( 16, 16, 16 ) );
+
+         results.clear();
+         container.findObjectList( box, StaticObjectType, &results );
+         found += results.size();
+      }
+      boxTime = Platform::getRealMilliseconds() - start;
+
+      start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < queries; ++ i )
+      {
+         const Point3F rayStart = randomPoint( random, worldSize );
+         Point3F rayEnd = rayStart + Point3F( random.randF( -100.0f, 100.0f ), random.randF( -100.0f, 100.0f ), 0.0f );
+
+         RayInfo info;
+         if( container.castRay( rayStart, rayEnd, StaticObjectType, &info ) )
+            found ++;
+      }
+      rayTime = Platform::getRealMilliseconds() - start;
+   }
+
+   void runCount( U32 count, F32 worldSize )
+   {
+      SceneContainer container;
+      Vector< ContainerTestObject* > objects;
+
+      container.setSpatialIndex( SceneContainer::SpatialIndexBinGrid );
+      populate( container, objects, count, worldSize, 5678 );
+
+      U32 gridBoxTime, gridRayTime, gridFound;
+      runQueries( container, worldSize, gridBoxTime, gridRayTime, gridFound );
+
+      container.setSpatialIndex( SceneContainer::SpatialIndexTree );
+
+      U32 treeBoxTime, treeRayTime, treeFound;
+      runQueries( container, worldSize, treeBoxTime, treeRayTime, treeFound );
+
+      test( gridFound == treeFound, "Grid and tree found different results" );
+
+      Con::printf( "   %d objects, %gm world: grid box %dms ray %dms, tree box %dms ray %dms",
+         count, worldSize, gridBoxTime, gridRayTime, treeBoxTime, treeRayTime );
+
+      clear( container, objects );
+   }
+
+   void run()
+   {
+      runCount( 1000, 1024.0f );
+      runCount( 10000, 1024.0f );
+      runCount( 10000, 8192.0f );
+      runCount( 50000, 8192.0f );
+   }
+};
+
+// Checks that castRayBatch() finds the same hits as individual castRay()
+// calls, serially and on the thread pool, and times the three.
+
+CreateUnitTest( TestSceneContainerRayBatch, "Scene/ContainerRayBatch" )
+{
+   bool compare( const Vector< RayInfo >& expected, const Vector< bool >& expectedHit, const Vector< RayInfo >& infos )
+   {
+      for( U32 i = 0; i < expected.size(); ++ i )
+      {
+         if( expectedHit[ i ] != ( infos[ i ].object != NULL ) )
+            return false;
+         if( expectedHit[ i ] && mFabs( expected[ i ].t - infos[ i ].t ) > 0.0001f )
+            return false;
+      }
+      return true;
+   }
+
+   void run()
+   {
+      const F32 worldSize = 2048.0f;
+      const U32 numRays = 20000;
+
+      SceneContainer container;
+      Vector< ContainerTestObject* > objects;
+      populate( container, objects, 10000, worldSize, 2468 );
+
+      MRandomLCG random( 1357 );
+      Vector< Point3F > starts;
+      Vector< Point3F > ends;
+      starts.setSize( numRays );
+      ends.setSize( numRays );
+      for( U32 i = 0; i < numRays; ++ i )
+      {
+         starts[ i ] = randomPoint( random, worldSize );
+         ends[ i ] = starts[ i ] + Point3F( random.randF( -100.0f, 100.0f ), random.randF( -100.0f, 100.0f ), random.randF( -10.0f, 10.0f ) );
+      }
+
+      Vector< RayInfo > expected;
+      Vector< bool > expectedHit;
+      expected.setSize( numRays );
+      expectedHit.setSize( numRays );
+
+      U32 numHits = 0;
+      U32 start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < numRays; ++ i )
+      {
+         expected[ i ] = RayInfo();
+         expectedHit[ i ] = container.castRay( starts[ i ], ends[ i ], StaticObjectType, &expected[ i ] );
+         if( expectedHit[ i ] )
+            numHits ++;
+      }
+      const U32 singleTime = Platform::getRealMilliseconds() - start;
+
+      Vector< RayInfo > infos;
+      infos.setSize( numRays );
+
+      start = Platform::getRealMilliseconds();
+      U32 batchHits = container.castRayBatch( starts.address(), ends.address(), numRays, StaticObjectType, infos.address() );
+      const U32 batchTime = Platform::getRealMilliseconds() - start;
+
+      test( batchHits == numHits, "Batch hit count differs from single rays" );
+      test( compare( expected, expectedHit, infos ), "Batch hits differ from single rays" );
+
+      start = Platform::getRealMilliseconds();
+      batchHits = container.castRayBatch( starts.address(), ends.address(), numRays, StaticObjectType, infos.address(), NULL, true );
+      const U32 parallelTime = Platform::getRealMilliseconds() - start;
+
+      test( batchHits == numHits, "Parallel batch hit count differs from single rays" );
+      test( compare( expected, expectedHit, infos ), "Parallel batch hits differ from single rays" );
+
+      // The grid falls back to single rays.
+      container.setSpatialIndex( SceneContainer::SpatialIndexBinGrid );
+      batchHits = container.castRayBatch( starts.address(), ends.address(), numRays, StaticObjectType, infos.address() );
+      test( batchHits == numHits && compare( expected, expectedHit, infos ), "Batch on bin grid differs from single rays" );
+
+      Con::printf( "   %d rays, %d hits: single %dms, batch %dms, parallel batch %dms",
+         numRays, numHits, singleTime, batchTime, parallelTime );
+
+      clear( container, objects );
+   }
+};
+
+// Runs the same box and ray queries through QueryContexts on several pool
+// threads at once and checks they match the container's own queries.
+
+CreateUnitTest( TestSceneContainerQueryContext, "Scene/ContainerQueryContext" )
+{
+   enum
+   {
+      NumQueries = 500,
+      NumItems = 8
+   };
+
+   struct Queries
+   {
+      Vector< Box3F > boxes;
+      Vector< Point3F > starts;
+      Vector< Point3F > ends;
+   };
+
+   struct Results
+   {
+      Vector< U32 > boxCounts;
+      Vector< F32 > rayT;
+   };
+
+   struct QueryWorkItem : public ThreadPool::WorkItem
+   {
+      SceneContainer::QueryContext mContext;
+      ThreadPool::WorkItemGroup* mGroup;
+      const Queries* mQueries;
+      Results mResults;
+
+      QueryWorkItem( const SceneContainer* container, ThreadPool::WorkItemGroup* group, const Queries* queries )
+         : mContext( container ), mGroup( group ), mQueries( queries ) {}
+
+      virtual void execute()
+      {
+         Vector< SceneObject* > found;
+         for( U32 i = 0; i < NumQueries; ++ i )
+         {
+            found.clear();
+            mContext.findObjectList( mQueries->boxes[ i ], StaticObjectType, &found );
+            mResults.boxCounts.push_back( found.size() );
+
+            RayInfo info;
+            if( mContext.castRay( mQueries->starts[ i ], mQueries->ends[ i ], StaticObjectType, &info ) )
+               mResults.rayT.push_back( info.t );
+            else
+               mResults.rayT.push_back( 2.0f );
+         }
+
+         mGroup->done();
+      }
+   };
+
+   bool runIndex( SceneContainer& container, const Queries& queries )
+   {
+      Results expected;
+      Vector< SceneObject* > found;
+      for( U32 i = 0; i < NumQueries; ++ i )
+      {
+         found.clear();
+         container.findObjectList( queries.boxes[ i ], StaticObjectType, &found );
+         expected.boxCounts.push_back( found.size() );
+
+         RayInfo info;
+         if( container.castRay( queries.starts[ i ], queries.ends[ i ], StaticObjectType, &info ) )
+            expected.rayT.push_back( info.t );
+         else
+            expected.rayT.push_back( 2.0f );
+      }
+
+      container.freeze();
+
+      ThreadPool::WorkItemGroup group;
+      Vector< ThreadSafeRef< QueryWorkItem > > items;
+      ThreadPool* pool = &ThreadPool::GLOBAL();
+      for( U32 i = 0; i < NumItems; ++ i )
+      {
+         ThreadSafeRef< QueryWorkItem > item( new QueryWorkItem( &container, &group, &queries ) );
+         items.push_back( item );
+         group.add();
+         pool->queueWorkItem( item );
+      }
+      group.wait();
+
+      container.unfreeze();
+
+      bool same = true;
+      for( U32 i = 0; i < items.size(); ++ i )
+      {
+         const Results& results = items[ i ]->mResults;
+         if( results.boxCounts.size() != NumQueries || results.rayT.size() != NumQueries )
+         {
+            same = false;
+            continue;
+         }
+
+         for( U32 j = 0; j < NumQueries; ++ j )
+         {
+            if( results.boxCounts[ j ] != expected.boxCounts[ j ] )
+               same = false;
+            if( mFabs( results.rayT[ j ] - expected.rayT[ j ] ) > 0.0001f )
+               same = false;
+         }
+      }
+
+      return same;
+   }
+
+   void run()
+   {
+      const F32 worldSize = 2048.0f;
+
+      SceneContainer container;
+      Vector< ContainerTestObject* > objects;
+      populate( container, objects, 5000, worldSize, 8642 );
+
+      MRandomLCG random( 9753 );
+      Queries queries;
+      for( U32 i = 0; i < NumQueries; ++ i )
+      {
+         const Point3F center = randomPoint( random, worldSize );
+         const Point3F extents = randomExtents( random ) * 4.0f;
+         queries.boxes.push_back( Box3F( center - extents, center + extents ) );
+
+         const Point3F start = randomPoint( random, worldSize );
+         queries.starts.push_back( start );
+         queries.ends.push_back( start + Point3F( random.randF( -200.0f, 200.0f ), random.randF( -200.0f, 200.0f ), 0.0f ) );
+      }
+
+      test( runIndex( container, queries ), "Query contexts on the tree differ from container queries" );
+
+      container.setSpatialIndex( SceneContainer::SpatialIndexBinGrid );
+      test( runIndex( container, queries ), "Query contexts on the bin grid differ from container queries" );
+
+      // Radius results come back nearest first.
+      container.freeze();
+      SceneContainer::QueryContext context( &container );
+      Vector< SceneObject* > found;
+      context.findObjectsInRadius( Point3F( 0, 0, 50 ), 100.0f, StaticObjectType, &found );
+      container.unfreeze();
+
+      bool sorted = true;
+      for( U32 i = 1; i < found.size(); ++ i )
+      {
+         Point3F a, b;
+         found[ i - 1 ]->getWorldBox().getCenter( &a );
+         found[ i ]->getWorldBox().getCenter( &b );
+         if( ( a - Point3F( 0, 0, 50 ) ).len() > ( b - Point3F( 0, 0, 50 ) ).len() )
+            sorted = false;
+      }
+      test( found.size() > 0 && sorted, "Radius search not sorted nearest first" );
+
+      clear( container, objects );
+   }
+};
+
+#endif // TORQUE_SHIPPING
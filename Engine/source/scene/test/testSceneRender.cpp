@@ -0,0 +1,208 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "console/console.h"
+#include "scene/sceneManager.h"
+#include "scene/sceneObject.h"
+#include "scene/sceneRenderState.h"
+#include "renderInstance/renderPassManager.h"
+#include "renderInstance/renderBinManager.h"
+#include "math/mRandom.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+namespace {
+
+   /// Object that submits a single ObjectRenderInst after doing some
+   /// busywork in place of what a real object would compute.
+   class RenderTestObject : public SceneObject
+   {
+      public:
+
+         U32 mIndex;
+         bool mThreadSafe;
+         U32 mWork;
+
+         RenderTestObject( U32 index, bool threadSafe, U32 work, const Point3F& position )
+            : mIndex( index ), mThreadSafe( threadSafe ), mWork( work )
+         {
+            mTypeMask = StaticObjectType;
+            mObjBox.set( Point3F( -1.0f, -1.0f, -1.0f ), Point3F( 1.0f, 1.0f, 1.0f ) );
+
+            MatrixF mat( true );
+            mat.setPosition( position );
+            setTransform( mat );
+         }
+
+         virtual bool isPrepRenderImageThreadSafe() const { return mThreadSafe; }
+
+         virtual void prepRenderImage( SceneRenderState* state )
+         {
+            MatrixF xfm = getRenderTransform();
+            for( U32 i = 0; i < mWork; ++ i )
+            {
+               MatrixF rot( EulerF( 0.0f, 0.0f, 0.001f ) );
+               xfm.mul( rot );
+            }
+
+            ObjectRenderInst* ri = state->getRenderPass()->allocInst< ObjectRenderInst >();
+            ri->type = RenderPassManager::RIT_Object;
+            ri->objectIndex = mIndex;
+            ri->userData = state->getRenderPass()->allocUniqueXform( xfm );
+            ri->defaultKey = mIndex;
+            state->getRenderPass()->addInst( ri );
+         }
+   };
+
+   /// Bin that exposes the elements it has been given.
+   class RecordingBin : public RenderBinManager
+   {
+      public:
+
+         typedef MainSortElem Element;
+
+         RecordingBin()
+            : RenderBinManager( RenderPassManager::RIT_Object, 1.0f, 1.0f ) {}
+
+         const Vector< Element >& getElements() const { return mElementList; }
+   };
+}
+
+CreateUnitTest( TestSceneParallelRender, "Scene/ParallelRender" )
+{
+   enum
+   {
+      NumObjects = 4000,
+      NumFrames = 20,
+      Work = 200,
+   };
+
+   Vector< RenderTestObject* > mObjects;
+
+   /// Prepare the objects and return the object indices and transforms
+   /// in the order the bin received them.
+   void prep( SceneRenderState& state, RecordingBin* bin, bool parallel, Vector< U32 >& indices, Vector< MatrixF >& xfms )
+   {
+      if( parallel )
+         state.prepRenderImagesParallel( ( SceneObject** ) mObjects.address(), mObjects.size() );
+      else
+         state.prepRenderImages( ( SceneObject** ) mObjects.address(), mObjects.size() );
+
+      indices.clear();
+      xfms.clear();
+      const Vector< RecordingBin::Element >& elements = bin->getElements();
+      for( U32 i = 0; i < elements.size(); ++ i )
+      {
+         ObjectRenderInst* ri = static_cast< ObjectRenderInst* >( elements[ i ].inst );
+         indices.push_back( ri->objectIndex );
+         xfms.push_back( *( MatrixF* ) ri->userData );
+      }
+
+      state.getRenderPass()->clear();
+   }
+
+   void run()
+   {
+      if( !gClientSceneGraph )
+         return;
+
+      const bool oldDisableZoneCulling = SceneCullingState::smDisableZoneCulling;
+      SceneCullingState::smDisableZoneCulling = true;
+
+      // Objects in runs of thread-safe and serial ones.
+
+      MRandomLCG random( 1 );
+      for( U32 i = 0; i < NumObjects; ++ i )
+      {
+         const bool threadSafe = ( i / 150 ) % 4 != 0;
+         const Point3F position( random.randF( -500.0f, 500.0f ), random.randF( -500.0f, 500.0f ), random.randF( -500.0f, 500.0f ) );
+         mObjects.push_back( new RenderTestObject( i, threadSafe, Work, position ) );
+      }
+
+      RenderPassManager pass;
+      RecordingBin* bin = new RecordingBin;
+      pass.addManager( bin );
+
+      const Frustum frustum( false, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f, 1000.0f );
+      const SceneCameraState camera( RectI( 0, 0, 800, 600 ), frustum, MatrixF( true ), MatrixF( true ) );
+      SceneRenderState state( gClientSceneGraph, SPT_Diffuse, camera, &pass );
+
+      // Culling in parallel must leave the same objects in the same order.
+
+      Vector< SceneObject* > culled;
+      Vector< SceneObject* > culledParallel;
+      culled.set( mObjects.address(), mObjects.size() );
+      culledParallel.set( mObjects.address(), mObjects.size() );
+      culled.setSize( state.getCullingState().cullObjects( culled.address(), culled.size() ) );
+      culledParallel.setSize( state.getCullingState().cullObjectsParallel( culledParallel.address(), culledParallel.size() ) );
+
+      test( culled.size() > 0 && culled.size() < NumObjects, "All or none of the objects got culled!" );
+      test( culled.size() == culledParallel.size(), "Parallel culling kept a different number of objects!" );
+      bool sameCulled = culled.size() == culledParallel.size();
+      for( U32 i = 0; sameCulled && i < culled.size(); ++ i )
+         sameCulled = culled[ i ] == culledParallel[ i ];
+      test( sameCulled, "Parallel culling kept different objects!" );
+
+      // The bin must see the instances in the same order either way.
+
+      Vector< U32 > indices, indicesParallel;
+      Vector< MatrixF > xfms, xfmsParallel;
+      prep( state, bin, false, indices, xfms );
+      prep( state, bin, true, indicesParallel, xfmsParallel );
+
+      test( indices.size() == NumObjects, "Not all objects got batched!" );
+      test( indicesParallel.size() == indices.size(), "Parallel batching lost instances!" );
+      bool sameOrder = indicesParallel.size() == indices.size();
+      for( U32 i = 0; sameOrder && i < indices.size(); ++ i )
+         sameOrder = indices[ i ] == indicesParallel[ i ] && dMemcmp( &xfms[ i ], &xfmsParallel[ i ], sizeof( MatrixF ) ) == 0;
+      test( sameOrder, "Parallel batching changed the instances or their order!" );
+      test( !pass.isDeferring(), "The render pass is still deferring!" );
+
+      // Time both.  No GFX work is involved so this works the same with
+      // the null device.
+
+      U32 start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < NumFrames; ++ i )
+         prep( state, bin, false, indices, xfms );
+      const U32 serialTime = Platform::getRealMilliseconds() - start;
+
+      start = Platform::getRealMilliseconds();
+      for( U32 i = 0; i < NumFrames; ++ i )
+         prep( state, bin, true, indices, xfms );
+      const U32 parallelTime = Platform::getRealMilliseconds() - start;
+
+      Con::printf( "   batching %d objects x %d: serial %dms, parallel %dms", (S32)NumObjects, (S32)NumFrames, serialTime, parallelTime );
+
+      for( U32 i = 0; i < mObjects.size(); ++ i )
+         delete mObjects[ i ];
+      mObjects.clear();
+
+      SceneCullingState::smDisableZoneCulling = oldDisableZoneCulling;
+   }
+};
+
+#endif // TORQUE_SHIPPING
@@ -0,0 +1,226 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "console/console.h"
+#include "scene/sceneContainer.h"
+#include "scene/sceneObject.h"
+#include "scene/sceneScopingGrid.h"
+#include "math/mRandom.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+namespace {
+
+   /// Box shaped object that is never registered with the Sim.
+   class ScopingTestObject : public SceneObject
+   {
+      public:
+
+         ScopingTestObject( const Point3F& position, const Point3F& halfExtents, bool ghostable )
+         {
+            mTypeMask = StaticObjectType;
+            if( ghostable )
+               mNetFlags.set( Ghostable );
+
+            mObjBox.set( -halfExtents, halfExtents );
+            setPosition( position );
+         }
+
+         void setPosition( const Point3F& position )
+         {
+            MatrixF mat( true );
+            mat.setPosition( position );
+            setTransform( mat );
+         }
+   };
+
+   struct ScopeQuery
+   {
+      Point3F point;
+      F32 distance;
+      F32 distanceSquared;
+      Vector< SceneObject* >* found;
+   };
+
+   /// What SceneManager::scopeScene() does without the grid.
+   void referenceScopeCallback( SceneObject* object, void* key )
+   {
+      if( !object->isScopeable() )
+         return;
+
+      ScopeQuery* query = reinterpret_cast< ScopeQuery* >( key );
+      F32 difSq = ( object->getWorldSphere().center - query->point ).lenSquared();
+      if( difSq < query->distanceSquared || mSqrt( difSq ) - object->getWorldSphere().radius < query->distance )
+         query->found->push_back( object );
+   }
+
+   void gridScopeCallback( SceneObject* object, void* key )
+   {
+      reinterpret_cast< Vector< SceneObject* >* >( key )->push_back( object );
+   }
+
+   S32 QSORT_CALLBACK comparePointers( const void* a, const void* b )
+   {
+      const dsize_t pa = dsize_t( *( SceneObject* const* ) a );
+      const dsize_t pb = dsize_t( *( SceneObject* const* ) b );
+      return pa < pb ? -1 : ( pa > pb ? 1 : 0 );
+   }
+
+   void scopeReference( SceneContainer& container, const Point3F& point, F32 distance, Vector< SceneObject* >& outFound )
+   {
+      ScopeQuery query;
+      query.point = point;
+      query.distance = distance;
+      query.distanceSquared = distance * distance;
+      query.found = &outFound;
+
+      Box3F area( distance );
+      area.setCenter( point );
+
+      outFound.clear();
+      container.findObjects( area, 0xFFFFFFFF, referenceScopeCallback, &query );
+      dQsort( outFound.address(), outFound.size(), sizeof( SceneObject* ), comparePointers );
+   }
+
+   void scopeGrid( SceneScopingGrid& grid, SceneContainer& container, const Point3F& point, F32 distance, Vector< SceneObject* >& outFound )
+   {
+      outFound.clear();
+      grid.scope( &container, point, distance, gridScopeCallback, &outFound );
+      dQsort( outFound.address(), outFound.size(), sizeof( SceneObject* ), comparePointers );
+   }
+}
+
+CreateUnitTest( TestSceneScopingGrid, "Scene/ScopingGrid" )
+{
+   enum
+   {
+      NumObjects = 5000,
+      NumCameras = 64,
+   };
+
+   Vector< ScopingTestObject* > mObjects;
+   Vector< Point3F > mCameras;
+
+   bool compare( SceneScopingGrid& grid, SceneContainer& container, F32 distance )
+   {
+      bool same = true;
+      Vector< SceneObject* > expected;
+      Vector< SceneObject* > found;
+
+      for( U32 i = 0; i < mCameras.size(); ++ i )
+      {
+         scopeReference( container, mCameras[ i ], distance, expected );
+         scopeGrid( grid, container, mCameras[ i ], distance, found );
+
+         if( expected.size() != found.size() )
+            same = false;
+         else if( found.size() && dMemcmp( expected.address(), found.address(), found.size() * sizeof( SceneObject* ) ) != 0 )
+            same = false;
+      }
+
+      return same;
+   }
+
+   void run()
+   {
+      const F32 worldSize = 4096.0f;
+      const F32 halfSize = worldSize * 0.5f;
+
+      SceneContainer container;
+      MRandomLCG random( 1 );
+
+      // Mostly small objects plus a few that are larger than a cell.
+
+      for( U32 i = 0; i < NumObjects; ++ i )
+      {
+         const Point3F position( random.randF( -halfSize, halfSize ), random.randF( -halfSize, halfSize ), random.randF( 0.0f, 100.0f ) );
+         const F32 size = ( i % 100 == 0 ) ? random.randF( 100.0f, 400.0f ) : random.randF( 0.5f, 10.0f );
+
+         ScopingTestObject* object = new ScopingTestObject( position, Point3F( size, size, size ), i % 10 != 0 );
+         container.addObject( object );
+         mObjects.push_back( object );
+      }
+
+      // Cameras in groups, as with players fighting over the same spot, and
+      // some outside the area covered by the objects.
+
+      for( U32 i = 0; i < NumCameras; ++ i )
+      {
+         Point3F center( F32( ( i / 8 ) * 400 ) - halfSize, F32( ( i / 8 ) * 300 ) - halfSize * 0.5f, 50.0f );
+         if( i % 16 == 15 )
+            center.x = -worldSize;
+         mCameras.push_back( center + Point3F( random.randF( -10.0f, 10.0f ), random.randF( -10.0f, 10.0f ), random.randF( -10.0f, 10.0f ) ) );
+      }
+
+      SceneScopingGrid grid;
+
+      test( compare( grid, container, 500.0f ), "Grid scoping differs from the container query!" );
+      test( compare( grid, container, 1500.0f ), "Grid scoping differs from the container query with a larger distance!" );
+      test( grid.getNumBuilds() == 1, "Grid got rebuilt without the container changing!" );
+      test( grid.getNumSharedQueries() > 0, "No queries shared their candidates!" );
+
+      // Moving objects has to trigger a rebuild.
+
+      for( U32 i = 0; i < mObjects.size(); i += 7 )
+      {
+         mObjects[ i ]->setPosition( mObjects[ i ]->getPosition() + Point3F( random.randF( -200.0f, 200.0f ), random.randF( -200.0f, 200.0f ), 0.0f ) );
+         container.checkBins( mObjects[ i ] );
+      }
+
+      test( compare( grid, container, 500.0f ), "Grid scoping differs after objects moved!" );
+      test( grid.getNumBuilds() == 2, "Grid did not get rebuilt after objects moved!" );
+
+      // Time a tick's worth of scoping for all cameras.
+
+      Vector< SceneObject* > found;
+      U32 start = Platform::getRealMilliseconds();
+      for( U32 n = 0; n < 10; ++ n )
+         for( U32 i = 0; i < mCameras.size(); ++ i )
+            scopeReference( container, mCameras[ i ], 1000.0f, found );
+      const U32 referenceTime = Platform::getRealMilliseconds() - start;
+
+      start = Platform::getRealMilliseconds();
+      for( U32 n = 0; n < 10; ++ n )
+      {
+         container.checkBins( mObjects[ n ] );
+         for( U32 i = 0; i < mCameras.size(); ++ i )
+            scopeGrid( grid, container, mCameras[ i ], 1000.0f, found );
+      }
+      const U32 gridTime = Platform::getRealMilliseconds() - start;
+
+      Con::printf( "   scoping %d objects for %d cameras x 10 ticks: container %dms, grid %dms", (S32)NumObjects, (S32)NumCameras, referenceTime, gridTime );
+
+      for( U32 i = 0; i < mObjects.size(); ++ i )
+      {
+         container.removeObject( mObjects[ i ] );
+         delete mObjects[ i ];
+      }
+      mObjects.clear();
+   }
+};
+
+#endif // TORQUE_SHIPPING
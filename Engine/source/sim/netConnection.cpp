@@ -32,6 +32,8 @@
 #include "console/consoleTypes.h"
 #include "sim/netInterface.h"
 #include "console/engineAPI.h"
+#include "platform/threads/threadPool.h"
+#include "platform/profiler.h"
 #include <stdarg.h>
 
 
@@ -73,19 +75,19 @@ public:
    {
       bstream->write(sequence);
       bstream->writeInt(message, 3);
-      bstream->writeInt(ghostCount, NetConnection::GhostIdBitSize + 1);
+      bstream->writeInt(ghostCount, NetConnection::MaxGhostIdBitSize + 1);
    }
    void write(NetConnection *, BitStream *bstream)
    {
       bstream->write(sequence);
       bstream->writeInt(message, 3);
-      bstream->writeInt(ghostCount, NetConnection::GhostIdBitSize + 1);
+      bstream->writeInt(ghostCount, NetConnection::MaxGhostIdBitSize + 1);
    }
    void unpack(NetConnection *, BitStream *bstream)
    {
       bstream->read(&sequence);
       message = bstream->readInt(3);
-      ghostCount = bstream->readInt(NetConnection::GhostIdBitSize + 1);
+      ghostCount = bstream->readInt(NetConnection::MaxGhostIdBitSize + 1);
    }
    void process(NetConnection *ps)
    {
@@ -216,6 +218,8 @@ static U32 gPacketRateToServer = 32;
 static U32 gPacketUpdateDelayToServer = 32;
 static U32 gPacketRateToClient = 10;
 static U32 gPacketSize = 200;
+static U32 gMaxGhostCount = 1 << NetConnection::DefaultGhostIdBitSize;
+static bool gGhostSnapshots = false;
 
 void NetConnection::consoleInit()
 {
@@ -278,6 +282,48 @@ void NetConnection::consoleInit()
 
       "@ingroup Networking");
 
+   Con::addVariable("$pref::Net::MaxGhostCount", TypeS32, &gMaxGhostCount,
+      "@brief Sets the maximum number of objects a server may ghost to each client.\n\n"
+
+      "Ghost IDs are sent with just enough bits to address this many ghosts, so it is "
+      "rounded up to a power of two between 4096 and 65536.  Raising it costs a few bits for "
+      "every ghost ID sent, but no memory until the ghosts are actually used.  The server "
+      "tells the client the value it uses when accepting the connection.  It can also be "
+      "changed for a single connection with NetConnection::setMaxGhostCount() from "
+      "onConnectRequest().  The default value is 4096.\n\n"
+
+      "@ingroup Networking");
+
+   Con::addVariable("$pref::Net::GhostSnapshots", TypeBool, &gGhostSnapshots,
+      "@brief If true, a server delta compresses the ghost updates it sends.\n\n"
+
+      "Both sides keep the last few updates of every ghost.  Each update is sent either as is or "
+      "as its difference to the newest earlier update the client has acknowledged, whichever is "
+      "smaller.  This mostly saves bandwidth on objects that send the same fields every tick, like "
+      "players and vehicles, at the cost of some memory per ghost.  The server tells the client "
+      "whether it is used when accepting the connection.  The default value is false.\n\n"
+
+      "@ingroup Networking");
+
+   Con::addVariable("$pref::Net::ParallelPacketWrite", TypeBool, &NetConnection::smParallelPacketWrite,
+      "@brief If true, a server writes the packets of its clients in parallel.\n\n"
+
+      "Scoping and everything else that touches state shared by the clients is still done on "
+      "the main thread.  Only the ghost updates of objects whose packUpdate() is thread safe are "
+      "written on the thread pool.  The packets are the same either way.  Mostly of use on "
+      "dedicated servers with many clients.  The default value is false.\n\n"
+
+      "@ingroup Networking");
+
+   Con::addVariable("$pref::Net::BatchedIO", TypeBool, &Net::smBatchedIO,
+      "@brief If true, UDP packets are received and sent in batches where the platform supports it.\n\n"
+
+      "On Linux this uses recvmmsg() and sendmmsg() to move many packets with a single system "
+      "call, which mostly matters to servers with many clients.  Elsewhere it has no effect.  "
+      "The default value is true.\n\n"
+
+      "@ingroup Networking");
+
    Con::addVariable("$Stats::netBitsSent", TypeS32, &gNetBitsSent,
       "@brief The number of bytes sent during the last packet send operation.\n\n"
 
@@ -411,9 +457,17 @@ NetConnection::NetConnection()
    mGhosting = false;
    mScoping = false;
    mGhostArray = NULL;
-   mGhostRefs = NULL;
+   mGhostRefCount = 0;
    mGhostLookupTable = NULL;
+   mGhostLookupTableSize = 0;
    mLocalGhosts = NULL;
+   mLocalGhostCount = 0;
+   mGhostIdBitSize = DefaultGhostIdBitSize;
+   setMaxGhostCount(gMaxGhostCount);
+   mGhostSnapshots = gGhostSnapshots;
+   mLocalGhostSnapshots = NULL;
+   mGhostWriteState.pending = false;
+   mDeferGhostUpdates = false;
 
    mGhostsActive = 0;
 
@@ -444,9 +498,13 @@ NetConnection::~NetConnection()
    if(mCurrentDownloadingFile)
       delete mCurrentDownloadingFile;
 
+   for(U32 i = 0; i < mLocalGhostCount; i++)
+      clearLocalGhostSnapshots(i);
+   delete[] mLocalGhostSnapshots;
    delete[] mLocalGhosts;
    delete[] mGhostLookupTable;
-   delete[] mGhostRefs;
+   for(S32 i = 0; i < mGhostRefBlocks.size(); i++)
+      delete[] mGhostRefBlocks[i];
    delete[] mGhostArray;
    delete mStringTable;
    if(mDemoWriteStream)
@@ -788,6 +846,23 @@ public:
 };
 
 void NetConnection::checkPacketSend(bool force)
+{
+   BitStream *stream = BitStream::getPacketStream(mCurRate.packetSize);
+   if(beginPacketSend(force, stream))
+      endPacketSend(stream);
+}
+
+bool NetConnection::isPacketSendDue(bool force)
+{
+   if(force)
+      return true;
+
+   U32 curTime = Platform::getVirtualMilliseconds();
+   U32 delay = isConnectionToServer() ? gPacketUpdateDelayToServer : mCurRate.updateDelay;
+   return curTime >= mLastUpdateTime + delay - mSendDelayCredit;
+}
+
+bool NetConnection::beginPacketSend(bool force, BitStream *stream)
 {
    U32 curTime = Platform::getVirtualMilliseconds();
    U32 delay = isConnectionToServer() ? gPacketUpdateDelayToServer : mCurRate.updateDelay;
@@ -795,7 +870,7 @@ void NetConnection::checkPacketSend(bool force)
    if(!force)
    {
       if(curTime < mLastUpdateTime + delay - mSendDelayCredit)
-         return;
+         return false;
 
       mSendDelayCredit = curTime - (mLastUpdateTime + delay - mSendDelayCredit);
       if(mSendDelayCredit > 1000)
@@ -805,9 +880,8 @@ void NetConnection::checkPacketSend(bool force)
          recordBlock(BlockTypeSendPacket, 0, 0);
    }
    if(windowFull())
-      return;
+      return false;
 
-   BitStream *stream = BitStream::getPacketStream(mCurRate.packetSize);
    buildSendPacketHeader(stream);
 
    mLastUpdateTime = curTime;
@@ -843,6 +917,11 @@ void NetConnection::checkPacketSend(bool force)
    DEBUG_LOG(("PKLOG %d START", getId()) );
    writePacket(stream, note);
    DEBUG_LOG(("PKLOG %d END - %d", getId(), stream->getCurPos() - start) );
+   return true;
+}
+
+void NetConnection::endPacketSend(BitStream *stream)
+{
    if(mSimulatedPacketLoss && Platform::getRandom() < mSimulatedPacketLoss)
    {
       //Con::printf("NET  %d: SENDDROP - %d", getId(), mLastSendSeq);
@@ -856,6 +935,119 @@ void NetConnection::checkPacketSend(bool force)
    sendPacket(stream);
 }
 
+//--------------------------------------------------------------------
+
+/// Writes the deferred ghost updates of a connection on the thread pool.
+class PacketWriteWorkItem : public ThreadPool::WorkItem
+{
+public:
+   typedef ThreadPool::WorkItem Parent;
+
+   NetConnection *mConnection;
+   ThreadPool::WorkItemGroup *mGroup;
+
+   PacketWriteWorkItem(NetConnection *connection, ThreadPool::WorkItemGroup *group)
+      : mConnection(connection), mGroup(group) {}
+
+   virtual void execute();
+};
+
+void PacketWriteWorkItem::execute()
+{
+   mConnection->ghostWriteUpdates(true);
+   mGroup->done();
+}
+
+void NetConnection::ghostWriteUpdatesParallel(NetConnection **connections, U32 count)
+{
+   // The class reps' net stats are shared by all connections, so with
+   // those the updates stay serial.
+
+#ifndef TORQUE_NET_STATS
+   ThreadPool *pool = &ThreadPool::GLOBAL();
+   ThreadPool::WorkItemGroup group;
+   Vector< ThreadSafeRef<PacketWriteWorkItem> > items;
+   for(U32 i = 0; i < count; i++)
+   {
+      if(!connections[i]->mGhostWriteState.pending)
+         continue;
+
+      ThreadSafeRef<PacketWriteWorkItem> item(new PacketWriteWorkItem(connections[i], &group));
+      items.push_back(item);
+      group.add();
+      pool->queueWorkItem(item);
+   }
+   group.wait();
+#endif
+
+   // Finish the updates that weren't thread safe.
+   for(U32 i = 0; i < count; i++)
+   {
+      if(connections[i]->mGhostWriteState.pending)
+         connections[i]->ghostWriteUpdates(false);
+   }
+}
+
+/// A packet being written by checkPacketSendParallel().
+struct ParallelPacket
+{
+   NetConnection *connection;
+   U8 buffer[Net::MaxPacketDataSize];
+   BitStream stream;
+
+   ParallelPacket(NetConnection *conn, U32 writeSize)
+      : connection(conn), stream(NULL, 0)
+   {
+      if(!writeSize)
+         writeSize = Net::MaxPacketDataSize;
+      stream.setBuffer(buffer, writeSize, Net::MaxPacketDataSize);
+   }
+};
+
+bool NetConnection::smParallelPacketWrite = false;
+
+void NetConnection::checkPacketSendParallel(NetConnection **connections, U32 count)
+{
+   PROFILE_SCOPE(NetConnection_checkPacketSendParallel);
+
+   // Don't leave building the string compression tables to the workers.
+   BitStream::initStringCompression();
+
+   // Write everything up to the ghost updates on this thread.
+
+   Vector<ParallelPacket *> packets;
+   Vector<NetConnection *> sending;
+   for(U32 i = 0; i < count; i++)
+   {
+      NetConnection *conn = connections[i];
+      if(!conn->isPacketSendDue(false))
+         continue;
+
+      ParallelPacket *packet = new ParallelPacket(conn, conn->mCurRate.packetSize);
+
+      conn->mDeferGhostUpdates = true;
+      bool send = conn->beginPacketSend(false, &packet->stream);
+      conn->mDeferGhostUpdates = false;
+
+      if(!send)
+      {
+         delete packet;
+         continue;
+      }
+      packets.push_back(packet);
+      sending.push_back(conn);
+   }
+
+   ghostWriteUpdatesParallel(sending.address(), sending.size());
+
+   // Send the packets in connection order.
+   for(U32 i = 0; i < packets.size(); i++)
+   {
+      packets[i]->connection->endPacketSend(&packets[i]->stream);
+      delete packets[i];
+   }
+}
+
 Net::Error NetConnection::sendPacket(BitStream *stream)
 {
    //Con::printf("NET  %d: SEND - %d", getId(), mLastSendSeq);
@@ -978,6 +1170,7 @@ bool NetConnection::startDemoRecord(const char *fileName)
 
    mDemoWriteStream = fs;
    mDemoWriteStream->write(mProtocolVersion);
+   mDemoWriteStream->write(U32(DemoVersion));
    ResizeBitStream bs;
 
    // then write out the start block
@@ -996,6 +1189,13 @@ bool NetConnection::replayDemoRecord(const char *fileName)
 
    mDemoReadStream = fs;
    mDemoReadStream->read(&mProtocolVersion);
+   U32 demoVersion;
+   mDemoReadStream->read(&demoVersion);
+   if(demoVersion != DemoVersion)
+   {
+      Con::errorf("NetConnection::replayDemoRecord - %s has demo version %d, expected %d", fileName, demoVersion, DemoVersion);
+      return false;
+   }
    U32 size;
    mDemoReadStream->read(&size);
    U8 *block = new U8[size];
@@ -1310,13 +1510,21 @@ bool NetConnection::readConnectRequest(BitStream *stream, const char **errorStri
 
 void NetConnection::writeConnectAccept(BitStream *stream)
 {
-   TORQUE_UNUSED(stream);
+   // Tell the client how wide the ghost IDs are and how updates are sent.
+   stream->writeInt(mGhostIdBitSize - DefaultGhostIdBitSize, GhostIdBitSizeBitSize);
+   stream->writeFlag(mGhostSnapshots);
 }
 
 bool NetConnection::readConnectAccept(BitStream *stream, const char **errorString)
 {
-   TORQUE_UNUSED(stream);
-   TORQUE_UNUSED(errorString);
+   U32 ghostIdBitSize = stream->readInt(GhostIdBitSizeBitSize) + DefaultGhostIdBitSize;
+   if(ghostIdBitSize > MaxGhostIdBitSize)
+   {
+      *errorString = "CHR_INVALID";
+      return false;
+   }
+   mGhostIdBitSize = ghostIdBitSize;
+   mGhostSnapshots = stream->readFlag();
    return true;
 }
 
@@ -1337,7 +1545,7 @@ DefineEngineMethod( NetConnection, resolveGhostID, S32, (S32 ghostID),,
    "@see @ref ghosting_scoping for a description of the ghosting system.\n\n")
 {
    // Safety check
-   if(ghostID < 0 || ghostID > NetConnection::MaxGhostCount) return 0;
+   if(ghostID < 0 || ghostID >= S32(object->getMaxGhostCount())) return 0;
 
    NetObject *foo = object->resolveGhost(ghostID);
 
@@ -1364,7 +1572,7 @@ DefineEngineMethod( NetConnection, resolveObjectFromGhostIndex, S32, (S32 ghostI
    "@see @ref ghosting_scoping for a description of the ghosting system.\n\n")
 {
    // Safety check
-   if(ghostID < 0 || ghostID > NetConnection::MaxGhostCount) return 0;
+   if(ghostID < 0 || ghostID >= S32(object->getMaxGhostCount())) return 0;
 
    NetObject *foo = object->resolveObjectFromGhostIndex(ghostID);
 
@@ -1398,6 +1606,61 @@ DefineEngineMethod( NetConnection, getGhostID, S32, (S32 realID),,
    }
 }
 
+DefineEngineMethod( NetConnection, setMaxGhostCount, void, (S32 count),,
+   "@brief On the server, set the maximum number of objects that may be ghosted to this client.\n\n"
+
+   "The count is rounded up to a power of two between 4096 and 65536.  This must be called before "
+   "the connection is accepted, which makes onConnectRequest() the place to do it.\n"
+
+   "@param count The maximum number of ghosts.\n"
+
+   "@see $pref::Net::MaxGhostCount\n"
+   "@see @ref ghosting_scoping for a description of the ghosting system.\n\n")
+{
+   if(object->isEstablished())
+   {
+      Con::errorf("NetConnection::setMaxGhostCount - the connection is already established");
+      return;
+   }
+   object->setMaxGhostCount(getMax(count, 0));
+}
+
+DefineEngineMethod( NetConnection, getMaxGhostCount, S32, (),,
+   "@brief Returns the maximum number of objects that may be ghosted over this connection.\n\n"
+
+   "@see @ref ghosting_scoping for a description of the ghosting system.\n\n")
+{
+   return object->getMaxGhostCount();
+}
+
+DefineEngineMethod( NetConnection, setGhostSnapshots, void, (bool enable),,
+   "@brief On the server, turn delta compression of ghost updates to this client on or off.\n\n"
+
+   "This must be called before the connection is accepted, which makes onConnectRequest() the "
+   "place to do it.\n"
+
+   "@param enable True to delta compress the ghost updates.\n"
+
+   "@see $pref::Net::GhostSnapshots\n"
+   "@see @ref ghosting_scoping for a description of the ghosting system.\n\n")
+{
+   if(object->isEstablished())
+   {
+      Con::errorf("NetConnection::setGhostSnapshots - the connection is already established");
+      return;
+   }
+   object->setGhostSnapshots(enable);
+}
+
+DefineEngineMethod( NetConnection, usesGhostSnapshots, bool, (),,
+   "@brief Returns true if ghost updates are delta compressed on this connection.\n\n"
+
+   "@see $pref::Net::GhostSnapshots\n"
+   "@see @ref ghosting_scoping for a description of the ghosting system.\n\n")
+{
+   return object->usesGhostSnapshots();
+}
+
 DefineEngineMethod( NetConnection, connect, void, (const char* remoteAddress),,
    "@brief Connects to the remote address.\n\n"
 
@@ -48,6 +48,7 @@ class Stream;
 class Point3F;
 
 struct GhostInfo;
+struct GhostSnapshots;
 struct SubPacketRef; // defined in NetConnection subclass
 
 //#define DEBUG_NET
@@ -382,9 +383,11 @@ public:
 /// scoping information for the client; then objects which are in scope are then transmitted to the
 /// client, prioritized by the results of their getPriority() method.
 ///
-/// There is a cap on the maximum number of ghosts; ghost IDs are currently sent via a 12-bit field,
-/// ergo, there is a cap of 4096 objects ghosted per client. This can be easily raised; see the
-/// GhostConstants enum.
+/// There is a cap on the maximum number of ghosts per client.  Ghost IDs are sent in a field whose
+/// width is chosen per connection, between 12 bits (4096 ghosts, the default) and 16 bits (65536
+/// ghosts); see setMaxGhostCount() and the $pref::Net::MaxGhostCount preference.  The server sends
+/// the width to the client when accepting the connection.  The ghost tables themselves grow in
+/// blocks as ghosts are added, so a connection only pays for the ghosts it actually uses.
 ///
 /// Each object ghosted is assigned a ghost ID; the client is _only_ aware of the ghost ID. This acts
 /// to enhance game security, as it becomes difficult to map objects from one connection to another, or
@@ -424,6 +427,7 @@ public:
       GhostInfo *ghost;          ///< Reference to the GhostInfo we're from.
       GhostRef *nextRef;         ///< Next GhostRef in this packet.
       GhostRef *nextUpdateChain; ///< Next update we sent for this ghost.
+      S32 snapshot;              ///< Number of the ghost snapshot we sent, or -1.
    };
 
    enum Constants
@@ -609,6 +613,18 @@ public:
    void setNetAddress(const NetAddress *address);
    Net::Error sendPacket(BitStream *stream);
 
+protected:
+   /// Return true if the next packet is due to be sent.  beginPacketSend()
+   /// may still send nothing if the packet window is full.
+   bool isPacketSendDue(bool force);
+
+   /// Write the next packet into @a stream if it is due.  Returns false if
+   /// there is nothing to send.
+   bool beginPacketSend(bool force, BitStream *stream);
+
+   /// Send a packet written by beginPacketSend().
+   void endPacketSend(BitStream *stream);
+
 private:
    void netAddressTableInsert();
    void netAddressTableRemove();
@@ -621,6 +637,21 @@ public:
 
    void checkPacketSend(bool force);
 
+   /// Write the next packet of each of the given connections that is due,
+   /// with the ghost updates of all of them written in parallel.
+   ///
+   /// Everything that touches state shared by the connections, including
+   /// scoping, is done on the main thread first.  The ghost updates are then
+   /// written on the thread pool up to the first ghost whose packUpdate() isn't
+   /// thread safe, and the rest is written on the main thread.  The packets
+   /// are the same as those checkPacketSend() would write.
+   ///
+   /// @see NetObject::isPackUpdateThreadSafe
+   static void checkPacketSendParallel(NetConnection **connections, U32 count);
+
+   /// If true, servers write the packets of their connections in parallel.
+   static bool smParallelPacketWrite;
+
    bool missionPathsSent() const          { return mMissionPathsSent; }
    void setMissionPathsSent(const bool s) { mMissionPathsSent = s; }
 
@@ -784,9 +815,17 @@ protected:
    NetObject **mLocalGhosts;  ///< Local ghost for remote object.
                               ///
                               /// mLocalGhosts pointer is NULL if mGhostTo is false
+   U32 mLocalGhostCount;      ///< Number of entries allocated in mLocalGhosts.
+
+   Vector<GhostInfo *> mGhostRefBlocks;   ///< Allocated blocks of GhostBlockSize ghostInfos. Empty if ghostFrom is false.
+   U32 mGhostRefCount;                    ///< Number of ghostInfos allocated, and entries in mGhostArray.
+   GhostInfo **mGhostLookupTable;         ///< Table indexed by object id to GhostInfo. Null if ghostFrom is false.
+   U32 mGhostLookupTableSize;             ///< Number of buckets in mGhostLookupTable; a power of two.
 
-   GhostInfo *mGhostRefs;           ///< Allocated array of ghostInfos. Null if ghostFrom is false.
-   GhostInfo **mGhostLookupTable;   ///< Table indexed by object id to GhostInfo. Null if ghostFrom is false.
+   U32 mGhostIdBitSize;       ///< Number of bits ghost IDs are sent with on this connection.
+
+   bool mGhostSnapshots;      ///< Ghost updates are delta compressed against snapshots the client has acked.
+   GhostSnapshots **mLocalGhostSnapshots; ///< Snapshots received for each entry of mLocalGhosts.
 
    /// The object around which we are scoping this connection.
    ///
@@ -797,11 +836,66 @@ protected:
    void clearGhostInfo();
    bool validateGhostArray();
 
+   /// Allocate more ghostInfos, up to getMaxGhostCount().  Returns false if
+   /// all of them are allocated already.
+   bool growGhostRefs();
+
+   /// Make sure mLocalGhosts can hold the ghost with the given index.  Returns
+   /// false if the index is out of range for this connection.
+   bool reserveLocalGhost(U32 index);
+
+   /// Free the snapshots received for a local ghost.
+   void clearLocalGhostSnapshots(U32 index);
+
+   /// Return the ghostInfo with the given ghost index.
+   inline GhostInfo *getGhostRef(U32 index);
+
+   /// Return the mGhostLookupTable bucket of an object.
+   U32 getGhostLookupIndex(NetObject *object) { return object->getId() & (mGhostLookupTableSize - 1); }
+
    void ghostPacketDropped(PacketNotify *notify);
    void ghostPacketReceived(PacketNotify *notify);
 
    void ghostWritePacket(BitStream *bstream, PacketNotify *notify);
    void ghostReadPacket(BitStream *bstream);
+
+   /// Write ghost updates into the packet started by ghostWritePacket() until
+   /// it is full.  If @a threadSafeOnly is set, this stops at the first ghost
+   /// whose packUpdate() isn't thread safe and returns false.
+   bool ghostWriteUpdates(bool threadSafeOnly);
+
+   /// Finish the deferred ghost updates of the given connections.  The updates
+   /// are written on the thread pool up to the first ghost of each connection
+   /// whose packUpdate() isn't thread safe, and the rest on this thread.
+   static void ghostWriteUpdatesParallel(NetConnection **connections, U32 count);
+
+   /// Write the update of a ghost as a snapshot, which is delta compressed
+   /// against the newest snapshot of the ghost the client has acked when
+   /// that is smaller.  Returns the mask returned by packUpdate().
+   U32 ghostWriteSnapshot(GhostInfo *info, U32 updateMask, BitStream *bstream, GhostRef *ref);
+
+   /// Read and unpack a snapshot written by ghostWriteSnapshot().  Returns
+   /// false if the packet is invalid.
+   bool ghostReadSnapshot(U32 index, BitStream *bstream);
+
+   /// Where ghostWriteUpdates() is in the packet being written.
+   struct GhostWriteState
+   {
+      BitStream *stream;
+      PacketNotify *notify;
+      S32 index;                 ///< Index in mGhostArray of the next ghost to write.
+      S32 selectedStart;         ///< Start of the ghosts selected by priority.
+      S32 idSize;                ///< Number of bits ghost indices are written with.
+      Point3F compressionPoint;  ///< Compression point of the stream when the updates were deferred.
+      bool pending;              ///< The updates have been deferred and not written yet.
+   };
+   GhostWriteState mGhostWriteState;
+
+   /// If true, ghostWritePacket() leaves writing the updates to a later
+   /// ghostWriteUpdates() call.
+   bool mDeferGhostUpdates;
+
+   friend class PacketWriteWorkItem;
    void freeGhostInfo(GhostInfo *);
 
    void ghostWriteStartBlock(ResizeBitStream *stream);
@@ -818,14 +912,45 @@ public:
    /// Some configuration values.
    enum GhostConstants
    {
-      GhostIdBitSize = 12,
-      MaxGhostCount = 1 << GhostIdBitSize, //4096,
-      GhostLookupTableSize = 1 << GhostIdBitSize, //4096
-      GhostIndexBitSize = 4 // number of bits GhostIdBitSize-3 fits into
+      DefaultGhostIdBitSize = 12,
+      MaxGhostIdBitSize = 16,
+      GhostIdBitSizeBitSize = 3, // number of bits MaxGhostIdBitSize-DefaultGhostIdBitSize fits into
+      GhostIndexBitSize = 4, // number of bits MaxGhostIdBitSize-3 fits into
+      GhostBlockBitSize = 8,
+      GhostBlockSize = 1 << GhostBlockBitSize, // ghost tables grow by this many entries
+      GhostSnapshotSlotBitSize = 3,
+      GhostSnapshotSlotCount = 1 << GhostSnapshotSlotBitSize, // snapshots kept per ghost for delta compression
+      GhostSnapshotSizeBitSize = 14, // number of bits the bit count of a MaxPacketDataSize snapshot fits into
    };
 
    U32 getGhostsActive() { return mGhostsActive;};
 
+   /// Number of bits ghost IDs are written with on this connection.
+   U32 getGhostIdBitSize() const { return mGhostIdBitSize; }
+
+   /// Maximum number of ghosts on this connection.
+   U32 getMaxGhostCount() const { return 1 << mGhostIdBitSize; }
+
+   /// Set the maximum number of ghosts on this connection.  The count is
+   /// rounded up to a power of two between 4096 and 65536.  On the server
+   /// this must be done before the connection is accepted, for instance
+   /// from onConnectRequest(); the client gets it from the server.
+   void setMaxGhostCount(U32 count);
+
+   /// Are ghost updates delta compressed on this connection?
+   bool usesGhostSnapshots() const { return mGhostSnapshots; }
+
+   /// Turn delta compression of ghost updates on or off.  Like
+   /// setMaxGhostCount(), the server must do this before the connection
+   /// is accepted and the client gets it from the server.
+   void setGhostSnapshots(bool enable) { mGhostSnapshots = enable; }
+
+   /// Write a ghost ID with the width used on this connection.
+   void writeGhostId(BitStream *stream, U32 id);
+
+   /// Read a ghost ID written by writeGhostId().
+   U32 readGhostId(BitStream *stream);
+
    /// Are we ghosting to someone?
    bool isGhostingTo() { return mLocalGhosts != NULL; };
 
@@ -1016,6 +1141,14 @@ public:
    enum DemoConstants {
       MaxNumBlockTypes = 16,
       MaxBlockSize = 0x1000,
+
+      /// Version of the demo file format, recorded after the protocol
+      /// version.  Bump this whenever the start block or the recorded
+      /// blocks change.  Demos from before it was recorded count as
+      /// version 1.
+      ///
+      /// 2: Ghost snapshot state in the start block.
+      DemoVersion = 2,
    };
 
    bool isRecording()
@@ -1077,6 +1210,8 @@ public:  // required for MSVC
    U32 index;
    U32 arrayIndex;
 
+   GhostSnapshots *snapshots;             ///< Snapshots sent on connections that use them.
+
    /// Flags relating to the state of the object.
    enum Flags
    {
@@ -1092,6 +1227,43 @@ public:  // required for MSVC
    };
 };
 
+/// The most recent updates of a ghost, as written by packUpdate().
+///
+/// Both sides of a connection that uses ghost snapshots keep them for every
+/// ghost.  Snapshot number N goes into slot N % GhostSnapshotSlotCount.  The
+/// server only compresses against an acked snapshot if it has sent fewer than
+/// GhostSnapshotSlotCount snapshots of the ghost since, so the client's copy
+/// can't have been overwritten yet.
+struct GhostSnapshots
+{
+   struct Slot
+   {
+      U8 *data;      ///< Zero padded to whole bytes.
+      U32 bitCount;
+      U32 capacity;  ///< Bytes allocated for data.
+
+      /// Make room for @a bits bits.  The contents are left undefined.
+      U8 *resize(U32 bits);
+
+      /// Zero the bits of the last byte past #bitCount.
+      void clearPadding();
+   };
+
+   Slot slots[NetConnection::GhostSnapshotSlotCount];
+
+   U32 nextNumber;   ///< Number of the next snapshot sent.  Only used by the server.
+   S32 baseline;     ///< Number of the newest snapshot acked by the client, or -1.  Only used by the server.
+
+   GhostSnapshots();
+   ~GhostSnapshots();
+};
+
+inline GhostInfo *NetConnection::getGhostRef(U32 index)
+{
+   AssertFatal(index < mGhostRefCount, "Out of range ghost index.");
+   return mGhostRefBlocks[index >> GhostBlockBitSize] + (index & (GhostBlockSize - 1));
+}
+
 inline void NetConnection::ghostPushNonZero(GhostInfo *info)
 {
    AssertFatal(info->arrayIndex >= mGhostZeroUpdateIndex && info->arrayIndex < mGhostFreeIndex, "Out of range arrayIndex.");
@@ -59,7 +59,7 @@ public:
 
    void pack(NetConnection *ps, BitStream *bstream)
    {
-      bstream->writeInt(ghostIndex, NetConnection::GhostIdBitSize);
+      ps->writeGhostId(bstream, ghostIndex);
 
       NetObject *obj = (NetObject *) Sim::findObject(objectId);
       if(bstream->writeFlag(obj != NULL))
@@ -79,7 +79,7 @@ public:
    }
    void write(NetConnection *ps, BitStream *bstream)
    {
-      bstream->writeInt(ghostIndex, NetConnection::GhostIdBitSize);
+      ps->writeGhostId(bstream, ghostIndex);
       if(bstream->writeFlag(validObject))
       {
          S32 classId = object->getClassId(ps->getNetClassGroup());
@@ -96,7 +96,7 @@ public:
    }
    void unpack(NetConnection *ps, BitStream *bstream)
    {
-      ghostIndex = bstream->readInt(NetConnection::GhostIdBitSize);
+      ghostIndex = ps->readGhostId(bstream);
 
       if(bstream->readFlag())
       {
@@ -162,9 +162,14 @@ void NetConnection::setGhostTo(bool ghostTo)
 
    if(ghostTo)
    {
-      mLocalGhosts = new NetObject *[MaxGhostCount];
-      for(S32 i = 0; i < MaxGhostCount; i++)
+      mLocalGhostCount = GhostBlockSize;
+      mLocalGhosts = new NetObject *[mLocalGhostCount];
+      mLocalGhostSnapshots = new GhostSnapshots *[mLocalGhostCount];
+      for(U32 i = 0; i < mLocalGhostCount; i++)
+      {
          mLocalGhosts[i] = NULL;
+         mLocalGhostSnapshots[i] = NULL;
+      }
    }
 }
 
@@ -175,20 +180,117 @@ void NetConnection::setGhostFrom(bool ghostFrom)
 
    if(ghostFrom)
    {
+      // The ghost tables start out with a single block and
+      // grow as objects come into scope.
       mGhostFreeIndex = mGhostZeroUpdateIndex = 0;
-      mGhostArray = new GhostInfo *[MaxGhostCount];
-      mGhostRefs = new GhostInfo[MaxGhostCount];
-      S32 i;
-      for(i = 0; i < MaxGhostCount; i++)
+      growGhostRefs();
+   }
+}
+
+void NetConnection::setMaxGhostCount(U32 count)
+{
+   mGhostIdBitSize = DefaultGhostIdBitSize;
+   while(mGhostIdBitSize < MaxGhostIdBitSize && (1U << mGhostIdBitSize) < count)
+      mGhostIdBitSize++;
+}
+
+void NetConnection::writeGhostId(BitStream *stream, U32 id)
+{
+   stream->writeInt(id, mGhostIdBitSize);
+}
+
+U32 NetConnection::readGhostId(BitStream *stream)
+{
+   return stream->readInt(mGhostIdBitSize);
+}
+
+bool NetConnection::growGhostRefs()
+{
+   const U32 maxCount = getMaxGhostCount();
+   if(mGhostRefCount >= maxCount)
+      return false;
+
+   // Double the tables so that filling them up doesn't copy
+   // mGhostArray too often.
+   const U32 newCount = getMin(getMax(mGhostRefCount * 2, U32(GhostBlockSize)), maxCount);
+
+   GhostInfo **ghostArray = new GhostInfo *[newCount];
+   if(mGhostArray)
+      dMemcpy(ghostArray, mGhostArray, mGhostRefCount * sizeof(GhostInfo *));
+   delete[] mGhostArray;
+   mGhostArray = ghostArray;
+
+   // The new ghostInfos are all free, so they go at the end of
+   // the free portion of mGhostArray.
+   for(U32 i = mGhostRefCount; i < newCount; i += GhostBlockSize)
+   {
+      GhostInfo *block = new GhostInfo[GhostBlockSize];
+      for(U32 j = 0; j < GhostBlockSize; j++)
       {
-         mGhostRefs[i].obj = NULL;
-         mGhostRefs[i].index = i;
-         mGhostRefs[i].updateMask = 0;
+         block[j].obj = NULL;
+         block[j].index = i + j;
+         block[j].updateMask = 0;
+         block[j].updateChain = NULL;
+         block[j].arrayIndex = i + j;
+         block[j].snapshots = NULL;
+         mGhostArray[i + j] = block + j;
       }
-      mGhostLookupTable = new GhostInfo *[GhostLookupTableSize];
-      for(i = 0; i < GhostLookupTableSize; i++)
-         mGhostLookupTable[i] = 0;
+      mGhostRefBlocks.push_back(block);
    }
+   mGhostRefCount = newCount;
+
+   // Keep about one lookup table bucket per ghostInfo.  The table is
+   // rehashed from the ghosts in use, as only those are in it.
+   GhostInfo **lookupTable = new GhostInfo *[newCount];
+   dMemset(lookupTable, 0, newCount * sizeof(GhostInfo *));
+   delete[] mGhostLookupTable;
+   mGhostLookupTable = lookupTable;
+   mGhostLookupTableSize = newCount;
+
+   for(U32 i = 0; i < mGhostFreeIndex; i++)
+   {
+      GhostInfo *info = mGhostArray[i];
+      if(!info->obj)
+         continue;
+      U32 index = getGhostLookupIndex(info->obj);
+      info->nextLookupInfo = mGhostLookupTable[index];
+      mGhostLookupTable[index] = info;
+   }
+   return true;
+}
+
+bool NetConnection::reserveLocalGhost(U32 index)
+{
+   if(index < mLocalGhostCount)
+      return true;
+   if(index >= getMaxGhostCount())
+      return false;
+
+   U32 newCount = mLocalGhostCount * 2;
+   while(newCount <= index)
+      newCount *= 2;
+   newCount = getMin(newCount, getMaxGhostCount());
+
+   NetObject **localGhosts = new NetObject *[newCount];
+   dMemcpy(localGhosts, mLocalGhosts, mLocalGhostCount * sizeof(NetObject *));
+   dMemset(localGhosts + mLocalGhostCount, 0, (newCount - mLocalGhostCount) * sizeof(NetObject *));
+   delete[] mLocalGhosts;
+   mLocalGhosts = localGhosts;
+
+   GhostSnapshots **localGhostSnapshots = new GhostSnapshots *[newCount];
+   dMemcpy(localGhostSnapshots, mLocalGhostSnapshots, mLocalGhostCount * sizeof(GhostSnapshots *));
+   dMemset(localGhostSnapshots + mLocalGhostCount, 0, (newCount - mLocalGhostCount) * sizeof(GhostSnapshots *));
+   delete[] mLocalGhostSnapshots;
+   mLocalGhostSnapshots = localGhostSnapshots;
+
+   mLocalGhostCount = newCount;
+   return true;
+}
+
+void NetConnection::clearLocalGhostSnapshots(U32 index)
+{
+   delete mLocalGhostSnapshots[index];
+   mLocalGhostSnapshots[index] = NULL;
 }
 
 void NetConnection::ghostOnRemove()
@@ -280,6 +382,12 @@ void NetConnection::ghostPacketReceived(PacketNotify *notify)
 
       *walk = 0;
 
+      // the client has the snapshot now, so later updates can be
+      // compressed against it
+
+      if(packRef->snapshot >= 0)
+         packRef->ghost->snapshots->baseline = packRef->snapshot;
+
       // if this object was ghosting , it is now ghosted
 
       if(packRef->ghostInfoFlags & GhostInfo::Ghosting)
@@ -313,6 +421,54 @@ static S32 QSORT_CALLBACK UQECompare(const void *a,const void *b)
    return (ret < 0) ? -1 : ((ret > 0) ? 1 : 0);
 }
 
+/// Number of ghosts put into priority order at a time by ghostWritePacket().
+static const S32 GhostSelectBlockSize = 64;
+
+/// Partially orders ghosts[0..count) so that its highest priority ghosts are
+/// at [first..count) in ascending order and all ghosts before first have a
+/// priority no higher than any of them.  The array indices are updated.
+static void selectHighestPriorityGhosts(GhostInfo **ghosts, S32 first, S32 count)
+{
+   // Quickselect the ghost that belongs at first.
+   S32 lo = 0;
+   S32 hi = count - 1;
+   while(lo < hi)
+   {
+      F32 a = ghosts[lo]->priority;
+      F32 b = ghosts[(lo + hi) >> 1]->priority;
+      F32 c = ghosts[hi]->priority;
+      F32 pivot = getMax(getMin(a, b), getMin(getMax(a, b), c));
+
+      S32 l = lo;
+      S32 r = hi;
+      while(l <= r)
+      {
+         while(ghosts[l]->priority < pivot)
+            l++;
+         while(ghosts[r]->priority > pivot)
+            r--;
+         if(l <= r)
+         {
+            GhostInfo *temp = ghosts[l];
+            ghosts[l++] = ghosts[r];
+            ghosts[r--] = temp;
+         }
+      }
+
+      if(first <= r)
+         hi = r;
+      else if(first >= l)
+         lo = l;
+      else
+         break;
+   }
+
+   dQsort(ghosts + first, count - first, sizeof(GhostInfo *), UQECompare);
+
+   for(S32 i = 0; i < count; i++)
+      ghosts[i]->arrayIndex = i;
+}
+
 void NetConnection::ghostWritePacket(BitStream *bstream, PacketNotify *notify)
 {
 #ifdef    TORQUE_DEBUG_NET
@@ -402,13 +558,6 @@ void NetConnection::ghostWritePacket(BitStream *bstream, PacketNotify *notify)
       else
          walk->priority = 0;
    }
-   GhostRef *updateList = NULL;
-   dQsort(mGhostArray, mGhostZeroUpdateIndex, sizeof(GhostInfo *), UQECompare);
-
-   // reset the array indices...
-   for(i = mGhostZeroUpdateIndex - 1; i >= 0; i--)
-      mGhostArray[i]->arrayIndex = i;
-
    S32 sendSize = 1;
    while(maxIndex >>= 1)
       sendSize++;
@@ -418,28 +567,69 @@ void NetConnection::ghostWritePacket(BitStream *bstream, PacketNotify *notify)
 
    bstream->writeInt(sendSize - 3, GhostIndexBitSize);
 
-   U32 count = 0;
-   //
-   for(i = mGhostZeroUpdateIndex - 1; i >= 0 && !bstream->isFull(); i--)
+   mGhostWriteState.stream = bstream;
+   mGhostWriteState.notify = notify;
+   mGhostWriteState.index = mGhostZeroUpdateIndex - 1;
+   mGhostWriteState.selectedStart = mGhostZeroUpdateIndex;
+   mGhostWriteState.idSize = sendSize;
+
+   if(mDeferGhostUpdates)
+   {
+      // The caller may still change the stream's compression point.
+      mGhostWriteState.compressionPoint = bstream->getCompressionPoint();
+      mGhostWriteState.pending = true;
+      return;
+   }
+
+   ghostWriteUpdates(false);
+}
+
+bool NetConnection::ghostWriteUpdates(bool threadSafeOnly)
+{
+   GhostWriteState &state = mGhostWriteState;
+   BitStream *bstream = state.stream;
+   if(state.pending)
+      bstream->setCompressionPoint(state.compressionPoint);
+
+   // Only the ghosts that make it into the packet need to be in order, so
+   // rather than sorting all of them, the highest priority ones are selected
+   // a block at a time as the packet fills up.  Ghosts below the current one
+   // are never moved by the updates, so the selection stays valid.
+   for(; state.index >= 0 && !bstream->isFull(); state.index--)
    {
+      S32 i = state.index;
+      if(i < state.selectedStart)
+      {
+         state.selectedStart = getMax(i + 1 - GhostSelectBlockSize, 0);
+         selectHighestPriorityGhosts(mGhostArray, state.selectedStart, i + 1);
+      }
+
       GhostInfo *walk = mGhostArray[i];
 		if(walk->flags & (GhostInfo::KillingGhost | GhostInfo::Ghosting))
 		   continue;
+
+      // Leave the rest to the main thread.
+      if(threadSafeOnly && !(walk->flags & GhostInfo::KillGhost) && !walk->obj->isPackUpdateThreadSafe(walk->updateMask))
+      {
+         state.compressionPoint = bstream->getCompressionPoint();
+         return false;
+      }
 		
       bstream->writeFlag(true);
 
-      bstream->writeInt(walk->index, sendSize);
+      bstream->writeInt(walk->index, state.idSize);
       U32 updateMask = walk->updateMask;
 
       GhostRef *upd = new GhostRef;
 
-      upd->nextRef = updateList;
-      updateList = upd;
+      upd->nextRef = state.notify->ghostList;
+      state.notify->ghostList = upd;
       upd->nextUpdateChain = walk->updateChain;
       walk->updateChain = upd;
 
       upd->ghost = walk;
       upd->ghostInfoFlags = 0;
+      upd->snapshot = -1;
 
       if(walk->flags & GhostInfo::KillGhost)
       {
@@ -480,7 +670,11 @@ void NetConnection::ghostWritePacket(BitStream *bstream, PacketNotify *notify)
 #ifdef TORQUE_NET_STATS
          U32 beginSize = bstream->getBitPosition();
 #endif
-         U32 retMask = walk->obj->packUpdate(this, updateMask, bstream);
+         U32 retMask;
+         if(mGhostSnapshots)
+            retMask = ghostWriteSnapshot(walk, updateMask, bstream, upd);
+         else
+            retMask = walk->obj->packUpdate(this, updateMask, bstream);
 #ifdef TORQUE_NET_STATS
          walk->obj->getClassRep()->updateNetStatPack(updateMask, bstream->getBitPosition() - beginSize);
 #endif
@@ -502,12 +696,143 @@ void NetConnection::ghostWritePacket(BitStream *bstream, PacketNotify *notify)
 #endif
       }
       walk->updateSkipCount = 0;
-      count++;
    }
-   //Con::printf("Ghosts updated: %d (%d remain)", count, mGhostZeroUpdateIndex);
    // no more objects...
    bstream->writeFlag(false);
-   notify->ghostList = updateList;
+   state.pending = false;
+   return true;
+}
+
+//-----------------------------------------------------------------------------
+
+GhostSnapshots::GhostSnapshots()
+{
+   for(U32 i = 0; i < NetConnection::GhostSnapshotSlotCount; i++)
+   {
+      slots[i].data = NULL;
+      slots[i].bitCount = 0;
+      slots[i].capacity = 0;
+   }
+   nextNumber = 0;
+   baseline = -1;
+}
+
+GhostSnapshots::~GhostSnapshots()
+{
+   for(U32 i = 0; i < NetConnection::GhostSnapshotSlotCount; i++)
+      delete[] slots[i].data;
+}
+
+U8 *GhostSnapshots::Slot::resize(U32 bits)
+{
+   const U32 byteCount = (bits + 7) >> 3;
+   if(byteCount > capacity)
+   {
+      delete[] data;
+      data = new U8[byteCount];
+      capacity = byteCount;
+   }
+   bitCount = bits;
+   return data;
+}
+
+void GhostSnapshots::Slot::clearPadding()
+{
+   if(bitCount & 7)
+      data[bitCount >> 3] &= (1 << (bitCount & 7)) - 1;
+}
+
+/// Write a snapshot as its difference to a baseline.  Gives up and returns
+/// false as soon as that takes @a maxBits bits or more, leaving the part
+/// written so far in the stream.
+static bool writeSnapshotDelta(BitStream *stream, const GhostSnapshots::Slot &snapshot, const GhostSnapshots::Slot &baseline, U32 maxBits)
+{
+   const U32 end = stream->getCurPos() + maxBits;
+   if(!stream->writeFlag(snapshot.bitCount == baseline.bitCount))
+      stream->writeInt(snapshot.bitCount, NetConnection::GhostSnapshotSizeBitSize);
+
+   // A flag for each byte, followed by the XOR of the byte with
+   // the baseline if that isn't zero.
+   const U32 byteCount = (snapshot.bitCount + 7) >> 3;
+   const U32 baselineByteCount = (baseline.bitCount + 7) >> 3;
+   for(U32 i = 0; i < byteCount; i++)
+   {
+      if(U32(stream->getCurPos()) >= end)
+         return false;
+      const U8 diff = snapshot.data[i] ^ (i < baselineByteCount ? baseline.data[i] : 0);
+      if(stream->writeFlag(diff != 0))
+         stream->writeInt(diff, 8);
+   }
+   return U32(stream->getCurPos()) < end;
+}
+
+/// Read a snapshot written by writeSnapshotDelta().
+static bool readSnapshotDelta(BitStream *stream, GhostSnapshots::Slot &snapshot, const GhostSnapshots::Slot &baseline)
+{
+   U32 bitCount = baseline.bitCount;
+   if(!stream->readFlag())
+      bitCount = stream->readInt(NetConnection::GhostSnapshotSizeBitSize);
+   if(bitCount > Net::MaxPacketDataSize << 3)
+      return false;
+
+   U8 *data = snapshot.resize(bitCount);
+   const U32 byteCount = (bitCount + 7) >> 3;
+   const U32 baselineByteCount = (baseline.bitCount + 7) >> 3;
+   for(U32 i = 0; i < byteCount; i++)
+   {
+      const U8 diff = stream->readFlag() ? U8(stream->readInt(8)) : 0;
+      data[i] = diff ^ (i < baselineByteCount ? baseline.data[i] : 0);
+   }
+   return stream->isValid();
+}
+
+U32 NetConnection::ghostWriteSnapshot(GhostInfo *info, U32 updateMask, BitStream *bstream, GhostRef *ref)
+{
+   // Pack the update on its own, with the compression point the
+   // client will unpack it with.
+   U8 buffer[Net::MaxPacketDataSize];
+   BitStream packStream(buffer, sizeof(buffer));
+   packStream.setCompressionPoint(bstream->getCompressionPoint());
+
+   U32 retMask = info->obj->packUpdate(this, updateMask, &packStream);
+   const U32 bitCount = packStream.getCurPos();
+
+   if(!info->snapshots)
+      info->snapshots = new GhostSnapshots;
+   GhostSnapshots *snapshots = info->snapshots;
+
+   // Keep a copy of the bits, padded with zeros like the client's.
+   const U32 number = snapshots->nextNumber++;
+   GhostSnapshots::Slot &snapshot = snapshots->slots[number % GhostSnapshotSlotCount];
+   U8 *data = snapshot.resize(bitCount);
+   dMemcpy(data, buffer, (bitCount + 7) >> 3);
+   snapshot.clearPadding();
+   ref->snapshot = number;
+
+   bstream->writeInt(number % GhostSnapshotSlotCount, GhostSnapshotSlotBitSize);
+
+   // The newest snapshot the client has acked is only of use if
+   // its slot hasn't been reused since.
+   const GhostSnapshots::Slot *baseline = NULL;
+   if(snapshots->baseline >= 0 && number - U32(snapshots->baseline) < GhostSnapshotSlotCount)
+      baseline = &snapshots->slots[snapshots->baseline % GhostSnapshotSlotCount];
+
+   // Write the delta straight into the packet and fall back to the raw
+   // bits if it doesn't come out smaller.
+   const U32 start = bstream->getCurPos();
+   if(baseline && bitCount > GhostSnapshotSlotBitSize)
+   {
+      bstream->writeFlag(true);
+      bstream->writeInt(snapshots->baseline % GhostSnapshotSlotCount, GhostSnapshotSlotBitSize);
+      if(writeSnapshotDelta(bstream, snapshot, *baseline, bitCount - GhostSnapshotSlotBitSize))
+         return retMask;
+      bstream->setCurPos(start);
+   }
+
+   bstream->writeFlag(false);
+   bstream->writeBits(bitCount, data);
+
+   return retMask;
 }
 
 void NetConnection::ghostReadPacket(BitStream *bstream)
@@ -537,12 +862,18 @@ void NetConnection::ghostReadPacket(BitStream *bstream)
       U32 index;
       //S32 startPos = bstream->getCurPos();
       index = (U32) bstream->readInt(idSize);
+      if(!reserveLocalGhost(index))
+      {
+         setLastError("Invalid packet. (ghost index out of range)");
+         return;
+      }
       if(bstream->readFlag()) // is this ghost being deleted?
       {
 		 mGhostsActive--;
          AssertFatal(mLocalGhosts[index] != NULL, "Error, NULL ghost encountered.");
          mLocalGhosts[index]->deleteObject();
          mLocalGhosts[index] = NULL;
+         clearLocalGhostSnapshots(index);
       }
       else
       {
@@ -586,7 +917,13 @@ void NetConnection::ghostReadPacket(BitStream *bstream)
 #ifdef TORQUE_NET_STATS
             U32 beginSize = bstream->getBitPosition();
 #endif
-            mLocalGhosts[index]->unpackUpdate(this, bstream);
+            if(mGhostSnapshots)
+            {
+               if(!ghostReadSnapshot(index, bstream))
+                  return;
+            }
+            else
+               mLocalGhosts[index]->unpackUpdate(this, bstream);
 #ifdef TORQUE_NET_STATS
             mLocalGhosts[index]->getClassRep()->updateNetStatUnpack(bstream->getBitPosition() - beginSize);
 #endif
@@ -635,7 +972,13 @@ void NetConnection::ghostReadPacket(BitStream *bstream)
 #ifdef TORQUE_NET_STATS
             U32 beginSize = bstream->getBitPosition();
 #endif
-            mLocalGhosts[index]->unpackUpdate(this, bstream);
+            if(mGhostSnapshots)
+            {
+               if(!ghostReadSnapshot(index, bstream))
+                  return;
+            }
+            else
+               mLocalGhosts[index]->unpackUpdate(this, bstream);
 #ifdef TORQUE_NET_STATS
             mLocalGhosts[index]->getClassRep()->updateNetStatUnpack(bstream->getBitPosition() - beginSize);
 #endif
@@ -655,6 +998,46 @@ void NetConnection::ghostReadPacket(BitStream *bstream)
    }
 }
 
+bool NetConnection::ghostReadSnapshot(U32 index, BitStream *bstream)
+{
+   if(!mLocalGhostSnapshots[index])
+      mLocalGhostSnapshots[index] = new GhostSnapshots;
+   GhostSnapshots *snapshots = mLocalGhostSnapshots[index];
+   GhostSnapshots::Slot &snapshot = snapshots->slots[bstream->readInt(GhostSnapshotSlotBitSize)];
+
+   if(bstream->readFlag())
+   {
+      const GhostSnapshots::Slot &baseline = snapshots->slots[bstream->readInt(GhostSnapshotSlotBitSize)];
+      if(&baseline == &snapshot)
+      {
+         setLastError("Invalid packet. (invalid ghost snapshot baseline)");
+         return false;
+      }
+      if(!readSnapshotDelta(bstream, snapshot, baseline))
+      {
+         setLastError("Invalid packet. (invalid ghost snapshot)");
+         return false;
+      }
+
+      BitStream snapshotStream(snapshot.data, (snapshot.bitCount + 7) >> 3);
+      snapshotStream.setCompressionPoint(bstream->getCompressionPoint());
+      mLocalGhosts[index]->unpackUpdate(this, &snapshotStream);
+   }
+   else
+   {
+      // The update was sent as is, so keep a copy of
+      // the bits the object read.
+      const U32 start = bstream->getCurPos();
+      mLocalGhosts[index]->unpackUpdate(this, bstream);
+      const U32 bitCount = bstream->getCurPos() - start;
+
+      bstream->setCurPos(start);
+      bstream->readBits(bitCount, snapshot.resize(bitCount));
+      snapshot.clearPadding();
+   }
+   return true;
+}
+
 //-----------------------------------------------------------------------------
 
 
@@ -688,8 +1071,7 @@ void NetConnection::detachObject(GhostInfo *info)
          info->nextObjectRef->prevObjectRef = info->prevObjectRef;
 
       // remove it from the lookup table
-      U32 id = info->obj->getId();
-      for(GhostInfo **walk = &mGhostLookupTable[id & (GhostLookupTableSize - 1)]; *walk; walk = &((*walk)->nextLookupInfo))
+      for(GhostInfo **walk = &mGhostLookupTable[getGhostLookupIndex(info->obj)]; *walk; walk = &((*walk)->nextLookupInfo))
       {
          GhostInfo *temp = *walk;
          if(temp == info)
@@ -714,6 +1096,9 @@ void NetConnection::freeGhostInfo(GhostInfo *ghost)
    }
    ghostPushZeroToFree(ghost);
    AssertFatal(ghost->updateChain == NULL, "Ack!");
+
+   delete ghost->snapshots;
+   ghost->snapshots = NULL;
 }
 
 //-----------------------------------------------------------------------------
@@ -723,7 +1108,7 @@ void NetConnection::objectLocalScopeAlways(NetObject *obj)
    if(!isGhostingFrom())
       return;
    objectInScope(obj);
-   for(GhostInfo *walk = mGhostLookupTable[obj->getId() & (GhostLookupTableSize - 1)]; walk; walk = walk->nextLookupInfo)
+   for(GhostInfo *walk = mGhostLookupTable[getGhostLookupIndex(obj)]; walk; walk = walk->nextLookupInfo)
    {
       if(walk->obj != obj)
          continue;
@@ -736,7 +1121,7 @@ void NetConnection::objectLocalClearAlways(NetObject *obj)
 {
    if(!isGhostingFrom())
       return;
-   for(GhostInfo *walk = mGhostLookupTable[obj->getId() & (GhostLookupTableSize - 1)]; walk; walk = walk->nextLookupInfo)
+   for(GhostInfo *walk = mGhostLookupTable[getGhostLookupIndex(obj)]; walk; walk = walk->nextLookupInfo)
    {
       if(walk->obj != obj)
          continue;
@@ -748,7 +1133,7 @@ void NetConnection::objectLocalClearAlways(NetObject *obj)
 bool NetConnection::validateGhostArray()
 {
    AssertFatal(mGhostZeroUpdateIndex >= 0 && mGhostZeroUpdateIndex <= mGhostFreeIndex, "Invalid update index range.");
-   AssertFatal(mGhostFreeIndex <= MaxGhostCount, "Invalid free index range.");
+   AssertFatal(mGhostFreeIndex <= mGhostRefCount, "Invalid free index range.");
    U32 i;
    for(i = 0; i < mGhostZeroUpdateIndex; i ++)
    {
@@ -760,7 +1145,7 @@ bool NetConnection::validateGhostArray()
       AssertFatal(mGhostArray[i]->arrayIndex == i, "Invalid array index.");
       AssertFatal(mGhostArray[i]->updateMask == 0, "Invalid ghost mask.");
    }
-   for(; i < MaxGhostCount; i++)
+   for(; i < mGhostRefCount; i++)
    {
       AssertFatal(mGhostArray[i]->arrayIndex == i, "Invalid array index.");
    }
@@ -774,13 +1159,11 @@ void NetConnection::objectInScope(NetObject *obj)
 	if (obj->isScopeLocal() && !isLocalConnection())
 		return;
 
-   S32 index = obj->getId() & (GhostLookupTableSize - 1);
-
    // check if it's already in scope
    // the object may have been cleared out without the lookupTable being cleared
    // so validate that the object pointers are the same.
 
-   for(GhostInfo *walk = mGhostLookupTable[index ]; walk; walk = walk->nextLookupInfo)
+   for(GhostInfo *walk = mGhostLookupTable[getGhostLookupIndex(obj)]; walk; walk = walk->nextLookupInfo)
    {
       if(walk->obj != obj)
          continue;
@@ -793,7 +1176,7 @@ void NetConnection::objectInScope(NetObject *obj)
       return;
    }
 
-   if (mGhostFreeIndex == MaxGhostCount)
+   if (mGhostFreeIndex == mGhostRefCount && !growGhostRefs())
    {
       AssertWarn(0,"NetConnection::objectInScope: too many ghosts");
       return;
@@ -821,6 +1204,8 @@ void NetConnection::objectInScope(NetObject *obj)
    giptr->prevObjectRef = NULL;
    obj->mFirstObjectRef = giptr;
 
+   // growing the tables may have resized the lookup table
+   U32 index = getGhostLookupIndex(obj);
    giptr->nextLookupInfo = mGhostLookupTable[index];
    mGhostLookupTable[index] = giptr;
    //AssertFatal(validateGhostArray(), "Invalid ghost array!");
@@ -873,13 +1258,14 @@ void NetConnection::handleConnectionMessage(U32 message, U32 sequence, U32 ghost
          onEndGhosting();
          // just delete all the local ghosts,
          // and delete all the ghosts in the current save list
-         for(i = 0; i < MaxGhostCount; i++)
+         for(i = 0; i < mLocalGhostCount; i++)
          {
             if(mLocalGhosts[i])
             {
                mLocalGhosts[i]->deleteObject();
                mLocalGhosts[i] = NULL;
             }
+            clearLocalGhostSnapshots(i);
          }
          while(mGhostAlwaysSaveList.size())
          {
@@ -917,19 +1303,13 @@ void NetConnection::activateGhosting()
 
    AssertFatal((mGhostFreeIndex == 0) && (mGhostZeroUpdateIndex == 0), "Error: ghosts in the ghost list before activate.");
 
-   U32 sz = ghostAlwaysSet->size();
    S32 j;
 
-   for(j = 0; j < sz; j++)
-   {
-      U32 idx = MaxGhostCount - sz + j;
-      mGhostArray[j] = mGhostRefs + idx;
-      mGhostArray[j]->arrayIndex = j;
-   }
-   for(j = sz; j < MaxGhostCount; j++)
+   // Hand out the ghost indices in order, starting with the ghost always
+   // objects, so they stay small and take few bits in ghost packets.
+   for(j = 0; j < mGhostRefCount; j++)
    {
-      U32 idx = j - sz;
-      mGhostArray[j] = mGhostRefs + idx;
+      mGhostArray[j] = getGhostRef(j);
       mGhostArray[j]->arrayIndex = j;
    }
    mScoping = true; // so that objectInScope will work
@@ -1034,12 +1414,13 @@ void NetConnection::clearGhostInfo()
       ghostPacketReceived(walk);
       walk->ghostList = NULL;
    }
-   for(S32 i = 0; i < MaxGhostCount; i++)
+   for(U32 i = 0; i < mGhostRefCount; i++)
    {
-      if(mGhostRefs[i].arrayIndex < mGhostFreeIndex)
+      GhostInfo *info = getGhostRef(i);
+      if(info->arrayIndex < mGhostFreeIndex)
       {
-         detachObject(&mGhostRefs[i]);
-         freeGhostInfo(&mGhostRefs[i]);
+         detachObject(info);
+         freeGhostInfo(info);
       }
    }
    AssertFatal((mGhostFreeIndex == 0) && (mGhostZeroUpdateIndex == 0), "Invalid indices.");
@@ -1068,6 +1449,12 @@ void NetConnection::setGhostAlwaysObject(NetObject *object, U32 index)
       setLastError("Invalid packet. (unexpected ghostalways)");
       return;
    }
+   if(!reserveLocalGhost(index))
+   {
+      object->deleteObject();
+      setLastError("Invalid packet. (ghostalways index out of range)");
+      return;
+   }
    object->mNetFlags = NetObject::IsGhost;
    object->mNetIndex = index;
 
@@ -1179,21 +1566,23 @@ void NetConnection::loadNextGhostAlwaysObject(bool hadNewFiles)
 
 NetObject *NetConnection::resolveGhost(S32 id)
 {
+   if(id < 0 || U32(id) >= mLocalGhostCount)
+      return NULL;
    return mLocalGhosts[id];
 }
 
 NetObject *NetConnection::resolveObjectFromGhostIndex(S32 id)
 {
-   return mGhostRefs[id].obj;
+   if(id < 0 || U32(id) >= mGhostRefCount)
+      return NULL;
+   return getGhostRef(id)->obj;
 }
 
 S32 NetConnection::getGhostIndex(NetObject *obj)
 {
    if(!isGhostingFrom())
       return obj->mNetIndex;
-   S32 index = obj->getId() & (GhostLookupTableSize - 1);
-
-   for(GhostInfo *gptr = mGhostLookupTable[index]; gptr; gptr = gptr->nextLookupInfo)
+   for(GhostInfo *gptr = mGhostLookupTable[getGhostLookupIndex(obj)]; gptr; gptr = gptr->nextLookupInfo)
    {
       if(gptr->obj == obj && (gptr->flags & (GhostInfo::KillingGhost | GhostInfo::Ghosting | GhostInfo::NotYetGhosted | GhostInfo::KillGhost)) == 0)
             return gptr->index;
@@ -1217,14 +1606,16 @@ void NetConnection::ghostWriteStartBlock(ResizeBitStream *stream)
    // table with the correct pointers before any of the unpacks are called.
 
    stream->write(mGhostingSequence);
+   stream->writeInt(mGhostIdBitSize - DefaultGhostIdBitSize, GhostIdBitSizeBitSize);
+   stream->writeFlag(mGhostSnapshots);
 
    // first write out the indices and ids:
-   for(U32 i = 0; i < MaxGhostCount; i++)
+   for(U32 i = 0; i < mLocalGhostCount; i++)
    {
       if(mLocalGhosts[i])
       {
          stream->writeFlag(true);
-         stream->writeInt(i, GhostIdBitSize);
+         writeGhostId(stream, i);
          stream->writeClassId(mLocalGhosts[i]->getClassId(getNetClassGroup()), NetClassTypeObject, getNetClassGroup());
          stream->validate();
       }
@@ -1238,13 +1629,28 @@ void NetConnection::ghostWriteStartBlock(ResizeBitStream *stream)
    // then, for each ghost written into the start block, write the full pack update
    // into the start block.  For demos to work properly, packUpdate must
    // be callable from client objects.
-   for(U32 i = 0; i < MaxGhostCount; i++)
+   for(U32 i = 0; i < mLocalGhostCount; i++)
    {
       if(mLocalGhosts[i])
       {
          U32 retMask = mLocalGhosts[i]->packUpdate(this, 0xFFFFFFFF, stream);
          if ( retMask != 0 ) mLocalGhosts[i]->setMaskBits( retMask );
          stream->validate();
+
+         // the packets that follow may be compressed against any
+         // of the snapshots we have.
+         if(mGhostSnapshots)
+         {
+            for(U32 j = 0; j < GhostSnapshotSlotCount; j++)
+            {
+               const GhostSnapshots::Slot *slot = mLocalGhostSnapshots[i] ? &mLocalGhostSnapshots[i]->slots[j] : NULL;
+               const U32 bitCount = slot ? slot->bitCount : 0;
+               stream->writeInt(bitCount, GhostSnapshotSizeBitSize);
+               if(bitCount)
+                  stream->writeBits(bitCount, slot->data);
+               stream->validate();
+            }
+         }
       }
    }
 }
@@ -1252,13 +1658,20 @@ void NetConnection::ghostWriteStartBlock(ResizeBitStream *stream)
 void NetConnection::ghostReadStartBlock(BitStream *stream)
 {
    stream->read(&mGhostingSequence);
+   mGhostIdBitSize = getMin(U32(stream->readInt(GhostIdBitSizeBitSize)) + DefaultGhostIdBitSize, U32(MaxGhostIdBitSize));
+   mGhostSnapshots = stream->readFlag();
 
    // read em back in.
    // first, read in the index/class id, construct the object, and place it in mLocalGhosts[i]
 
    while(stream->readFlag())
    {
-      U32 index = stream->readInt(GhostIdBitSize);
+      U32 index = readGhostId(stream);
+      if(!reserveLocalGhost(index))
+      {
+         setLastError("Invalid packet. (ghost index out of range in demo block)");
+         return;
+      }
       S32 tag = stream->readClassId(NetClassTypeObject, getNetClassGroup());
       NetObject *obj = (NetObject *) ConsoleObject::create(getNetClassGroup(), NetClassTypeObject, tag);
       if(!obj)
@@ -1275,11 +1688,25 @@ void NetConnection::ghostReadStartBlock(BitStream *stream)
    // through all non-null mLocalGhosts, unpacking the objects
    // as we go:
 
-   for(U32 i = 0; i < MaxGhostCount; i++)
+   for(U32 i = 0; i < mLocalGhostCount; i++)
    {
       if(mLocalGhosts[i])
       {
          mLocalGhosts[i]->unpackUpdate(this, stream);
+
+         if(mGhostSnapshots)
+         {
+            if(!mLocalGhostSnapshots[i])
+               mLocalGhostSnapshots[i] = new GhostSnapshots;
+            for(U32 j = 0; j < GhostSnapshotSlotCount; j++)
+            {
+               GhostSnapshots::Slot &slot = mLocalGhostSnapshots[i]->slots[j];
+               U32 bitCount = stream->readInt(GhostSnapshotSizeBitSize);
+               stream->readBits(bitCount, slot.resize(bitCount));
+               slot.clearPadding();
+            }
+         }
+
          if(!mLocalGhosts[i]->registerObject())
          {
             if(mErrorBuffer.isEmpty())
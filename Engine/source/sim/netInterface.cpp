@@ -422,23 +422,45 @@ void NetInterface::handleInfoPacket(const NetAddress *address, U8 packetType, Bi
 void NetInterface::processClient()
 {
    NetObject::collapseDirtyList(); // collapse all the mask bits...
+   Net::beginBatchedSend();
    for(NetConnection *walk = NetConnection::getConnectionList();
       walk; walk = walk->getNext())
    {
       if(walk->isConnectionToServer() && (walk->isLocalConnection() || walk->isNetworkConnection()))
          walk->checkPacketSend(false);
    }
+   Net::endBatchedSend();
 }
 
 void NetInterface::processServer()
 {
    NetObject::collapseDirtyList(); // collapse all the mask bits...
-   for(NetConnection *walk = NetConnection::getConnectionList();
-      walk; walk = walk->getNext())
+
+   // The packets of all clients go out together at the end.
+   Net::beginBatchedSend();
+
+   if(NetConnection::smParallelPacketWrite)
    {
-      if(!walk->isConnectionToServer() && (walk->isLocalConnection() || walk->isNetworkConnection()))
-         walk->checkPacketSend(false);
+      Vector<NetConnection *> connections;
+      for(NetConnection *walk = NetConnection::getConnectionList();
+         walk; walk = walk->getNext())
+      {
+         if(!walk->isConnectionToServer() && (walk->isLocalConnection() || walk->isNetworkConnection()))
+            connections.push_back(walk);
+      }
+      NetConnection::checkPacketSendParallel(connections.address(), connections.size());
    }
+   else
+   {
+      for(NetConnection *walk = NetConnection::getConnectionList();
+         walk; walk = walk->getNext())
+      {
+         if(!walk->isConnectionToServer() && (walk->isLocalConnection() || walk->isNetworkConnection()))
+            walk->checkPacketSend(false);
+      }
+   }
+
+   Net::endBatchedSend();
 }
 
 void NetInterface::startConnection(NetConnection *conn)
@@ -342,6 +342,17 @@ public:
    ///          system. Don't set bits you weren't passed.
    virtual U32  packUpdate(NetConnection * conn, U32 mask, BitStream *stream);
 
+   /// Return true if packUpdate() with the given mask may be called from a
+   /// worker thread while other connections pack the same object.
+   ///
+   /// This is the case when packUpdate() only reads the state of the object
+   /// and writes to the stream.  It must not change the object or any other
+   /// shared state, which rules out setMaskBits(), posting events and packing
+   /// NetStringHandles.  Resolving ghost indices on @a conn is fine.
+   ///
+   /// @see NetConnection::smParallelPacketWrite
+   virtual bool isPackUpdateThreadSafe(U32 mask) const { return false; }
+
    /// Instructs this object to read state data previously packed with packUpdate.
    ///
    /// @param   conn    Net connection being used
@@ -0,0 +1,169 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "unit/test.h"
+#include "sim/netConnection.h"
+#include "core/stream/bitStream.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+namespace
+{
+   /// Exposes the ghost tables of a connection that is never registered.
+   class TestGhostIdConnection : public NetConnection
+   {
+   public:
+      using NetConnection::growGhostRefs;
+      using NetConnection::reserveLocalGhost;
+      using NetConnection::getGhostRef;
+      using NetConnection::mGhostArray;
+      using NetConnection::mGhostRefCount;
+      using NetConnection::mLocalGhosts;
+      using NetConnection::mLocalGhostCount;
+   };
+}
+
+// Rounds ghost counts to ID widths and sends the width from a server
+// connection to a client connection through the connect accept.
+
+CreateUnitTest( TestNetGhostIdWidth, "Sim/NetConnection/GhostIdWidth" )
+{
+   void testRoundTrip( U32 maxGhostCount, U32 expectedBits )
+   {
+      TestGhostIdConnection server;
+      TestGhostIdConnection client;
+
+      server.setMaxGhostCount( maxGhostCount );
+      test( server.getGhostIdBitSize() == expectedBits, "unexpected ghost ID width" );
+      test( server.getMaxGhostCount() == ( 1U << expectedBits ), "unexpected max ghost count" );
+
+      U8 buffer[ 64 ];
+      BitStream stream( buffer, sizeof( buffer ) );
+      server.writeConnectAccept( &stream );
+
+      // The client starts out at its own default and must take the server's width.
+      const U32 acceptBits = stream.getBitPosition();
+      stream.setCurPos( 0 );
+      const char* errorString = NULL;
+      test( client.readConnectAccept( &stream, &errorString ), "connect accept rejected" );
+      test( stream.getBitPosition() == acceptBits, "connect accept read size mismatch" );
+      test( client.getGhostIdBitSize() == expectedBits, "client ghost ID width mismatch" );
+
+      // IDs at both ends of the range survive a write and read at that width.
+      const U32 maxId = server.getMaxGhostCount() - 1;
+      stream.setCurPos( 0 );
+      server.writeGhostId( &stream, 0 );
+      server.writeGhostId( &stream, maxId );
+      test( stream.getBitPosition() == S32( expectedBits * 2 ), "ghost IDs written with the wrong width" );
+
+      stream.setCurPos( 0 );
+      test( client.readGhostId( &stream ) == 0, "ghost ID 0 mismatch" );
+      test( client.readGhostId( &stream ) == maxId, "max ghost ID mismatch" );
+   }
+
+   void run()
+   {
+      testRoundTrip( 0, 12 );
+      testRoundTrip( 4096, 12 );
+      testRoundTrip( 4097, 13 );
+      testRoundTrip( 32768, 15 );
+      testRoundTrip( 65536, 16 );
+      testRoundTrip( 1000000, 16 );
+
+      // A width the client can't handle must be rejected.
+      U8 buffer[ 8 ];
+      BitStream stream( buffer, sizeof( buffer ) );
+      stream.writeInt( NetConnection::MaxGhostIdBitSize - NetConnection::DefaultGhostIdBitSize + 1, NetConnection::GhostIdBitSizeBitSize );
+      stream.setCurPos( 0 );
+
+      TestGhostIdConnection client;
+      const char* errorString = NULL;
+      test( !client.readConnectAccept( &stream, &errorString ), "out of range ghost ID width accepted" );
+      test( client.getGhostIdBitSize() == NetConnection::DefaultGhostIdBitSize, "rejected width was applied" );
+   }
+};
+
+// Grows the ghost tables of server and client connections past the old
+// fixed size of 1024 entries and up to the limit of their ID width.
+
+CreateUnitTest( TestNetGhostTableGrowth, "Sim/NetConnection/GhostTableGrowth" )
+{
+   void testServer( U32 idBits )
+   {
+      TestGhostIdConnection server;
+      server.setMaxGhostCount( 1 << idBits );
+      server.setGhostFrom( true );
+      test( server.mGhostRefCount == NetConnection::GhostBlockSize, "server tables don't start with one block" );
+
+      U32 numGrows = 0;
+      while( server.growGhostRefs() )
+         numGrows ++;
+
+      test( numGrows > 2, "server tables didn't grow past 1024 entries" );
+      test( server.mGhostRefCount == server.getMaxGhostCount(), "server tables not grown to the max ghost count" );
+
+      // Every ghostInfo must be reachable and still free.
+      bool ok = true;
+      for( U32 i = 0; i < server.mGhostRefCount; ++ i )
+      {
+         GhostInfo* info = server.getGhostRef( i );
+         if( info->index != S32( i ) || info->arrayIndex != S32( i ) || info->obj != NULL || server.mGhostArray[ i ] != info )
+            ok = false;
+      }
+      test( ok, "server ghostInfo mismatch after growing" );
+   }
+
+   void testClient( U32 idBits )
+   {
+      TestGhostIdConnection client;
+      client.setMaxGhostCount( 1 << idBits );
+      client.setGhostTo( true );
+      test( client.mLocalGhostCount == NetConnection::GhostBlockSize, "client table doesn't start with one block" );
+
+      test( client.reserveLocalGhost( 1500 ), "client can't hold ghost 1500" );
+      test( client.mLocalGhostCount > 1500, "client table not grown past 1500" );
+
+      const U32 maxId = client.getMaxGhostCount() - 1;
+      test( client.reserveLocalGhost( maxId ), "client can't hold the max ghost ID" );
+      test( client.mLocalGhostCount == client.getMaxGhostCount(), "client table not grown to the max ghost count" );
+      test( !client.reserveLocalGhost( maxId + 1 ), "client accepted a ghost ID past the max" );
+
+      bool ok = true;
+      for( U32 i = 0; i < client.mLocalGhostCount; ++ i )
+         if( client.mLocalGhosts[ i ] != NULL )
+            ok = false;
+      test( ok, "client table not cleared after growing" );
+   }
+
+   void run()
+   {
+      testServer( 12 );
+      testServer( 16 );
+      testClient( 12 );
+      testClient( 16 );
+   }
+};
+
+#endif // !TORQUE_SHIPPING
@@ -0,0 +1,210 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "unit/test.h"
+#include "sim/netConnection.h"
+#include "sim/netObject.h"
+#include "core/stream/bitStream.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+namespace
+{
+   /// Packs and unpacks a list of values.
+   class TestSnapshotObject : public NetObject
+   {
+   public:
+      typedef NetObject Parent;
+
+      Vector< U32 > mValues;
+
+      TestSnapshotObject()
+      {
+         mNetFlags.set( Ghostable | ScopeAlways );
+      }
+
+      virtual U32 packUpdate( NetConnection* conn, U32 mask, BitStream* stream )
+      {
+         stream->writeInt( mValues.size(), 8 );
+         for( U32 i = 0; i < mValues.size(); ++ i )
+            stream->writeInt( mValues[ i ], 31 );
+         return 0;
+      }
+
+      virtual void unpackUpdate( NetConnection* conn, BitStream* stream )
+      {
+         mValues.setSize( stream->readInt( 8 ) );
+         for( U32 i = 0; i < mValues.size(); ++ i )
+            mValues[ i ] = stream->readInt( 31 );
+      }
+   };
+
+   /// Exposes the snapshot reading and writing of a connection that is
+   /// never registered.
+   class TestSnapshotConnection : public NetConnection
+   {
+   public:
+      using NetConnection::ghostWriteSnapshot;
+      using NetConnection::ghostReadSnapshot;
+      using NetConnection::ghostPacketReceived;
+      using NetConnection::ghostPacketDropped;
+      using NetConnection::clearGhostInfo;
+      using NetConnection::mGhostArray;
+      using NetConnection::mLocalGhosts;
+
+      void beginScoping() { mScoping = true; }
+   };
+}
+
+// Sends a ghost's updates as snapshots from a server to a client connection
+// and checks when they are sent raw or as deltas against the acked baseline,
+// including after the baseline's slot has been reused.
+
+CreateUnitTest( TestNetGhostSnapshots, "Sim/NetConnection/GhostSnapshots" )
+{
+   TestSnapshotConnection* mServer;
+   TestSnapshotConnection* mClient;
+   TestSnapshotObject* mServerObject;
+   TestSnapshotObject* mClientObject;
+   GhostInfo* mInfo;
+
+   /// Notify of the last update written.
+   NetConnection::PacketNotify* mNotify;
+
+   /// Write an update and have the client read it.  Returns true if the
+   /// update was sent as a delta.
+   bool sendUpdate( U32 expectedNumber )
+   {
+      U8 buffer[ Net::MaxPacketDataSize ];
+      BitStream stream( buffer, sizeof( buffer ) );
+
+      NetConnection::GhostRef* ref = new NetConnection::GhostRef;
+      ref->mask = 0;
+      ref->ghostInfoFlags = 0;
+      ref->ghost = mInfo;
+      ref->nextRef = NULL;
+      ref->nextUpdateChain = mInfo->updateChain;
+      mInfo->updateChain = ref;
+
+      mNotify = new NetConnection::PacketNotify;
+      mNotify->ghostList = ref;
+
+      mServer->ghostWriteSnapshot( mInfo, 0xFFFFFFFF, &stream, ref );
+      const U32 bitCount = stream.getCurPos();
+      test( ref->snapshot == S32( expectedNumber ), "unexpected snapshot number" );
+
+      stream.setCurPos( 0 );
+      test( U32( stream.readInt( NetConnection::GhostSnapshotSlotBitSize ) ) == expectedNumber % NetConnection::GhostSnapshotSlotCount, "wrong snapshot slot" );
+      const bool delta = stream.readFlag();
+
+      stream.setCurPos( 0 );
+      mClientObject->mValues.clear();
+      test( mClient->ghostReadSnapshot( 0, &stream ), "snapshot rejected by the client" );
+      test( U32( stream.getCurPos() ) == bitCount, "snapshot read size mismatch" );
+
+      bool same = mClientObject->mValues.size() == mServerObject->mValues.size();
+      for( U32 i = 0; same && i < mServerObject->mValues.size(); ++ i )
+         same = mClientObject->mValues[ i ] == mServerObject->mValues[ i ];
+      test( same, "client state differs from server state" );
+
+      return delta;
+   }
+
+   void ack()
+   {
+      mServer->ghostPacketReceived( mNotify );
+      delete mNotify;
+      mNotify = NULL;
+   }
+
+   void drop()
+   {
+      mServer->ghostPacketDropped( mNotify );
+      delete mNotify;
+      mNotify = NULL;
+   }
+
+   void run()
+   {
+      mServerObject = new TestSnapshotObject;
+      mClientObject = new TestSnapshotObject;
+      for( U32 i = 0; i < 40; ++ i )
+         mServerObject->mValues.push_back( i * 1000 );
+
+      mServer = new TestSnapshotConnection;
+      mServer->setGhostFrom( true );
+      mServer->setGhostSnapshots( true );
+      mServer->beginScoping();
+      mServer->objectInScope( mServerObject );
+      mInfo = mServer->mGhostArray[ 0 ];
+
+      mClient = new TestSnapshotConnection;
+      mClient->setGhostTo( true );
+      mClient->setGhostSnapshots( true );
+      mClient->mLocalGhosts[ 0 ] = mClientObject;
+
+      // Nothing acked yet, so the updates go raw.
+      test( !sendUpdate( 0 ), "update without a baseline sent as a delta" );
+      drop();
+      test( !sendUpdate( 1 ), "update without a baseline sent as a delta" );
+      ack();
+
+      // Acked snapshot 1 is the baseline until its slot is reused by
+      // snapshot 9.  The acks of the updates in between get lost.
+      for( U32 number = 2; number < 2 + NetConnection::GhostSnapshotSlotCount; ++ number )
+      {
+         mServerObject->mValues[ number ] ++;
+         const bool delta = sendUpdate( number );
+         if( number - 1 < NetConnection::GhostSnapshotSlotCount )
+            test( delta, "small change not sent as a delta" );
+         else
+            test( !delta, "update sent as a delta against a reused slot" );
+         drop();
+      }
+
+      // Acking snapshot 10 makes it the baseline.  Growing the state
+      // changes the size in the delta.
+      sendUpdate( 10 );
+      ack();
+      mServerObject->mValues.push_back( 12345 );
+      test( sendUpdate( 11 ), "update after an ack not sent as a delta" );
+      ack();
+
+      // A delta that isn't smaller than the update falls back to raw.
+      for( U32 i = 0; i < mServerObject->mValues.size(); ++ i )
+         mServerObject->mValues[ i ] = ( mServerObject->mValues[ i ] * 2654435761U + 1 ) & 0x7FFFFFFF;
+      test( !sendUpdate( 12 ), "larger delta sent instead of the raw update" );
+      ack();
+
+      mClient->mLocalGhosts[ 0 ] = NULL;
+      mServer->clearGhostInfo();
+      delete mServer;
+      delete mClient;
+      delete mServerObject;
+      delete mClientObject;
+   }
+};
+
+#endif // !TORQUE_SHIPPING
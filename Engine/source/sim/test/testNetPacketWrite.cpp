@@ -0,0 +1,214 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "unit/test.h"
+#include "sim/netConnection.h"
+#include "sim/netObject.h"
+#include "core/stream/bitStream.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+namespace
+{
+   /// Packs an update that depends on its index and mask.  Every few
+   /// objects packs with state that isn't thread safe.
+   class TestPacketWriteObject : public NetObject
+   {
+   public:
+      typedef NetObject Parent;
+
+      U32 mIndex;
+
+      TestPacketWriteObject( U32 index )
+         : mIndex( index )
+      {
+         mNetFlags.set( Ghostable | ScopeAlways );
+      }
+
+      virtual F32 getUpdatePriority( CameraScopeQuery*, U32, S32 updateSkips )
+      {
+         return F32( mIndex % 7 ) + F32( updateSkips ) * 0.5f;
+      }
+
+      virtual bool isPackUpdateThreadSafe( U32 mask ) const
+      {
+         return ( mIndex % 50 ) != 49;
+      }
+
+      virtual U32 packUpdate( NetConnection* conn, U32 mask, BitStream* stream )
+      {
+         stream->writeInt( mIndex, 16 );
+         if( stream->writeFlag( mask & 1 ) )
+            stream->writeCompressedPoint( Point3F( F32( mIndex ), F32( mIndex % 13 ), 2.0f ) );
+         if( stream->writeFlag( mask & 2 ) )
+         {
+            for( U32 i = 0; i < mIndex % 5; ++ i )
+               stream->writeInt( mIndex * 31 + i, 24 );
+         }
+
+         // Leave some of the objects dirty for the next packet.
+         return ( mIndex % 3 ) == 0 ? ( mask & 2 ) : 0;
+      }
+   };
+
+   /// Exposes the ghosting state of a connection that is never registered.
+   class TestPacketWriteConnection : public NetConnection
+   {
+   public:
+      using NetConnection::allocNotify;
+      using NetConnection::ghostWritePacket;
+      using NetConnection::ghostPacketReceived;
+      using NetConnection::ghostWriteUpdatesParallel;
+      using NetConnection::clearGhostInfo;
+
+      void beginGhosting( const Vector< TestPacketWriteObject* >& objects, bool snapshots )
+      {
+         setGhostFrom( true );
+         setGhostSnapshots( snapshots );
+         mGhosting = true;
+         mScoping = true;
+         for( U32 i = 0; i < objects.size(); ++ i )
+            objectInScope( objects[ i ] );
+
+         // Treat the ghosts as created on the client already so the
+         // test objects don't need a net class ID.
+         for( U32 i = 0; i < mGhostFreeIndex; ++ i )
+            mGhostArray[ i ]->flags &= ~GhostInfo::NotYetGhosted;
+      }
+
+      void setDeferGhostUpdates( bool defer ) { mDeferGhostUpdates = defer; }
+   };
+}
+
+// Writes the same ghost updates for a set of connections serially and
+// through ghostWriteUpdatesParallel() and checks that the packets are
+// identical bit for bit.
+
+CreateUnitTest( TestNetPacketWriteParallel, "Sim/NetConnection/PacketWriteParallel" )
+{
+   enum
+   {
+      NumConnections = 8,
+      NumObjects = 300,
+      NumPackets = 4,
+      PacketSize = 400,
+   };
+
+   struct Packet
+   {
+      U8 buffer[ Net::MaxPacketDataSize ];
+      BitStream stream;
+      NetConnection::PacketNotify* notify;
+
+      Packet()
+         : stream( NULL, 0 )
+      {
+         dMemset( buffer, 0, sizeof( buffer ) );
+         stream.setBuffer( buffer, PacketSize, Net::MaxPacketDataSize );
+         stream.setCompressionPoint( Point3F( 10.0f, 20.0f, 0.0f ) );
+      }
+   };
+
+   void testWrites( bool snapshots )
+   {
+      Vector< TestPacketWriteObject* > objects;
+      for( U32 i = 0; i < NumObjects; ++ i )
+         objects.push_back( new TestPacketWriteObject( i ) );
+
+      TestPacketWriteConnection* serial[ NumConnections ];
+      TestPacketWriteConnection* parallel[ NumConnections ];
+      for( U32 i = 0; i < NumConnections; ++ i )
+      {
+         serial[ i ] = new TestPacketWriteConnection;
+         parallel[ i ] = new TestPacketWriteConnection;
+         serial[ i ]->beginGhosting( objects, snapshots );
+         parallel[ i ]->beginGhosting( objects, snapshots );
+      }
+
+      bool same = true;
+      for( U32 n = 0; n < NumPackets; ++ n )
+      {
+         Packet* serialPackets = new Packet[ NumConnections ];
+         Packet* parallelPackets = new Packet[ NumConnections ];
+
+         for( U32 i = 0; i < NumConnections; ++ i )
+         {
+            serialPackets[ i ].notify = serial[ i ]->allocNotify();
+            serial[ i ]->ghostWritePacket( &serialPackets[ i ].stream, serialPackets[ i ].notify );
+
+            parallelPackets[ i ].notify = parallel[ i ]->allocNotify();
+            parallel[ i ]->setDeferGhostUpdates( true );
+            parallel[ i ]->ghostWritePacket( &parallelPackets[ i ].stream, parallelPackets[ i ].notify );
+            parallel[ i ]->setDeferGhostUpdates( false );
+
+            // Move the compression point like writePacket() would after the
+            // ghost packet has been started.
+            parallelPackets[ i ].stream.setCompressionPoint( Point3F( 0.0f, 0.0f, 0.0f ) );
+         }
+
+         NetConnection* connections[ NumConnections ];
+         for( U32 i = 0; i < NumConnections; ++ i )
+            connections[ i ] = parallel[ i ];
+         TestPacketWriteConnection::ghostWriteUpdatesParallel( connections, NumConnections );
+
+         for( U32 i = 0; i < NumConnections; ++ i )
+         {
+            const S32 bits = serialPackets[ i ].stream.getBitPosition();
+            if( bits != parallelPackets[ i ].stream.getBitPosition() ||
+                dMemcmp( serialPackets[ i ].buffer, parallelPackets[ i ].buffer, ( bits + 7 ) >> 3 ) != 0 )
+               same = false;
+
+            // Ack the packets so the next ones start from the sent state.
+            serial[ i ]->ghostPacketReceived( serialPackets[ i ].notify );
+            parallel[ i ]->ghostPacketReceived( parallelPackets[ i ].notify );
+            delete serialPackets[ i ].notify;
+            delete parallelPackets[ i ].notify;
+         }
+
+         delete [] serialPackets;
+         delete [] parallelPackets;
+      }
+
+      test( same, snapshots ? "parallel packets with snapshots differ from serial ones" : "parallel packets differ from serial ones" );
+
+      for( U32 i = 0; i < NumConnections; ++ i )
+      {
+         serial[ i ]->clearGhostInfo();
+         parallel[ i ]->clearGhostInfo();
+         delete serial[ i ];
+         delete parallel[ i ];
+      }
+      for( U32 i = 0; i < objects.size(); ++ i )
+         delete objects[ i ];
+   }
+
+   void run()
+   {
+      testWrites( false );
+      testWrites( true );
+   }
+};
+
+#endif // !TORQUE_SHIPPING
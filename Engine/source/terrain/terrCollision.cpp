@@ -591,22 +591,18 @@ bool TerrainBlock::buildPolyList(PolyListContext, AbstractPolyList* polyList, co
 
 //----------------------------------------------------------------------------
 
-static F32 calcInterceptV(F32 vStart, F32 invDeltaV, F32 intercept)
-{
-   return (intercept - vStart) * invDeltaV;
-}
+// The ray casts below keep no state outside of the call so that they can
+// run on several threads at once against a frozen scene container.
 
-static F32 calcInterceptNone(F32, F32, F32)
+/// Return the ray parameter at which the ray crosses @a intercept along one
+/// axis or MAX_FLOAT if the ray does not move along it (@a invDeltaV is 0).
+static inline F32 calcIntercept(F32 vStart, F32 invDeltaV, F32 intercept)
 {
-   return MAX_FLOAT;
+   if(invDeltaV == 0)
+      return MAX_FLOAT;
+   return (intercept - vStart) * invDeltaV;
 }
 
-static F32 (*calcInterceptX)(F32, F32, F32);
-static F32 (*calcInterceptY)(F32, F32, F32);
-
-static U32 lineCount;
-static Point3F lineStart, lineEnd;
-
 bool TerrainBlock::castRay(const Point3F &start, const Point3F &end, RayInfo *info)
 {
 	PROFILE_SCOPE( TerrainBlock_castRay );
@@ -628,10 +624,6 @@ bool TerrainBlock::castRay(const Point3F &start, const Point3F &end, RayInfo *in
 
 bool TerrainBlock::castRayI(const Point3F &start, const Point3F &end, RayInfo *info, bool collideEmpty)
 {
-   lineCount = 0;
-   lineStart = start;
-   lineEnd = end;
-
    info->object = this;
 
    if(start.x == end.x && start.y == end.y)
@@ -664,14 +656,12 @@ bool TerrainBlock::castRayI(const Point3F &start, const Point3F &end, RayInfo *i
    F32 invDeltaX;
    if(pEnd.x == pStart.x)
    {
-      calcInterceptX = calcInterceptNone;
       invDeltaX = 0;
       dx = 0;
    }
    else
    {
       invDeltaX = 1 / (pEnd.x - pStart.x);
-      calcInterceptX = calcInterceptV;
       if(pEnd.x < pStart.x)
          dx = -1;
       else
@@ -681,14 +671,12 @@ bool TerrainBlock::castRayI(const Point3F &start, const Point3F &end, RayInfo *i
    F32 invDeltaY;
    if(pEnd.y == pStart.y)
    {
-      calcInterceptY = calcInterceptNone;
       invDeltaY = 0;
       dy = 0;
    }
    else
    {
       invDeltaY = 1 / (pEnd.y - pStart.y);
-      calcInterceptY = calcInterceptV;
       if(pEnd.y < pStart.y)
          dy = -1;
       else
@@ -701,8 +689,8 @@ bool TerrainBlock::castRayI(const Point3F &start, const Point3F &end, RayInfo *i
    F32 startT = 0;
    for(;;)
    {
-      F32 nextXInt = calcInterceptX(pStart.x, invDeltaX, (F32)(blockX + (dx == 1)));
-      F32 nextYInt = calcInterceptY(pStart.y, invDeltaY, (F32)(blockY + (dy == 1)));
+      F32 nextXInt = calcIntercept(pStart.x, invDeltaX, (F32)(blockX + (dx == 1)));
+      F32 nextYInt = calcIntercept(pStart.y, invDeltaY, (F32)(blockY + (dy == 1)));
 
       F32 intersectT = 1;
 
@@ -753,6 +741,10 @@ struct TerrLOSStackNode
    U32 level;
 };
 
+/// Each level pushes at most three nodes, and mFile->mSize is a U32 so
+/// there can't be more than 32 grid levels.
+static const U32 TerrLOSMaxStackSize = 32 * 3 + 1;
+
 bool TerrainBlock::castRayBlock( const Point3F &pStart, 
                                  const Point3F &pEnd, 
                                  const Point2I &aBlockPos, 
@@ -770,8 +762,8 @@ bool TerrainBlock::castRayBlock( const Point3F &pStart,
 
    F32 invBlockSize = 1 / F32( BlockSquareWidth );
 
-   static Vector<TerrLOSStackNode> stack;
-   stack.setSize( GridLevels * 3 + 1 );
+   AssertFatal( GridLevels * 3 + 1 <= TerrLOSMaxStackSize, "TerrainBlock::castRayBlock - Too many grid levels" );
+   TerrLOSStackNode stack[ TerrLOSMaxStackSize ];
    U32 stackSize = 1;
 
    stack[0].startT = aStartT;
@@ -784,7 +776,7 @@ bool TerrainBlock::castRayBlock( const Point3F &pStart,
 
    while(stackSize--)
    {
-      TerrLOSStackNode *sn = stack.address() + stackSize;
+      TerrLOSStackNode *sn = stack + stackSize;
       U32 level  = sn->level;
       F32 startT = sn->startT;
       F32 endT   = sn->endT;
@@ -893,9 +885,9 @@ bool TerrainBlock::castRayBlock( const Point3F &pStart,
       }
       int subSqWidth = 1 << (level - 1);
       F32 xIntercept = (blockPos.x + subSqWidth) * invBlockSize;
-      F32 xInt = calcInterceptX(pStart.x, invDeltaX, xIntercept);
+      F32 xInt = calcIntercept(pStart.x, invDeltaX, xIntercept);
       F32 yIntercept = (blockPos.y + subSqWidth) * invBlockSize;
-      F32 yInt = calcInterceptY(pStart.y, invDeltaY, yIntercept);
+      F32 yInt = calcIntercept(pStart.y, invDeltaY, yIntercept);
 
       F32 startX = startT * (pEnd.x - pStart.x) + pStart.x;
       F32 startY = startT * (pEnd.y - pStart.y) + pStart.y;
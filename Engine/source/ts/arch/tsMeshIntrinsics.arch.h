@@ -27,6 +27,8 @@
 # // x86 CPU family implementations
 extern void zero_vert_normal_bulk_SSE(const dsize_t count, U8 * __restrict const outPtr, const dsize_t outStride);
 extern void m_matF_x_BatchedVertWeightList_SSE(const MatrixF &mat, const dsize_t count, const TSSkinMesh::BatchData::BatchedVertWeight * __restrict batch, U8 * const __restrict outPtr, const dsize_t outStride);
+extern S32 castRay_TriangleBlocks_SSE(const Point3F &start, const Point3F &dir, const TSTriangleBlock * __restrict blocks, const dsize_t numTriangles, F32 &inOutT);
+extern U32 triBoxOverlap_TriangleBlocks_SSE(const Point3F &center, const Point3F &halfSize, const TSTriangleBlock * __restrict blocks, const dsize_t numTriangles, U8 * __restrict outOverlap);
 #if (_MSC_VER >= 1500)
 extern void m_matF_x_BatchedVertWeightList_SSE4(const MatrixF &mat, const dsize_t count, const TSSkinMesh::BatchData::BatchedVertWeight * __restrict batch, U8 * const __restrict outPtr, const dsize_t outStride);
 #endif
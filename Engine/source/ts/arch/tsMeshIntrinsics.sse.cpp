@@ -180,4 +180,214 @@ void m_matF_x_BatchedVertWeightList_SSE(const MatrixF &mat,
    }
 }
 
+//------------------------------------------------------------------------------
+
+S32 castRay_TriangleBlocks_SSE(const Point3F &start, const Point3F &dir, const TSTriangleBlock * __restrict blocks, const dsize_t numTriangles, F32 &inOutT)
+{
+   const __m128 signMask = _mm_set1_ps(-0.0f);
+   const __m128 zero = _mm_setzero_ps();
+   const __m128 one = _mm_set1_ps(1.0f);
+   const __m128 epsilon = _mm_set1_ps(0.00001f);
+
+   const __m128 ox = _mm_set1_ps(start.x);
+   const __m128 oy = _mm_set1_ps(start.y);
+   const __m128 oz = _mm_set1_ps(start.z);
+   const __m128 dx = _mm_set1_ps(dir.x);
+   const __m128 dy = _mm_set1_ps(dir.y);
+   const __m128 dz = _mm_set1_ps(dir.z);
+
+   S32 best = -1;
+   F32 bestT = inOutT;
+   __m128 vBestT = _mm_set1_ps(bestT);
+
+   const dsize_t numBlocks = (numTriangles + 3) >> 2;
+   for(dsize_t i = 0; i < numBlocks; i++)
+   {
+      const TSTriangleBlock &block = blocks[i];
+
+      const __m128 v0x = _mm_loadu_ps(block.v0[0]);
+      const __m128 v0y = _mm_loadu_ps(block.v0[1]);
+      const __m128 v0z = _mm_loadu_ps(block.v0[2]);
+
+      // Edges sharing v0
+      const __m128 e1x = _mm_sub_ps(_mm_loadu_ps(block.v1[0]), v0x);
+      const __m128 e1y = _mm_sub_ps(_mm_loadu_ps(block.v1[1]), v0y);
+      const __m128 e1z = _mm_sub_ps(_mm_loadu_ps(block.v1[2]), v0z);
+      const __m128 e2x = _mm_sub_ps(_mm_loadu_ps(block.v2[0]), v0x);
+      const __m128 e2y = _mm_sub_ps(_mm_loadu_ps(block.v2[1]), v0y);
+      const __m128 e2z = _mm_sub_ps(_mm_loadu_ps(block.v2[2]), v0z);
+
+      // pvec = dir x edge2
+      const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+      const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+      const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+
+      const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+
+      // Flip u and v by the sign of the determinant so both sides of the
+      // triangle are tested against |det|.
+      const __m128 detSign = _mm_and_ps(det, signMask);
+      const __m128 absDet = _mm_andnot_ps(signMask, det);
+
+      const __m128 tx = _mm_sub_ps(ox, v0x);
+      const __m128 ty = _mm_sub_ps(oy, v0y);
+      const __m128 tz = _mm_sub_ps(oz, v0z);
+
+      const __m128 u = _mm_xor_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), detSign);
+
+      // qvec = tvec x edge1
+      const __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+      const __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+      const __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+
+      const __m128 v = _mm_xor_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), detSign);
+
+      __m128 hit = _mm_cmpgt_ps(absDet, epsilon);
+      hit = _mm_and_ps(hit, _mm_cmpge_ps(u, zero));
+      hit = _mm_and_ps(hit, _mm_cmple_ps(u, absDet));
+      hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+      hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), absDet));
+
+      if(_mm_movemask_ps(hit) == 0)
+         continue;
+
+      const __m128 t = _mm_div_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), det);
+      hit = _mm_and_ps(hit, _mm_cmpge_ps(t, zero));
+      hit = _mm_and_ps(hit, _mm_cmple_ps(t, one));
+      hit = _mm_and_ps(hit, _mm_cmplt_ps(t, vBestT));
+
+      const S32 hitBits = _mm_movemask_ps(hit);
+      if(hitBits == 0)
+         continue;
+
+      F32 hitT[4];
+      _mm_storeu_ps(hitT, t);
+      for(U32 lane = 0; lane < 4; lane++)
+      {
+         const dsize_t index = (i << 2) + lane;
+         if((hitBits & (1 << lane)) && index < numTriangles && hitT[lane] < bestT)
+         {
+            bestT = hitT[lane];
+            best = index;
+         }
+      }
+
+      vBestT = _mm_set1_ps(bestT);
+   }
+
+   if(best != -1)
+      inOutT = bestT;
+
+   return best;
+}
+
+//------------------------------------------------------------------------------
+
+U32 triBoxOverlap_TriangleBlocks_SSE(const Point3F &center, const Point3F &halfSize, const TSTriangleBlock * __restrict blocks, const dsize_t numTriangles, U8 * __restrict outOverlap)
+{
+   const __m128 signMask = _mm_set1_ps(-0.0f);
+
+   const __m128 cx = _mm_set1_ps(center.x);
+   const __m128 cy = _mm_set1_ps(center.y);
+   const __m128 cz = _mm_set1_ps(center.z);
+   const __m128 hx = _mm_set1_ps(halfSize.x);
+   const __m128 hy = _mm_set1_ps(halfSize.y);
+   const __m128 hz = _mm_set1_ps(halfSize.z);
+
+   U32 count = 0;
+
+   const dsize_t numBlocks = (numTriangles + 3) >> 2;
+   for(dsize_t i = 0; i < numBlocks; i++)
+   {
+      const TSTriangleBlock &block = blocks[i];
+
+      // Move everything so that the box center is at the origin
+      const __m128 v0x = _mm_sub_ps(_mm_loadu_ps(block.v0[0]), cx);
+      const __m128 v0y = _mm_sub_ps(_mm_loadu_ps(block.v0[1]), cy);
+      const __m128 v0z = _mm_sub_ps(_mm_loadu_ps(block.v0[2]), cz);
+      const __m128 v1x = _mm_sub_ps(_mm_loadu_ps(block.v1[0]), cx);
+      const __m128 v1y = _mm_sub_ps(_mm_loadu_ps(block.v1[1]), cy);
+      const __m128 v1z = _mm_sub_ps(_mm_loadu_ps(block.v1[2]), cz);
+      const __m128 v2x = _mm_sub_ps(_mm_loadu_ps(block.v2[0]), cx);
+      const __m128 v2y = _mm_sub_ps(_mm_loadu_ps(block.v2[1]), cy);
+      const __m128 v2z = _mm_sub_ps(_mm_loadu_ps(block.v2[2]), cz);
+
+      // Separating axis tests as in triBoxOverlap().  A lane is set once
+      // any axis separates its triangle from the box.
+      __m128 separated = _mm_setzero_ps();
+
+      #define TRIBOX_AXISTEST(p0, p1, p2, rad) \
+         { \
+            const __m128 pMin = _mm_min_ps(_mm_min_ps(p0, p1), p2); \
+            const __m128 pMax = _mm_max_ps(_mm_max_ps(p0, p1), p2); \
+            separated = _mm_or_ps(separated, _mm_cmpgt_ps(pMin, rad)); \
+            separated = _mm_or_ps(separated, _mm_cmplt_ps(pMax, _mm_xor_ps(rad, signMask))); \
+         }
+
+      // The cross product of each edge with the x, y and z axes
+      #define TRIBOX_EDGETESTS(ex, ey, ez) \
+         { \
+            const __m128 fex = _mm_andnot_ps(signMask, ex); \
+            const __m128 fey = _mm_andnot_ps(signMask, ey); \
+            const __m128 fez = _mm_andnot_ps(signMask, ez); \
+            TRIBOX_AXISTEST(_mm_sub_ps(_mm_mul_ps(ez, v0y), _mm_mul_ps(ey, v0z)), \
+                            _mm_sub_ps(_mm_mul_ps(ez, v1y), _mm_mul_ps(ey, v1z)), \
+                            _mm_sub_ps(_mm_mul_ps(ez, v2y), _mm_mul_ps(ey, v2z)), \
+                            _mm_add_ps(_mm_mul_ps(fez, hy), _mm_mul_ps(fey, hz))); \
+            TRIBOX_AXISTEST(_mm_sub_ps(_mm_mul_ps(ex, v0z), _mm_mul_ps(ez, v0x)), \
+                            _mm_sub_ps(_mm_mul_ps(ex, v1z), _mm_mul_ps(ez, v1x)), \
+                            _mm_sub_ps(_mm_mul_ps(ex, v2z), _mm_mul_ps(ez, v2x)), \
+                            _mm_add_ps(_mm_mul_ps(fez, hx), _mm_mul_ps(fex, hz))); \
+            TRIBOX_AXISTEST(_mm_sub_ps(_mm_mul_ps(ey, v0x), _mm_mul_ps(ex, v0y)), \
+                            _mm_sub_ps(_mm_mul_ps(ey, v1x), _mm_mul_ps(ex, v1y)), \
+                            _mm_sub_ps(_mm_mul_ps(ey, v2x), _mm_mul_ps(ex, v2y)), \
+                            _mm_add_ps(_mm_mul_ps(fey, hx), _mm_mul_ps(fex, hy))); \
+         }
+
+      const __m128 e0x = _mm_sub_ps(v1x, v0x);
+      const __m128 e0y = _mm_sub_ps(v1y, v0y);
+      const __m128 e0z = _mm_sub_ps(v1z, v0z);
+      const __m128 e1x = _mm_sub_ps(v2x, v1x);
+      const __m128 e1y = _mm_sub_ps(v2y, v1y);
+      const __m128 e1z = _mm_sub_ps(v2z, v1z);
+      const __m128 e2x = _mm_sub_ps(v0x, v2x);
+      const __m128 e2y = _mm_sub_ps(v0y, v2y);
+      const __m128 e2z = _mm_sub_ps(v0z, v2z);
+
+      TRIBOX_EDGETESTS(e0x, e0y, e0z);
+      TRIBOX_EDGETESTS(e1x, e1y, e1z);
+      TRIBOX_EDGETESTS(e2x, e2y, e2z);
+
+      // The box axes, i.e. the bounds of the triangle against the box
+      TRIBOX_AXISTEST(v0x, v1x, v2x, hx);
+      TRIBOX_AXISTEST(v0y, v1y, v2y, hy);
+      TRIBOX_AXISTEST(v0z, v1z, v2z, hz);
+
+      #undef TRIBOX_EDGETESTS
+      #undef TRIBOX_AXISTEST
+
+      // The plane of the triangle
+      const __m128 nx = _mm_sub_ps(_mm_mul_ps(e0y, e1z), _mm_mul_ps(e0z, e1y));
+      const __m128 ny = _mm_sub_ps(_mm_mul_ps(e0z, e1x), _mm_mul_ps(e0x, e1z));
+      const __m128 nz = _mm_sub_ps(_mm_mul_ps(e0x, e1y), _mm_mul_ps(e0y, e1x));
+      const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, v0x), _mm_mul_ps(ny, v0y)), _mm_mul_ps(nz, v0z));
+      const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, nx), hx),
+                                             _mm_mul_ps(_mm_andnot_ps(signMask, ny), hy)),
+                                             _mm_mul_ps(_mm_andnot_ps(signMask, nz), hz));
+      separated = _mm_or_ps(separated, _mm_cmpgt_ps(d, r));
+      separated = _mm_or_ps(separated, _mm_cmplt_ps(d, _mm_xor_ps(r, signMask)));
+
+      const S32 overlapBits = ~_mm_movemask_ps(separated);
+      for(U32 lane = 0; lane < 4; lane++)
+      {
+         const dsize_t index = (i << 2) + lane;
+         const U8 overlaps = ((overlapBits & (1 << lane)) && index < numTriangles) ? 1 : 0;
+         outOverlap[index] = overlaps;
+         count += overlaps;
+      }
+   }
+
+   return count;
+}
+
 #endif // TORQUE_CPU_X86
\ No newline at end of file
@@ -0,0 +1,235 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "console/console.h"
+#include "ts/tsMesh.h"
+#include "ts/tsMeshIntrinsics.h"
+#include "collision/concretePolyList.h"
+#include "collision/collision.h"
+#include "util/triRayCheck.h"
+#include "util/triBoxCheck.h"
+#include "math/mRandom.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+using namespace UnitTesting;
+
+namespace {
+
+   /// A bumpy grid of triangles which never has a shape.
+   class BVHTestMesh : public TSMesh
+   {
+      public:
+
+         /// A copy of the vertices of every triangle for the brute force checks.
+         Vector< Point3F > mTriangleVerts;
+
+         BVHTestMesh( MRandomLCG &rand, U32 gridSize )
+         {
+            mVertSize = sizeof( __TSMeshVertexBase );
+
+            for ( U32 y = 0; y <= gridSize; y++ )
+            {
+               for ( U32 x = 0; x <= gridSize; x++ )
+               {
+                  verts.push_back( Point3F( x, y, rand.randF( 0.0f, 2.0f ) ) );
+                  norms.push_back( Point3F( 0, 0, 1 ) );
+                  tangents.push_back( Point4F( 1, 0, 0, 1 ) );
+                  tverts.push_back( Point2F( 0, 0 ) );
+               }
+            }
+
+            for ( U32 y = 0; y < gridSize; y++ )
+            {
+               for ( U32 x = 0; x < gridSize; x++ )
+               {
+                  const U32 idx = y * ( gridSize + 1 ) + x;
+                  const U32 quad[6] = { idx, idx + 1, idx + gridSize + 2, idx, idx + gridSize + 2, idx + gridSize + 1 };
+                  for ( U32 i = 0; i < 6; i++ )
+                  {
+                     indices.push_back( quad[i] );
+                     mTriangleVerts.push_back( verts[ quad[i] ] );
+                  }
+               }
+            }
+
+            TSDrawPrimitive draw;
+            draw.start = 0;
+            draw.numElements = indices.size();
+            draw.matIndex = TSDrawPrimitive::Triangles | TSDrawPrimitive::Indexed;
+            primitives.push_back( draw );
+
+            numFrames = 1;
+            numMatFrames = 1;
+            vertsPerFrame = verts.size();
+
+            convertToAlignedMeshData();
+         }
+
+         U32 getNumTriangles() const { return mTriangleVerts.size() / 3; }
+
+         bool castRayBruteForce( const Point3F &start, const Point3F &end, F32 &outT ) const
+         {
+            const Point3F dir = end - start;
+            bool found = false;
+            outT = F32_MAX;
+            for ( U32 i = 0; i < getNumTriangles(); i++ )
+            {
+               F32 t;
+               Point2F bary;
+               if (  castRayTriangle( start, dir, mTriangleVerts[i * 3], mTriangleVerts[i * 3 + 1], mTriangleVerts[i * 3 + 2], t, bary ) &&
+                     t < outT )
+               {
+                  outT = t;
+                  found = true;
+               }
+            }
+            return found;
+         }
+
+         U32 countOverlapsBruteForce( const Box3F &box ) const
+         {
+            Point3F center;
+            box.getCenter( &center );
+            const Point3F halfSize = box.getExtents() * 0.5f;
+
+            U32 count = 0;
+            for ( U32 i = 0; i < getNumTriangles(); i++ )
+               if ( triBoxOverlap( center, halfSize, &mTriangleVerts[i * 3] ) )
+                  count++;
+            return count;
+         }
+   };
+}
+
+CreateUnitTest( TestTSMeshTriangleBVH, "TS/Mesh/TriangleBVH" )
+{
+   void run()
+   {
+      MRandomLCG rand( 1 );
+      const U32 gridSize = 64;
+      BVHTestMesh mesh( rand, gridSize );
+
+      test( mesh.prepTriangleBlocks(), "The mesh should have triangle blocks!" );
+      test( mesh.getNumBlockTriangles() == mesh.getNumTriangles(), "Triangle count mismatch!" );
+      test( mesh.mTriangleBVH.size() > 1, "A mesh this size should have more than one node!" );
+
+      // Every leaf should start on a block and the leaves should
+      // cover every triangle exactly once.
+      U32 leafTriangles = 0;
+      bool leavesAligned = true;
+      for ( U32 i = 0; i < mesh.mTriangleBVH.size(); i++ )
+      {
+         const TSMesh::TriangleBVHNode &node = mesh.mTriangleBVH[i];
+         if ( !node.count )
+            continue;
+
+         leafTriangles += node.count;
+         leavesAligned &= ( node.first & 3 ) == 0 && node.count <= TSMesh::MaxTriangleBVHLeafSize;
+      }
+
+      test( leavesAligned, "Leaves should start on a block and not be too large!" );
+      test( leafTriangles == mesh.getNumTriangles(), "The leaves should cover every triangle!" );
+
+      // Rays, both steep and shallow, against brute force.
+      bool raysMatch = true;
+      U32 numHits = 0;
+      for ( U32 i = 0; i < 1000; i++ )
+      {
+         const Point3F start( rand.randF( -4.0f, gridSize + 4.0f ), rand.randF( -4.0f, gridSize + 4.0f ), rand.randF( 2.5f, 10.0f ) );
+         const Point3F end( rand.randF( -4.0f, gridSize + 4.0f ), rand.randF( -4.0f, gridSize + 4.0f ), rand.randF( -1.0f, 1.5f ) );
+
+         F32 expectedT;
+         const bool expected = mesh.castRayBruteForce( start, end, expectedT );
+
+         RayInfo info;
+         const bool hit = mesh.castRayRendered( 0, start, end, &info, NULL );
+
+         if ( hit != expected || ( hit && mFabs( info.t - expectedT ) > 0.0001f ) )
+            raysMatch = false;
+         if ( expected )
+            numHits++;
+      }
+
+      test( numHits > 0, "The test rays should hit something!" );
+      test( raysMatch, "castRayRendered disagrees with brute force!" );
+
+      // Boxes against brute force.
+      bool boxesMatch = true;
+      for ( U32 i = 0; i < 200; i++ )
+      {
+         const Point3F center( rand.randF( 0.0f, gridSize ), rand.randF( 0.0f, gridSize ), rand.randF( 0.0f, 2.0f ) );
+         const Point3F halfSize( rand.randF( 0.1f, 4.0f ), rand.randF( 0.1f, 4.0f ), rand.randF( 0.1f, 2.0f ) );
+         const Box3F box( center - halfSize, center + halfSize );
+
+         ConcretePolyList polyList;
+         mesh.buildPolyListOpcode( 0, &polyList, box, NULL );
+
+         if ( polyList.mPolyList.size() != mesh.countOverlapsBruteForce( box ) )
+            boxesMatch = false;
+      }
+
+      test( boxesMatch, "buildPolyListOpcode disagrees with brute force!" );
+
+      // Timings against testing every triangle block.
+      const U32 numRays = 20000;
+      MRandomLCG timingRand( 2 );
+
+      U32 start = Platform::getRealMilliseconds();
+      U32 linearHits = 0;
+      for ( U32 i = 0; i < numRays; i++ )
+      {
+         const Point3F rayStart( timingRand.randF( 0.0f, gridSize ), timingRand.randF( 0.0f, gridSize ), 10.0f );
+         const Point3F dir( timingRand.randF( -8.0f, 8.0f ), timingRand.randF( -8.0f, 8.0f ), -12.0f );
+
+         F32 t = F32_MAX;
+         if ( castRay_TriangleBlocks( rayStart, dir, mesh.mTriangleBlocks.address(), mesh.getNumBlockTriangles(), t ) != -1 )
+            linearHits++;
+      }
+      const U32 linearTime = Platform::getRealMilliseconds() - start;
+
+      timingRand.setSeed( 2 );
+
+      start = Platform::getRealMilliseconds();
+      U32 bvhHits = 0;
+      for ( U32 i = 0; i < numRays; i++ )
+      {
+         const Point3F rayStart( timingRand.randF( 0.0f, gridSize ), timingRand.randF( 0.0f, gridSize ), 10.0f );
+         const Point3F dir( timingRand.randF( -8.0f, 8.0f ), timingRand.randF( -8.0f, 8.0f ), -12.0f );
+
+         F32 t = F32_MAX;
+         if ( mesh.castRayTriangleBlocks( rayStart, dir, t ) != -1 )
+            bvhHits++;
+      }
+      const U32 bvhTime = Platform::getRealMilliseconds() - start;
+
+      test( linearHits == bvhHits, "The timed rays should hit the same number of triangles!" );
+
+      Con::printf( "   %d rays against %d triangles: linear %dms, hierarchy %dms",
+         numRays, mesh.getNumTriangles(), linearTime, bvhTime );
+   }
+};
+
+#endif // TORQUE_SHIPPING
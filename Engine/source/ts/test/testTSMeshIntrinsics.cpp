@@ -0,0 +1,177 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "unit/test.h"
+#include "console/console.h"
+#include "ts/tsMesh.h"
+#include "ts/tsMeshIntrinsics.h"
+#include "math/mRandom.h"
+
+
+#ifndef TORQUE_SHIPPING
+
+extern S32 castRay_TriangleBlocks_C(const Point3F &start, const Point3F &dir, const TSTriangleBlock * __restrict blocks, const dsize_t numTriangles, F32 &inOutT);
+extern U32 triBoxOverlap_TriangleBlocks_C(const Point3F &center, const Point3F &halfSize, const TSTriangleBlock * __restrict blocks, const dsize_t numTriangles, U8 * __restrict outOverlap);
+
+#if defined(TORQUE_CPU_X86)
+extern S32 castRay_TriangleBlocks_SSE(const Point3F &start, const Point3F &dir, const TSTriangleBlock * __restrict blocks, const dsize_t numTriangles, F32 &inOutT);
+extern U32 triBoxOverlap_TriangleBlocks_SSE(const Point3F &center, const Point3F &halfSize, const TSTriangleBlock * __restrict blocks, const dsize_t numTriangles, U8 * __restrict outOverlap);
+#endif
+
+using namespace UnitTesting;
+
+namespace {
+
+   /// Fills the blocks with small random triangles scattered through a
+   /// cube of the given size.  Every 50th triangle is degenerate.
+   void buildRandomBlocks( MRandomLCG &rand, Vector< TSTriangleBlock > &blocks, U32 numTris, F32 size )
+   {
+      blocks.setSize( ( numTris + 3 ) >> 2 );
+      dMemset( blocks.address(), 0, blocks.size() * sizeof( TSTriangleBlock ) );
+
+      for ( U32 i = 0; i < numTris; i++ )
+      {
+         TSTriangleBlock &block = blocks[i >> 2];
+         const U32 lane = i & 3;
+         F32 (*blockVerts[3])[4] = { block.v0, block.v1, block.v2 };
+
+         const Point3F center( rand.randF( 0.0f, size ), rand.randF( 0.0f, size ), rand.randF( 0.0f, size ) );
+         for ( U32 k = 0; k < 3; k++ )
+            for ( U32 axis = 0; axis < 3; axis++ )
+               blockVerts[k][axis][lane] = center[axis] + rand.randF( -0.5f, 0.5f );
+
+         if ( ( i % 50 ) == 0 )
+            for ( U32 axis = 0; axis < 3; axis++ )
+               block.v2[axis][lane] = block.v1[axis][lane];
+      }
+   }
+}
+
+CreateUnitTest( TestTSMeshTriangleBlocks, "TS/Mesh/TriangleBlocks" )
+{
+   typedef S32 ( *RayFn )( const Point3F&, const Point3F&, const TSTriangleBlock*, const dsize_t, F32& );
+   typedef U32 ( *BoxFn )( const Point3F&, const Point3F&, const TSTriangleBlock*, const dsize_t, U8* );
+
+   enum
+   {
+      NumTriangles = 1023,
+      NumQueries = 2000,
+   };
+
+   /// Checks that an implementation agrees with the C version.
+   void testImplementation( const char *name, RayFn castRayFn, BoxFn overlapFn )
+   {
+      MRandomLCG rand( 1 );
+      const F32 size = 10.0f;
+
+      Vector< TSTriangleBlock > blocks;
+      buildRandomBlocks( rand, blocks, NumTriangles, size );
+
+      bool raysMatch = true;
+      U32 numHits = 0;
+      for ( U32 i = 0; i < NumQueries; i++ )
+      {
+         const Point3F start( rand.randF( 0.0f, size ), rand.randF( 0.0f, size ), -1.0f );
+         const Point3F end( rand.randF( 0.0f, size ), rand.randF( 0.0f, size ), size + 1.0f );
+         const Point3F dir = end - start;
+
+         F32 expectedT = F32_MAX;
+         F32 t = F32_MAX;
+         const S32 expected = castRay_TriangleBlocks_C( start, dir, blocks.address(), NumTriangles, expectedT );
+         const S32 hit = castRayFn( start, dir, blocks.address(), NumTriangles, t );
+
+         if ( hit != expected || ( hit != -1 && mFabs( t - expectedT ) > 0.0001f ) )
+            raysMatch = false;
+         if ( expected != -1 )
+            numHits++;
+      }
+
+      test( numHits > 0, "The test rays should hit something!" );
+      test( raysMatch, avar( "castRay_TriangleBlocks disagrees with the C version. (%s)", name ) );
+
+      U8 expectedOverlap[NumTriangles + 3];
+      U8 overlap[NumTriangles + 3];
+      bool boxesMatch = true;
+      for ( U32 i = 0; i < NumQueries; i++ )
+      {
+         const Point3F center( rand.randF( 0.0f, size ), rand.randF( 0.0f, size ), rand.randF( 0.0f, size ) );
+         const Point3F halfSize( rand.randF( 0.1f, 1.0f ), rand.randF( 0.1f, 1.0f ), rand.randF( 0.1f, 1.0f ) );
+
+         const U32 expectedCount = triBoxOverlap_TriangleBlocks_C( center, halfSize, blocks.address(), NumTriangles, expectedOverlap );
+         const U32 count = overlapFn( center, halfSize, blocks.address(), NumTriangles, overlap );
+
+         if ( count != expectedCount || dMemcmp( overlap, expectedOverlap, NumTriangles ) != 0 )
+            boxesMatch = false;
+      }
+
+      test( boxesMatch, avar( "triBoxOverlap_TriangleBlocks disagrees with the C version. (%s)", name ) );
+   }
+
+   /// Prints the time taken by an implementation for the same set of rays.
+   U32 timeRays( RayFn castRayFn, const Vector< TSTriangleBlock > &blocks )
+   {
+      MRandomLCG rand( 2 );
+
+      const U32 start = Platform::getRealMilliseconds();
+
+      S32 sum = 0;
+      for ( U32 i = 0; i < NumQueries * 10; i++ )
+      {
+         const Point3F rayStart( rand.randF( 0.0f, 10.0f ), rand.randF( 0.0f, 10.0f ), -1.0f );
+         const Point3F dir( rand.randF( -1.0f, 1.0f ), rand.randF( -1.0f, 1.0f ), 12.0f );
+
+         F32 t = F32_MAX;
+         sum += castRayFn( rayStart, dir, blocks.address(), NumTriangles, t );
+      }
+
+      // Keep the results alive.
+      test( sum != 0x7fffffff, "Unexpected ray result" );
+
+      return Platform::getRealMilliseconds() - start;
+   }
+
+   void run()
+   {
+      testImplementation( "dispatched", castRay_TriangleBlocks, triBoxOverlap_TriangleBlocks );
+
+#if defined(TORQUE_CPU_X86)
+      if ( Platform::SystemInfo.processor.properties & CPU_PROP_SSE )
+         testImplementation( "SSE", castRay_TriangleBlocks_SSE, triBoxOverlap_TriangleBlocks_SSE );
+      else
+         warn( "Could not test SSE triangle blocks because CPU does not support SSE." );
+#endif
+
+      // Timings
+      MRandomLCG rand( 3 );
+      Vector< TSTriangleBlock > blocks;
+      buildRandomBlocks( rand, blocks, NumTriangles, 10.0f );
+
+      const U32 cTime = timeRays( castRay_TriangleBlocks_C, blocks );
+      const U32 bestTime = timeRays( castRay_TriangleBlocks, blocks );
+
+      Con::printf( "   %d rays against %d triangles: C %dms, dispatched %dms",
+         NumQueries * 10, NumTriangles, cTime, bestTime );
+   }
+};
+
+#endif // TORQUE_SHIPPING
@@ -33,6 +33,8 @@
 #include "collision/concretePolyList.h"
 #include "collision/vertexPolyList.h"
 #include "platform/profiler.h"
+#include "ts/tsMeshIntrinsics.h"
+#include "platform/threads/mutex.h"
 
 #include "opcode/Opcode.h"
 #include "opcode/Ice/IceAABB.h"
@@ -1183,6 +1185,68 @@ bool TSMesh::buildPolyListOpcode( const S32 od, AbstractPolyList *polyList, cons
 {
    PROFILE_SCOPE( TSMesh_buildPolyListOpcode );
 
+   // Standard meshes walk the triangle hierarchy and test the
+   // triangles of each leaf it reaches four at a time.
+   if ( prepTriangleBlocks() )
+   {
+      Point3F center, halfSize;
+      nodeBox.getCenter( &center );
+      halfSize = nodeBox.getExtents() * 0.5f;
+
+      U8 overlap[MaxTriangleBVHLeafSize + 3];
+      U32 plIdx[3];
+      U32 emitted = 0;
+      Point3F tmp;
+
+      U32 stack[MaxTriangleBVHDepth + 1];
+      U32 stackSize = 0;
+      stack[stackSize++] = 0;
+
+      while ( stackSize )
+      {
+         const TriangleBVHNode &node = mTriangleBVH[ stack[--stackSize] ];
+         if ( !node.box.isOverlapped( nodeBox ) )
+            continue;
+
+         if ( !node.count )
+         {
+            stack[stackSize++] = node.first;
+            stack[stackSize++] = node.first + 1;
+            continue;
+         }
+
+         if ( !triBoxOverlap_TriangleBlocks( center, halfSize, &mTriangleBlocks[node.first >> 2], node.count, overlap ) )
+            continue;
+
+         for ( U32 i = 0; i < node.count; i++ )
+         {
+            if ( !overlap[i] )
+               continue;
+
+            const U32 tri = node.first + i;
+            const TSTriangleBlock &block = mTriangleBlocks[tri >> 2];
+            const U32 lane = tri & 3;
+            const F32 (*blockVerts[3])[4] = { block.v0, block.v1, block.v2 };
+
+            // Emit in the same order and winding as the OPCODE path below.
+            polyList->begin( NULL, emitted++ );
+
+            for ( U32 j = 0; j < 3; j++ )
+            {
+               tmp.set( blockVerts[j][0][lane], blockVerts[j][1][lane], blockVerts[j][2][lane] );
+               plIdx[j] = polyList->addPoint( tmp );
+               polyList->vertex( plIdx[j] );
+            }
+
+            polyList->plane( plIdx[2], plIdx[0], plIdx[1] );
+
+            polyList->end();
+         }
+      }
+
+      return emitted > 0;
+   }
+
    // This is small... there is no win for preallocating it.
    Opcode::AABBCollider opCollider;
    opCollider.SetPrimitiveTests( true );
@@ -1481,6 +1545,332 @@ void TSMesh::prepOpcodeCollision()
    mOptTree->Build( opcc );
 }
 
+/// Guards the lazy build in TSMesh::prepTriangleBlocks().
+static Mutex sgTriangleBlocksMutex;
+
+/// Reorders the triangles so that the first k of them have a centroid
+/// no greater than the rest along the given axis.
+static void selectTriangles( U32 *tris, const Point3F *centroids, U32 axis, S32 count, S32 k )
+{
+   S32 lo = 0;
+   S32 hi = count - 1;
+   while ( lo < hi )
+   {
+      const F32 pivot = centroids[ tris[ ( lo + hi ) >> 1 ] ][axis];
+
+      S32 i = lo;
+      S32 j = hi;
+      while ( i <= j )
+      {
+         while ( centroids[ tris[i] ][axis] < pivot )
+            i++;
+         while ( centroids[ tris[j] ][axis] > pivot )
+            j--;
+
+         if ( i <= j )
+         {
+            const U32 tmp = tris[i];
+            tris[i] = tris[j];
+            tris[j] = tmp;
+            i++;
+            j--;
+         }
+      }
+
+      if ( k <= j )
+         hi = j;
+      else if ( k >= i )
+         lo = i;
+      else
+         break;
+   }
+}
+
+/// Recursively splits the triangles at the median of their centroids
+/// along the longest axis.  The split is rounded to a multiple of four
+/// so that every leaf starts on a block boundary.
+static void buildTriangleBVHNode(   Vector<TSMesh::TriangleBVHNode> &nodes, 
+                                    U32 nodeIndex,
+                                    U32 *tris, 
+                                    const Point3F *centroids, 
+                                    const Box3F *bounds,
+                                    U32 first, 
+                                    U32 count,
+                                    U32 depth )
+{
+   Box3F box = bounds[ tris[first] ];
+   Box3F centroidBox( centroids[ tris[first] ], centroids[ tris[first] ] );
+   for ( U32 i = 1; i < count; i++ )
+   {
+      box.intersect( bounds[ tris[first + i] ] );
+      centroidBox.extend( centroids[ tris[first + i] ] );
+   }
+
+   nodes[nodeIndex].box = box;
+   nodes[nodeIndex].first = first;
+   nodes[nodeIndex].count = count;
+
+   if ( count <= TSMesh::MaxTriangleBVHLeafSize || depth >= TSMesh::MaxTriangleBVHDepth - 1 )
+      return;
+
+   const Point3F extents = centroidBox.getExtents();
+   U32 axis = 0;
+   if ( extents.y > extents[axis] )
+      axis = 1;
+   if ( extents.z > extents[axis] )
+      axis = 2;
+
+   const U32 split = ( ( count >> 1 ) + 3 ) & ~3;
+   selectTriangles( tris + first, centroids, axis, count, split );
+
+   const U32 child = nodes.size();
+   nodes.increment( 2 );
+   nodes[nodeIndex].first = child;
+   nodes[nodeIndex].count = 0;
+
+   buildTriangleBVHNode( nodes, child, tris, centroids, bounds, first, split, depth + 1 );
+   buildTriangleBVHNode( nodes, child + 1, tris, centroids, bounds, first + split, count - split, depth + 1 );
+}
+
+bool TSMesh::prepTriangleBlocks()
+{
+   // castRay() runs on pool threads, so the flag is read with a barrier
+   // that keeps the reads of the blocks after it.
+   if ( dAtomicRead( mTriangleBlocksReady ) )
+      return mTriangleBlockMaterials.size() > 0;
+
+   // The vertices of the other mesh types move so there is
+   // nothing we can cache for them.
+   if ( getMeshType() != StandardMeshType )
+      return false;
+
+   MutexHandle handle;
+   handle.lock( &sgTriangleBlocksMutex, true );
+
+   // Another thread may have beaten us to it.
+   if ( dAtomicRead( mTriangleBlocksReady ) )
+      return mTriangleBlockMaterials.size() > 0;
+
+   PROFILE_SCOPE( TSMesh_PrepTriangleBlocks );
+
+   const bool useVertexData = mVertexData.isReady();
+
+   // Gather the triangles of every primitive in the same order as
+   // prepOpcodeCollision() does.
+   Vector<U32> triIndices;
+   Vector<U32> triMaterials;
+   for ( U32 i = 0; i < primitives.size(); i++ )
+   {
+      TSDrawPrimitive & draw = primitives[i];
+      const U32 start = draw.start;
+
+      AssertFatal( draw.matIndex & TSDrawPrimitive::Indexed,"TSMesh::prepTriangleBlocks (1)" );
+
+      const U32 matIndex = draw.matIndex & TSDrawPrimitive::MaterialMask;
+
+      if ( (draw.matIndex & TSDrawPrimitive::TypeMask) == TSDrawPrimitive::Triangles )
+      {
+         for ( S32 j = 0; j + 2 < draw.numElements; j += 3 )
+         {
+            triIndices.push_back( indices[start + j + 0] );
+            triIndices.push_back( indices[start + j + 1] );
+            triIndices.push_back( indices[start + j + 2] );
+            triMaterials.push_back( matIndex );
+         }
+      }
+      else
+      {
+         AssertFatal( (draw.matIndex & TSDrawPrimitive::TypeMask) == TSDrawPrimitive::Strip,"TSMesh::prepTriangleBlocks (2)" );
+
+         U32 idx0 = indices[start + 0];
+         U32 idx1;
+         U32 idx2 = indices[start + 1];
+         U32 * nextIdx = &idx1;
+         for ( S32 j = 2; j < draw.numElements; j++ )
+         {
+            *nextIdx = idx2;
+            nextIdx = (U32*) ( (dsize_t)nextIdx ^ (dsize_t)&idx0 ^ (dsize_t)&idx1);
+            idx2 = indices[start + j];
+            if ( idx0 == idx1 || idx0 == idx2 || idx1 == idx2 )
+               continue;
+
+            triIndices.push_back( idx0 );
+            triIndices.push_back( idx1 );
+            triIndices.push_back( idx2 );
+            triMaterials.push_back( matIndex );
+         }
+      }
+   }
+
+   const U32 numTris = triMaterials.size();
+   if ( numTris )
+   {
+      // Build the hierarchy over the triangle bounds and centroids.
+      Vector<U32> order( numTris );
+      Vector<Point3F> centroids( numTris );
+      Vector<Box3F> bounds( numTris );
+      order.setSize( numTris );
+      centroids.setSize( numTris );
+      bounds.setSize( numTris );
+
+      for ( U32 i = 0; i < numTris; i++ )
+      {
+         const Point3F *v[3];
+         for ( U32 k = 0; k < 3; k++ )
+         {
+            const U32 idx = triIndices[i * 3 + k];
+            v[k] = useVertexData ? &mVertexData[idx].vert() : &verts[idx];
+         }
+
+         order[i] = i;
+         centroids[i] = ( *v[0] + *v[1] + *v[2] ) / 3.0f;
+         bounds[i].minExtents = *v[0];
+         bounds[i].maxExtents = *v[0];
+         bounds[i].extend( *v[1] );
+         bounds[i].extend( *v[2] );
+      }
+
+      mTriangleBVH.setSize( 1 );
+      buildTriangleBVHNode( mTriangleBVH, 0, order.address(), centroids.address(), bounds.address(), 0, numTris, 0 );
+
+      // Now swizzle the triangles into blocks of four in leaf order.  The
+      // unused slots in the last block are left zeroed which the kernels
+      // treat as degenerate triangles.
+      mTriangleBlockIndices.setSize( numTris * 3 );
+      mTriangleBlockMaterials.setSize( numTris );
+      mTriangleBlocks.setSize( ( numTris + 3 ) >> 2 );
+      dMemset( mTriangleBlocks.address(), 0, mTriangleBlocks.size() * sizeof( TSTriangleBlock ) );
+
+      for ( U32 i = 0; i < numTris; i++ )
+      {
+         const U32 tri = order[i];
+         mTriangleBlockMaterials[i] = triMaterials[tri];
+
+         TSTriangleBlock &block = mTriangleBlocks[i >> 2];
+         const U32 lane = i & 3;
+
+         F32 (*blockVerts[3])[4] = { block.v0, block.v1, block.v2 };
+         for ( U32 k = 0; k < 3; k++ )
+         {
+            const U32 idx = triIndices[tri * 3 + k];
+            mTriangleBlockIndices[i * 3 + k] = idx;
+
+            const Point3F &vert = useVertexData ? mVertexData[idx].vert() : verts[idx];
+            blockVerts[k][0][lane] = vert.x;
+            blockVerts[k][1][lane] = vert.y;
+            blockVerts[k][2][lane] = vert.z;
+         }
+      }
+   }
+
+   // Publish the blocks with a barrier so that no thread sees the flag
+   // before all of the stores above.
+   dCompareAndSwap( mTriangleBlocksReady, 0, 1 );
+
+   return numTris > 0;
+}
+
+/// Returns the distance along the ray, as a fraction of dir, at which
+/// it enters the box or false if it misses it before maxT.
+static inline bool castRayTriangleBVHBox( const Box3F &box, const Point3F &start, const Point3F &invDir, F32 maxT, F32 &outT )
+{
+   F32 tMin = 0.0f;
+   F32 tMax = maxT;
+   for ( U32 i = 0; i < 3; i++ )
+   {
+      F32 t0 = ( box.minExtents[i] - start[i] ) * invDir[i];
+      F32 t1 = ( box.maxExtents[i] - start[i] ) * invDir[i];
+      if ( t0 > t1 )
+      {
+         const F32 tmp = t0;
+         t0 = t1;
+         t1 = tmp;
+      }
+
+      tMin = getMax( tMin, t0 );
+      tMax = getMin( tMax, t1 );
+      if ( tMin > tMax )
+         return false;
+   }
+
+   outT = tMin;
+   return true;
+}
+
+S32 TSMesh::castRayTriangleBlocks( const Point3F &start, const Point3F &dir, F32 &inOutT ) const
+{
+   AssertFatal( mTriangleBlocksReady, "TSMesh::castRayTriangleBlocks - Call prepTriangleBlocks() first!" );
+
+   if ( mTriangleBVH.empty() )
+      return -1;
+
+   // Very large rather than infinite so that a ray running
+   // along a box face doesn't produce a NaN.
+   Point3F invDir;
+   for ( U32 i = 0; i < 3; i++ )
+      invDir[i] = mFabs( dir[i] ) > POINT_EPSILON ? 1.0f / dir[i] : ( dir[i] < 0.0f ? -1.0e30f : 1.0e30f );
+
+   const F32 maxT = getMin( inOutT, 1.0f );
+
+   F32 t;
+   if ( !castRayTriangleBVHBox( mTriangleBVH[0].box, start, invDir, maxT, t ) )
+      return -1;
+
+   struct StackEntry
+   {
+      U32 node;
+      F32 t;
+   };
+
+   StackEntry stack[MaxTriangleBVHDepth + 1];
+   U32 stackSize = 0;
+   stack[stackSize].node = 0;
+   stack[stackSize].t = t;
+   stackSize++;
+
+   S32 best = -1;
+   while ( stackSize )
+   {
+      const StackEntry entry = stack[--stackSize];
+
+      // Skip nodes which are farther than the best hit so far.
+      if ( entry.t > inOutT )
+         continue;
+
+      const TriangleBVHNode &node = mTriangleBVH[entry.node];
+      if ( node.count )
+      {
+         const S32 hit = castRay_TriangleBlocks( start, dir, &mTriangleBlocks[node.first >> 2], node.count, inOutT );
+         if ( hit != -1 )
+            best = node.first + hit;
+         continue;
+      }
+
+      // Push the farther child first so the nearer one is visited next.
+      F32 t0, t1;
+      const bool hit0 = castRayTriangleBVHBox( mTriangleBVH[node.first].box, start, invDir, getMin( inOutT, maxT ), t0 );
+      const bool hit1 = castRayTriangleBVHBox( mTriangleBVH[node.first + 1].box, start, invDir, getMin( inOutT, maxT ), t1 );
+      if ( hit0 && hit1 )
+      {
+         const bool firstNearer = t0 <= t1;
+         stack[stackSize].node = firstNearer ? node.first + 1 : node.first;
+         stack[stackSize].t = firstNearer ? t1 : t0;
+         stackSize++;
+         stack[stackSize].node = firstNearer ? node.first : node.first + 1;
+         stack[stackSize].t = firstNearer ? t0 : t1;
+         stackSize++;
+      }
+      else if ( hit0 || hit1 )
+      {
+         stack[stackSize].node = hit0 ? node.first : node.first + 1;
+         stack[stackSize].t = hit0 ? t0 : t1;
+         stackSize++;
+      }
+   }
+
+   return best;
+}
+
 static Point3F	texGenAxis[18] =
 {
    Point3F(0,0,1), Point3F(1,0,0), Point3F(0,-1,0),
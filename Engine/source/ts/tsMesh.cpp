@@ -769,77 +769,95 @@ bool TSMesh::castRayRendered( S32 frame, const Point3F & start, const Point3F &
    BaseMatInstance* bestMaterial = NULL;
 	Point3F dir = end - start;
 
-   for ( S32 i = 0; i < primitives.size(); i++ )
+   if ( frame == 0 && prepTriangleBlocks() )
    {
-      TSDrawPrimitive & draw = primitives[i];
-      U32 drawStart = draw.start;
+      // The first frame of a standard mesh has its triangles cached in
+      // a hierarchy of blocks so we can skip most of them and test the
+      // rest four at a time.
+      const S32 hit = castRayTriangleBlocks( start, dir, best_t );
+      if ( hit != -1 )
+      {
+         bestIdx0 = mTriangleBlockIndices[hit * 3 + 0];
+         bestIdx1 = mTriangleBlockIndices[hit * 3 + 1];
+         bestIdx2 = mTriangleBlockIndices[hit * 3 + 2];
+         bestMaterial = ( materials ? materials->getMaterialInst( mTriangleBlockMaterials[hit] ) : 0 );
+         found = true;
+      }
+   }
+   else
+   {
+      for ( S32 i = 0; i < primitives.size(); i++ )
+      {
+         TSDrawPrimitive & draw = primitives[i];
+         U32 drawStart = draw.start;
 
-      AssertFatal( draw.matIndex & TSDrawPrimitive::Indexed,"TSMesh::castRayRendered (1)" );
+         AssertFatal( draw.matIndex & TSDrawPrimitive::Indexed,"TSMesh::castRayRendered (1)" );
 
-      U32 matIndex = draw.matIndex & TSDrawPrimitive::MaterialMask;
-      BaseMatInstance* material = ( materials ? materials->getMaterialInst( matIndex ) : 0 );
+         U32 matIndex = draw.matIndex & TSDrawPrimitive::MaterialMask;
+         BaseMatInstance* material = ( materials ? materials->getMaterialInst( matIndex ) : 0 );
 
-      U32 idx0, idx1, idx2;
+         U32 idx0, idx1, idx2;
 
-      // gonna depend on what kind of primitive it is...
-      if ( (draw.matIndex & TSDrawPrimitive::TypeMask) == TSDrawPrimitive::Triangles )
-      {
-         for ( S32 j = 0; j < draw.numElements-2; j++)
+         // gonna depend on what kind of primitive it is...
+         if ( (draw.matIndex & TSDrawPrimitive::TypeMask) == TSDrawPrimitive::Triangles )
          {
-            idx0 = indices[drawStart + j + 0];
-            idx1 = indices[drawStart + j + 1];
-            idx2 = indices[drawStart + j + 2];
-
-			   F32 cur_t = 0;
-			   Point2F b;
-
-			   if(castRayTriangle(start, dir, mVertexData[firstVert + idx0].vert(),
-               mVertexData[firstVert + idx1].vert(), mVertexData[firstVert + idx2].vert(), cur_t, b))
-			   {
-				   if(cur_t < best_t)
-				   {
-					   best_t = cur_t;
-                  bestIdx0 = idx0;
-                  bestIdx1 = idx1;
-                  bestIdx2 = idx2;
-                  bestMaterial = material;
-					   found = true;
-				   }
-			   }
-         }
-      }
-      else
-      {
-         AssertFatal( (draw.matIndex & TSDrawPrimitive::TypeMask) == TSDrawPrimitive::Strip,"TSMesh::castRayRendered (2)" );
+            for ( S32 j = 0; j < draw.numElements-2; j += 3 )
+            {
+               idx0 = indices[drawStart + j + 0];
+               idx1 = indices[drawStart + j + 1];
+               idx2 = indices[drawStart + j + 2];
 
-         idx0 = indices[drawStart + 0];
-         idx2 = indices[drawStart + 1];
-         U32 * nextIdx = &idx1;
-         for ( S32 j = 2; j < draw.numElements; j++ )
+               F32 cur_t = 0;
+               Point2F b;
+
+               if(castRayTriangle(start, dir, mVertexData[firstVert + idx0].vert(),
+                  mVertexData[firstVert + idx1].vert(), mVertexData[firstVert + idx2].vert(), cur_t, b))
+               {
+                  if(cur_t < best_t)
+                  {
+                     best_t = cur_t;
+                     bestIdx0 = firstVert + idx0;
+                     bestIdx1 = firstVert + idx1;
+                     bestIdx2 = firstVert + idx2;
+                     bestMaterial = material;
+                     found = true;
+                  }
+               }
+            }
+         }
+         else
          {
-            *nextIdx = idx2;
-            // nextIdx = (j%2)==0 ? &idx0 : &idx1;
-            nextIdx = (U32*) ( (dsize_t)nextIdx ^ (dsize_t)&idx0 ^ (dsize_t)&idx1);
-            idx2 = indices[drawStart + j];
-            if ( idx0 == idx1 || idx0 == idx2 || idx1 == idx2 )
-               continue;
+            AssertFatal( (draw.matIndex & TSDrawPrimitive::TypeMask) == TSDrawPrimitive::Strip,"TSMesh::castRayRendered (2)" );
 
-			   F32 cur_t = 0;
-			   Point2F b;
-
-			   if(castRayTriangle(start, dir, mVertexData[firstVert + idx0].vert(), 
-               mVertexData[firstVert + idx1].vert(), mVertexData[firstVert + idx2].vert(), cur_t, b))
-			   {
-				   if(cur_t < best_t)
-				   {
-					   best_t = cur_t;
-                  bestIdx0 = firstVert + idx0;
-                  bestIdx1 = firstVert + idx1;
-                  bestIdx2 = firstVert + idx2;
-                  bestMaterial = material;
-					   found = true;
-				   }
-			   }
+            idx0 = indices[drawStart + 0];
+            idx2 = indices[drawStart + 1];
+            U32 * nextIdx = &idx1;
+            for ( S32 j = 2; j < draw.numElements; j++ )
+            {
+               *nextIdx = idx2;
+               // nextIdx = (j%2)==0 ? &idx0 : &idx1;
+               nextIdx = (U32*) ( (dsize_t)nextIdx ^ (dsize_t)&idx0 ^ (dsize_t)&idx1);
+               idx2 = indices[drawStart + j];
+               if ( idx0 == idx1 || idx0 == idx2 || idx1 == idx2 )
+                  continue;
+
+               F32 cur_t = 0;
+               Point2F b;
+
+               if(castRayTriangle(start, dir, mVertexData[firstVert + idx0].vert(), 
+                  mVertexData[firstVert + idx1].vert(), mVertexData[firstVert + idx2].vert(), cur_t, b))
+               {
+                  if(cur_t < best_t)
+                  {
+                     best_t = cur_t;
+                     bestIdx0 = firstVert + idx0;
+                     bestIdx1 = firstVert + idx1;
+                     bestIdx2 = firstVert + idx2;
+                     bestMaterial = material;
+                     found = true;
+                  }
+               }
+            }
          }
       }
    }
@@ -1141,6 +1159,8 @@ TSMesh::TSMesh() : meshType( StandardMeshType )
    mHasColor = false;
 
    mNumVerts = 0;
+
+   mTriangleBlocksReady = 0;
 }
 
 //-----------------------------------------------------
@@ -89,6 +89,16 @@ struct TSDrawPrimitive
    S32 matIndex;    ///< holds material index & element type (see above enum)
 };
 
+/// Four triangles in structure-of-arrays form for the batched intersection
+/// kernels in tsMeshIntrinsics.h.  Each array holds the x, y and z of one
+/// vertex of the four triangles.
+struct TSTriangleBlock
+{
+   F32 v0[3][4];
+   F32 v1[3][4];
+   F32 v2[3][4];
+};
+
 #if defined(USE_MEM_VERTEX_BUFFERS)
 struct __NullVertexStruct {};
 typedef GFX360MemVertexBufferHandle<__NullVertexStruct> TSVertexBufferHandle;
@@ -398,6 +408,68 @@ class TSMesh
    IceMaths::Point* mOpPoints;
 
    void prepOpcodeCollision();
+
+   /// @name Triangle Blocks
+   ///
+   /// The triangles of frame 0, four to a block, for the batched kernels
+   /// in tsMeshIntrinsics.h.  The triangles are sorted into the leaf order
+   /// of a bounding volume hierarchy which is built along with the blocks
+   /// the first time a ray or box query needs it.  They are only built for
+   /// standard meshes as the vertices of other mesh types move.
+   /// @{
+
+   Vector< TSTriangleBlock > mTriangleBlocks;
+
+   /// Vertex indices of the triangles, three per triangle.
+   Vector< U32 > mTriangleBlockIndices;
+
+   /// Material index of each triangle.
+   Vector< U32 > mTriangleBlockMaterials;
+
+   /// A node of the triangle hierarchy.
+   struct TriangleBVHNode
+   {
+      Box3F box;
+
+      /// The first of the two children of an interior node, which are
+      /// stored next to each other, or the first triangle of a leaf.
+      U32 first;
+
+      /// The number of triangles in a leaf or zero for interior nodes.
+      U32 count;
+   };
+
+   /// The hierarchy with the root node first.  Leaves always start on
+   /// a block boundary.
+   Vector< TriangleBVHNode > mTriangleBVH;
+
+   /// Set to 1 once the blocks and hierarchy have been built.  Only
+   /// accessed through dAtomicRead() and dCompareAndSwap() as the
+   /// blocks may be built and used from several threads.
+   volatile U32 mTriangleBlocksReady;
+
+   enum
+   {
+      /// The most triangles stored in a single leaf.
+      MaxTriangleBVHLeafSize = 16,
+
+      /// The deepest the hierarchy is allowed to get.
+      MaxTriangleBVHDepth = 64,
+   };
+
+   /// Builds the triangle blocks and their hierarchy.  This is safe to call
+   /// from several threads and returns true if the mesh has any triangles
+   /// to query.
+   bool prepTriangleBlocks();
+
+   U32 getNumBlockTriangles() const { return mTriangleBlockMaterials.size(); }
+
+   /// Returns the triangle hit nearest to the start of the ray, or -1 if
+   /// there was no hit closer than inOutT.  prepTriangleBlocks() must have
+   /// been called.
+   S32 castRayTriangleBlocks( const Point3F &start, const Point3F &dir, F32 &inOutT ) const;
+
+   /// @}
    bool buildConvexOpcode( const MatrixF &mat, const Box3F &bounds, Convex *c, Convex *list );
    bool buildPolyListOpcode( const S32 od, AbstractPolyList *polyList, const Box3F &nodeBox, TSMaterialList *materials );
    bool castRayOpcode( const Point3F &start, const Point3F &end, RayInfo *rayInfo, TSMaterialList *materials );
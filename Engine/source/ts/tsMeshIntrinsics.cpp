@@ -23,10 +23,14 @@
 #include "ts/tsMeshIntrinsics.h"
 #include "ts/arch/tsMeshIntrinsics.arch.h"
 #include "core/module.h"
+#include "util/triRayCheck.h"
+#include "util/triBoxCheck.h"
 
 
 void (*zero_vert_normal_bulk)(const dsize_t count, U8 * __restrict const outPtr, const dsize_t outStride) = NULL;
 void (*m_matF_x_BatchedVertWeightList)(const MatrixF &mat, const dsize_t count, const TSSkinMesh::BatchData::BatchedVertWeight * __restrict batch, U8 * const __restrict outPtr, const dsize_t outStride) = NULL;
+S32 (*castRay_TriangleBlocks)(const Point3F &start, const Point3F &dir, const TSTriangleBlock * __restrict blocks, const dsize_t numTriangles, F32 &inOutT) = NULL;
+U32 (*triBoxOverlap_TriangleBlocks)(const Point3F &center, const Point3F &halfSize, const TSTriangleBlock * __restrict blocks, const dsize_t numTriangles, U8 * __restrict outOverlap) = NULL;
 
 //------------------------------------------------------------------------------
 // Default C++ Implementations (pretty slow)
@@ -74,6 +78,54 @@ void m_matF_x_BatchedVertWeightList_C(const MatrixF &mat,
    }
 }
 
+//------------------------------------------------------------------------------
+
+static inline void getBlockTriangle(const TSTriangleBlock &block, const U32 lane, Point3F verts[3])
+{
+   verts[0].set( block.v0[0][lane], block.v0[1][lane], block.v0[2][lane] );
+   verts[1].set( block.v1[0][lane], block.v1[1][lane], block.v1[2][lane] );
+   verts[2].set( block.v2[0][lane], block.v2[1][lane], block.v2[2][lane] );
+}
+
+S32 castRay_TriangleBlocks_C(const Point3F &start, const Point3F &dir, const TSTriangleBlock * __restrict blocks, const dsize_t numTriangles, F32 &inOutT)
+{
+   S32 best = -1;
+   Point3F verts[3];
+
+   for(dsize_t i = 0; i < numTriangles; i++)
+   {
+      getBlockTriangle( blocks[i >> 2], i & 3, verts );
+
+      F32 t;
+      Point2F bary;
+      if( castRayTriangle( start, dir, verts[0], verts[1], verts[2], t, bary ) && t < inOutT )
+      {
+         inOutT = t;
+         best = i;
+      }
+   }
+
+   return best;
+}
+
+//------------------------------------------------------------------------------
+
+U32 triBoxOverlap_TriangleBlocks_C(const Point3F &center, const Point3F &halfSize, const TSTriangleBlock * __restrict blocks, const dsize_t numTriangles, U8 * __restrict outOverlap)
+{
+   U32 count = 0;
+   Point3F verts[3];
+
+   for(dsize_t i = 0; i < numTriangles; i++)
+   {
+      getBlockTriangle( blocks[i >> 2], i & 3, verts );
+
+      outOverlap[i] = triBoxOverlap( center, halfSize, verts ) ? 1 : 0;
+      count += outOverlap[i];
+   }
+
+   return count;
+}
+
 //------------------------------------------------------------------------------
 // Initializer.
 //------------------------------------------------------------------------------
@@ -87,6 +139,8 @@ MODULE_BEGIN( TSMeshIntrinsics )
       // Assign defaults (C++ versions)
       zero_vert_normal_bulk = zero_vert_normal_bulk_C;
       m_matF_x_BatchedVertWeightList = m_matF_x_BatchedVertWeightList_C;
+      castRay_TriangleBlocks = castRay_TriangleBlocks_C;
+      triBoxOverlap_TriangleBlocks = triBoxOverlap_TriangleBlocks_C;
 
    #if defined(TORQUE_OS_XENON)
       zero_vert_normal_bulk = zero_vert_normal_bulk_X360;
@@ -99,6 +153,8 @@ MODULE_BEGIN( TSMeshIntrinsics )
          
          zero_vert_normal_bulk = zero_vert_normal_bulk_SSE;
          m_matF_x_BatchedVertWeightList = m_matF_x_BatchedVertWeightList_SSE;
+         castRay_TriangleBlocks = castRay_TriangleBlocks_SSE;
+         triBoxOverlap_TriangleBlocks = triBoxOverlap_TriangleBlocks_SSE;
 
          /* This code still has a bug left in it
    #if (_MSC_VER >= 1500)
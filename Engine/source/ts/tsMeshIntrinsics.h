@@ -47,5 +47,39 @@ extern void (*zero_vert_normal_bulk)
                            U8 * __restrict const outPtr, 
                            const dsize_t outStride);
 
+/// Find the closest triangle hit by a line segment
+///
+/// Hits follow castRayTriangle(): both sides of a triangle count and the
+/// hit has to lie on the segment.
+///
+/// @param start        Start of the segment
+/// @param dir          End of the segment minus its start
+/// @param blocks       Triangles, four to a block; unused slots of the last block must be degenerate
+/// @param numTriangles Number of triangles
+/// @param inOutT       Only hits closer than this are reported; lowered to the hit found
+/// @return             Index of the triangle hit or -1
+extern S32 (*castRay_TriangleBlocks)
+                          (const Point3F &start,
+                           const Point3F &dir,
+                           const TSTriangleBlock * __restrict blocks,
+                           const dsize_t numTriangles,
+                           F32 &inOutT);
+
+/// Test which triangles overlap a box, like triBoxOverlap()
+///
+/// @param center       Box center
+/// @param halfSize     Half the box extents
+/// @param blocks       Triangles, four to a block
+/// @param numTriangles Number of triangles
+/// @param outOverlap   Set to 1 for each triangle that overlaps the box and 0 otherwise;
+///                     needs room for numTriangles rounded up to a multiple of four
+/// @return             Number of triangles overlapping the box
+extern U32 (*triBoxOverlap_TriangleBlocks)
+                          (const Point3F &center,
+                           const Point3F &halfSize,
+                           const TSTriangleBlock * __restrict blocks,
+                           const dsize_t numTriangles,
+                           U8 * __restrict outOverlap);
+
 #endif
 
@@ -76,6 +76,11 @@
 #  undef TORQUE_TOOLS
 #endif
 
+/// Define me to make the TorqueScript interpreter dispatch opcodes through a
+/// plain switch statement.  By default, GCC and Clang builds use a threaded
+/// dispatch loop built on computed gotos which is noticeably faster.
+//#define TORQUE_SCRIPT_SWITCH_DISPATCH
+
 /// Define me if you want to enable the profiler.
 ///    See also the TORQUE_SHIPPING block below
 //#define TORQUE_ENABLE_PROFILER